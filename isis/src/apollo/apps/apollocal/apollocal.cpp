@@ -15,7 +15,7 @@ void cal(vector<Buffer *> &in,
 void IsisMain() {
   // We will be processing by line
   ProcessByTile p;
-  p.SetTileSize(128, 128);
+  p.SetOptimalBrickSize(true);
 
   Cube *inCube = p.SetInputCube("FROM");
 
@@ -19,7 +19,7 @@ static QString action;
 void IsisMain() {
   // We will be processing by line
   ProcessByTile p;
-  p.SetTileSize(128, 128);
+  p.SetOptimalBrickSize(true);
 
   // Setup the input and output cubes
   Cube* info = p.SetInputCube("FROM");
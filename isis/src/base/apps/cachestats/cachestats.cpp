@@ -0,0 +1,33 @@
+#include "Isis.h"
+
+#include "Cube.h"
+#include "CubeStatisticsCache.h"
+#include "Histogram.h"
+#include "Progress.h"
+#include "PvlGroup.h"
+#include "Statistics.h"
+
+using namespace std;
+using namespace Isis;
+
+void IsisMain() {
+  UserInterface &ui = Application::GetUserInterface();
+  Cube cube;
+  cube.open(ui.GetFileName("FROM"), "rw");
+
+  if (!cube.storesDnData()) {
+    QString msg = "The cube [" + ui.GetFileName("FROM") + "] does not store its own DNs";
+    throw IException(IException::User, msg, _FILEINFO_);
+  }
+
+  Progress prog;
+  CubeStatisticsCache cache(cube, &prog);
+  cube.write(cache);
+
+  PvlGroup results("Results");
+  results += PvlKeyword("Bands", toString(cache.bands()));
+  results += PvlKeyword("Bytes", toString(cache.Size()));
+  Application::Log(results);
+
+  cube.close();
+}
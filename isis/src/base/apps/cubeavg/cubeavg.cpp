@@ -8,8 +8,8 @@
 using namespace std;
 using namespace Isis;
 
-void cubeavg(vector<Buffer *> &in,
-             vector<Buffer *> &out);
+void cubeavg(ProcessBySpectra::SpectraBlock &in,
+             ProcessBySpectra::SpectraBlock &out);
 
 void removekeywords(PvlGroup &pvlg);
 
@@ -104,15 +104,18 @@ void IsisMain() {
     }
   }
 
-  p.StartProcess(cubeavg);
+  p.ProcessSpectra(cubeavg);
   p.EndProcess();
 }
 
-// Band processing routine
-void cubeavg(vector<Buffer *> &in, vector<Buffer *> &out) {
-  Statistics sts;
-  sts.AddData((*in[0]).DoubleBuffer() , (*in[0]).size());
-  (*out[0]) = sts.Average();
+// Averages every spectrum of a tile
+void cubeavg(ProcessBySpectra::SpectraBlock &in,
+             ProcessBySpectra::SpectraBlock &out) {
+  for(int i = 0; i < in.spectrumCount(); i++) {
+    Statistics sts;
+    sts.AddData(in.spectrum(i), in.bandCount());
+    out.spectrum(i)[0] = sts.Average();
+  }
 }
 
 /**
@@ -2,7 +2,6 @@
 
 #include "FileList.h"
 #include "ImageOverlapSet.h"
-#include "SerialNumber.h"
 #include "SerialNumberList.h"
 
 using namespace std;
@@ -10,13 +9,9 @@ using namespace Isis;
 
 void IsisMain() {
   UserInterface &ui = Application::GetUserInterface();
-  SerialNumberList serialNumbers(true);
 
   FileList images(ui.GetFileName("FROMLIST"));
-  // list of sns/filenames sorted by serial number
 
-  vector< pair<QString, QString> > sortedList;
-  
   if (images.size() == 1) {
     throw IException(IException::User, "The list [" + ui.GetFileName("FROMLIST") +
                      "] only contains one image.", _FILEINFO_);
@@ -24,22 +19,10 @@ void IsisMain() {
 
   // We want to sort the input data by serial number so that the same
   //   results are produced every time this program is run with the same
-  //   images. This is a modified insertion sort.
-  for (int image = 0; image < images.size(); image++) {
-    unsigned int insertPos = 0;
-    QString sn = SerialNumber::Compose(images[image].toString());
-    for (insertPos = 0; insertPos < sortedList.size(); insertPos++) {
-      if (sn.compare(sortedList[insertPos].first) < 0) break;
-    }
-    pair<QString, QString> newPair = pair<QString, QString>(sn, images[image].toString());
-    sortedList.insert(sortedList.begin() + insertPos, newPair);
-  }
-  
-  // Add the serial numbers in sorted order now
-  for (unsigned int i = 0; i < sortedList.size(); i++) {
-    serialNumbers.add(sortedList[i].second);
-  }
-  
+  //   images.
+  SerialNumberList serialNumbers(ui.GetFileName("FROMLIST"), true);
+  serialNumbers.sortBySerialNumber();
+
   // Now we want the ImageOverlapSet to calculate our overlaps
   ImageOverlapSet overlaps(true);
   
@@ -27,6 +27,7 @@
 #include "CubeInfixToPostfix.h"
 #include "FileList.h"
 #include "FileName.h"
+#include "PixelKernel.h"
 #include "ProcessByLine.h"
 
 using namespace std;
@@ -45,6 +46,26 @@ void IsisMain() {
   Cube *inCube;
   int bands = 1;
 
+  if (ui.GetString("MODE") == "CUBES" && !ui.WasEntered("F2") && !ui.WasEntered("F3") &&
+      !ui.WasEntered("F4") && !ui.WasEntered("F5")) {
+    // A single input cube is evaluated by the fx pixel kernel, which the
+    // Pipeline also uses to run fx in a single pass with other programs
+    inCube = p.SetInputCube("F1", Isis::AllMatchOrOne);
+    p.SetOutputCube("TO");
+
+    QMap<QString, QString> parameters;
+    parameters["EQUATION"] = ui.GetString("EQUATION");
+
+    QList<PixelKernel *> kernels;
+    kernels.append(PixelKernel::Create("fx", parameters));
+    PixelKernelChain fx(kernels);
+    fx.Prepare(*inCube);
+
+    p.ProcessCube(fx);
+    p.EndProcess();
+    return;
+  }
+
   if (ui.GetString("MODE") == "CUBES") {
     // Require atleast one file to be specified
     inCube = p.SetInputCube("F1", Isis::AllMatchOrOne);
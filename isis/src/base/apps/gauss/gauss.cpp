@@ -7,6 +7,8 @@
 #include "FileName.h"
 #include "IException.h"
 
+#include <vector>
+
 using namespace std;
 using namespace Isis;
 
@@ -36,7 +38,17 @@ void IsisMain() {
   coefs = new double[size*size];
   setFilter(size, stdDev);
 
-  p.StartProcess(useFilter);
+  // The gaussian kernel is separable, so apply it as a sample filter followed
+  // by a line filter
+  vector<double> kernel(coefs, coefs + size * size);
+  vector<double> sampleWeights, lineWeights;
+  if(size % 2 == 1 &&
+     ProcessByBoxcar::SeparateKernel(kernel, size, size, sampleWeights, lineWeights)) {
+    p.StartSeparableProcess(sampleWeights, lineWeights, ProcessByBoxcar::IgnoreSpecialPixels);
+  }
+  else {
+    p.StartProcess(useFilter);
+  }
   p.EndProcess();
 
   delete [] coefs;
@@ -26,7 +26,7 @@ void IsisMain() {
   UserInterface &ui = Application::GetUserInterface();
   Cube cube;
   QString from = ui.GetFileName("FROM");
-  cube.open(from, "r");
+  cube.open(from, "label");
 
   // Determine if output should be written base on parameters
   bool WriteFile = ui.GetBoolean("FILE");
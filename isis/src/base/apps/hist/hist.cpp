@@ -5,10 +5,10 @@
 #include <QString>
 
 #include "CubePlotCurve.h"
+#include "CubeStatisticsDriver.h"
 #include "Histogram.h"
 #include "HistogramItem.h"
 #include "HistogramPlotWindow.h"
-#include "LineManager.h"
 #include "Process.h"
 #include "Progress.h"
 #include "QHistogram.h"
@@ -42,14 +42,8 @@ void IsisMain() {
   p.Progress()->SetText("Gathering Histogram");
   p.Progress()->SetMaximumSteps(icube->lineCount());
   p.Progress()->CheckStatus();
-  LineManager line(*icube);
-
-  for(int i = 1; i <= icube->lineCount(); i++) {
-    line.SetLine(i);
-    icube->read(line);
-    hist.AddData(line.DoubleBuffer(), line.size());
-    p.Progress()->CheckStatus();
-  }
+  CubeStatisticsDriver driver(*icube, p.Progress());
+  driver.addData(1, hist);
 
   if(!ui.IsInteractive() || ui.WasEntered("TO") ) {
     // Write the results
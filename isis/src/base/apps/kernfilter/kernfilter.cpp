@@ -62,7 +62,17 @@ void IsisMain() {
   // Weight for multiplication of resultant immidately before completion
   weight = kern["weight"];
 
-  p.StartProcess(filter);
+  // Separable kernels are applied as a sample filter followed by a line filter
+  vector<double> sampleWeights, lineWeights;
+  if(ProcessByBoxcar::SeparateKernel(coefs, samples, lines, sampleWeights, lineWeights)) {
+    for(unsigned int i = 0; i < lineWeights.size(); i++) {
+      lineWeights[i] *= weight;
+    }
+    p.StartSeparableProcess(sampleWeights, lineWeights, ProcessByBoxcar::NullIfAnySpecial);
+  }
+  else {
+    p.StartProcess(filter);
+  }
   p.EndProcess();
 }
 
@@ -1,45 +1,28 @@
 #include "Isis.h"
 
+#include "PixelKernel.h"
 #include "ProcessByLine.h"
-#include "SpecialPixel.h"
 
 using namespace std;
 using namespace Isis;
 
-void doRatio(vector<Buffer*> &in,
-           vector<Buffer*> &out);
-
 void IsisMain() {
   ProcessByLine p;
-  p.SetInputCube("NUMERATOR");
-  p.SetInputCube("DENOMINATOR");
+  Cube *numerator = p.SetInputCube("NUMERATOR");
   p.SetOutputCube("TO");
-  p.StartProcess(doRatio);
-  p.EndProcess();
-}
 
-// Line processing routine
-void doRatio(vector<Buffer*> &in,
-           vector<Buffer*> &out) {
-  Buffer &num = *in[0];
-  Buffer &den = *in[1];
-  Buffer &rat = *out[0];
+  // The ratio pixel kernel reads the denominator and divides each pixel.
+  // Special pixels and division by zero give NULL. The Pipeline also uses it
+  // to run ratio in a single pass with other programs.
+  UserInterface &ui = Application::GetUserInterface();
+  QMap<QString, QString> parameters;
+  parameters["DENOMINATOR"] = ui.GetAsString("DENOMINATOR");
 
-  // Loop for each pixel in the line. Check
-  // for special pixels and if any are found the
-  // output will be set to NULL.
-  for (int i = 0; i < num.size(); i++) {
-    if ( IsSpecial(num[i]) ) {
-      rat[i] = NULL8;
-    }
-    else if ( IsSpecial(den[i]) ) {
-      rat[i] = NULL8;
-    }
-    else if ( den[i] == 0.0 ) {
-      rat[i] = NULL8;
-    }
-    else {
-      rat[i] = num[i] / den[i];
-    }
-  }
+  QList<PixelKernel *> kernels;
+  kernels.append(PixelKernel::Create("ratio", parameters));
+  PixelKernelChain ratio(kernels);
+  ratio.Prepare(*numerator);
+
+  p.ProcessCube(ratio);
+  p.EndProcess();
 }
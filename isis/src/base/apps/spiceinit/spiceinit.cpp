@@ -4,19 +4,23 @@
 #include <queue>
 
 #include <QList>
+#include <QMap>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 
 #include "Camera.h"
 #include "CameraFactory.h"
+#include "FileList.h"
 #include "FileName.h"
 #include "IException.h"
 #include "Kernel.h"
 #include "KernelDb.h"
 #include "Longitude.h"
 #include "Process.h"
+#include "Pvl.h"
 #include "PvlToPvlTranslationManager.h"
+#include "Spice.h"
 #include "SpiceClient.h"
 #include "SpiceClientStarter.h"
 #include "Table.h"
@@ -24,6 +28,31 @@
 using namespace std;
 using namespace Isis;
 
+//! The kernels selected for a cube
+struct KernelSelection {
+  Kernel lk;           //!< Leap second kernel
+  Kernel pck;          //!< Target attitude and shape kernel
+  Kernel targetSpk;    //!< Target position kernel
+  Kernel fk;           //!< Frame kernel
+  Kernel ik;           //!< Instrument kernel
+  Kernel sclk;         //!< Spacecraft clock kernel
+  Kernel spk;          //!< Spacecraft position kernel
+  Kernel iak;          //!< Instrument addendum kernel
+  Kernel dem;          //!< Shape model
+  Kernel exk;          //!< Extra kernels
+  QList< priority_queue<Kernel> > ck; //!< Camera kernels, by priority
+};
+
+//! The system kernel databases of one mission and set of database files
+struct SystemKernelDbs {
+  KernelDb *base; //!< Databases searched with no kernel types
+  KernelDb *ck;   //!< Databases searched with the allowed CK types
+  KernelDb *spk;  //!< Databases searched with the allowed SPK types
+};
+
+//! Loaded kernel databases, by mission and database files
+typedef QMap<QString, SystemKernelDbs> KernelDbCache;
+
 void getUserEnteredKernel(const QString &param, Kernel &kernel);
 bool tryKernels(Cube *icube, Process &p,
                 Kernel lk, Kernel pck,
@@ -35,13 +64,77 @@ bool tryKernels(Cube *icube, Process &p,
 
 void requestSpice(Cube *icube, Pvl &labels, QString missionName);
 
+QString missionName(Pvl &lab);
+SystemKernelDbs &systemKernelDbs(const QString &mission, Pvl &lab,
+                                 KernelDbCache &cache);
+KernelSelection selectKernels(const QString &mission, Pvl &lab,
+                              KernelDbCache &cache);
+QString kernelSetKey(const KernelSelection &selection);
+QStringList naifKernels(const KernelSelection &selection);
+bool spiceinit(const QString &fileName, const KernelSelection *selection,
+               KernelDbCache &cache);
+void spiceinitList(const QString &listFileName, KernelDbCache &cache);
+void clearKernelDbs(KernelDbCache &cache);
+
 void IsisMain() {
+  UserInterface &ui = Application::GetUserInterface();
+  KernelDbCache cache;
+
+  try {
+    if (ui.WasEntered("FROMLIST")) {
+      spiceinitList(ui.GetFileName("FROMLIST"), cache);
+    }
+    else if (ui.WasEntered("FROM")) {
+      spiceinit(ui.GetFileName("FROM"), NULL, cache);
+    }
+    else {
+      QString msg = "Either FROM or FROMLIST must be entered";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+  }
+  catch (IException &) {
+    clearKernelDbs(cache);
+    throw;
+  }
+
+  clearKernelDbs(cache);
+}
+
+
+/**
+ * Deletes the loaded kernel databases.
+ *
+ * @param cache The kernel databases loaded so far
+ */
+void clearKernelDbs(KernelDbCache &cache) {
+  foreach (SystemKernelDbs dbs, cache) {
+    delete dbs.base;
+    delete dbs.ck;
+    delete dbs.spk;
+  }
+  cache.clear();
+}
+
+
+/**
+ * Initializes the SPICE of one cube.
+ *
+ * @param fileName The cube to initialize
+ * @param selection The kernels already selected for the cube from the
+ *                  system kernel databases, or NULL to select them here
+ * @param cache The kernel databases loaded so far
+ *
+ * @return bool True if a failed try unloaded the kernels furnished with
+ *              Spice::furnishKernels()
+ */
+bool spiceinit(const QString &fileName, const KernelSelection *selection,
+               KernelDbCache &cache) {
   // Open the input cube
   Process p;
   UserInterface &ui = Application::GetUserInterface();
 
   CubeAttributeInput cai;
-  Cube *icube = p.SetInputCube(ui.GetFileName("FROM"), cai, ReadWrite);
+  Cube *icube = p.SetInputCube(fileName, cai, ReadWrite);
   // Make sure at least one CK & SPK quality was selected
   if (!ui.GetBoolean("CKPREDICTED") && !ui.GetBoolean("CKRECON") &&
      !ui.GetBoolean("CKSMITHED") && !ui.GetBoolean("CKNADIR")) {
@@ -75,102 +168,24 @@ void IsisMain() {
     icube->label()->deleteObject("Polygon");
   }
 
-  // Set up for getting the mission name
-  // Get the directory where the system missions translation table is.
-  QString transFile = p.MissionData("base",
-                                    "translations/MissionName2DataDir.trn");
-
-  // Get the mission translation manager ready
-  PvlToPvlTranslationManager missionXlater(lab, transFile);
-
   // Get the mission name so we can search the correct DB's for kernels
-  QString mission = missionXlater.Translate("MissionName");
+  QString mission = missionName(lab);
+
+  bool unloadedFurnished = false;
 
   if (ui.GetBoolean("WEB")) {
     requestSpice(icube, *icube->label(), mission);
   }
   else {
-    // Get system base kernels
-    unsigned int allowed = 0;
-    unsigned int allowedCK = 0;
-    unsigned int allowedSPK = 0;
-
-    if (ui.GetBoolean("CKPREDICTED"))
-      allowedCK |= Kernel::typeEnum("PREDICTED");
-    if (ui.GetBoolean("CKRECON"))
-      allowedCK |= Kernel::typeEnum("RECONSTRUCTED");
-    if (ui.GetBoolean("CKSMITHED"))
-      allowedCK |= Kernel::typeEnum("SMITHED");
-    if (ui.GetBoolean("CKNADIR"))
-      allowedCK |= Kernel::typeEnum("NADIR");
-    if (ui.GetBoolean("SPKPREDICTED"))
-      allowedSPK |= Kernel::typeEnum("PREDICTED");
-    if (ui.GetBoolean("SPKRECON"))
-      allowedSPK |= Kernel::typeEnum("RECONSTRUCTED");
-    if (ui.GetBoolean("SPKSMITHED"))
-      allowedSPK |= Kernel::typeEnum("SMITHED");
-
-    KernelDb baseKernels(allowed);
-    KernelDb ckKernels(allowedCK);
-    KernelDb spkKernels(allowedSPK);
-
-    baseKernels.loadSystemDb(mission, lab);
-    ckKernels.loadSystemDb(mission, lab);
-    spkKernels.loadSystemDb(mission, lab);
-
-    Kernel lk, pck, targetSpk, fk, ik, sclk, spk, iak, dem, exk;
-    QList< priority_queue<Kernel> > ck;
-    lk        = baseKernels.leapSecond(lab);
-    pck       = baseKernels.targetAttitudeShape(lab);
-    targetSpk = baseKernels.targetPosition(lab);
-    ik        = baseKernels.instrument(lab);
-    sclk      = baseKernels.spacecraftClock(lab);
-    iak       = baseKernels.instrumentAddendum(lab);
-    fk        = ckKernels.frame(lab);
-    ck        = ckKernels.spacecraftPointing(lab);
-    spk       = spkKernels.spacecraftPosition(lab);
-
-    if (ui.GetBoolean("CKNADIR")) {
-      // Only add nadir if no spacecraft pointing found, so we will set (priority) type to 0.
-      QStringList nadirCk;
-      nadirCk.push_back("Nadir");
-      // if a priority queue already exists, add Nadir with low priority of 0
-      if (ck.size() > 0) {
-        ck[0].push(Kernel((Kernel::Type)0, nadirCk));
-      }
-      // if no queue exists, create a nadir queue
-      else {
-        priority_queue<Kernel> nadirQueue;
-        nadirQueue.push(Kernel((Kernel::Type)0, nadirCk));
-        ck.push_back(nadirQueue);
-      }
-    }
-
-    // Get user defined kernels and override ones already found
-    getUserEnteredKernel("LS", lk);
-    getUserEnteredKernel("PCK", pck);
-    getUserEnteredKernel("TSPK", targetSpk);
-    getUserEnteredKernel("FK", fk);
-    getUserEnteredKernel("IK", ik);
-    getUserEnteredKernel("SCLK", sclk);
-    getUserEnteredKernel("SPK", spk);
-    getUserEnteredKernel("IAK", iak);
-    getUserEnteredKernel("EXTRA", exk);
-
-    // Get shape kernel
-    if (ui.GetString("SHAPE") == "USER") {
-      getUserEnteredKernel("MODEL", dem);
-    }
-    else if (ui.GetString("SHAPE") == "SYSTEM") {
-      dem = baseKernels.dem(lab);
-    }
+    KernelSelection kernels = selection ? *selection : selectKernels(mission, lab, cache);
+    QList< priority_queue<Kernel> > &ck = kernels.ck;
 
     bool kernelSuccess = false;
 
     if ((ck.size() == 0 || ck.at(0).size() == 0) && !ui.WasEntered("CK")) {
       // no ck was found in system and user did not enter ck, throw error
       throw IException(IException::Unknown,
-                       "No Camera Kernels found for the image [" + ui.GetFileName("FROM")
+                       "No Camera Kernels found for the image [" + fileName
                        + "]",
                        _FILEINFO_);
     }
@@ -225,14 +240,23 @@ void IsisMain() {
       ck[0].pop();
 
       // Merge SpacecraftPointing and Frame into ck
-      for (int i = 0; i < fk.size(); i++) {
-        ckKernelList.push_back(fk[i]);
+      for (int i = 0; i < kernels.fk.size(); i++) {
+        ckKernelList.push_back(kernels.fk[i]);
       }
 
       realCkKernel.setKernels(ckKernelList);
 
-      kernelSuccess = tryKernels(icube, p, lk, pck, targetSpk,
-                                 realCkKernel, fk, ik, sclk, spk, iak, dem, exk);
+      kernelSuccess = tryKernels(icube, p, kernels.lk, kernels.pck,
+                                 kernels.targetSpk, realCkKernel, kernels.fk,
+                                 kernels.ik, kernels.sclk, kernels.spk,
+                                 kernels.iak, kernels.dem, kernels.exk);
+
+      // Kernels furnished for the list hold the first try's camera kernels,
+      // so the next try loads its own
+      if (!kernelSuccess) {
+        Spice::unloadFurnishedKernels();
+        unloadedFurnished = true;
+      }
     }
 
     if (!kernelSuccess)
@@ -241,8 +265,321 @@ void IsisMain() {
                        _FILEINFO_);
   }
   p.EndProcess();
+
+  return unloadedFurnished;
 }
 
+/**
+ * Returns the name of the mission of a cube, which names the directories of
+ * its kernel databases.
+ *
+ * @param lab The label of the cube
+ *
+ * @return QString The mission name
+ */
+QString missionName(Pvl &lab) {
+  // Set up for getting the mission name
+  // Get the directory where the system missions translation table is.
+  QString transFile = FileName("$base/translations/MissionName2DataDir.trn").expanded();
+
+  // Get the mission translation manager ready
+  PvlToPvlTranslationManager missionXlater(lab, transFile);
+
+  return missionXlater.Translate("MissionName");
+}
+
+
+/**
+ * Returns the system kernel databases for a cube. The databases are loaded
+ * once for each mission and set of database files, and shared by the cubes
+ * that need them.
+ *
+ * @param mission The mission of the cube
+ * @param lab The label of the cube
+ * @param cache The kernel databases loaded so far
+ *
+ * @return SystemKernelDbs& The kernel databases for the cube
+ */
+SystemKernelDbs &systemKernelDbs(const QString &mission, Pvl &lab,
+                                 KernelDbCache &cache) {
+  UserInterface &ui = Application::GetUserInterface();
+
+  // The database files can depend on the instrument through config files
+  KernelDb files(0);
+  files.findSystemDbFiles(mission, lab);
+
+  QStringList key(mission);
+  foreach (FileName dbFile, files.kernelDbFiles()) {
+    key.append(dbFile.expanded());
+  }
+  QString dbKey = key.join("\n");
+
+  if (cache.contains(dbKey)) return cache[dbKey];
+
+  // Get system base kernels
+  unsigned int allowed = 0;
+  unsigned int allowedCK = 0;
+  unsigned int allowedSPK = 0;
+
+  if (ui.GetBoolean("CKPREDICTED"))
+    allowedCK |= Kernel::typeEnum("PREDICTED");
+  if (ui.GetBoolean("CKRECON"))
+    allowedCK |= Kernel::typeEnum("RECONSTRUCTED");
+  if (ui.GetBoolean("CKSMITHED"))
+    allowedCK |= Kernel::typeEnum("SMITHED");
+  if (ui.GetBoolean("CKNADIR"))
+    allowedCK |= Kernel::typeEnum("NADIR");
+  if (ui.GetBoolean("SPKPREDICTED"))
+    allowedSPK |= Kernel::typeEnum("PREDICTED");
+  if (ui.GetBoolean("SPKRECON"))
+    allowedSPK |= Kernel::typeEnum("RECONSTRUCTED");
+  if (ui.GetBoolean("SPKSMITHED"))
+    allowedSPK |= Kernel::typeEnum("SMITHED");
+
+  SystemKernelDbs dbs;
+  dbs.base = new KernelDb(allowed);
+  dbs.ck = new KernelDb(allowedCK);
+  dbs.spk = new KernelDb(allowedSPK);
+
+  try {
+    dbs.base->loadSystemDb(mission, lab);
+    dbs.ck->loadSystemDb(mission, lab);
+    dbs.spk->loadSystemDb(mission, lab);
+  }
+  catch (IException &) {
+    delete dbs.base;
+    delete dbs.ck;
+    delete dbs.spk;
+    throw;
+  }
+
+  cache.insert(dbKey, dbs);
+  return cache[dbKey];
+}
+
+
+/**
+ * Selects the kernels of a cube from the system kernel databases and the
+ * kernels the user entered.
+ *
+ * @param mission The mission of the cube
+ * @param lab The label of the cube
+ * @param cache The kernel databases loaded so far
+ *
+ * @return KernelSelection The kernels for the cube
+ */
+KernelSelection selectKernels(const QString &mission, Pvl &lab,
+                              KernelDbCache &cache) {
+  UserInterface &ui = Application::GetUserInterface();
+  SystemKernelDbs &dbs = systemKernelDbs(mission, lab, cache);
+  KernelDb &baseKernels = *dbs.base;
+  KernelDb &ckKernels = *dbs.ck;
+  KernelDb &spkKernels = *dbs.spk;
+
+  KernelSelection kernels;
+  kernels.lk        = baseKernels.leapSecond(lab);
+  kernels.pck       = baseKernels.targetAttitudeShape(lab);
+  kernels.targetSpk = baseKernels.targetPosition(lab);
+  kernels.ik        = baseKernels.instrument(lab);
+  kernels.sclk      = baseKernels.spacecraftClock(lab);
+  kernels.iak       = baseKernels.instrumentAddendum(lab);
+  kernels.fk        = ckKernels.frame(lab);
+  kernels.ck        = ckKernels.spacecraftPointing(lab);
+  kernels.spk       = spkKernels.spacecraftPosition(lab);
+
+  if (ui.GetBoolean("CKNADIR")) {
+    // Only add nadir if no spacecraft pointing found, so we will set (priority) type to 0.
+    QStringList nadirCk;
+    nadirCk.push_back("Nadir");
+    // if a priority queue already exists, add Nadir with low priority of 0
+    if (kernels.ck.size() > 0) {
+      kernels.ck[0].push(Kernel((Kernel::Type)0, nadirCk));
+    }
+    // if no queue exists, create a nadir queue
+    else {
+      priority_queue<Kernel> nadirQueue;
+      nadirQueue.push(Kernel((Kernel::Type)0, nadirCk));
+      kernels.ck.push_back(nadirQueue);
+    }
+  }
+
+  // Get user defined kernels and override ones already found
+  getUserEnteredKernel("LS", kernels.lk);
+  getUserEnteredKernel("PCK", kernels.pck);
+  getUserEnteredKernel("TSPK", kernels.targetSpk);
+  getUserEnteredKernel("FK", kernels.fk);
+  getUserEnteredKernel("IK", kernels.ik);
+  getUserEnteredKernel("SCLK", kernels.sclk);
+  getUserEnteredKernel("SPK", kernels.spk);
+  getUserEnteredKernel("IAK", kernels.iak);
+  getUserEnteredKernel("EXTRA", kernels.exk);
+
+  // Get shape kernel
+  if (ui.GetString("SHAPE") == "USER") {
+    getUserEnteredKernel("MODEL", kernels.dem);
+  }
+  else if (ui.GetString("SHAPE") == "SYSTEM") {
+    kernels.dem = baseKernels.dem(lab);
+  }
+
+  return kernels;
+}
+
+
+/**
+ * Returns a key naming the kernels selected for a cube, including the
+ * highest priority camera kernels. Cubes with the same key load the same
+ * kernels on their first try.
+ *
+ * @param selection The kernels selected for a cube
+ *
+ * @return QString The key of the kernels
+ */
+QString kernelSetKey(const KernelSelection &selection) {
+  QStringList key;
+  QList<Kernel> kernels;
+  kernels << selection.lk << selection.pck << selection.targetSpk << selection.fk
+          << selection.ik << selection.sclk << selection.spk << selection.iak
+          << selection.dem << selection.exk;
+
+  for (int i = 0; i < selection.ck.size(); i++) {
+    if (selection.ck[i].size() != 0) kernels << selection.ck[i].top();
+  }
+
+  for (int i = 0; i < kernels.size(); i++) {
+    key.append(kernels[i].kernels().join(","));
+  }
+
+  return key.join("\n");
+}
+
+
+/**
+ * Returns the NAIF kernel files a cube loads on its first try, in the order
+ * a Spice object loads them.
+ *
+ * @param selection The kernels selected for a cube
+ *
+ * @return QStringList The kernel files
+ */
+QStringList naifKernels(const KernelSelection &selection) {
+  UserInterface &ui = Application::GetUserInterface();
+  QStringList kernels;
+
+  kernels << selection.targetSpk.kernels() << selection.spk.kernels();
+
+  if (!ui.WasEntered("CK")) {
+    for (int i = selection.ck.size() - 1; i >= 0; i--) {
+      if (selection.ck[i].size() != 0) kernels << selection.ck[i].top().kernels();
+    }
+  }
+
+  kernels << selection.fk.kernels() << selection.pck.kernels()
+          << selection.ik.kernels() << selection.iak.kernels()
+          << selection.lk.kernels() << selection.sclk.kernels()
+          << selection.exk.kernels();
+
+  return kernels;
+}
+
+
+/**
+ * Initializes the SPICE of every cube in a list in this process. The kernel
+ * databases are read once for each mission and set of database files. The
+ * kernels of every cube are selected first, and the cubes are then
+ * initialized grouped by the kernels they load. The kernels of each group are
+ * furnished once and used by all of its cubes.
+ *
+ * A cube that fails is logged and the rest of the list is still processed.
+ * An exception naming the cubes that failed is thrown at the end.
+ *
+ * @param listFileName The list of cubes
+ * @param cache The kernel databases loaded so far
+ */
+void spiceinitList(const QString &listFileName, KernelDbCache &cache) {
+  UserInterface &ui = Application::GetUserInterface();
+  FileList list((FileName(listFileName)));
+
+  if (list.size() == 0) {
+    QString msg = "The list file [" + listFileName + "] does not contain any cubes";
+    throw IException(IException::User, msg, _FILEINFO_);
+  }
+
+  QVector<KernelSelection> selections(list.size());
+  QVector<bool> selected(list.size(), false);
+  QMultiMap<QString, int> order;
+  QStringList failed;
+  PvlGroup failures("SpiceinitFailures");
+
+  // Select the kernels of every cube. The web service selects its own.
+  for (int i = 0; i < list.size(); i++) {
+    QString key;
+
+    if (!ui.GetBoolean("WEB")) {
+      try {
+        Pvl lab(list[i].expanded());
+        selections[i] = selectKernels(missionName(lab), lab, cache);
+        selected[i] = true;
+        key = kernelSetKey(selections[i]);
+      }
+      catch (IException &) {
+        // The cube reports its own error when it is initialized
+      }
+    }
+
+    order.insert(key, i);
+  }
+
+  QString furnishedKey;
+  bool furnished = false;
+  QMultiMap<QString, int>::const_iterator cube;
+  for (cube = order.constBegin(); cube != order.constEnd(); cube++) {
+    int i = cube.value();
+
+    try {
+      if (!furnished || cube.key() != furnishedKey) {
+        Spice::unloadFurnishedKernels();
+        furnishedKey = cube.key();
+        furnished = true;
+
+        if (selected[i]) {
+          try {
+            Spice::furnishKernels(naifKernels(selections[i]));
+          }
+          catch (IException &) {
+            // The cubes of the group load and report their kernels themselves
+            Spice::unloadFurnishedKernels();
+          }
+        }
+      }
+
+      // A cube that needed another try unloaded the kernels of its group, so
+      //   the next cube furnishes them again
+      if (spiceinit(list[i].original(), selected[i] ? &selections[i] : NULL, cache)) {
+        furnished = false;
+      }
+    }
+    catch (IException &e) {
+      furnished = false;
+      failed.append(list[i].original());
+      failures += PvlKeyword("Cube", list[i].original());
+      failures += PvlKeyword("Error", e.toString().simplified());
+    }
+  }
+
+  Spice::unloadFurnishedKernels();
+
+  if (failed.size() > 0) {
+    Application::Log(failures);
+
+    QString msg = "Unable to initialize SPICE for [" + toString(failed.size()) +
+                  "] of the [" + toString(list.size()) + "] cubes in [" +
+                  listFileName + "]: [" + failed.join(", ") + "]";
+    throw IException(IException::Unknown, msg, _FILEINFO_);
+  }
+}
+
+
 /**
  * If the user entered the parameter param, then kernel is replaced by the 
  * user's values and quality is reset to 0. Otherwise, the kernels loaded by the
@@ -1,16 +1,11 @@
 #include "Isis.h"
+#include "PixelKernel.h"
 #include "ProcessByLine.h"
-#include "SpecialPixel.h"
-#include "IException.h"
+#include "IString.h"
 
 using namespace std;
 using namespace Isis;
 
-// Line processing routine
-void trim(Buffer &in, Buffer &out);
-
-int top, bottom, lleft, rright;
-
 void IsisMain() {
   // We will be processing by line
   ProcessByLine p;
@@ -21,54 +16,24 @@ void IsisMain() {
 
   // Override the defaults if the user entered a value
   UserInterface &ui = Application::GetUserInterface();
-  top = ui.GetInteger("TOP");
-  bottom = ui.GetInteger("BOTTOM");
-  lleft = ui.GetInteger("LEFT");
-  rright = ui.GetInteger("RIGHT");
 
-  //  Will anything be trimmed from the cube?
-  bool notrim = false;
-  if(top == 0 && bottom == 0 && lleft == 0 && rright == 0) {
-    notrim = true;
-  }
+  // The trimming is done by the trim pixel kernel, which the Pipeline also
+  // uses to run trim in a single pass with other programs
+  QMap<QString, QString> parameters;
+  parameters["TOP"] = toString(ui.GetInteger("TOP"));
+  parameters["BOTTOM"] = toString(ui.GetInteger("BOTTOM"));
+  parameters["LEFT"] = toString(ui.GetInteger("LEFT"));
+  parameters["RIGHT"] = toString(ui.GetInteger("RIGHT"));
 
-  //  Adjust bottom and right
-  bottom = icube->lineCount() - bottom;
-  rright = icube->sampleCount() - rright;
+  QList<PixelKernel *> kernels;
+  kernels.append(PixelKernel::Create("trim", parameters));
+  PixelKernelChain trim(kernels);
+  trim.Prepare(*icube);
 
   // Start the processing
-  p.StartProcess(trim);
+  p.ProcessCube(trim);
   p.EndProcess();
 
-  //The user didn't trim anything
-  if(notrim == true) {
-    string message = "No trimming was done-output equals input file";
-    throw IException(IException::User, message, _FILEINFO_);
-  }
-
+  // The kernel throws if the user didn't trim anything
+  trim.Finish();
 }
-
-
-//  Line processing routine
-void trim(Buffer &in, Buffer &out) {
-
-  //  Test for line trim and NULL full line
-  if(in.Line() <= top || in.Line() > bottom) {
-    for(int i = 0; i < in.size(); i++) {
-      out[i] = NULL8;
-    }
-  }
-  else {
-    //  Loop and test for sample trim
-    for(int i = 0; i < in.size(); i++) {
-      if(in.Sample(i) <= lleft || in.Sample(i) > rright) {
-        out[i] = NULL8;
-      }
-      else {
-        out[i] = in[i];
-      }
-    }
-  }
-}
-
-
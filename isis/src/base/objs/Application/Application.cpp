@@ -45,7 +45,9 @@ extern int errno;
 #include <QTime>
 
 #include "Application.h"
+#include "ApplicationDaemon.h"
 #include "Constants.h"    //is this still used in this class?
+#include "CubeCacheManager.h"
 #include "CubeManager.h"
 #include "FileName.h"
 #include "IException.h"
@@ -232,6 +234,9 @@ namespace Isis {
             }
           }
         }
+        else if (p_ui->DaemonName() != "") {
+          status = ApplicationDaemon::Serve(p_ui->DaemonName(), funct);
+        }
         else {
           p_ui->SaveHistory();
           // The gui checks everything but not the command line mode so
@@ -262,6 +267,41 @@ namespace Isis {
     return status;
   }
 
+  /**
+   * Runs the program for one run sent to a resident worker. This is called in
+   * a child of the worker, so nothing it changes is seen by later runs.
+   *
+   * @param argc Number of arguments on the command line of the run
+   * @param argv[] Array of arguments
+   * @param funct The program to run
+   *
+   * @return int Status of the function execution
+   */
+  int Application::RunDaemonRequest(int argc, char *argv[], void (*funct)()) {
+    int status = 0;
+    try {
+      p_ui->SetCommandLine(argc, argv);
+
+      p_datetime = DateTime(&p_startTime);
+      m_connectTime.start();
+      p_startClock = clock();
+      p_startDirectIO = DirectIO();
+      p_startPageFaults = PageFaults();
+      p_startProcessSwaps = ProcessSwaps();
+      SessionLog::TheLog(true);
+
+      p_ui->SaveHistory();
+      p_ui->VerifyAll();
+      funct();
+      Application::FunctionCleanup();
+    }
+    catch (IException &e) {
+      status = Application::FunctionError(e);
+    }
+
+    return status;
+  }
+
   /**
    * Creates an application history PvlObject
    *
@@ -554,6 +594,14 @@ namespace Isis {
    */
   void Application::FunctionCleanup() {
 
+    // Report the process wide cube cache when it is on and was used
+    CubeCacheManager *cubeCache = CubeCacheManager::instance();
+    if (cubeCache->budget() > 0 && cubeCache->hitCount() + cubeCache->missCount() > 0) {
+      PvlGroup cacheReport = cubeCache->report();
+      Application::Log(cacheReport);
+      cubeCache->resetCounters();
+    }
+
     SessionLog::TheLog().Write();
 
     if (SessionLog::TheLog().TerminalOutput()) {
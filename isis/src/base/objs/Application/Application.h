@@ -113,6 +113,10 @@ namespace Isis {
    *                          QCoreApplication are instantiated. Fixes #3908.
    *   @history 2017-06-08 Christopher Combs - Changed object used to calculate
    *                          connectTime from  a time_t to a QTime. Fixes #4618.
+   *   @history 2018-09-07 Isis Development Team - Added the -DAEMON reserved parameter, which
+   *                          runs the program as a resident worker through ApplicationDaemon.
+   *   @history 2018-09-07 Isis Development Team - FunctionCleanup() logs the CubeCacheManager
+   *                          report after a run that used the cube cache.
    */
   class Application : public Environment {
     public:
@@ -188,6 +192,8 @@ namespace Isis {
 
       friend class Progress;
       friend class ProgramLauncher;
+      friend class ApplicationDaemon;
+      int RunDaemonRequest(int argc, char *argv[], void (*funct)());
       void UpdateProgress(const QString &text, bool print);
       void UpdateProgress(int percent, bool print);
       void ProcessGuiEvents();
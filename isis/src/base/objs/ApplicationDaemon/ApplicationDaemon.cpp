@@ -0,0 +1,465 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "ApplicationDaemon.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <errno.h>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcessEnvironment>
+
+#include "Application.h"
+#include "FileName.h"
+#include "IException.h"
+#include "IString.h"
+
+using namespace std;
+
+namespace Isis {
+  /**
+   * Sends this run of a program to a resident worker, if the ISISDAEMON
+   * environment variable names one and it is running. Runs with no parameters
+   * or with reserved parameters are never sent, since they may need the gui
+   * or state the worker does not have.
+   *
+   * The output of the run is written to the standard output and error of this
+   * process.
+   *
+   * @param argc Number of arguments on the command line
+   * @param argv[] Array of arguments
+   * @param status Set to the exit status of the run if it was sent
+   *
+   * @return @b bool True if the worker ran the program
+   */
+  bool ApplicationDaemon::RunRemote(int &argc, char *argv[], int &status) {
+    const char *daemonName = getenv("ISISDAEMON");
+    if (daemonName == NULL || QString(daemonName) == "" || argc < 2) return false;
+
+    QStringList arguments;
+    for (int i = 0; i < argc; i++) {
+      if (i > 0 && argv[i][0] == '-') return false;
+      arguments.append(argv[i]);
+    }
+
+    QCoreApplication app(argc, argv);
+    QLocalSocket worker;
+    worker.connectToServer(ServerName(argv[0], daemonName));
+    if (!worker.waitForConnected(1000)) return false;
+
+    worker.write(EncodeRequest(QDir::currentPath(), arguments,
+                               QProcessEnvironment::systemEnvironment().toStringList()));
+    worker.waitForBytesWritten(-1);
+
+    // Relay the output of the run until its exit status arrives
+    QByteArray data;
+    while (true) {
+      while (data.size() >= 5) {
+        const unsigned char *header = (const unsigned char *) data.constData();
+        int size = (header[1] << 24) | (header[2] << 16) | (header[3] << 8) | header[4];
+        if (data.size() < 5 + size) break;
+
+        char channel = data[0];
+        if (channel == 'O') {
+          fwrite(data.constData() + 5, 1, size, stdout);
+          fflush(stdout);
+        }
+        else if (channel == 'E') {
+          fwrite(data.constData() + 5, 1, size, stderr);
+          fflush(stderr);
+        }
+        else if (channel == 'X') {
+          status = toInt(QString::fromLatin1(data.constData() + 5, size));
+          return true;
+        }
+        else if (channel == 'R') {
+          // The worker can not run with this environment, so run here
+          return false;
+        }
+        data.remove(0, 5 + size);
+      }
+
+      if (worker.bytesAvailable() == 0 &&
+          (worker.state() != QLocalSocket::ConnectedState ||
+           !worker.waitForReadyRead(-1))) {
+        break;
+      }
+      data.append(worker.readAll());
+    }
+
+    cerr << "Lost the connection to Isis daemon [" << daemonName << "]" << endl;
+    status = IException::Unknown;
+    return true;
+  }
+
+
+  /**
+   * Runs as a resident worker for a program. This does not return until the
+   * process is killed.
+   *
+   * @param daemonName The name of the worker
+   * @param funct The program to run
+   *
+   * @throws Isis::IException::Io - Unable to listen for runs
+   *
+   * @return @b int The exit status of the worker
+   */
+  int ApplicationDaemon::Serve(const QString &daemonName, void (*funct)()) {
+    QString serverName = ServerName(Application::Name(), daemonName);
+
+    // Remove the socket of a worker that did not shut down cleanly
+    QLocalServer::removeServer(serverName);
+
+    // Only the user who started the worker may send it runs
+    QLocalServer server;
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server.listen(serverName)) {
+      QString msg = "Unable to listen for runs of Isis daemon [" + daemonName +
+                    "]: " + server.errorString();
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    // Runs are handled by children that nobody waits on
+    signal(SIGCHLD, SIG_IGN);
+
+    // Each caller is handed to a child as soon as it connects, so waiting for
+    //   a slow caller's run never holds up the next caller
+    while (true) {
+      if (!server.waitForNewConnection(-1)) continue;
+
+      QLocalSocket *caller = server.nextPendingConnection();
+      pid_t pid = fork();
+      if (pid == 0) {
+        signal(SIGCHLD, SIG_DFL);
+        ServeCaller(caller->socketDescriptor(), funct);
+        _exit(0);
+      }
+
+      delete caller;
+    }
+
+    return 0;
+  }
+
+
+  /**
+   * Returns the name of the local socket a worker listens on.
+   *
+   * @param programName The program the worker runs
+   * @param daemonName The name of the worker
+   *
+   * @return @b QString The socket name
+   */
+  QString ApplicationDaemon::ServerName(const QString &programName,
+                                        const QString &daemonName) {
+    return "isis_" + Application::UserName() + "_" +
+           FileName(programName).baseName() + "_" + daemonName;
+  }
+
+
+  /**
+   * Reads a run from a caller and runs it. This is called in a child of the
+   * worker for each caller. Callers that do not send a whole run within 30
+   * seconds are dropped, and runs from a caller with a different ISISROOT are
+   * refused so the caller runs them itself.
+   *
+   * @param socket The connection to the caller
+   * @param funct The program to run
+   */
+  void ApplicationDaemon::ServeCaller(int socket, void (*funct)()) {
+    QByteArray data;
+    QString directory;
+    QStringList arguments;
+    QStringList environment;
+    bool received = false;
+    char buffer[65536];
+
+    while (!received) {
+      struct pollfd fds;
+      fds.fd = socket;
+      fds.events = POLLIN;
+      int ready = poll(&fds, 1, 30000);
+      if (ready < 0 && errno == EINTR) continue;
+      if (ready <= 0) return;
+
+      ssize_t count = read(socket, buffer, sizeof(buffer));
+      if (count < 0 && errno == EINTR) continue;
+      if (count <= 0) return;
+
+      data.append(buffer, count);
+      received = DecodeRequest(data, directory, arguments, environment);
+    }
+
+    QString isisRoot;
+    for (int i = 0; i < environment.size(); i++) {
+      if (environment[i].startsWith("ISISROOT=")) {
+        isisRoot = environment[i].mid(9);
+      }
+    }
+
+    const char *workerRoot = getenv("ISISROOT");
+    if (isisRoot != QString(workerRoot ? workerRoot : "")) {
+      WriteMessage(socket, 'R', "", 0);
+      return;
+    }
+
+    SetEnvironment(environment);
+    RunRequest(socket, directory, arguments, funct);
+  }
+
+
+  /**
+   * Replaces the environment of this process.
+   *
+   * @param environment The new environment as NAME=VALUE strings
+   */
+  void ApplicationDaemon::SetEnvironment(const QStringList &environment) {
+    QStringList names = QProcessEnvironment::systemEnvironment().keys();
+    for (int i = 0; i < names.size(); i++) {
+      unsetenv(names[i].toLocal8Bit().constData());
+    }
+
+    for (int i = 0; i < environment.size(); i++) {
+      int equals = environment[i].indexOf('=');
+      if (equals < 1) continue;
+
+      setenv(environment[i].left(equals).toLocal8Bit().constData(),
+             environment[i].mid(equals + 1).toLocal8Bit().constData(), 1);
+    }
+  }
+
+
+  /**
+   * Encodes a run of a program to send to a worker.
+   *
+   * @param directory The working directory of the run
+   * @param arguments The command line of the run
+   * @param environment The environment of the run as NAME=VALUE strings
+   *
+   * @return @b QByteArray The encoded run
+   */
+  QByteArray ApplicationDaemon::EncodeRequest(const QString &directory,
+                                              const QStringList &arguments,
+                                              const QStringList &environment) {
+    QByteArray request;
+    QDataStream stream(&request, QIODevice::WriteOnly);
+    stream << (quint32) 0 << directory << arguments << environment;
+    stream.device()->seek(0);
+    stream << (quint32) (request.size() - sizeof(quint32));
+    return request;
+  }
+
+
+  /**
+   * Decodes a run of a program sent to a worker. The run is removed from the
+   * data once all of it has been received.
+   *
+   * @param data The data received so far
+   * @param directory Set to the working directory of the run
+   * @param arguments Set to the command line of the run
+   * @param environment Set to the environment of the run
+   *
+   * @return @b bool True if all of the run has been received
+   */
+  bool ApplicationDaemon::DecodeRequest(QByteArray &data, QString &directory,
+                                        QStringList &arguments,
+                                        QStringList &environment) {
+    if (data.size() < (int) sizeof(quint32)) return false;
+
+    QDataStream stream(data);
+    quint32 size;
+    stream >> size;
+    if ((quint32) data.size() < sizeof(quint32) + size) return false;
+
+    stream >> directory >> arguments >> environment;
+    data.remove(0, sizeof(quint32) + size);
+    return true;
+  }
+
+
+  /**
+   * Runs a program in a child process and sends its output and exit status to
+   * the caller. The output is sent as it is written.
+   *
+   * @param socket The connection to the caller
+   * @param directory The working directory of the run
+   * @param arguments The command line of the run
+   * @param funct The program to run
+   */
+  void ApplicationDaemon::RunRequest(int socket, const QString &directory,
+                                     const QStringList &arguments,
+                                     void (*funct)()) {
+    // A caller that went away must not kill the run
+    signal(SIGPIPE, SIG_IGN);
+
+    int out[2];
+    int err[2];
+    pid_t pid = -1;
+    if (pipe(out) == 0 && pipe(err) == 0) pid = fork();
+
+    if (pid < 0) {
+      QString msg = "Unable to start a run of the Isis daemon\n";
+      WriteMessage(socket, 'E', msg.toLatin1().constData(), msg.size());
+      WriteMessage(socket, 'X', "1", 1);
+      return;
+    }
+
+    if (pid == 0) {
+      signal(SIGPIPE, SIG_DFL);
+      close(socket);
+      close(out[0]);
+      close(err[0]);
+      dup2(out[1], 1);
+      dup2(err[1], 2);
+      close(out[1]);
+      close(err[1]);
+
+      int status = IException::Io;
+      if (QDir::setCurrent(directory)) {
+        vector<QByteArray> values;
+        vector<char *> argv;
+        for (int i = 0; i < arguments.size(); i++) {
+          values.push_back(arguments[i].toLocal8Bit());
+        }
+        for (unsigned int i = 0; i < values.size(); i++) {
+          argv.push_back(values[i].data());
+        }
+        argv.push_back(NULL);
+
+        status = iApp->RunDaemonRequest(arguments.size(), &argv[0], funct);
+      }
+      else {
+        cerr << "Unable to change to directory [" << directory << "]" << endl;
+      }
+
+      cout.flush();
+      cerr.flush();
+      fflush(stdout);
+      fflush(stderr);
+      _exit(status);
+    }
+
+    close(out[1]);
+    close(err[1]);
+
+    struct pollfd fds[2];
+    fds[0].fd = out[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = err[0];
+    fds[1].events = POLLIN;
+    int openPipes = 2;
+    bool connected = true;
+    char buffer[65536];
+
+    while (openPipes > 0) {
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR) continue;
+        break;
+      }
+
+      for (int i = 0; i < 2; i++) {
+        if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+
+        ssize_t count = read(fds[i].fd, buffer, sizeof(buffer));
+        if (count > 0) {
+          // Keep draining the pipes even if the caller went away
+          if (connected) {
+            connected = WriteMessage(socket, i == 0 ? 'O' : 'E', buffer, count);
+          }
+        }
+        else if (count == 0 || errno != EINTR) {
+          close(fds[i].fd);
+          fds[i].fd = -1;
+          openPipes--;
+        }
+      }
+    }
+
+    int waitStatus = 0;
+    while (waitpid(pid, &waitStatus, 0) < 0 && errno == EINTR);
+
+    int status = 1;
+    if (WIFEXITED(waitStatus)) {
+      status = WEXITSTATUS(waitStatus);
+    }
+    else if (WIFSIGNALED(waitStatus)) {
+      status = 128 + WTERMSIG(waitStatus);
+    }
+
+    if (connected) {
+      QByteArray exitStatus = QString::number(status).toLatin1();
+      WriteMessage(socket, 'X', exitStatus.constData(), exitStatus.size());
+    }
+  }
+
+
+  /**
+   * Sends a message to the caller of a run. Each message is a channel
+   * character, the size of the data as a four byte big endian integer, and
+   * the data.
+   *
+   * @param socket The connection to the caller
+   * @param channel 'O' for standard output, 'E' for standard error, 'X' for
+   *                the exit status or 'R' for a refused run
+   * @param data The data to send
+   * @param size The number of bytes of data
+   *
+   * @return @b bool False if the caller is no longer connected
+   */
+  bool ApplicationDaemon::WriteMessage(int socket, char channel,
+                                       const char *data, int size) {
+    unsigned char header[5];
+    header[0] = channel;
+    header[1] = (size >> 24) & 0xFF;
+    header[2] = (size >> 16) & 0xFF;
+    header[3] = (size >> 8) & 0xFF;
+    header[4] = size & 0xFF;
+
+    QByteArray message((const char *) header, 5);
+    message.append(data, size);
+
+    const char *next = message.constData();
+    int remaining = message.size();
+    while (remaining > 0) {
+      ssize_t count = write(socket, next, remaining);
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      next += count;
+      remaining -= count;
+    }
+
+    return true;
+  }
+}
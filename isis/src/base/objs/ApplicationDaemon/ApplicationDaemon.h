@@ -0,0 +1,108 @@
+#ifndef ApplicationDaemon_h
+#define ApplicationDaemon_h
+
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+namespace Isis {
+  /**
+   * @brief Runs an Isis program from a resident worker process
+   *
+   * Starting an Isis program parses its xml file, reads the preferences and
+   * loads the camera plugins before any work is done. For programs that are
+   * run many times on small inputs this startup is most of the run time.
+   *
+   * Running a program with the -DAEMON=name reserved parameter starts a
+   * resident worker that does this startup once and then waits on a local
+   * socket. When the ISISDAEMON environment variable is set to the same name,
+   * a later run of the program sends its command line, working directory and
+   * environment to the worker instead of starting up. The worker forks a
+   * child for each run, which takes on the caller's environment, so the state
+   * of a run never leaks into the next one, and sends the output and exit
+   * status of the child back to the caller. The child reads the run, so a
+   * slow caller does not hold up the worker.
+   *
+   * The socket of the worker only accepts connections from the user who
+   * started it. The worker read its preferences and plugins from its own
+   * ISISROOT, so it refuses runs from a caller with a different ISISROOT.
+   * Refused runs, runs that use reserved parameters, and runs that find no
+   * worker start up and run normally.
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version
+   *   @history 2018-09-07 Isis Development Team - Runs carry the caller's
+   *                           environment, and are read by the child of the
+   *                           run instead of the accepting loop.
+   */
+  class ApplicationDaemon {
+    public:
+      static bool RunRemote(int &argc, char *argv[], int &status);
+      static int Serve(const QString &daemonName, void (*funct)());
+
+      static QString ServerName(const QString &programName,
+                                const QString &daemonName);
+      static QByteArray EncodeRequest(const QString &directory,
+                                      const QStringList &arguments,
+                                      const QStringList &environment);
+      static bool DecodeRequest(QByteArray &data, QString &directory,
+                                QStringList &arguments,
+                                QStringList &environment);
+
+    private:
+      static void ServeCaller(int socket, void (*funct)());
+      static void SetEnvironment(const QStringList &environment);
+      static void RunRequest(int socket, const QString &directory,
+                             const QStringList &arguments, void (*funct)());
+      static bool WriteMessage(int socket, char channel, const char *data,
+                               int size);
+
+    private:
+      //! Construction is not allowed
+      ApplicationDaemon();
+      //! Destruction is not allowed
+      ~ApplicationDaemon();
+
+      /**
+       * Copy construction is not allowed
+       *
+       * @param other
+       */
+      ApplicationDaemon(ApplicationDaemon &other);
+
+      /**
+       * Assignment is not allowed
+       *
+       * @param other
+       * @returns
+       */
+      ApplicationDaemon &operator=(ApplicationDaemon &other);
+  };
+};
+
+#endif
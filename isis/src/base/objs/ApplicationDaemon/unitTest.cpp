@@ -0,0 +1,53 @@
+#include <iostream>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "ApplicationDaemon.h"
+#include "IException.h"
+#include "IString.h"
+#include "Preference.h"
+
+using namespace Isis;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  try {
+    cout << "Testing ApplicationDaemon requests ..." << endl;
+    QStringList arguments;
+    arguments << "catlab" << "from=$base/testData/isisTruth.cub" << "to=label.pvl";
+    QStringList environment;
+    environment << "ISISROOT=/isis/root" << "TMPDIR=/scratch";
+    QByteArray request = ApplicationDaemon::EncodeRequest("/work/directory", arguments,
+                                                          environment);
+
+    QString directory;
+    QStringList decoded;
+    QStringList decodedEnvironment;
+
+    QByteArray partial = request.left(request.size() - 1);
+    cout << "Partial request decoded? "
+         << ApplicationDaemon::DecodeRequest(partial, directory, decoded,
+                                             decodedEnvironment) << endl;
+    cout << "Partial request bytes left = " << (partial.size() == request.size() - 1) << endl;
+
+    QByteArray data = request + request.left(3);
+    cout << "Full request decoded? "
+         << ApplicationDaemon::DecodeRequest(data, directory, decoded,
+                                             decodedEnvironment) << endl;
+    cout << "Directory = " << directory << endl;
+    for (int i = 0; i < decoded.size(); i++) {
+      cout << "Argument " << i << " = " << decoded[i] << endl;
+    }
+    for (int i = 0; i < decodedEnvironment.size(); i++) {
+      cout << "Environment " << i << " = " << decodedEnvironment[i] << endl;
+    }
+    cout << "Bytes left = " << data.size() << endl;
+  }
+  catch (IException &e) {
+    e.print();
+  }
+}
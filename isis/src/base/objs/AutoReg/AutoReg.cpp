@@ -477,6 +477,21 @@ namespace Isis {
 
   }
 
+
+  /**
+   * Sets the cache used when the pattern and search chips are loaded from cubes. Sharing a
+   * cache lets repeated loads of the same chip, such as the reference chip of a control point
+   * that is registered against many measures, be served without reading the cube again.
+   *
+   * @param cache The cache to use, or NULL to load chips directly from their cubes. The
+   *              cache is not owned by this object and must outlive it.
+   * @see ChipCache
+   */
+  void AutoReg::SetChipCache(ChipCache *cache) {
+    p_patternChip.SetCache(cache);
+    p_searchChip.SetCache(cache);
+  }
+
   /**
    * Set the surface model window size. The pixels in this window
    * will be used to fit a surface model in order to compute
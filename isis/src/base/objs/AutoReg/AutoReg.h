@@ -34,6 +34,7 @@ class QString;
 namespace Isis {
   class AutoRegItem;
   class Buffer;
+  class ChipCache;
   class Pvl;
 
   /**
@@ -173,6 +174,8 @@ namespace Isis {
    *             give useful results due to the 2x2 matrix it uses.
    *    @history 2012-01-05 Travis Addair - Added separate variables for Whole
    *             Pixel Correlation and Subpixel Correlation.
+   *    @history 2018-09-04 Isis Development Team - Added SetChipCache() so that the
+   *             pattern and search chips can share a ChipCache.
    */
   class AutoReg {
     public:
@@ -263,6 +266,7 @@ namespace Isis {
       void SetSubsearchValidPercent(const double percent);
       void SetTolerance(double tolerance);
       void SetChipInterpolator(const QString &interpolator);
+      void SetChipCache(ChipCache *cache);
       void SetSurfaceModelWindowSize(int size);
       void SetSurfaceModelDistanceTolerance(double distance);
       void SetReductionFactor(int reductionFactor);
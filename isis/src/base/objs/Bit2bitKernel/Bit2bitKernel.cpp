@@ -0,0 +1,168 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "Bit2bitKernel.h"
+
+#include <QScopedPointer>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "Histogram.h"
+#include "IString.h"
+#include "PixelType.h"
+#include "PvlKeyword.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the BITTYPE, CLIP, MINPER, MAXPER, MINVAL and
+   * MAXVAL parameters.
+   *
+   * @param parameters The parameters of the run
+   */
+  Bit2bitKernel::Bit2bitKernel(const QMap<QString, QString> &parameters) {
+    m_bitType = StringParameter(parameters, "BITTYPE", "32BIT");
+    m_clipPercent = StringParameter(parameters, "CLIP", "PERCENT") == "PERCENT";
+    m_minimumPercent = DoubleParameter(parameters, "MINPER", 0.5);
+    m_maximumPercent = DoubleParameter(parameters, "MAXPER", 99.5);
+    m_minimum = DoubleParameter(parameters, "MINVAL", 0.0);
+    m_maximum = DoubleParameter(parameters, "MAXVAL", 255.0);
+    m_inputLrs = 0;
+    m_inputHrs = 0;
+    m_inputNull = 0;
+    m_inputInvalidPercent = 0.0;
+  }
+
+
+  //! Destroys the Bit2bitKernel
+  Bit2bitKernel::~Bit2bitKernel() {
+  }
+
+
+  /**
+   * Returns true, as the input histogram is read.
+   *
+   * @return bool True
+   */
+  bool Bit2bitKernel::PrepareReadsPixels() const {
+    return true;
+  }
+
+
+  /**
+   * Reads the histogram of the input cube, which gives the special pixel
+   * counts and, with CLIP=PERCENT, the output range.
+   *
+   * @param input The input cube
+   */
+  void Bit2bitKernel::Prepare(Cube &input) {
+    QScopedPointer<Histogram> histogram(input.histogram());
+
+    if (m_clipPercent) {
+      m_maximum = histogram->Percent(m_maximumPercent);
+      m_minimum = histogram->Percent(m_minimumPercent);
+    }
+
+    m_inputLrs = histogram->LrsPixels();
+    m_inputHrs = histogram->HrsPixels();
+    m_inputNull = histogram->NullPixels();
+    m_inputInvalidPercent = ((histogram->TotalPixels() - histogram->ValidPixels()) * 100.0) /
+                            (histogram->TotalPixels() * 1.0);
+  }
+
+
+  /**
+   * Sets the output range and pixel type.
+   *
+   * @param attributes The attributes of the output cube
+   */
+  void Bit2bitKernel::SetOutputAttributes(CubeAttributeOutput &attributes) const {
+    attributes.setMaximum(m_maximum);
+    attributes.setMinimum(m_minimum);
+
+    if (m_bitType == "8BIT") {
+      attributes.setPixelType(UnsignedByte);
+    }
+    else if (m_bitType == "16BIT") {
+      attributes.setPixelType(SignedWord);
+    }
+    else {
+      attributes.setPixelType(Real);
+    }
+  }
+
+
+  /**
+   * Returns the output range, from the parameters or from the percentages of
+   * the input histogram.
+   *
+   * @param minimum Set to the minimum of the output range
+   * @param maximum Set to the maximum of the output range
+   */
+  void Bit2bitKernel::OutputRange(double &minimum, double &maximum) const {
+    minimum = m_minimum;
+    maximum = m_maximum;
+  }
+
+
+  /**
+   * Copies the pixels of a line. Writing them to the output pixel type does
+   * the conversion.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void Bit2bitKernel::Apply(Buffer &in, Buffer &out) const {
+    for (int i = 0; i < in.size(); i++) {
+      out[i] = in[i];
+    }
+  }
+
+
+  /**
+   * Returns the special pixels of the input and the output range.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup Bit2bitKernel::Results() const {
+    PvlGroup results("bit2bit_Results");
+    results += PvlKeyword("INPUT_LRS", toString(m_inputLrs));
+    results += PvlKeyword("INPUT_HRS", toString(m_inputHrs));
+    results += PvlKeyword("INPUT_NULL", toString(m_inputNull));
+    results += PvlKeyword("INPUT_INVALID_PERCENT", toString(m_inputInvalidPercent));
+    results += PvlKeyword("OUTPUT_MIN", toString(m_minimum));
+    results += PvlKeyword("OUTPUT_MAX", toString(m_maximum));
+    return results;
+  }
+}
+
+
+/**
+ * Creates a bit2bit kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *Bit2bitKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::Bit2bitKernel(parameters);
+}
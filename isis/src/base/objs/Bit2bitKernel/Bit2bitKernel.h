@@ -0,0 +1,73 @@
+#ifndef Bit2bitKernel_h
+#define Bit2bitKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QString>
+
+#include "Constants.h"
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the bit2bit program
+   *
+   * This kernel limits the valid range of the output to a range of values or
+   * of percentages of the input histogram, and sets the output pixel type.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin. Added OutputRange() so
+   *                           bit2bit uses the exact output range.
+   */
+  class Bit2bitKernel : public PixelKernel {
+    public:
+      Bit2bitKernel(const QMap<QString, QString> &parameters);
+      ~Bit2bitKernel();
+
+      bool PrepareReadsPixels() const;
+      void Prepare(Cube &input);
+      void SetOutputAttributes(CubeAttributeOutput &attributes) const;
+      void OutputRange(double &minimum, double &maximum) const;
+      void Apply(Buffer &in, Buffer &out) const;
+      PvlGroup Results() const;
+
+    private:
+      QString m_bitType;       //!< 8BIT, 16BIT or 32BIT
+      bool m_clipPercent;      //!< True if the range is percentages
+      double m_minimumPercent; //!< The minimum as a percentage
+      double m_maximumPercent; //!< The maximum as a percentage
+      double m_minimum;        //!< The minimum of the output range
+      double m_maximum;        //!< The maximum of the output range
+      BigInt m_inputLrs;       //!< The LRS pixels of the input
+      BigInt m_inputHrs;       //!< The HRS pixels of the input
+      BigInt m_inputNull;      //!< The NULL pixels of the input
+      double m_inputInvalidPercent; //!< The percent of invalid input pixels
+  };
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Bit2bitKernel.h"
+#include "CubeAttribute.h"
+#include "PixelType.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  cout << "Testing a bit2bit kernel with a range of values ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["BITTYPE"] = "8BIT";
+  parameters["CLIP"] = "VALUE";
+  parameters["MINVAL"] = "1.5";
+  parameters["MAXVAL"] = "200.25";
+
+  Bit2bitKernel bit2bit(parameters);
+  cout << "Prepare reads pixels? " << bit2bit.PrepareReadsPixels() << endl;
+
+  double minimum = Null;
+  double maximum = Null;
+  bit2bit.OutputRange(minimum, maximum);
+  cout << "Output range = " << minimum << " to " << maximum << endl;
+
+  CubeAttributeOutput attributes;
+  bit2bit.SetOutputAttributes(attributes);
+  cout << "Output pixel type = " << PixelTypeName(attributes.pixelType()) << endl;
+  cout << "Output minimum = " << attributes.minimum() << endl;
+  cout << "Output maximum = " << attributes.maximum() << endl;
+  cout << endl;
+
+  cout << "Testing a bit2bit kernel with 16 bit output ..." << endl;
+  parameters["BITTYPE"] = "16BIT";
+  Bit2bitKernel signedWord(parameters);
+  CubeAttributeOutput signedWordAttributes;
+  signedWord.SetOutputAttributes(signedWordAttributes);
+  cout << "Output pixel type = " << PixelTypeName(signedWordAttributes.pixelType()) << endl;
+
+  return 0;
+}
@@ -0,0 +1,751 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "CalculatorProgram.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "IException.h"
+#include "IString.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+
+namespace Isis {
+  namespace {
+    /**
+     * Rounds to the closest integer the way the Calculator does for its
+     *   integer operations.
+     */
+    inline int roundToInt(double a) {
+      return (a > 0) ? (int)(a + 0.5) : (int)(a - 0.5);
+    }
+
+    //! Applies a unary functor to each value
+    template <typename Op>
+    void unaryLoop(Op op, const double *data, int size, double *results) {
+      for (int i = 0; i < size; i++) {
+        results[i] = op(data[i]);
+      }
+    }
+
+    /**
+     * Applies a binary functor pixel by pixel, or between a scalar and each
+     *   value when one operand has a single value.
+     */
+    template <typename Op>
+    void binaryLoop(Op op, const double *first, int firstSize,
+                    const double *second, int secondSize,
+                    double *results, int size) {
+      if (firstSize == secondSize) {
+        for (int i = 0; i < size; i++) {
+          results[i] = op(first[i], second[i]);
+        }
+      }
+      else if (firstSize == 1) {
+        double firstValue = first[0];
+        for (int i = 0; i < size; i++) {
+          results[i] = op(firstValue, second[i]);
+        }
+      }
+      else {
+        double secondValue = second[0];
+        for (int i = 0; i < size; i++) {
+          results[i] = op(first[i], secondValue);
+        }
+      }
+    }
+
+    // Unary operations. These match the operators used by the Calculator.
+    struct NegateOp { double operator()(double a) const { return -1 * a; } };
+    struct SqrtOp { double operator()(double a) const { return sqrt(a); } };
+    struct FabsOp { double operator()(double a) const { return fabs(a); } };
+    struct LogOp { double operator()(double a) const { return log(a); } };
+    struct Log10Op { double operator()(double a) const { return log10(a); } };
+    struct SinOp { double operator()(double a) const { return sin(a); } };
+    struct CosOp { double operator()(double a) const { return cos(a); } };
+    struct TanOp { double operator()(double a) const { return tan(a); } };
+    struct SecOp { double operator()(double a) const { return 1.0 / cos(a); } };
+    struct CscOp { double operator()(double a) const { return 1.0 / sin(a); } };
+    struct CotOp { double operator()(double a) const { return 1.0 / tan(a); } };
+    struct AsinOp { double operator()(double a) const { return asin(a); } };
+    struct AcosOp { double operator()(double a) const { return acos(a); } };
+    struct AtanOp { double operator()(double a) const { return atan(a); } };
+    struct SinhOp { double operator()(double a) const { return sinh(a); } };
+    struct CoshOp { double operator()(double a) const { return cosh(a); } };
+    struct TanhOp { double operator()(double a) const { return tanh(a); } };
+    struct AsinhOp { double operator()(double a) const { return asinh(a); } };
+    struct AcoshOp { double operator()(double a) const { return acosh(a); } };
+    struct AtanhOp { double operator()(double a) const { return atanh(a); } };
+
+    // Binary operations, with a pushed before b
+    struct AddOp {
+      double operator()(double a, double b) const { return a + b; }
+    };
+    struct SubtractOp {
+      double operator()(double a, double b) const { return a - b; }
+    };
+    struct MultiplyOp {
+      double operator()(double a, double b) const { return a * b; }
+    };
+    struct DivideOp {
+      double operator()(double a, double b) const { return a / b; }
+    };
+    struct ModulusOp {
+      double operator()(double a, double b) const {
+        return (double)(roundToInt(a) % roundToInt(b));
+      }
+    };
+    struct FmodOp {
+      double operator()(double a, double b) const { return fmod(a, b); }
+    };
+    struct PowOp {
+      double operator()(double a, double b) const { return pow(a, b); }
+    };
+    struct Atan2Op {
+      double operator()(double a, double b) const { return atan2(a, b); }
+    };
+    // The Calculator compares the top value against the one below it
+    struct MinimumOp {
+      double operator()(double a, double b) const {
+        if (std::isnan(b)) return b;
+        if (std::isnan(a)) return a;
+        return (b < a) ? b : a;
+      }
+    };
+    struct MaximumOp {
+      double operator()(double a, double b) const {
+        if (std::isnan(b)) return b;
+        if (std::isnan(a)) return a;
+        return (b > a) ? b : a;
+      }
+    };
+    struct GreaterThanOp {
+      double operator()(double a, double b) const { return a > b ? 1.0 : 0.0; }
+    };
+    struct LessThanOp {
+      double operator()(double a, double b) const { return a < b ? 1.0 : 0.0; }
+    };
+    struct EqualOp {
+      double operator()(double a, double b) const { return a == b ? 1.0 : 0.0; }
+    };
+    struct GreaterThanOrEqualOp {
+      double operator()(double a, double b) const { return a >= b ? 1.0 : 0.0; }
+    };
+    struct LessThanOrEqualOp {
+      double operator()(double a, double b) const { return a <= b ? 1.0 : 0.0; }
+    };
+    struct NotEqualOp {
+      double operator()(double a, double b) const { return a != b ? 1.0 : 0.0; }
+    };
+    struct BitwiseAndOp {
+      double operator()(double a, double b) const {
+        return (double)(roundToInt(a) & roundToInt(b));
+      }
+    };
+    struct BitwiseOrOp {
+      double operator()(double a, double b) const {
+        return (double)(roundToInt(a) | roundToInt(b));
+      }
+    };
+    struct LogicalAndOp {
+      double operator()(double a, double b) const { return b && a; }
+    };
+    struct LogicalOrOp {
+      double operator()(double a, double b) const { return b || a; }
+    };
+  }
+
+
+  //! Constructs an empty CalculatorProgram.
+  CalculatorProgram::CalculatorProgram() {
+    m_inputCount = 0;
+    m_valid = true;
+  }
+
+
+  //! Destroys the CalculatorProgram.
+  CalculatorProgram::~CalculatorProgram() {
+  }
+
+
+  /**
+   * Removes all of the instructions, constants and registers so a new
+   *   equation can be built.
+   */
+  void CalculatorProgram::clear() {
+    m_stack.clear();
+    m_instructions.clear();
+    m_constants.clear();
+    m_freeRegisters.clear();
+    m_registers.clear();
+    m_registerSizes.clear();
+    m_inputCount = 0;
+    m_valid = true;
+  }
+
+
+  /**
+   * Pushes a constant onto the program's stack.
+   *
+   * @param value The constant
+   */
+  void CalculatorProgram::pushConstant(double value) {
+    m_stack.append(constantOperand(value));
+  }
+
+
+  /**
+   * Pushes an input array onto the program's stack.
+   *
+   * @param input The position of the array in the inputs given to evaluate()
+   * @param specialPixels True if the input holds Isis special pixels that need
+   *                      to be mapped the way Calculator::Push(Buffer &) does.
+   *                      Inputs that are not mapped are read in place.
+   */
+  void CalculatorProgram::pushInput(int input, bool specialPixels) {
+    m_inputCount = max(m_inputCount, input + 1);
+
+    Operand inputOperand;
+    inputOperand.type = InputOperand;
+    inputOperand.index = input;
+
+    if (specialPixels) {
+      Instruction instruction;
+      instruction.type = MapInput;
+      instruction.operation = Negative;
+      instruction.first = inputOperand;
+      instruction.second = inputOperand;
+      instruction.result = allocateRegister();
+      m_instructions.append(instruction);
+
+      Operand result;
+      result.type = RegisterOperand;
+      result.index = instruction.result;
+      m_stack.append(result);
+    }
+    else {
+      m_stack.append(inputOperand);
+    }
+  }
+
+
+  /**
+   * Adds an operation on the values at the top of the program's stack. If
+   *   every operand is a constant, the operation is done now and its result is
+   *   pushed as a constant.
+   *
+   * @param operation The operation to add
+   *
+   * @return bool False if the stack did not have enough operands, which makes
+   *              the program invalid
+   */
+  bool CalculatorProgram::addOperation(Operation operation) {
+    int operandCount = isUnary(operation) ? 1 : 2;
+    if (!m_valid || m_stack.size() < operandCount) {
+      m_valid = false;
+      return false;
+    }
+
+    Instruction instruction;
+    instruction.operation = operation;
+    if (operandCount == 1) {
+      instruction.type = UnaryInstruction;
+      instruction.first = m_stack.takeLast();
+      instruction.second = instruction.first;
+    }
+    else {
+      instruction.type = BinaryInstruction;
+      instruction.second = m_stack.takeLast();
+      instruction.first = m_stack.takeLast();
+    }
+
+    bool constants = instruction.first.type == ConstantOperand &&
+                     instruction.second.type == ConstantOperand;
+    if (constants && isFoldable(operation)) {
+      double result = 0.0;
+      if (operandCount == 1) {
+        applyUnary(operation, &m_constants[instruction.first.index], 1, &result);
+      }
+      else {
+        applyBinary(operation, &m_constants[instruction.first.index], 1,
+                    &m_constants[instruction.second.index], 1, &result, 1);
+      }
+      m_stack.append(constantOperand(result));
+      return true;
+    }
+
+    // The result never shares a register with its operands
+    instruction.result = allocateRegister();
+    release(instruction.first);
+    if (operandCount == 2) {
+      release(instruction.second);
+    }
+    m_instructions.append(instruction);
+
+    Operand result;
+    result.type = RegisterOperand;
+    result.index = instruction.result;
+    m_stack.append(result);
+    return true;
+  }
+
+
+  /**
+   * A program is valid when every operation had its operands and exactly one
+   *   value is left on the stack.
+   *
+   * @return bool True if the program can be evaluated
+   */
+  bool CalculatorProgram::isValid() const {
+    return m_valid && m_stack.size() == 1;
+  }
+
+
+  /**
+   * The number of inputs evaluate() expects.
+   *
+   * @return int One more than the largest input pushed
+   */
+  int CalculatorProgram::inputCount() const {
+    return m_inputCount;
+  }
+
+
+  /**
+   * Runs the program over the given inputs. Special pixels in the results are
+   *   mapped back the way Calculator::Pop(true) does. Registers are kept
+   *   between calls, so evaluating arrays of the same size does not allocate.
+   *
+   * @param inputs The input arrays, by input number
+   * @param inputSizes The number of values in each input
+   * @param results [out] The results, with one value if the equation reduces
+   *                to a scalar
+   *
+   * @throws IException::Programmer "The calculator program is not valid"
+   * @throws IException::Programmer "The calculator program needs more inputs"
+   */
+  void CalculatorProgram::evaluate(const QVector<const double *> &inputs,
+                                   const QVector<int> &inputSizes,
+                                   QVector<double> &results) {
+    if (!isValid()) {
+      QString msg = "The calculator program is not valid";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    if (inputs.size() < m_inputCount || inputSizes.size() < m_inputCount) {
+      QString msg = "The calculator program needs [" + toString(m_inputCount) +
+                    "] inputs but was given [" + toString(inputs.size()) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    const double notANumber = sqrt(-1.0);
+    const double positiveInfinity = DBL_MAX * 2;
+    const double negativeInfinity = -DBL_MAX * 2;
+
+    for (int step = 0; step < m_instructions.size(); step++) {
+      const Instruction &instruction = m_instructions[step];
+
+      const double *first = NULL;
+      int firstSize = 0;
+      operand(instruction.first, inputs, inputSizes, first, firstSize);
+
+      if (instruction.type == MapInput) {
+        double *out = resultRegister(instruction.result, firstSize);
+        for (int i = 0; i < firstSize; i++) {
+          double value = first[i];
+          if (IsSpecial(value)) {
+            if (IsNullPixel(value)) {
+              value = notANumber;
+            }
+            else if (IsHrsPixel(value) || IsHisPixel(value)) {
+              value = positiveInfinity;
+            }
+            else if (IsLrsPixel(value) || IsLisPixel(value)) {
+              value = negativeInfinity;
+            }
+          }
+          out[i] = value;
+        }
+      }
+      else if (instruction.type == UnaryInstruction) {
+        if (instruction.operation == MinimumLine ||
+            instruction.operation == MaximumLine) {
+          double extreme = (firstSize > 0) ? first[0] : notANumber;
+          for (int i = 0; i < firstSize; i++) {
+            if (!IsSpecial(first[i])) {
+              extreme = (instruction.operation == MinimumLine) ?
+                        min(extreme, first[i]) : max(extreme, first[i]);
+            }
+          }
+          double *out = resultRegister(instruction.result, 1);
+          out[0] = extreme;
+        }
+        else {
+          double *out = resultRegister(instruction.result, firstSize);
+          applyUnary(instruction.operation, first, firstSize, out);
+        }
+      }
+      else {
+        const double *second = NULL;
+        int secondSize = 0;
+        operand(instruction.second, inputs, inputSizes, second, secondSize);
+
+        if (instruction.operation == LeftShift ||
+            instruction.operation == RightShift) {
+          QString direction = (instruction.operation == LeftShift) ? "left" : "right";
+          if (secondSize != 1) {
+            QString msg = "When trying to do a " + direction + " shift calculation, a "
+                          "non-scalar shift value was encountered. Shifting requires "
+                          "scalars.";
+            throw IException(IException::Unknown, msg, _FILEINFO_);
+          }
+
+          int shift = (int)second[0];
+          if (shift > firstSize) {
+            QString msg = "When trying to do a " + direction + " shift calculation, a "
+                          "shift value greater than the data size was encountered. "
+                          "Shifting by this value would erase all of the data.";
+            throw IException(IException::Unknown, msg, _FILEINFO_);
+          }
+
+          if (instruction.operation == RightShift) {
+            shift = -shift;
+          }
+
+          double *out = resultRegister(instruction.result, firstSize);
+          for (int i = 0; i < firstSize; i++) {
+            out[i] = (i + shift < firstSize && i + shift >= 0) ? first[i + shift] : notANumber;
+          }
+        }
+        else {
+          int size = binarySize(instruction.operation, firstSize, secondSize);
+          double *out = resultRegister(instruction.result, size);
+          applyBinary(instruction.operation, first, firstSize, second, secondSize,
+                      out, size);
+        }
+      }
+    }
+
+    const double *data = NULL;
+    int size = 0;
+    operand(m_stack.last(), inputs, inputSizes, data, size);
+
+    results.resize(size);
+    double *out = results.data();
+    for (int i = 0; i < size; i++) {
+      double value = data[i];
+      if (std::isnan(value)) {
+        value = Null;
+      }
+      else if (value > DBL_MAX) {
+        value = Hrs;
+      }
+      else if (value < -DBL_MAX) {
+        value = Lrs;
+      }
+      out[i] = value;
+    }
+  }
+
+
+  /**
+   * Tests if an operation takes one operand.
+   *
+   * @param operation The operation to test
+   *
+   * @return bool True for unary operations
+   */
+  bool CalculatorProgram::isUnary(Operation operation) const {
+    return operation <= MaximumLine;
+  }
+
+
+  /**
+   * Tests if an operation on constants can be done while the program is
+   *   built. Operations on whole lines and shifts are always left for
+   *   evaluate(), which also reports their errors.
+   *
+   * @param operation The operation to test
+   *
+   * @return bool True if the operation works value by value
+   */
+  bool CalculatorProgram::isFoldable(Operation operation) const {
+    return operation != MinimumLine && operation != MaximumLine &&
+           operation != LeftShift && operation != RightShift;
+  }
+
+
+  /**
+   * Stores a constant and returns an operand that refers to it.
+   *
+   * @param value The constant
+   *
+   * @return Operand The constant operand
+   */
+  CalculatorProgram::Operand CalculatorProgram::constantOperand(double value) {
+    Operand constant;
+    constant.type = ConstantOperand;
+    constant.index = m_constants.size();
+    m_constants.append(value);
+    return constant;
+  }
+
+
+  /**
+   * Gets a register that is not holding a live value, creating one if all of
+   *   the registers are in use.
+   *
+   * @return int The register
+   */
+  int CalculatorProgram::allocateRegister() {
+    if (!m_freeRegisters.isEmpty()) {
+      return m_freeRegisters.takeLast();
+    }
+
+    m_registers.append(std::vector<double>());
+    m_registerSizes.append(0);
+    return m_registers.size() - 1;
+  }
+
+
+  /**
+   * Frees the register of an operand that has been consumed.
+   *
+   * @param operand The consumed operand
+   */
+  void CalculatorProgram::release(const Operand &operand) {
+    if (operand.type == RegisterOperand) {
+      m_freeRegisters.append(operand.index);
+    }
+  }
+
+
+  /**
+   * Finds the values of an operand.
+   *
+   * @param op The operand
+   * @param inputs The input arrays
+   * @param inputSizes The number of values in each input
+   * @param data [out] The operand's values
+   * @param size [out] The number of values
+   */
+  void CalculatorProgram::operand(const Operand &op, const QVector<const double *> &inputs,
+                                  const QVector<int> &inputSizes, const double *&data,
+                                  int &size) const {
+    if (op.type == RegisterOperand) {
+      data = m_registers[op.index].data();
+      size = m_registerSizes[op.index];
+    }
+    else if (op.type == InputOperand) {
+      data = inputs[op.index];
+      size = inputSizes[op.index];
+    }
+    else {
+      data = m_constants.constData() + op.index;
+      size = 1;
+    }
+  }
+
+
+  /**
+   * Sizes a register for a result. Storage only grows, so it is reused
+   *   between evaluations.
+   *
+   * @param registerIndex The register
+   * @param size The number of values in the result
+   *
+   * @return double* The register's storage
+   */
+  double *CalculatorProgram::resultRegister(int registerIndex, int size) {
+    std::vector<double> &storage = m_registers[registerIndex];
+    if ((int)storage.size() < size) {
+      storage.resize(size);
+    }
+    m_registerSizes[registerIndex] = size;
+    return storage.data();
+  }
+
+
+  /**
+   * Applies a value by value unary operation.
+   *
+   * @param operation The operation
+   * @param data The operand's values
+   * @param size The number of values
+   * @param results [out] Storage for size results
+   */
+  void CalculatorProgram::applyUnary(Operation operation, const double *data, int size,
+                                     double *results) {
+    switch (operation) {
+      case Negative:      unaryLoop(NegateOp(), data, size, results); break;
+      case SquareRoot:    unaryLoop(SqrtOp(), data, size, results); break;
+      case AbsoluteValue: unaryLoop(FabsOp(), data, size, results); break;
+      case Log:           unaryLoop(LogOp(), data, size, results); break;
+      case Log10:         unaryLoop(Log10Op(), data, size, results); break;
+      case Sine:          unaryLoop(SinOp(), data, size, results); break;
+      case Cosine:        unaryLoop(CosOp(), data, size, results); break;
+      case Tangent:       unaryLoop(TanOp(), data, size, results); break;
+      case Secant:        unaryLoop(SecOp(), data, size, results); break;
+      case Cosecant:      unaryLoop(CscOp(), data, size, results); break;
+      case Cotangent:     unaryLoop(CotOp(), data, size, results); break;
+      case Arcsine:       unaryLoop(AsinOp(), data, size, results); break;
+      case Arccosine:     unaryLoop(AcosOp(), data, size, results); break;
+      case Arctangent:    unaryLoop(AtanOp(), data, size, results); break;
+      case SineH:         unaryLoop(SinhOp(), data, size, results); break;
+      case CosineH:       unaryLoop(CoshOp(), data, size, results); break;
+      case TangentH:      unaryLoop(TanhOp(), data, size, results); break;
+      case ArcsineH:      unaryLoop(AsinhOp(), data, size, results); break;
+      case ArccosineH:    unaryLoop(AcoshOp(), data, size, results); break;
+      case ArctangentH:   unaryLoop(AtanhOp(), data, size, results); break;
+      default: {
+        QString msg = "Operation [" + toString((int)operation) + "] is not a "
+                      "value by value unary operation";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+    }
+  }
+
+
+  /**
+   * Applies a value by value binary operation.
+   *
+   * @param operation The operation
+   * @param first The left operand's values
+   * @param firstSize The number of left values
+   * @param second The right operand's values
+   * @param secondSize The number of right values
+   * @param results [out] Storage for the results
+   * @param size The number of results, from binarySize()
+   */
+  void CalculatorProgram::applyBinary(Operation operation, const double *first,
+                                      int firstSize, const double *second, int secondSize,
+                                      double *results, int size) {
+    switch (operation) {
+      case Add:
+        binaryLoop(AddOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Subtract:
+        binaryLoop(SubtractOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Multiply:
+        binaryLoop(MultiplyOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Divide:
+        binaryLoop(DivideOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Modulus:
+        binaryLoop(ModulusOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case FloatModulus:
+        binaryLoop(FmodOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Exponent:
+        binaryLoop(PowOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Arctangent2:
+        binaryLoop(Atan2Op(), first, firstSize, second, secondSize, results, size);
+        break;
+      case MinimumPixel:
+        binaryLoop(MinimumOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case MaximumPixel:
+        binaryLoop(MaximumOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case GreaterThan:
+        binaryLoop(GreaterThanOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case LessThan:
+        binaryLoop(LessThanOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Equal:
+        binaryLoop(EqualOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case GreaterThanOrEqual:
+        binaryLoop(GreaterThanOrEqualOp(), first, firstSize, second, secondSize,
+                   results, size);
+        break;
+      case LessThanOrEqual:
+        binaryLoop(LessThanOrEqualOp(), first, firstSize, second, secondSize,
+                   results, size);
+        break;
+      case NotEqual:
+        binaryLoop(NotEqualOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case And:
+        binaryLoop(BitwiseAndOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case Or:
+        binaryLoop(BitwiseOrOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case LogicalAnd:
+        binaryLoop(LogicalAndOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      case LogicalOr:
+        binaryLoop(LogicalOrOp(), first, firstSize, second, secondSize, results, size);
+        break;
+      default: {
+        QString msg = "Operation [" + toString((int)operation) + "] is not a "
+                      "value by value binary operation";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+    }
+  }
+
+
+  /**
+   * The number of results of a binary operation. Arrays must be the same
+   *   size unless one of them is a scalar. The logical operations require
+   *   the same size in every case, like InlineCalculator's.
+   *
+   * @param operation The operation
+   * @param firstSize The number of left values
+   * @param secondSize The number of right values
+   *
+   * @return int The number of results
+   *
+   * @throws IException::Unknown "Failed performing logical operation"
+   * @throws IException::Programmer "The stack based calculator cannot operate on
+   *                                 vectors of differing sizes."
+   */
+  int CalculatorProgram::binarySize(Operation operation, int firstSize, int secondSize) {
+    if (operation == LogicalAnd || operation == LogicalOr) {
+      if (firstSize != secondSize) {
+        QString name = (operation == LogicalAnd) ? "and" : "or";
+        QString msg = "Failed performing logical " + name + " operation, "
+                      "input vectors are of differnet lengths.";
+        throw IException(IException::Unknown, msg, _FILEINFO_);
+      }
+      return firstSize;
+    }
+
+    if (firstSize != 1 && secondSize != 1 && firstSize != secondSize) {
+      QString msg = "The stack based calculator cannot operate on vectors "
+                    "of differing sizes.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    return max(firstSize, secondSize);
+  }
+}
@@ -0,0 +1,201 @@
+#ifndef CalculatorProgram_h
+#define CalculatorProgram_h
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <vector>
+
+#include <QVector>
+
+namespace Isis {
+  /**
+   * @brief A postfix equation compiled for evaluation over arrays
+   *
+   * This class compiles a postfix equation once into a list of instructions
+   * that evaluate it over whole arrays, such as the lines of a cube. The
+   * equation is built the same way it would be run on a Calculator: push
+   * constants and inputs, then add operations. Instead of a stack of vectors,
+   * each intermediate result is given a register that is reused once the
+   * result has been consumed, so evaluating the program does not allocate
+   * after the first call. Operations on constants are folded when the program
+   * is built, and each operation runs as one tight loop over its operands.
+   *
+   * Inputs are given to evaluate() as arrays in the order of their input
+   * numbers. Inputs pushed with special pixel mapping are treated like a
+   * Buffer pushed on a Calculator: Null becomes NaN and the high and low
+   * saturation values become plus and minus infinity. The results are mapped
+   * back the way Calculator::Pop(true) does, so special pixels propagate
+   * exactly as they do in the Calculator.
+   *
+   * If an operation is added without enough operands on the stack, the
+   * program is no longer valid. Callers should check isValid() and fall back
+   * to the Calculator, which reports the error when it runs.
+   *
+   * @code
+   *   CalculatorProgram program;
+   *   program.pushInput(0, true);
+   *   program.pushConstant(2.0);
+   *   program.addOperation(CalculatorProgram::Multiply);
+   *   program.evaluate(inputs, inputSizes, results);
+   * @endcode
+   *
+   * @ingroup Math
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version.
+   */
+  class CalculatorProgram {
+    public:
+      /**
+       * The operations of a program. Each matches the Calculator method of
+       *   the same name, and binary operations take the value pushed first
+       *   as their left operand.
+       */
+      enum Operation {
+        Negative,           //!< Negates the top value
+        SquareRoot,         //!< Square root of the top value
+        AbsoluteValue,      //!< Absolute value of the top value
+        Log,                //!< Natural log of the top value
+        Log10,              //!< Base 10 log of the top value
+        Sine,               //!< Sine of the top value
+        Cosine,             //!< Cosine of the top value
+        Tangent,            //!< Tangent of the top value
+        Secant,             //!< Secant of the top value
+        Cosecant,           //!< Cosecant of the top value
+        Cotangent,          //!< Cotangent of the top value
+        Arcsine,            //!< Arcsine of the top value
+        Arccosine,          //!< Arccosine of the top value
+        Arctangent,         //!< Arctangent of the top value
+        SineH,              //!< Hyperbolic sine of the top value
+        CosineH,            //!< Hyperbolic cosine of the top value
+        TangentH,           //!< Hyperbolic tangent of the top value
+        ArcsineH,           //!< Inverse hyperbolic sine of the top value
+        ArccosineH,         //!< Inverse hyperbolic cosine of the top value
+        ArctangentH,        //!< Inverse hyperbolic tangent of the top value
+        MinimumLine,        //!< Minimum valid value of the top array
+        MaximumLine,        //!< Maximum valid value of the top array
+        Add,                //!< Sum of the top two values
+        Subtract,           //!< Difference of the top two values
+        Multiply,           //!< Product of the top two values
+        Divide,             //!< Quotient of the top two values
+        Modulus,            //!< Integer modulus of the top two values
+        FloatModulus,       //!< Floating point modulus of the top two values
+        Exponent,           //!< The second value raised to the top value
+        Arctangent2,        //!< Two argument arctangent of the top two values
+        MinimumPixel,       //!< Pixel by pixel minimum of the top two values
+        MaximumPixel,       //!< Pixel by pixel maximum of the top two values
+        GreaterThan,        //!< 1 where the second value is greater, else 0
+        LessThan,           //!< 1 where the second value is less, else 0
+        Equal,              //!< 1 where the values are equal, else 0
+        GreaterThanOrEqual, //!< 1 where the second value is greater or equal
+        LessThanOrEqual,    //!< 1 where the second value is less or equal
+        NotEqual,           //!< 1 where the values differ, else 0
+        And,                //!< Bitwise and of the rounded values
+        Or,                 //!< Bitwise or of the rounded values
+        LogicalAnd,         //!< Logical and of arrays of the same size
+        LogicalOr,          //!< Logical or of arrays of the same size
+        LeftShift,          //!< Shifts the second array left by the top scalar
+        RightShift          //!< Shifts the second array right by the top scalar
+      };
+
+      CalculatorProgram();
+      ~CalculatorProgram();
+
+      void clear();
+
+      void pushConstant(double value);
+      void pushInput(int input, bool specialPixels);
+      bool addOperation(Operation operation);
+
+      bool isValid() const;
+      int inputCount() const;
+
+      void evaluate(const QVector<const double *> &inputs,
+                    const QVector<int> &inputSizes,
+                    QVector<double> &results);
+
+    private:
+      //! Where an operand's values are
+      enum OperandType {
+        RegisterOperand,  //!< A register holding an earlier result
+        InputOperand,     //!< An input array passed to evaluate()
+        ConstantOperand   //!< A single constant value
+      };
+
+      //! A value on the stack while the program is built
+      struct Operand {
+        OperandType type; //!< Where the values are
+        int index;        //!< The register, input or constant number
+      };
+
+      //! How an instruction uses its operands
+      enum InstructionType {
+        MapInput,         //!< Copy an input, mapping its special pixels
+        UnaryInstruction, //!< Apply an operation to one operand
+        BinaryInstruction //!< Apply an operation to two operands
+      };
+
+      //! One step of the program
+      struct Instruction {
+        InstructionType type; //!< How the operands are used
+        Operation operation;  //!< The operation for unary and binary steps
+        Operand first;        //!< The only operand, or the left operand
+        Operand second;       //!< The right operand of binary steps
+        int result;           //!< The register the result goes in
+      };
+
+      CalculatorProgram(const CalculatorProgram &other);
+      CalculatorProgram &operator=(const CalculatorProgram &other);
+
+      bool isUnary(Operation operation) const;
+      bool isFoldable(Operation operation) const;
+      Operand constantOperand(double value);
+      int allocateRegister();
+      void release(const Operand &operand);
+
+      void operand(const Operand &op, const QVector<const double *> &inputs,
+                   const QVector<int> &inputSizes, const double *&data,
+                   int &size) const;
+      double *resultRegister(int registerIndex, int size);
+
+      static void applyUnary(Operation operation, const double *data, int size,
+                             double *results);
+      static void applyBinary(Operation operation, const double *first,
+                              int firstSize, const double *second, int secondSize,
+                              double *results, int size);
+      static int binarySize(Operation operation, int firstSize, int secondSize);
+
+      QVector<Operand> m_stack;               //!< The stack while building
+      QVector<Instruction> m_instructions;    //!< The compiled steps
+      QVector<double> m_constants;            //!< Values of constant operands
+      QVector<int> m_freeRegisters;           //!< Registers with consumed values
+      QVector< std::vector<double> > m_registers; //!< Register storage
+      QVector<int> m_registerSizes;           //!< Number of values in each register
+      int m_inputCount;                       //!< One more than the largest input
+      bool m_valid;                           //!< False after a stack underflow
+  };
+}
+
+#endif
@@ -0,0 +1,232 @@
+#include <iostream>
+
+#include <QVector>
+
+#include "Buffer.h"
+#include "Calculator.h"
+#include "CalculatorProgram.h"
+#include "IException.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+using namespace Isis;
+
+void print(const QVector<double> &values);
+void compare(const QVector<double> &program, const QVector<double> &calculator);
+
+int main() {
+  Preference::Preferences(true);
+
+  Buffer f1(6, 1, 1, Real);
+  f1[0] = 1.0;
+  f1[1] = 4.0;
+  f1[2] = Null;
+  f1[3] = His;
+  f1[4] = Lrs;
+  f1[5] = 9.0;
+
+  QVector<double> samples;
+  for (int i = 1; i <= 6; i++) {
+    samples.push_back(i);
+  }
+
+  QVector<const double *> inputs;
+  inputs.push_back(f1.DoubleBuffer());
+  inputs.push_back(samples.constData());
+  QVector<int> inputSizes;
+  inputSizes.push_back(f1.size());
+  inputSizes.push_back(samples.size());
+
+  QVector<double> results;
+
+  cout << "Testing f1 2 3 * * sample +" << endl;
+  {
+    CalculatorProgram program;
+    program.pushInput(0, true);
+    program.pushConstant(2.0);
+    program.pushConstant(3.0);
+    program.addOperation(CalculatorProgram::Multiply);
+    program.addOperation(CalculatorProgram::Multiply);
+    program.pushInput(1, false);
+    program.addOperation(CalculatorProgram::Add);
+    cout << "Valid:        " << program.isValid() << endl;
+    cout << "Input count:  " << program.inputCount() << endl;
+    program.evaluate(inputs, inputSizes, results);
+
+    Calculator calculator;
+    calculator.Push(f1);
+    calculator.Push(2.0);
+    calculator.Push(3.0);
+    calculator.Multiply();
+    calculator.Multiply();
+    calculator.Push(samples);
+    calculator.Add();
+    print(results);
+    compare(results, calculator.Pop(true));
+  }
+  cout << endl;
+
+  cout << "Testing f1 5 > f1 min" << endl;
+  {
+    CalculatorProgram program;
+    program.pushInput(0, true);
+    program.pushConstant(5.0);
+    program.addOperation(CalculatorProgram::GreaterThan);
+    program.pushInput(0, true);
+    program.addOperation(CalculatorProgram::MinimumPixel);
+    program.evaluate(inputs, inputSizes, results);
+
+    Calculator calculator;
+    calculator.Push(f1);
+    calculator.Push(5.0);
+    calculator.GreaterThan();
+    calculator.Push(f1);
+    calculator.MinimumPixel();
+    print(results);
+    compare(results, calculator.Pop(true));
+  }
+  cout << endl;
+
+  cout << "Testing f1 linemax and f1 linemin" << endl;
+  {
+    CalculatorProgram program;
+    program.pushInput(0, true);
+    program.addOperation(CalculatorProgram::MaximumLine);
+    program.evaluate(inputs, inputSizes, results);
+
+    Calculator calculator;
+    calculator.Push(f1);
+    calculator.MaximumLine();
+    print(results);
+    compare(results, calculator.Pop(true));
+
+    program.clear();
+    program.pushInput(0, true);
+    program.addOperation(CalculatorProgram::MinimumLine);
+    program.evaluate(inputs, inputSizes, results);
+
+    calculator.Push(f1);
+    calculator.MinimumLine();
+    print(results);
+    compare(results, calculator.Pop(true));
+  }
+  cout << endl;
+
+  cout << "Testing f1 2 <<" << endl;
+  {
+    CalculatorProgram program;
+    program.pushInput(0, true);
+    program.pushConstant(2.0);
+    program.addOperation(CalculatorProgram::LeftShift);
+    program.evaluate(inputs, inputSizes, results);
+
+    Calculator calculator;
+    calculator.Push(f1);
+    calculator.Push(2.0);
+    calculator.LeftShift();
+    print(results);
+    compare(results, calculator.Pop(true));
+  }
+  cout << endl;
+
+  cout << "Testing constants 2 3 ^ sqrt" << endl;
+  {
+    CalculatorProgram program;
+    program.pushConstant(2.0);
+    program.pushConstant(3.0);
+    program.addOperation(CalculatorProgram::Exponent);
+    program.addOperation(CalculatorProgram::SquareRoot);
+    program.evaluate(inputs, inputSizes, results);
+    print(results);
+  }
+  cout << endl;
+
+  cout << "Testing incomplete programs" << endl;
+  {
+    CalculatorProgram program;
+    program.pushConstant(1.0);
+    cout << "Operation added: " << program.addOperation(CalculatorProgram::Add) << endl;
+    cout << "Valid:           " << program.isValid() << endl;
+
+    program.clear();
+    program.pushConstant(1.0);
+    program.pushConstant(2.0);
+    cout << "Valid:           " << program.isValid() << endl;
+
+    try {
+      program.evaluate(inputs, inputSizes, results);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+  }
+  cout << endl;
+
+  cout << "Testing evaluation errors" << endl;
+  {
+    CalculatorProgram program;
+    program.pushInput(0, true);
+    program.pushInput(1, false);
+    program.addOperation(CalculatorProgram::Add);
+    try {
+      program.evaluate(inputs.mid(0, 1), inputSizes.mid(0, 1), results);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+
+    QVector<int> shortSizes(inputSizes);
+    shortSizes[1] = 3;
+    try {
+      program.evaluate(inputs, shortSizes, results);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+
+    program.clear();
+    program.pushInput(0, true);
+    program.pushInput(0, true);
+    program.addOperation(CalculatorProgram::LeftShift);
+    try {
+      program.evaluate(inputs, inputSizes, results);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+  }
+
+  return 0;
+}
+
+
+/**
+ * Prints values with special pixels by name.
+ */
+void print(const QVector<double> &values) {
+  cout << "Results:      ";
+  for (int i = 0; i < values.size(); i++) {
+    if (IsNullPixel(values[i])) {
+      cout << "Null ";
+    }
+    else if (IsHrsPixel(values[i])) {
+      cout << "Hrs ";
+    }
+    else if (IsLrsPixel(values[i])) {
+      cout << "Lrs ";
+    }
+    else {
+      cout << values[i] << " ";
+    }
+  }
+  cout << endl;
+}
+
+
+/**
+ * Prints whether the program's results match the calculator's exactly.
+ */
+void compare(const QVector<double> &program, const QVector<double> &calculator) {
+  cout << "Matches calculator: " << (program == calculator) << endl;
+}
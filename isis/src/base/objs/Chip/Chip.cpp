@@ -27,6 +27,7 @@
 
 
 #include "Camera.h"
+#include "ChipCache.h"
 #include "Cube.h"
 #include "IException.h"
 #include "Interpolator.h"
@@ -92,6 +93,7 @@ namespace Isis {
     m_affine = other.m_affine;
     m_readInterpolator = other.m_readInterpolator;
     m_filename = other.m_filename;
+    m_cache = other.m_cache;
   }
 
 
@@ -140,6 +142,7 @@ namespace Isis {
     SetSize(samples, lines);
     SetValidRange();
     m_clipPolygon = NULL;
+    m_cache = NULL;
   }
 
 
@@ -232,11 +235,18 @@ namespace Isis {
     m_affine.Rotate(rotation);
     m_affine.Translate(m_cubeTackSample, m_cubeTackLine);
 
+    // Use a previously loaded chip if the cache has one
+    QString key = CacheKey(cube, band);
+    if (RestoreFromCache(key)) {
+      return;
+    }
+
     // Now go read the data from the cube into the chip
     Read(cube, band);
 
     // Store off the cube address in case someone wants to match this chip
     m_filename = cube.fileName();
+    SaveToCache(key);
   }
 
 
@@ -275,11 +285,18 @@ namespace Isis {
       m_clipPolygon = 0;
     }
 
+    // Use a previously loaded chip if the cache has one
+    QString key = CacheKey(cube, band);
+    if (RestoreFromCache(key)) {
+      return;
+    }
+
     // Now go read the data from the cube into the chip
     Read(cube, band);
 
     // Store off the cube address in case someone wants to match this chip
     m_filename = cube.fileName();
+    SaveToCache(key);
   }
 
 
@@ -321,6 +338,13 @@ namespace Isis {
    */
   void Chip::Load(Cube &cube, Chip &match, Cube &matchChipCube, const double scale, const int band)
   {
+    // The affine solution below is the expensive part of a match load, so the cache is keyed
+    // on its inputs rather than on the resulting transform
+    QString key = CacheKey(cube, match, matchChipCube, scale, band);
+    if (RestoreFromCache(key)) {
+      return;
+    }
+
     // See if the match cube has a camera or projection
     Camera *matchCam = NULL;
     TProjection *matchProj = NULL;
@@ -540,6 +564,7 @@ namespace Isis {
     // Store off the cube address in case someone wants to match
     // this chip
     m_filename = cube.fileName();
+    SaveToCache(key);
   }
 
 
@@ -957,6 +982,8 @@ namespace Isis {
    * @see GetReadInterpolator()
    * @internal
    *   @history 2010-06-15 Jeannie Walldren - Modified to allow any interpolator type except "None"
+   *   @history 2018-09-04 Isis Development Team - Reads through the chip cache's tiles when
+   *                           a cache has been set.
    */
   void Chip::Read(Cube &cube, const int band) {
     // Create an interpolator and portal for geoming
@@ -976,7 +1003,12 @@ namespace Isis {
         }
         else if (m_clipPolygon == NULL) {
           port.SetPosition(CubeSample(), CubeLine(), band);
-          cube.read(port);
+          if (m_cache) {
+            m_cache->read(cube, port);
+          }
+          else {
+            cube.read(port);
+          }
           m_buf[line-1][samp-1] =
             interp.Interpolate(CubeSample(), CubeLine(), port.DoubleBuffer());
         }
@@ -985,7 +1017,12 @@ namespace Isis {
                                      geos::geom::Coordinate(CubeSample(), CubeLine()));
           if (pnt->within(m_clipPolygon)) {
             port.SetPosition(CubeSample(), CubeLine(), band);
-            cube.read(port);
+            if (m_cache) {
+              m_cache->read(cube, port);
+            }
+            else {
+              cube.read(port);
+            }
             m_buf[line-1][samp-1] =
               interp.Interpolate(CubeSample(), CubeLine(), port.DoubleBuffer());
           }
@@ -999,6 +1036,114 @@ namespace Isis {
   }
 
 
+  /**
+   * Builds the key used to find this chip in its cache when it is loaded with its current
+   * chip-to-cube transform. Chips with a clipping polygon are not cached.
+   *
+   * @param cube The cube the chip is loaded from
+   * @param band The band the chip is loaded from
+   *
+   * @return @b QString The cache key, or an empty string if the chip should not be cached
+   */
+  QString Chip::CacheKey(Cube &cube, const int band) const {
+    if (m_cache == NULL || m_clipPolygon != NULL) {
+      return "";
+    }
+
+    QString key = "affine|" + cube.fileName() + "|" + toString(band) + "|" +
+                  toString(Samples()) + "|" + toString(Lines()) + "|" +
+                  toString((int) m_readInterpolator);
+
+    Affine::AMatrix forward = m_affine.Forward();
+    for (int row = 0; row < 2; row++) {
+      for (int col = 0; col < 3; col++) {
+        key += "|" + QString::number(forward[row][col], 'g', 17);
+      }
+    }
+
+    return key;
+  }
+
+
+  /**
+   * Builds the key used to find this chip in its cache when it is loaded to match the
+   * geometry of another chip. Chips with a clipping polygon are not cached.
+   *
+   * @param cube          The cube the chip is loaded from
+   * @param match         The chip whose geometry is matched
+   * @param matchChipCube The cube the match chip was loaded from
+   * @param scale         The scale factor applied to the match transform
+   * @param band          The band the chip is loaded from
+   *
+   * @return @b QString The cache key, or an empty string if the chip should not be cached
+   */
+  QString Chip::CacheKey(Cube &cube, const Chip &match, Cube &matchChipCube,
+                         const double scale, const int band) const {
+    if (m_cache == NULL || m_clipPolygon != NULL) {
+      return "";
+    }
+
+    QString key = "match|" + cube.fileName() + "|" + toString(band) + "|" +
+                  toString(Samples()) + "|" + toString(Lines()) + "|" +
+                  toString((int) m_readInterpolator) + "|" +
+                  QString::number(m_cubeTackSample, 'g', 17) + "|" +
+                  QString::number(m_cubeTackLine, 'g', 17) + "|" +
+                  QString::number(scale, 'g', 17) + "|" +
+                  matchChipCube.fileName() + "|" +
+                  toString(match.Samples()) + "|" + toString(match.Lines());
+
+    Affine::AMatrix forward = match.m_affine.Forward();
+    for (int row = 0; row < 2; row++) {
+      for (int col = 0; col < 3; col++) {
+        key += "|" + QString::number(forward[row][col], 'g', 17);
+      }
+    }
+
+    return key;
+  }
+
+
+  /**
+   * Replaces the loaded data and transform of this chip with a cached chip.
+   *
+   * @param key The cache key built by CacheKey()
+   *
+   * @return @b bool True if the chip was found in the cache
+   */
+  bool Chip::RestoreFromCache(const QString &key) {
+    if (key.isEmpty()) {
+      return false;
+    }
+
+    Chip cached;
+    if (!m_cache->findChip(key, cached)) {
+      return false;
+    }
+
+    m_buf = cached.m_buf;
+    m_affine = cached.m_affine;
+    m_chipSample = cached.m_chipSample;
+    m_chipLine = cached.m_chipLine;
+    m_cubeSample = cached.m_cubeSample;
+    m_cubeLine = cached.m_cubeLine;
+    m_filename = cached.m_filename;
+
+    return true;
+  }
+
+
+  /**
+   * Stores this freshly loaded chip in its cache.
+   *
+   * @param key The cache key built by CacheKey()
+   */
+  void Chip::SaveToCache(const QString &key) {
+    if (!key.isEmpty()) {
+      m_cache->addChip(key, *this);
+    }
+  }
+
+
   /**
    * Writes the contents of the Chip to a cube.
    *
@@ -1072,6 +1217,7 @@ namespace Isis {
     m_affine = other.m_affine;
     m_readInterpolator = other.m_readInterpolator;
     m_filename = other.m_filename;
+    m_cache = other.m_cache;
 
     return *this;
   }
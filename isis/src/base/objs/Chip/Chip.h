@@ -35,6 +35,7 @@
 #include <geos/geom/MultiPolygon.h>
 
 namespace Isis {
+  class ChipCache;
   class Cube;
   class Statistics;
 
@@ -98,6 +99,10 @@ namespace Isis {
    *   @history 2015-07-06 David Miller - Modified code to better reflect current Coding Standards.
    *                           Updated truth data. Fixes #2273
    *   @history 2017-08-30 Summer Stapleton - Updated documentation. References #4807.
+   *   @history 2018-09-04 Isis Development Team - Added SetCache() and Cache(). When a
+   *                           ChipCache is assigned, the Load methods return previously loaded
+   *                           chips from the cache and Read() gets its cube data from the
+   *                           cache's tiles instead of reading the cube for every pixel.
    */
   class Chip {
     public:
@@ -211,6 +216,26 @@ namespace Isis {
       void Load(Cube &cube, const Affine &affine, const bool &keepPoly = true,
                 const int band = 1);
 
+      /**
+       * @brief Sets the cache used when loading this chip.
+       *
+       * The cache is not owned by the chip and must outlive it. Pass NULL to stop using a
+       * cache.
+       *
+       * @param cache The cache to use, or NULL
+       * @see ChipCache
+       */
+      void SetCache(ChipCache *cache) {
+        m_cache = cache;
+      }
+
+      /**
+       * @returns The cache used when loading this chip, or NULL if there is none
+       */
+      ChipCache *Cache() const {
+        return m_cache;
+      }
+
       void SetChipPosition(const double sample, const double line);
 
       /**
@@ -352,6 +377,11 @@ namespace Isis {
     private:
       void Init(const int samples, const int lines);
       void Read(Cube &cube, const int band);
+      QString CacheKey(Cube &cube, const int band) const;
+      QString CacheKey(Cube &cube, const Chip &match, Cube &matchChipCube,
+                       const double scale, const int band) const;
+      bool RestoreFromCache(const QString &key);
+      void SaveToCache(const QString &key);
       std::vector<int> MovePoints(int startSamp, int startLine,
                              int endSamp, int endLine);
       bool PointsColinear(double x0, double y0,
@@ -387,6 +417,8 @@ namespace Isis {
                                                    // cubes into chip.
 
       QString m_filename;                          //!< FileName of loaded cube
+
+      ChipCache *m_cache;                          //!< Cache set by SetCache. Not owned.
   };
 };
 
@@ -0,0 +1,274 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "ChipCache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "Brick.h"
+#include "Chip.h"
+#include "Cube.h"
+#include "IException.h"
+#include "IString.h"
+#include "Portal.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+
+  /**
+   * Constructs an empty chip cache.
+   *
+   * @param maxChips    Maximum number of loaded chips to keep
+   * @param maxTiles    Maximum number of cube tiles to keep
+   * @param tileSamples Number of samples in each cached cube tile
+   * @param tileLines   Number of lines in each cached cube tile
+   *
+   * @throws IException::Programmer "Chip cache sizes must be greater than zero"
+   */
+  ChipCache::ChipCache(int maxChips, int maxTiles, int tileSamples, int tileLines) {
+    if (maxChips < 1 || maxTiles < 1 || tileSamples < 1 || tileLines < 1) {
+      QString msg = "Chip cache sizes must be greater than zero. Unable to create a cache of ["
+                    + toString(maxChips) + "] chips and [" + toString(maxTiles)
+                    + "] tiles of [" + toString(tileSamples) + ", " + toString(tileLines) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    m_mutex = new QMutex;
+    m_chips.setMaxCost(maxChips);
+    m_tiles.setMaxCost(maxTiles);
+    m_tileSamples = tileSamples;
+    m_tileLines = tileLines;
+
+    m_chipHits = 0;
+    m_chipMisses = 0;
+    m_tileHits = 0;
+    m_tileMisses = 0;
+  }
+
+
+  /**
+   * Destroys the cache and all of the chips and tiles it holds.
+   */
+  ChipCache::~ChipCache() {
+    clear();
+
+    delete m_mutex;
+    m_mutex = NULL;
+  }
+
+
+  /**
+   * Looks up a previously loaded chip.
+   *
+   * @param key  The load key built by the chip
+   * @param chip Set to a copy of the cached chip if one was found
+   *
+   * @return @b bool True if the chip was in the cache
+   */
+  bool ChipCache::findChip(const QString &key, Chip &chip) {
+    QMutexLocker locker(m_mutex);
+
+    Chip *cached = m_chips.object(key);
+    if (!cached) {
+      m_chipMisses++;
+      return false;
+    }
+
+    m_chipHits++;
+    chip = *cached;
+    return true;
+  }
+
+
+  /**
+   * Stores a copy of a loaded chip. The least recently used chip is discarded when the
+   * cache is full.
+   *
+   * @param key  The load key built by the chip
+   * @param chip The loaded chip
+   */
+  void ChipCache::addChip(const QString &key, const Chip &chip) {
+    QMutexLocker locker(m_mutex);
+    m_chips.insert(key, new Chip(chip));
+  }
+
+
+  /**
+   * Fills a portal from the tile cache, reading tiles from the cube as needed. This
+   * produces the same values as Cube::read(portal) for a single band portal.
+   *
+   * @param cube   The cube to read from
+   * @param portal The portal to fill; must already be positioned
+   */
+  void ChipCache::read(Cube &cube, Portal &portal) {
+    QMutexLocker locker(m_mutex);
+
+    int samples = cube.sampleCount();
+    int lines = cube.lineCount();
+
+    const QVector<double> *currentTile = NULL;
+    int currentTileSample = -1;
+    int currentTileLine = -1;
+    int currentBand = -1;
+
+    for (int i = 0; i < portal.size(); i++) {
+      int sample = portal.Sample(i);
+      int line = portal.Line(i);
+      int band = portal.Band(i);
+
+      if (sample < 1 || line < 1 || sample > samples || line > lines) {
+        portal[i] = Null;
+        continue;
+      }
+
+      int tileSample = (sample - 1) / m_tileSamples;
+      int tileLine = (line - 1) / m_tileLines;
+
+      if (!currentTile || tileSample != currentTileSample ||
+          tileLine != currentTileLine || band != currentBand) {
+        currentTile = tile(cube, tileSample, tileLine, band);
+        currentTileSample = tileSample;
+        currentTileLine = tileLine;
+        currentBand = band;
+      }
+
+      int tileIndex = ((line - 1) % m_tileLines) * m_tileSamples + (sample - 1) % m_tileSamples;
+      portal[i] = (*currentTile)[tileIndex];
+    }
+  }
+
+
+  /**
+   * Discards all cached chips and tiles. The hit and miss counters are not reset.
+   */
+  void ChipCache::clear() {
+    QMutexLocker locker(m_mutex);
+    m_chips.clear();
+    m_tiles.clear();
+  }
+
+
+  /**
+   * @return @b int The maximum number of chips kept in the cache
+   */
+  int ChipCache::maxChips() const {
+    return m_chips.maxCost();
+  }
+
+
+  /**
+   * @return @b int The maximum number of cube tiles kept in the cache
+   */
+  int ChipCache::maxTiles() const {
+    return m_tiles.maxCost();
+  }
+
+
+  /**
+   * @return @b int The number of samples in a cached cube tile
+   */
+  int ChipCache::tileSamples() const {
+    return m_tileSamples;
+  }
+
+
+  /**
+   * @return @b int The number of lines in a cached cube tile
+   */
+  int ChipCache::tileLines() const {
+    return m_tileLines;
+  }
+
+
+  /**
+   * @return @b BigInt The number of chip lookups that were found in the cache
+   */
+  BigInt ChipCache::chipHits() const {
+    QMutexLocker locker(m_mutex);
+    return m_chipHits;
+  }
+
+
+  /**
+   * @return @b BigInt The number of chip lookups that were not found in the cache
+   */
+  BigInt ChipCache::chipMisses() const {
+    QMutexLocker locker(m_mutex);
+    return m_chipMisses;
+  }
+
+
+  /**
+   * @return @b BigInt The number of tile lookups that were found in the cache
+   */
+  BigInt ChipCache::tileHits() const {
+    QMutexLocker locker(m_mutex);
+    return m_tileHits;
+  }
+
+
+  /**
+   * @return @b BigInt The number of tiles that had to be read from a cube
+   */
+  BigInt ChipCache::tileMisses() const {
+    QMutexLocker locker(m_mutex);
+    return m_tileMisses;
+  }
+
+
+  /**
+   * Finds a cube tile in the cache, reading it from the cube if it is not there. The
+   * caller must hold the mutex.
+   *
+   * @param cube       The cube the tile belongs to
+   * @param tileSample Zero-based tile index in the sample direction
+   * @param tileLine   Zero-based tile index in the line direction
+   * @param band       The band of the tile
+   *
+   * @return @b const @b QVector<double>* The tile data, owned by the cache
+   */
+  const QVector<double> *ChipCache::tile(Cube &cube, int tileSample, int tileLine, int band) {
+    QString key = cube.fileName() + "|" + toString(band) + "|" +
+                  toString(tileSample) + "|" + toString(tileLine);
+
+    QVector<double> *data = m_tiles.object(key);
+    if (data) {
+      m_tileHits++;
+      return data;
+    }
+
+    m_tileMisses++;
+
+    Brick brick(m_tileSamples, m_tileLines, 1, cube.pixelType());
+    brick.SetBasePosition(tileSample * m_tileSamples + 1, tileLine * m_tileLines + 1, band);
+    cube.read(brick);
+
+    data = new QVector<double>(brick.size());
+    for (int i = 0; i < brick.size(); i++) {
+      (*data)[i] = brick[i];
+    }
+
+    m_tiles.insert(key, data);
+    return data;
+  }
+}
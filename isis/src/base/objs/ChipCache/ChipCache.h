@@ -0,0 +1,119 @@
+#ifndef ChipCache_h
+#define ChipCache_h
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QCache>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "Constants.h"
+
+class QMutex;
+
+namespace Isis {
+  class Chip;
+  class Cube;
+  class Portal;
+
+  /**
+   * @brief Bounded, thread-safe cache of loaded chips and cube tiles
+   *
+   * Registration applications load the same chips over and over. pointreg loads the
+   * reference chip of a control point once per measure being registered and qnet
+   * reloads both chips every time the user navigates between points. This class keeps
+   * two least-recently-used caches that a Chip consults when one has been assigned to it
+   * with Chip::SetCache():
+   *
+   * <ul>
+   *   <li>A chip cache, keyed by the cube, band, chip size, interpolator and the
+   *       chip-to-cube transform (or match geometry), holding the interpolated chip
+   *       data produced by Chip::Load.</li>
+   *   <li>A tile cache, keyed by cube, band and tile position, holding decoded
+   *       pixel data that feeds the interpolation portal used by Chip::Load. Consecutive
+   *       points in the same region of an image share these tiles instead of reading the
+   *       cube again for every chip pixel.</li>
+   * </ul>
+   *
+   * Cubes are identified by their expanded file name. If the contents of a cube change
+   * while a cache is in use, clear() must be called.
+   *
+   * @code
+   *   ChipCache cache;
+   *   Chip chip(25, 25);
+   *   chip.SetCache(&cache);
+   *   chip.TackCube(100.0, 100.0);
+   *   chip.Load(cube);   // reads the cube
+   *   chip.Load(cube);   // returns the cached chip
+   * @endcode
+   *
+   * @ingroup PatternMatching
+   *
+   * @author 2018-09-04 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-04 Isis Development Team - Original version.
+   */
+  class ChipCache {
+    public:
+      ChipCache(int maxChips = 256, int maxTiles = 128,
+                int tileSamples = 128, int tileLines = 128);
+      ~ChipCache();
+
+      bool findChip(const QString &key, Chip &chip);
+      void addChip(const QString &key, const Chip &chip);
+
+      void read(Cube &cube, Portal &portal);
+
+      void clear();
+
+      int maxChips() const;
+      int maxTiles() const;
+      int tileSamples() const;
+      int tileLines() const;
+
+      BigInt chipHits() const;
+      BigInt chipMisses() const;
+      BigInt tileHits() const;
+      BigInt tileMisses() const;
+
+    private:
+      Q_DISABLE_COPY(ChipCache)
+
+      const QVector<double> *tile(Cube &cube, int tileSample, int tileLine, int band);
+
+      QMutex *m_mutex;                             //!< Guards the caches and counters
+      QCache<QString, Chip> m_chips;               //!< Loaded chips keyed by load parameters
+      QCache<QString, QVector<double> > m_tiles;   //!< Decoded cube tiles
+      int m_tileSamples;                           //!< Number of samples in a tile
+      int m_tileLines;                             //!< Number of lines in a tile
+
+      BigInt m_chipHits;                           //!< Number of chips found in the cache
+      BigInt m_chipMisses;                         //!< Number of chips not found in the cache
+      BigInt m_tileHits;                           //!< Number of tiles found in the cache
+      BigInt m_tileMisses;                         //!< Number of tiles read from a cube
+  };
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <iostream>
+
+#include <QFile>
+
+#include "Affine.h"
+#include "Chip.h"
+#include "ChipCache.h"
+#include "Cube.h"
+#include "IException.h"
+#include "Preference.h"
+
+using namespace std;
+using namespace Isis;
+
+int differences(Chip &a, Chip &b);
+void printCounts(ChipCache &cache);
+
+int main() {
+  Preference::Preferences(true);
+
+  cout << "Creating test cube" << endl;
+  Chip source(51, 50);
+  for (int i = 1; i <= source.Lines(); i++) {
+    for (int j = 1; j <= source.Samples(); j++) {
+      source.SetValue(j, i, (double)(i * 100 + j));
+    }
+  }
+  source.Write("junk.cub");
+
+  Cube junk;
+  junk.open("junk.cub");
+
+  ChipCache cache(16, 4, 64, 64);
+  cout << "Maximum chips: " << cache.maxChips() << endl;
+  cout << "Maximum tiles: " << cache.maxTiles() << endl;
+  cout << "Tile size: " << cache.tileSamples() << " x " << cache.tileLines() << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Load rotated chip through the cache" << endl;
+  Chip direct(25, 25);
+  direct.TackCube(26.0, 25.0);
+  direct.Load(junk, 45.0);
+
+  Chip cached(25, 25);
+  cached.SetCache(&cache);
+  cout << "Chip has cache: " << (cached.Cache() == &cache) << endl;
+  cached.TackCube(26.0, 25.0);
+  cached.Load(junk, 45.0);
+  cout << "Differences from direct load: " << differences(direct, cached) << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Load the same chip again" << endl;
+  cached.SetAllValues(0.0);
+  cached.Load(junk, 45.0);
+  cout << "Differences from direct load: " << differences(direct, cached) << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Load a different chip from the same tile" << endl;
+  direct.TackCube(20.0, 20.0);
+  direct.Load(junk);
+  cached.TackCube(20.0, 20.0);
+  cached.Load(junk);
+  cout << "Differences from direct load: " << differences(direct, cached) << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Load the same chip with an affine transform" << endl;
+  Chip affineChip(25, 25);
+  affineChip.SetCache(&cache);
+  affineChip.Load(junk, cached.GetTransform());
+  cout << "Differences from direct load: " << differences(direct, affineChip) << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Clear the cache and load again" << endl;
+  cache.clear();
+  cached.Load(junk);
+  cout << "Differences from direct load: " << differences(direct, cached) << endl;
+  printCounts(cache);
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  try {
+    ChipCache badCache(0);
+  }
+  catch (IException &e) {
+    cout << e.toString() << endl;
+  }
+
+  junk.close();
+  QFile::remove("junk.cub");
+
+  return 0;
+}
+
+
+/**
+ * Counts the pixels that differ between two chips of the same size.
+ */
+int differences(Chip &a, Chip &b) {
+  int count = 0;
+  for (int line = 1; line <= a.Lines(); line++) {
+    for (int samp = 1; samp <= a.Samples(); samp++) {
+      if (a.GetValue(samp, line) != b.GetValue(samp, line)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+
+void printCounts(ChipCache &cache) {
+  cout << "Chip hits: " << cache.chipHits() << endl;
+  cout << "Chip misses: " << cache.chipMisses() << endl;
+  cout << "Tile misses: " << cache.tileMisses() << endl;
+}
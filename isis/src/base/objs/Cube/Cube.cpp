@@ -36,12 +36,14 @@
 #include "CameraFactory.h"
 #include "CubeAttribute.h"
 #include "CubeBsqHandler.h"
+#include "CubeCompressedTileHandler.h"
+#include "CubeStatisticsCache.h"
+#include "CubeStatisticsDriver.h"
 #include "CubeTileHandler.h"
 #include "Endian.h"
 #include "FileName.h"
 #include "Histogram.h"
 #include "IException.h"
-#include "LineManager.h"
 #include "Message.h"
 #include "Preference.h"
 #include "ProgramLauncher.h"
@@ -96,7 +98,7 @@ namespace Isis {
    * @returns True if a cube has been opened and I/O operations are allowed
    */
   bool Cube::isOpen() const {
-    bool open = (m_ioHandler != NULL);
+    bool open = (m_labelFile != NULL);
 
     ASSERT(open == (bool)m_labelFile);
     ASSERT(open == (bool)m_labelFileName);
@@ -152,6 +154,18 @@ namespace Isis {
   }
 
 
+  /**
+   * Test if the cube is sparse, that is chunks of the cube that are all NULL
+   *   are not stored in the file. If no cube is opened, this is whether a
+   *   created cube will be sparse.
+   *
+   * @returns True if the cube is sparse
+   */
+  bool Cube::isSparse() const {
+    return m_sparse;
+  }
+
+
   /**
    * Test if labels are attached. If a cube is open, then this indicates
    *   whether or not the opened cube's labels are attached. If a cube is not
@@ -202,6 +216,7 @@ namespace Isis {
       result->setDimensions(sampleCount(), lineCount(), bandCount());
       result->setByteOrder(newFileAttributes.byteOrder());
       result->setFormat(newFileAttributes.fileFormat());
+      result->setSparse(newFileAttributes.sparse());
 
       if (newFileAttributes.labelAttachment() == DetachedLabel) {
         result->setLabelsAttached(false);
@@ -238,7 +253,7 @@ namespace Isis {
     else {
       if (isReadWrite()) {
         writeLabels();
-        m_ioHandler->clearCache(true);
+        if (m_ioHandler) m_ioHandler->clearCache(true);
       }
 
       result->setExternalDnData(fileName());
@@ -420,6 +435,10 @@ namespace Isis {
       ptype += PvlKeyword("Base", toString(m_base));
       ptype += PvlKeyword("Multiplier", toString(m_multiplier));
       core.addGroup(ptype);
+
+      if (m_sparse) {
+        core += PvlKeyword("Sparse", "True");
+      }
     }
     else {
       cubFile = cubFile.addExtension("ecub");
@@ -477,13 +496,21 @@ namespace Isis {
 
     bool dataAlreadyOnDisk = m_storesDnData ? false : true;
 
-    if (m_format == Bsq) {
-      m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
-                                       dataAlreadyOnDisk);
-    }
-    else {
-      m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
-                                        dataAlreadyOnDisk);
+    m_ioHandler = createIoHandler(dataAlreadyOnDisk);
+
+    // The ChunkPresence keyword of an attached sparse cube grows with its
+    //   chunk count, so room for it is added to the label space that was
+    //   asked for. The pixels start after the larger label area, so the IO
+    //   handler is made again.
+    if (m_storesDnData && m_attached && m_ioHandler->isSparse()) {
+      m_labelBytes += m_ioHandler->chunkPresenceLabelBytes();
+      m_label->findObject("IsisCube").findObject("Core")["StartByte"] =
+          toString(m_labelBytes + 1);
+      m_label->findObject("Label")["Bytes"] = toString(m_labelBytes);
+
+      delete m_ioHandler;
+      m_ioHandler = NULL;
+      m_ioHandler = createIoHandler(dataAlreadyOnDisk);
     }
 
     if (m_storesDnData)
@@ -520,6 +547,7 @@ namespace Isis {
 
     setByteOrder(att.byteOrder());
     setFormat(att.fileFormat());
+    setSparse(att.sparse());
     setLabelsAttached(att.labelAttachment() == AttachedLabel);
     if (!att.propagatePixelType())
       setPixelType(att.pixelType());
@@ -531,12 +559,26 @@ namespace Isis {
 
 
   /**
-   * This method will open an isis cube for reading or reading/writing.
+   * This method will open an isis cube for reading or reading/writing. The
+   * IO handler that reads and writes the pixels is created the first time the
+   * pixels are used, so programs that only look at the labels never build it.
+   *
+   * Opening with "label" access only reads the labels. The data file of a
+   * cube with detached labels is not opened, and reading or writing pixels
+   * throws an exception. getsn opens its cube this way. The labels are read
+   * with Pvl, so only the label and at most one 64k read block after its End
+   * keyword are read from the file.
+   *
+   * Programs that read pixels, such as campt, which reports the DN under each
+   * point, still open the cube with "r" access; they only gain from the IO
+   * handler being created when it is first used. getkey and catlab read any
+   * PVL file, not just cubes, so they read the label with Pvl directly and do
+   * not open a Cube at all.
    *
    * @param[in] cubeFileName Name of the cube file to open. Environment
    *     variables in the filename will be automatically expanded.
    * @param[in] access (Default value of "r") Defines how the cube will be
-   *     accessed. Either read-only "r" or read-write "rw".
+   *     accessed. Either read-only "r", read-write "rw" or label only "label".
    */
   void Cube::open(const QString &cubeFileName, QString access) {
     // Already opened?
@@ -546,7 +588,14 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    if (access != "r" && access != "rw" && access != "label") {
+      QString msg = "Unknown value for access [" + access + "]. Expected 'r', "
+                    "'rw' or 'label'";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
     initLabelFromFile(cubeFileName, (access == "rw"));
+    m_labelOnly = (access == "label");
 
     // Figure out the name of the data file
     try {
@@ -564,7 +613,9 @@ namespace Isis {
         m_attached = false;
         m_storesDnData = true;
 
-        m_dataFile = new QFile(realDataFileName().expanded());
+        if (!m_labelOnly) {
+          m_dataFile = new QFile(realDataFileName().expanded());
+        }
       }
       else if (core.hasKeyword("^DnFile")) {
         FileName dataFileName(core["^DnFile"][0]);
@@ -579,7 +630,9 @@ namespace Isis {
         m_attached = true;
         m_storesDnData = false;
 
-        m_dataFile = new QFile(realDataFileName().expanded());
+        if (!m_labelOnly) {
+          m_dataFile = new QFile(realDataFileName().expanded());
+        }
       }
       else {
         m_dataFileName = new FileName(*m_labelFileName);
@@ -592,7 +645,7 @@ namespace Isis {
       throw;
     }
 
-    if (access == "r") {
+    if (access == "r" || access == "label") {
       if (!m_labelFile->open(QIODevice::ReadOnly)) {
         QString msg = "Failed to open [" + m_labelFile->fileName() + "] with "
             "read only access";
@@ -633,12 +686,6 @@ namespace Isis {
         }
       }
     }
-    else {
-      QString msg = "Unknown value for access [" + access + "]. Expected 'r' "
-                    " or 'rw'";
-      cleanUp(false);
-      throw IException(IException::Programmer, msg, _FILEINFO_);
-    }
 
     initCoreFromLabel(*m_label);
 
@@ -650,26 +697,6 @@ namespace Isis {
       m_labelBytes = labelSize(true);
     }
 
-    QPair<bool, Pvl *> dataLabel = qMakePair(false, m_label);
-    if (!m_storesDnData) {
-      dataLabel = qMakePair(true, new Pvl(m_dataFileName->expanded()));
-    }
-
-    // Now examine the format to see which type of handler to create
-    if (m_format == Bsq) {
-      m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList,
-          realDataFileLabel(), true);
-    }
-    else {
-      m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList,
-          realDataFileLabel(), true);
-    }
-
-    if (dataLabel.first) {
-      delete dataLabel.second;
-      dataLabel.second = NULL;
-    }
-
     applyVirtualBandsToLabel();
   }
 
@@ -726,7 +753,7 @@ namespace Isis {
       cubeFile = *m_tempCube;
 
     QMutexLocker locker(m_mutex);
-    QMutexLocker locker2(m_ioHandler->dataFileMutex());
+    QMutexLocker locker2(m_ioHandler ? m_ioHandler->dataFileMutex() : NULL);
     blob.Read(cubeFile.toString(), *label());
   }
 
@@ -744,7 +771,25 @@ namespace Isis {
     }
 
     QMutexLocker locker(m_mutex);
-    m_ioHandler->read(bufferToFill);
+    ioHandler()->read(bufferToFill);
+  }
+
+
+  /**
+   * Hint that the area of a buffer will be read soon. The area is read into
+   *   the process wide CubeCacheManager in the background, so reading it later
+   *   does not wait for the disk. Nothing is read into the buffer.
+   *
+   * @param bufferToRead A buffer positioned on the area that will be read
+   */
+  void Cube::prefetch(const Buffer &bufferToRead) const {
+    if (!isOpen()) {
+      string msg = "Try opening a file before you prefetch from it";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(m_mutex);
+    ioHandler()->prefetch(bufferToRead);
   }
 
 
@@ -768,7 +813,7 @@ namespace Isis {
     // Write an attached blob
     if (m_attached) {
       QMutexLocker locker(m_mutex);
-      QMutexLocker locker2(m_ioHandler->dataFileMutex());
+      QMutexLocker locker2(ioHandler()->dataFileMutex());
 
       // Compute the number of bytes in the cube + label bytes and if the
       // endpos of the file // is not greater than this then seek to that position.
@@ -843,7 +888,13 @@ namespace Isis {
     }
 
     QMutexLocker locker(m_mutex);
-    m_ioHandler->write(bufferToWrite);
+
+    // Cached statistics no longer describe the pixels
+    if (m_label->hasObject("BandStatistics")) {
+      m_label->deleteObject("BandStatistics");
+    }
+
+    ioHandler()->write(bufferToWrite);
   }
 
 
@@ -978,6 +1029,21 @@ namespace Isis {
   }
 
 
+  /**
+   * Used prior to the create method, this sets whether the cube will be
+   *   sparse. Sparse cubes keep a map of which chunks are stored in their
+   *   labels, and chunks that are all NULL are never written. This makes
+   *   creating large cubes that are mostly NULL, such as mosaics, much faster
+   *   and smaller on file systems with sparse files.
+   *
+   * @param sparse True to create a sparse cube
+   */
+  void Cube::setSparse(bool sparse) {
+    openCheck();
+    m_sparse = sparse;
+  }
+
+
   /**
    * Use prior to calling create, this sets whether or not to use separate
    *   label and data files.
@@ -1279,18 +1345,24 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
-    int bandStart = band;
-    int bandStop = band;
+    if (validMin == ValidMinimum && validMax == ValidMaximum) {
+      int cacheBand = statisticsCacheBand(band);
+      if (cacheBand != 0) {
+        CubeStatisticsCache cache;
+        read(cache);
+        if (cache.hasBand(cacheBand)) {
+          return cache.histogram(cacheBand);
+        }
+      }
+    }
+
     int maxSteps = lineCount();
     if (band == 0) {
-      bandStart = 1;
-      bandStop = bandCount();
       maxSteps = lineCount() * bandCount();
     }
 
     Progress progress;
     Histogram *hist = new Histogram(*this, band, &progress);
-    LineManager line(*this);
 
     // This range is for throwing out data; the default parameters are OK always
     //hist->SetValidRange(validMin, validMax);
@@ -1315,14 +1387,8 @@ namespace Isis {
     progress.SetMaximumSteps(maxSteps);
     progress.CheckStatus();
 
-    for(int useBand = bandStart ; useBand <= bandStop ; useBand++) {
-      for(int i = 1; i <= lineCount(); i++) {
-        line.SetLine(i, useBand);
-        read(line);
-        hist->AddData(line.DoubleBuffer(), line.size());
-        progress.CheckStatus();
-      }
-    }
+    CubeStatisticsDriver driver(*this, &progress);
+    driver.addData(band, *hist);
 
     return hist;
   }
@@ -1448,6 +1514,56 @@ namespace Isis {
   }
 
 
+  /**
+   * Returns the number of samples in each chunk the cube is stored in on
+   * disk. Buffers whose samples start and end on chunk boundaries read and
+   * write whole chunks.
+   *
+   * @returns The number of samples in a chunk
+   */
+  int Cube::sampleCountInChunk() const {
+    if (!isOpen()) {
+      string msg = "The cube is not opened so it has no chunks";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(m_mutex);
+    return ioHandler()->getSampleCountInChunk();
+  }
+
+
+  /**
+   * Returns the number of lines in each chunk the cube is stored in on disk.
+   *
+   * @returns The number of lines in a chunk
+   */
+  int Cube::lineCountInChunk() const {
+    if (!isOpen()) {
+      string msg = "The cube is not opened so it has no chunks";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(m_mutex);
+    return ioHandler()->getLineCountInChunk();
+  }
+
+
+  /**
+   * Returns the number of bands in each chunk the cube is stored in on disk.
+   *
+   * @returns The number of bands in a chunk
+   */
+  int Cube::bandCountInChunk() const {
+    if (!isOpen()) {
+      string msg = "The cube is not opened so it has no chunks";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(m_mutex);
+    return ioHandler()->getBandCountInChunk();
+  }
+
+
   /**
    * This method returns a pointer to a Statistics object
    * which allows the program to obtain and use various statistics
@@ -1501,18 +1617,23 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
-    // Construct a line buffer manager and a statistics object
-    LineManager line(*this);
+    if (validMin == ValidMinimum && validMax == ValidMaximum) {
+      int cacheBand = statisticsCacheBand(band);
+      if (cacheBand != 0) {
+        CubeStatisticsCache cache;
+        read(cache);
+        if (cache.hasBand(cacheBand)) {
+          return cache.statistics(cacheBand);
+        }
+      }
+    }
+
     Statistics *stats = new Statistics();
 
     stats->SetValidRange(validMin, validMax);
 
-    int bandStart = band;
-    int bandStop = band;
     int maxSteps = lineCount();
     if (band == 0) {
-      bandStart = 1;
-      bandStop = bandCount();
       maxSteps = lineCount() * bandCount();
     }
 
@@ -1521,15 +1642,8 @@ namespace Isis {
     progress.SetMaximumSteps(maxSteps);
     progress.CheckStatus();
 
-    // Loop and get the statistics for a good minimum/maximum
-    for(int useBand = bandStart ; useBand <= bandStop ; useBand++) {
-      for(int i = 1; i <= lineCount(); i++) {
-        line.SetLine(i, useBand);
-        read(line);
-        stats->AddData(line.DoubleBuffer(), line.size());
-        progress.CheckStatus();
-      }
-    }
+    CubeStatisticsDriver driver(*this, &progress);
+    driver.addData(band, *stats);
 
     return stats;
   }
@@ -1560,10 +1674,14 @@ namespace Isis {
    */
   void Cube::addCachingAlgorithm(CubeCachingAlgorithm *algorithm) {
 
-    if (isOpen() && m_ioHandler) {
-      m_ioHandler->addCachingAlgorithm(algorithm);
+    if (isOpen() && !m_labelOnly) {
+      QMutexLocker locker(m_mutex);
+      ioHandler()->addCachingAlgorithm(algorithm);
     }
-    else if (!isOpen()) {
+    else if (isOpen()) {
+      delete algorithm;
+    }
+    else {
       QString msg = "Cannot add a caching algorithm until the cube is open";
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
@@ -1647,6 +1765,18 @@ namespace Isis {
   }
 
 
+  /**
+   * Return if the cube has cached band statistics in its labels. The cache is
+   *   written with a CubeStatisticsCache and removed as soon as any pixels are
+   *   written.
+   *
+   * @return bool True if the cube has a statistics cache
+   */
+  bool Cube::hasStatisticsCache() const {
+    return isOpen() && label()->hasObject("BandStatistics");
+  }
+
+
   /**
    * Check to see if the cube contains a pvl table by the provided name
    *
@@ -1884,10 +2014,12 @@ namespace Isis {
     if (IsBigEndian())
       m_byteOrder = Msb;
     m_format = Tile;
+    m_sparse = false;
     m_pixelType = Real;
 
     m_attached = true;
     m_storesDnData = true;
+    m_labelOnly = false;
     m_labelBytes = 65536;
 
     m_samples = 0;
@@ -1925,9 +2057,15 @@ namespace Isis {
       if ((QString) core["Format"] == "BandSequential") {
         m_format = Bsq;
       }
+      else if ((QString) core["Format"] == "CompressedTile") {
+        m_format = CompressedTile;
+      }
       else {
         m_format = Tile;
       }
+
+      m_sparse = core.hasKeyword("Sparse") &&
+                 core["Sparse"][0].toUpper() == "TRUE";
     }
     else {
       FileName temp(core["^DnFile"][0]);
@@ -2063,6 +2201,52 @@ namespace Isis {
   }
 
 
+  /**
+   * Returns the handler that reads and writes the pixels of the cube, creating
+   * it the first time it is needed. The caller must hold m_mutex.
+   *
+   * @throws IException::Programmer - The cube was opened to read its labels
+   *                                  only
+   *
+   * @return CubeIoHandler* The IO handler
+   */
+  CubeIoHandler *Cube::ioHandler() const {
+    if (!m_ioHandler) {
+      if (m_labelOnly) {
+        QString msg = "The pixels of the cube [" + QFileInfo(fileName()).fileName() +
+            "] can not be used because it was opened with label only access";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+
+      m_ioHandler = createIoHandler(true);
+    }
+
+    return m_ioHandler;
+  }
+
+
+  /**
+   * Creates the IO handler for the format of the cube.
+   *
+   * @param dataAlreadyOnDisk True if the cube's pixels are already on disk
+   *
+   * @return CubeIoHandler* The new IO handler, owned by the caller
+   */
+  CubeIoHandler *Cube::createIoHandler(bool dataAlreadyOnDisk) const {
+    if (m_format == Bsq) {
+      return new CubeBsqHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
+                                dataAlreadyOnDisk);
+    }
+    else if (m_format == CompressedTile) {
+      return new CubeCompressedTileHandler(dataFile(), m_virtualBandList,
+                                           realDataFileLabel(), dataAlreadyOnDisk);
+    }
+
+    return new CubeTileHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
+                               dataAlreadyOnDisk);
+  }
+
+
   /**
    * Function to read data from a cube label and return it as a PVL object
    *
@@ -2119,6 +2303,28 @@ namespace Isis {
   }
 
 
+  /**
+   * Returns the physical band to look up in the statistics cache for the
+   *   given band, or 0 if the cache can't answer for it. Band 0 (all bands)
+   *   can only be answered for single band cubes.
+   *
+   * @param band The band passed to statistics() or histogram()
+   *
+   * @return int The physical band in the cache, or 0
+   */
+  int Cube::statisticsCacheBand(const int &band) const {
+    if (!hasStatisticsCache()) {
+      return 0;
+    }
+
+    if (band == 0) {
+      return (bandCount() == 1) ? physicalBand(1) : 0;
+    }
+
+    return physicalBand(band);
+  }
+
+
   /**
    * Write the Pvl labels to the cube's label file. Excess data in the attached
    *   labels is set to 0.
@@ -2132,10 +2338,18 @@ namespace Isis {
     // Set the pvl's format template
     m_label->setFormatTemplate(m_formatTemplateFile->original());
 
+    // Sparse cubes store which chunks are in the file in their labels, so
+    //   every cached chunk has to be written first.
+    if (m_storesDnData && m_ioHandler && m_ioHandler->isSparse()) {
+      QMutexLocker locker(m_mutex);
+      m_ioHandler->clearCache();
+      m_ioHandler->updateChunkPresence(*m_label);
+    }
+
     // Write them with attached data
     if (m_attached) {
       QMutexLocker locker(m_mutex);
-      QMutexLocker locker2(m_ioHandler->dataFileMutex());
+      QMutexLocker locker2(m_ioHandler ? m_ioHandler->dataFileMutex() : NULL);
 
       ostringstream temp;
       temp << *m_label << endl;
@@ -157,6 +157,30 @@ namespace Isis {
    *   @history 2017-06-08 Chris Combs - Made "Failed to create" error messages more descriptive.
    *                           Fixes #833.
    *   @history 2017-09-22 Cole Neubauer - Fixed documentation. References #4807
+   *   @history 2018-09-07 Isis Development Team - histogram() and statistics() now read the
+   *                           cube with CubeStatisticsDriver, in parallel when the
+   *                           ParallelStatistics preference is On.
+   *   @history 2018-09-07 Isis Development Team - histogram() and statistics() return the
+   *                           results stored in a CubeStatisticsCache blob when there is one
+   *                           and the default valid range is requested. Writing pixels removes
+   *                           the cache from the labels. Added hasStatisticsCache().
+   *   @history 2018-09-07 Isis Development Team - Added sampleCountInChunk(),
+   *                           lineCountInChunk() and bandCountInChunk() so processing
+   *                           classes can align their buffers with the cube's chunks.
+   *   @history 2018-09-07 Isis Development Team - Added the CompressedTile format, which
+   *                           stores each tile compressed with CubeCompressedTileHandler.
+   *   @history 2018-09-07 Isis Development Team - Added setSparse() and isSparse(). Sparse
+   *                           cubes do not store chunks that are all NULL, so creating a
+   *                           large, mostly empty cube such as a mosaic does not write NULLs
+   *                           across the whole file.
+   *   @history 2018-09-07 Isis Development Team - Added prefetch() to hint that an area will
+   *                           be read soon.
+   *   @history 2018-09-07 Isis Development Team - open() creates the IO handler the first
+   *                           time the pixels are used, and accepts "label" access, which
+   *                           only reads the labels and does not open a detached data file.
+   *   @history 2018-09-07 Isis Development Team - create() adds room for the ChunkPresence
+   *                           keyword to the label space of attached sparse cubes, so a cube
+   *                           with many chunks does not run out of label space.
    */
   class Cube {
     public:
@@ -222,13 +246,21 @@ namespace Isis {
          * The symbol '*' denotes tile boundaries.
          * The symbols '-' and '|' denote cube boundaries.
          */
-        Tile
+        Tile,
+        /**
+         * Cubes are stored in the same tiles as the Tile format, but each tile
+         *   is compressed losslessly before it is written. This is intended
+         *   for output cubes with large areas of repetitive or special pixel
+         *   data. See CubeCompressedTileHandler.
+         */
+        CompressedTile
       };
 
       bool isOpen() const;
       bool isProjected() const;
       bool isReadOnly() const;
       bool isReadWrite() const;
+      bool isSparse() const;
       bool labelsAttached() const;
 
       void close(bool remove = false);
@@ -240,6 +272,7 @@ namespace Isis {
 
       void read(Blob &blob) const;
       void read(Buffer &rbuf) const;
+      void prefetch(const Buffer &rbuf) const;
       void write(Blob &blob);
       void write(Buffer &wbuf);
 
@@ -252,6 +285,7 @@ namespace Isis {
       void setLabelsAttached(bool attached);
       void setLabelSize(int labelBytes);
       void setPixelType(PixelType pixelType);
+      void setSparse(bool sparse);
       void setVirtualBands(const QList<QString> &vbands);
       void setVirtualBands(const std::vector<QString> &vbands);
 
@@ -278,6 +312,9 @@ namespace Isis {
       int physicalBand(const int &virtualBand) const;
       Projection *projection();
       int sampleCount() const;
+      int sampleCountInChunk() const;
+      int lineCountInChunk() const;
+      int bandCountInChunk() const;
       Statistics *statistics(const int &band = 1,
                              QString msg = "Gathering statistics");
       Statistics *statistics(const int &band, const double &validMin,
@@ -291,6 +328,7 @@ namespace Isis {
       void deleteGroup(const QString &group);
       PvlGroup &group(const QString &group) const;
       bool hasGroup(const QString &group) const;
+      bool hasStatisticsCache() const;
       bool hasTable(const QString &name);
       void putGroup(const PvlGroup &group);
 
@@ -300,6 +338,8 @@ namespace Isis {
 
       void construct();
       QFile *dataFile() const;
+      CubeIoHandler *ioHandler() const;
+      CubeIoHandler *createIoHandler(bool dataAlreadyOnDisk) const;
       FileName realDataFileName() const;
 
       void initialize();
@@ -308,6 +348,7 @@ namespace Isis {
       void openCheck();
       Pvl realDataFileLabel() const;
       void reformatOldIsisLabel(const QString &oldCube);
+      int statisticsCacheBand(const int &band) const;
       void writeLabels();
 
     private:
@@ -328,10 +369,10 @@ namespace Isis {
       QFile *m_dataFile;
 
       /**
-       * This does the heavy lifting for cube DN IO and is always allocated
-       *   when isOpen() is true.
+       * This does the heavy lifting for cube DN IO. It is created by
+       *   ioHandler() the first time the pixels of an opened cube are used.
        */
-      CubeIoHandler *m_ioHandler;
+      mutable CubeIoHandler *m_ioHandler;
 
       /**
        * The byte order of the opened cube; if there is no open cube then
@@ -347,6 +388,12 @@ namespace Isis {
        */
       Format m_format;
 
+      /**
+       * If true, chunks that are all NULL are not stored in the cube file. This
+       *   is read from the labels of opened cubes and defaults to false.
+       */
+      bool m_sparse;
+
       /**
        * This is the pixel type on disk. If a cube is open, then this will be
        *   the opened cube's pixel type. Otherwise, if a cube is created with
@@ -389,6 +436,9 @@ namespace Isis {
        */
       bool m_storesDnData;
 
+      //! True if the cube was opened with label only access
+      bool m_labelOnly;
+
       //! The label if IsOpen(), otherwise NULL
       Pvl *m_label;
 
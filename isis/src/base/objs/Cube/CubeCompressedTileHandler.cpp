@@ -0,0 +1,454 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include "CubeCompressedTileHandler.h"
+
+#include <QFile>
+#include <QList>
+#include <QtConcurrentMap>
+#include <QtEndian>
+
+#include "IException.h"
+#include "IString.h"
+#include "PixelType.h"
+#include "Pvl.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+#include "RawCubeChunk.h"
+
+using namespace std;
+
+namespace Isis {
+
+  /**
+   * The zlib compression level of the tiles. The fastest levels compress
+   * cube data nearly as well as the slowest.
+   */
+  static const int TileCompressionLevel = 1;
+
+
+  /**
+   * Construct a compressed tile handler. The tile size is chosen the same way
+   *   as for CubeTileHandler. The tile index of a cube that is already on disk
+   *   is read.
+   *
+   * @param dataFile The file with cube DN data in it
+   * @param virtualBandList The mapping from virtual band to physical band, see
+   *          CubeIoHandler's description.
+   * @param labels The Pvl labels for the cube
+   * @param alreadyOnDisk True if the cube is allocated on the disk, false
+   *          otherwise
+   */
+  CubeCompressedTileHandler::CubeCompressedTileHandler(QFile * dataFile,
+      const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk)
+      : CubeTileHandler(dataFile, virtualBandList, labels, alreadyOnDisk, false) {
+
+    // This sizes a new file for the tile index, or checks an existing one
+    setTileSizes(labels);
+
+    m_tileIndex.resize(getChunkCount());
+    for (int i = 0; i < m_tileIndex.size(); i++) {
+      m_tileIndex[i].startByte = 0;
+      m_tileIndex[i].bytes = 0;
+    }
+
+    if (alreadyOnDisk) {
+      readTileIndex();
+    }
+  }
+
+
+  /**
+   * Writes all data from memory to disk.
+   */
+  CubeCompressedTileHandler::~CubeCompressedTileHandler() {
+    clearCache();
+  }
+
+
+  /**
+   * The tiles are packed after the index and grow the file as they are
+   *   written, so only the index has a fixed size.
+   *
+   * @return The number of bytes the tile index takes up in the file
+   */
+  BigInt CubeCompressedTileHandler::getDataSize() const {
+    return (BigInt)getChunkCountInSampleDimension() *
+           (BigInt)getChunkCountInLineDimension() *
+           (BigInt)getChunkCountInBandDimension() *
+           IndexEntryBytes;
+  }
+
+
+  /**
+   * Update the cube labels so that this cube indicates its tile size and
+   *   compression.
+   *
+   * @param labels The "Core" object in this Pvl will be updated
+   */
+  void CubeCompressedTileHandler::updateLabels(Pvl &labels) {
+    CubeTileHandler::updateLabels(labels);
+
+    PvlObject &core = labels.findObject("IsisCube").findObject("Core");
+    core.addKeyword(PvlKeyword("Format", "CompressedTile"),
+                    PvlContainer::Replace);
+    core.addKeyword(PvlKeyword("TileCompression", "Deflate"),
+                    PvlContainer::Replace);
+  }
+
+
+  /**
+   * Reads and decompresses a tile.
+   *
+   * @param chunkToFill The container to fill with the raw tile data
+   */
+  void CubeCompressedTileHandler::readRaw(RawCubeChunk &chunkToFill) {
+    const TileLocation &location = m_tileIndex[getChunkIndex(chunkToFill)];
+    BigInt startByte = location.startByte;
+
+    QFile * dataFile = getDataFile();
+    bool success = false;
+    QByteArray storedData;
+    int encoding = RawTile;
+
+    if (startByte > 0 && dataFile->seek(startByte)) {
+      QByteArray tile = dataFile->read(location.bytes);
+
+      if (tile.size() == (int)location.bytes && tile.size() >= HeaderBytes) {
+        const uchar *headerData = (const uchar *)tile.constData();
+        quint32 storedBytes = qFromBigEndian<quint32>(headerData);
+        encoding = qFromBigEndian<quint32>(headerData + 4);
+
+        if (storedBytes <= (quint32)chunkToFill.getByteCount() &&
+            storedBytes + HeaderBytes == location.bytes) {
+          storedData = tile.mid(HeaderBytes);
+          success = true;
+        }
+      }
+    }
+
+    if (!success) {
+      IString msg = "Reading from the file [" + dataFile->fileName() + "] "
+          "failed with reading the tile at position [" +
+          QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    chunkToFill.setRawData(decode(storedData, encoding, chunkToFill.getByteCount()));
+  }
+
+
+  /**
+   * Compresses and writes a tile.
+   *
+   * @param chunkToWrite The tile to put on disk
+   */
+  void CubeCompressedTileHandler::writeRaw(const RawCubeChunk &chunkToWrite) {
+    writeTile(chunkToWrite, encode(chunkToWrite, SizeOf(pixelType())));
+    flushTiles();
+  }
+
+
+  /**
+   * Compresses a group of tiles in parallel, then writes them in order and
+   *   flushes the file once.
+   *
+   * @param chunksToWrite The tiles to put on disk
+   */
+  void CubeCompressedTileHandler::writeRawChunks(const QList<RawCubeChunk *> &chunksToWrite) {
+    if (chunksToWrite.size() < 2) {
+      CubeIoHandler::writeRawChunks(chunksToWrite);
+      return;
+    }
+
+    QList<QByteArray> tiles = QtConcurrent::blockingMapped(chunksToWrite,
+        TileEncoder(SizeOf(pixelType())));
+
+    for (int i = 0; i < chunksToWrite.size(); i++) {
+      writeTile(*chunksToWrite[i], tiles[i]);
+    }
+
+    flushTiles();
+  }
+
+
+  /**
+   * Compresses the raw bytes of a tile. The bytes of multi-byte pixels are
+   *   shuffled first: all of the first bytes of the pixels, then all of the
+   *   second bytes, and so on. If compressing does not make the tile smaller,
+   *   the raw bytes are kept.
+   *
+   * @param chunk The tile to compress
+   * @param pixelBytes The number of bytes in each pixel
+   *
+   * @return QByteArray The header followed by the stored bytes
+   */
+  QByteArray CubeCompressedTileHandler::encode(const RawCubeChunk &chunk, int pixelBytes) {
+    const QByteArray &rawData = chunk.getRawData();
+    int encoding = DeflateTile;
+    QByteArray compressed;
+
+    if (pixelBytes > 1) {
+      int pixelCount = rawData.size() / pixelBytes;
+      QByteArray shuffled(rawData.size(), '\0');
+      const char *raw = rawData.constData();
+      char *shuffledData = shuffled.data();
+
+      for (int byte = 0; byte < pixelBytes; byte++) {
+        char *plane = shuffledData + (BigInt)byte * pixelCount;
+        for (int pixel = 0; pixel < pixelCount; pixel++) {
+          plane[pixel] = raw[(BigInt)pixel * pixelBytes + byte];
+        }
+      }
+
+      encoding = ShuffledDeflateTile;
+      compressed = qCompress(shuffled, TileCompressionLevel);
+    }
+    else {
+      compressed = qCompress(rawData, TileCompressionLevel);
+    }
+
+    const QByteArray &stored = (compressed.size() < rawData.size()) ? compressed : rawData;
+    if (compressed.size() >= rawData.size()) {
+      encoding = RawTile;
+    }
+
+    QByteArray tile(HeaderBytes, '\0');
+    uchar *header = (uchar *)tile.data();
+    qToBigEndian<quint32>(stored.size(), header);
+    qToBigEndian<quint32>(encoding, header + 4);
+    tile.append(stored);
+
+    return tile;
+  }
+
+
+  /**
+   * Restores the raw bytes of a stored tile.
+   *
+   * @param storedData The stored bytes of the tile, without its header
+   * @param encoding How the tile was stored
+   * @param byteCount The number of raw bytes in the tile
+   *
+   * @return QByteArray The raw bytes of the tile
+   */
+  QByteArray CubeCompressedTileHandler::decode(const QByteArray &storedData, int encoding,
+                                               int byteCount) {
+    QByteArray rawData;
+    if (encoding == RawTile) {
+      rawData = storedData;
+    }
+    else if (encoding == DeflateTile || encoding == ShuffledDeflateTile) {
+      rawData = qUncompress(storedData);
+    }
+
+    if (rawData.size() != byteCount) {
+      IString msg = "The compressed tile in the file [" + getDataFile()->fileName() +
+          "] is corrupt";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    if (encoding == ShuffledDeflateTile) {
+      int pixelBytes = SizeOf(pixelType());
+      int pixelCount = byteCount / pixelBytes;
+      QByteArray shuffled = rawData;
+      const char *shuffledData = shuffled.constData();
+      char *raw = rawData.data();
+
+      for (int byte = 0; byte < pixelBytes; byte++) {
+        const char *plane = shuffledData + (BigInt)byte * pixelCount;
+        for (int pixel = 0; pixel < pixelCount; pixel++) {
+          raw[(BigInt)pixel * pixelBytes + byte] = plane[pixel];
+        }
+      }
+    }
+
+    return rawData;
+  }
+
+
+  /**
+   * Reads the tile index from the start of the cube data.
+   */
+  void CubeCompressedTileHandler::readTileIndex() {
+    QFile * dataFile = getDataFile();
+    BigInt indexBytes = (BigInt)m_tileIndex.size() * IndexEntryBytes;
+    QByteArray index;
+
+    if (dataFile->seek(getDataStartByte())) {
+      index = dataFile->read(indexBytes);
+    }
+
+    if (index.size() != indexBytes) {
+      IString msg = "Reading from the file [" + dataFile->fileName() + "] "
+          "failed with reading the tile index at position [" +
+          QString::number(getDataStartByte()) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    const uchar *entry = (const uchar *)index.constData();
+    for (int i = 0; i < m_tileIndex.size(); i++, entry += IndexEntryBytes) {
+      m_tileIndex[i].startByte = qFromBigEndian<quint64>(entry);
+      m_tileIndex[i].bytes = qFromBigEndian<quint32>(entry + 8);
+    }
+  }
+
+
+  /**
+   * Writes a compressed tile and its index entry where allocateTile() puts
+   *   it. The file is not flushed; see flushTiles().
+   *
+   * @param chunk The chunk the tile was made from
+   * @param tile The header and stored bytes from encode()
+   */
+  void CubeCompressedTileHandler::writeTile(const RawCubeChunk &chunk, const QByteArray &tile) {
+    int tileIndex = getChunkIndex(chunk);
+    TileLocation &location = m_tileIndex[tileIndex];
+
+    QFile * dataFile = getDataFile();
+    BigInt startByte = allocateTile(location, tile.size());
+
+    QByteArray entry(IndexEntryBytes, '\0');
+    qToBigEndian<quint64>(startByte, (uchar *)entry.data());
+    qToBigEndian<quint32>(tile.size(), (uchar *)entry.data() + 8);
+    BigInt entryByte = getDataStartByte() + (BigInt)tileIndex * IndexEntryBytes;
+
+    bool success = dataFile->seek(startByte) &&
+                   dataFile->write(tile) == tile.size() &&
+                   dataFile->seek(entryByte) &&
+                   dataFile->write(entry) == entry.size();
+
+    if (!success) {
+      IString msg = "Writing to the file [" + dataFile->fileName() + "] "
+          "failed with writing [" + QString::number(tile.size()) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    location.startByte = startByte;
+    location.bytes = tile.size();
+  }
+
+
+  /**
+   * Flushes the tiles written to the file. Blobs are appended through another
+   *   stream, so this keeps the end of the file current for them.
+   */
+  void CubeCompressedTileHandler::flushTiles() {
+    QFile * dataFile = getDataFile();
+
+    if (!dataFile->flush()) {
+      IString msg = "Writing to the file [" + dataFile->fileName() + "] "
+          "failed with flushing the written tiles";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Finds where to write a tile. The space the tile was in is released
+   *   first, so the tile stays where it was if it still fits there, including
+   *   in space released next to it. Otherwise it goes in the first released
+   *   space it fits in, where space that ends at the end of the file fits any
+   *   tile, or it is appended to the end of the file.
+   *
+   * @param location Where the tile is now
+   * @param bytes The bytes of the header and stored tile to write
+   *
+   * @return BigInt The position to write the tile at
+   */
+  BigInt CubeCompressedTileHandler::allocateTile(const TileLocation &location, quint32 bytes) {
+    BigInt endOfFile = getDataFile()->size();
+
+    if (location.startByte > 0) {
+      releaseSpace(location.startByte, location.bytes);
+    }
+
+    BigInt startByte = endOfFile;
+    QMap<BigInt, BigInt>::iterator space = m_freeSpace.end();
+
+    if (location.startByte > 0) {
+      // The released space that holds where the tile was
+      QMap<BigInt, BigInt>::iterator held = m_freeSpace.upperBound(location.startByte);
+      --held;
+      BigInt heldEnd = held.key() + held.value();
+      if (heldEnd == endOfFile || heldEnd - location.startByte >= bytes) {
+        space = held;
+        startByte = location.startByte;
+      }
+    }
+
+    if (space == m_freeSpace.end()) {
+      QMap<BigInt, BigInt>::iterator it;
+      for (it = m_freeSpace.begin(); it != m_freeSpace.end(); ++it) {
+        if (it.value() >= bytes || it.key() + it.value() == endOfFile) {
+          space = it;
+          startByte = it.key();
+          break;
+        }
+      }
+    }
+
+    if (space != m_freeSpace.end()) {
+      BigInt spaceStart = space.key();
+      BigInt spaceEnd = space.key() + space.value();
+      m_freeSpace.erase(space);
+
+      if (startByte > spaceStart) {
+        m_freeSpace.insert(spaceStart, startByte - spaceStart);
+      }
+      if (startByte + bytes < spaceEnd) {
+        m_freeSpace.insert(startByte + bytes, spaceEnd - startByte - bytes);
+      }
+    }
+
+    return startByte;
+  }
+
+
+  /**
+   * Keeps space that no tile is stored in, joined with the space next to it.
+   *
+   * @param startByte The position of the space
+   * @param bytes The size of the space
+   */
+  void CubeCompressedTileHandler::releaseSpace(BigInt startByte, BigInt bytes) {
+    QMap<BigInt, BigInt>::iterator next = m_freeSpace.upperBound(startByte);
+
+    if (next != m_freeSpace.end() && startByte + bytes == next.key()) {
+      bytes += next.value();
+      next = m_freeSpace.erase(next);
+    }
+
+    if (next != m_freeSpace.begin()) {
+      QMap<BigInt, BigInt>::iterator previous = next;
+      --previous;
+      if (previous.key() + previous.value() == startByte) {
+        previous.value() += bytes;
+        return;
+      }
+    }
+
+    m_freeSpace.insert(startByte, bytes);
+  }
+}
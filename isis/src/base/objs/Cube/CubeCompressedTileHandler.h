@@ -0,0 +1,165 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#ifndef CubeCompressedTileHandler_h
+#define CubeCompressedTileHandler_h
+
+#include "CubeTileHandler.h"
+
+#include <functional>
+
+#include <QByteArray>
+#include <QMap>
+#include <QVector>
+
+namespace Isis {
+
+  /**
+   * @brief IO Handler for Isis Cubes using the compressed tile format.
+   *
+   * This handler stores cubes in the same tiles as CubeTileHandler, but each
+   *   tile is compressed losslessly with deflate before it is written. For
+   *   pixel types larger than a byte, the bytes of the pixels are shuffled
+   *   first so the most significant bytes, which change slowly, are next to
+   *   each other. Tiles that do not get smaller are stored as they are.
+   *
+   * The cube data starts with a tile index that holds the file position and
+   *   size of every tile. The tiles are packed after it: a tile is stored as
+   *   a small header holding its stored size and encoding, followed by the
+   *   stored bytes. A tile that is written again is rewritten in place when
+   *   it still fits. Otherwise the space it leaves is kept, and it is moved
+   *   to the first space it fits in, or appended to the end of the file, so
+   *   the file only grows by the compressed size of the tiles. The space
+   *   left by moved tiles is only known while the cube is open. Blobs are
+   *   appended to the end of the file as well, so tiles and blobs may be
+   *   interleaved; the index and the blob labels locate each of them.
+   *
+   * Dirty tiles leaving the cache together are compressed in parallel.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version.
+   *   @history 2018-09-07 Isis Development Team - Tiles that grow reuse the
+   *                           space left by tiles that moved. The file is
+   *                           flushed once per group of tiles written.
+   */
+  class CubeCompressedTileHandler : public CubeTileHandler {
+    public:
+      CubeCompressedTileHandler(QFile * dataFile, const QList<int> *virtualBandList,
+          const Pvl &label, bool alreadyOnDisk);
+      ~CubeCompressedTileHandler();
+
+      BigInt getDataSize() const;
+      void updateLabels(Pvl &label);
+
+    protected:
+      virtual void readRaw(RawCubeChunk &chunkToFill);
+      virtual void writeRaw(const RawCubeChunk &chunkToWrite);
+      virtual void writeRawChunks(const QList<RawCubeChunk *> &chunksToWrite);
+
+    private:
+      /**
+       * Disallow copying of this object.
+       *
+       * @param other The object to copy.
+       */
+      CubeCompressedTileHandler(const CubeCompressedTileHandler &other);
+
+      /**
+       * Disallow assignments of this object
+       *
+       * @param other The CubeCompressedTileHandler on the right-hand side of
+       *              the assignment that we are copying into *this.
+       * @return A reference to *this.
+       */
+      CubeCompressedTileHandler &operator=(const CubeCompressedTileHandler &other);
+
+      //! How the bytes of a tile are stored
+      enum TileEncoding {
+        RawTile = 0,            //!< The raw bytes of the tile
+        DeflateTile = 1,        //!< The raw bytes compressed
+        ShuffledDeflateTile = 2 //!< The raw bytes shuffled, then compressed
+      };
+
+      /**
+       * Compresses the raw bytes of chunks. This is designed to be passed
+       *   into QtConcurrent::blockingMapped.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      class TileEncoder : public std::unary_function<RawCubeChunk * const &, QByteArray> {
+        public:
+          /**
+           * @param pixelBytes The number of bytes in each pixel
+           */
+          TileEncoder(int pixelBytes) : m_pixelBytes(pixelBytes) {
+          }
+
+          /**
+           * @param chunk The chunk to compress
+           * @return QByteArray The header and stored bytes of the tile
+           */
+          QByteArray operator()(RawCubeChunk * const &chunk) const {
+            return encode(*chunk, m_pixelBytes);
+          }
+
+        private:
+          int m_pixelBytes; //!< The number of bytes in each pixel
+      };
+
+      static QByteArray encode(const RawCubeChunk &chunk, int pixelBytes);
+      QByteArray decode(const QByteArray &storedData, int encoding,
+                        int byteCount);
+
+      void readTileIndex();
+      void writeTile(const RawCubeChunk &chunk, const QByteArray &tile);
+      void flushTiles();
+
+      //! The bytes before each stored tile: its stored size and its encoding
+      static const int HeaderBytes = 8;
+
+      //! The bytes of each tile index entry: its file position and its size
+      static const int IndexEntryBytes = 12;
+
+      //! Where a tile is stored in the file
+      struct TileLocation {
+        BigInt startByte; //!< The position of the tile header, 0 if unwritten
+        quint32 bytes;    //!< The bytes of the header and stored tile
+      };
+
+      BigInt allocateTile(const TileLocation &location, quint32 bytes);
+      void releaseSpace(BigInt startByte, BigInt bytes);
+
+      QVector<TileLocation> m_tileIndex; //!< The location of every tile
+
+      //! The bytes left by tiles that moved, by their position in the file
+      QMap<BigInt, BigInt> m_freeSpace;
+  };
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <iomanip>
 
+#include <QBitArray>
 #include <QDebug>
 #include <QFile>
 #include <QList>
@@ -40,6 +41,7 @@
 
 #include "Area3D.h"
 #include "Brick.h"
+#include "CubeCacheManager.h"
 #include "CubeCachingAlgorithm.h"
 #include "Displacement.h"
 #include "Distance.h"
@@ -81,6 +83,7 @@ namespace Isis {
     m_byteSwapper = NULL;
     m_cachingAlgorithms = NULL;
     m_dataIsOnDiskMap = NULL;
+    m_chunkPresence = NULL;
     m_rawData = NULL;
     m_virtualBands = NULL;
     m_nullChunkData = NULL;
@@ -149,15 +152,55 @@ namespace Isis {
       m_linesInChunk = -1;
       m_bandsInChunk = -1;
 
-      if(!alreadyOnDisk) {
+      // Sparse cubes know which chunks are stored from their labels, so they
+      //   never need to fill the file with NULLs.
+      if(core.hasKeyword("Sparse") &&
+         core.findKeyword("Sparse")[0].toUpper() == "TRUE") {
+        m_chunkPresence = new QBitArray;
+
+        if(alreadyOnDisk) {
+          if(!core.hasKeyword("ChunkPresence")) {
+            IString msg = "The sparse cube labels do not have a ChunkPresence "
+                "keyword";
+            throw IException(IException::Io, msg, _FILEINFO_);
+          }
+
+          const PvlKeyword &presenceKeyword = core.findKeyword("ChunkPresence");
+          QByteArray encodedPresence;
+          for(int i = 0; i < presenceKeyword.size(); i++) {
+            encodedPresence.append(presenceKeyword[i].toLatin1());
+          }
+
+          // An empty result means the keyword is not valid compressed hex. The
+          //   bit count is checked against the chunk count in setChunkSizes().
+          QByteArray presence = qUncompress(QByteArray::fromHex(encodedPresence));
+          if(presence.isEmpty()) {
+            IString msg = "The ChunkPresence keyword of the sparse cube labels "
+                "could not be decoded";
+            throw IException(IException::Io, msg, _FILEINFO_);
+          }
+
+          m_chunkPresence->resize(presence.size() * 8);
+          for(int i = 0; i < m_chunkPresence->size(); i++) {
+            m_chunkPresence->setBit(i, presence[i / 8] & (1 << (i % 8)));
+          }
+        }
+      }
+      else if(!alreadyOnDisk) {
         m_dataIsOnDiskMap = new QMap<int, bool>;
       }
 
       setVirtualBands(virtualBandList);
     }
     catch(IException &e) {
+      // Labels that do not describe the file are I/O errors, not programming
+      //   errors
       IString msg = "Constructing CubeIoHandler failed";
-      throw IException(e, IException::Programmer, msg, _FILEINFO_);
+      IException::ErrorType errorType = IException::Programmer;
+      if(e.errorType() == IException::Io) {
+        errorType = IException::Io;
+      }
+      throw IException(e, errorType, msg, _FILEINFO_);
     }
     catch(...) {
       IString msg = "Constructing CubeIoHandler failed";
@@ -173,6 +216,8 @@ namespace Isis {
   CubeIoHandler::~CubeIoHandler() {
     ASSERT( m_rawData ? m_rawData->size() == 0 : 1 );
 
+    CubeCacheManager::instance()->removeHandler(this);
+
     if (m_ioThreadPool)
       m_ioThreadPool->waitForDone();
 
@@ -182,6 +227,9 @@ namespace Isis {
     delete m_dataIsOnDiskMap;
     m_dataIsOnDiskMap = NULL;
 
+    delete m_chunkPresence;
+    m_chunkPresence = NULL;
+
     if (m_cachingAlgorithms) {
       QListIterator<CubeCachingAlgorithm *> it(*m_cachingAlgorithms);
       while (it.hasNext()) {
@@ -400,6 +448,10 @@ namespace Isis {
     if (blockForWriteCache) {
       // Start the rest of the writes
       flushWriteCache(true);
+
+      // Stop prefetching and drop our chunks from the process wide cache. The
+      //   write thread can't do this, because a prefetch may be waiting on it.
+      CubeCacheManager::instance()->removeHandler(this);
     }
 
     // If this map is allocated, then this is a brand new cube and we need to
@@ -411,19 +463,24 @@ namespace Isis {
     // This should be allocated. This is a list of the cached cube data.
     //   Write it all to disk.
     if (m_rawData) {
+      QList<RawCubeChunk *> dirtyChunks;
       QMapIterator<int, RawCubeChunk *> it(*m_rawData);
       while (it.hasNext()) {
         it.next();
 
-        if(it.value()) {
-          if(it.value()->isDirty()) {
-            (const_cast<CubeIoHandler *>(this))->writeRaw(*it.value());
-          }
-
-          delete it.value();
+        if(it.value() && it.value()->isDirty()) {
+          dirtyChunks.append(it.value());
         }
       }
 
+      writeChunks(dirtyChunks);
+
+      it.toFront();
+      while (it.hasNext()) {
+        it.next();
+        delete it.value();
+      }
+
       m_rawData->clear();
     }
 
@@ -446,6 +503,70 @@ namespace Isis {
   }
 
 
+  /**
+   * Hint that an area of the cube will be read soon. The chunks of the area
+   *   that would have to be read from disk are read into the process wide
+   *   CubeCacheManager on its prefetch thread, so this returns without
+   *   reading anything. Chunks that are already in memory, and chunks that
+   *   have not been written yet, are skipped.
+   *
+   * @param bufferToRead A buffer positioned on the area that will be read
+   */
+  void CubeIoHandler::prefetch(const Buffer &bufferToRead) const {
+    if(bufferToRead.size() == 0) {
+      return;
+    }
+
+    int startSample = max(bufferToRead.Sample(), 1);
+    int endSample = min(bufferToRead.Sample() + bufferToRead.SampleDimension() - 1,
+                        sampleCount());
+    int startLine = max(bufferToRead.Line(), 1);
+    int endLine = min(bufferToRead.Line() + bufferToRead.LineDimension() - 1,
+                      lineCount());
+
+    if(startSample > endSample || startLine > endLine) {
+      return;
+    }
+
+    QMutexLocker lock(m_writeThreadMutex);
+
+    QList<int> chunkIndices;
+    for(int band = bufferToRead.Band();
+        band < bufferToRead.Band() + bufferToRead.BandDimension(); band++) {
+      int physicalBand = band;
+      if(m_virtualBands) {
+        physicalBand = (band >= 1 && band <= m_virtualBands->size()) ?
+                       m_virtualBands->at(band - 1) : 0;
+      }
+
+      if(physicalBand < 1 || physicalBand > bandCount()) {
+        continue;
+      }
+
+      int chunkBand = (physicalBand - 1) / getBandCountInChunk();
+      for(int chunkLine = (startLine - 1) / getLineCountInChunk();
+          chunkLine <= (endLine - 1) / getLineCountInChunk(); chunkLine++) {
+        for(int chunkSample = (startSample - 1) / getSampleCountInChunk();
+            chunkSample <= (endSample - 1) / getSampleCountInChunk(); chunkSample++) {
+          int chunkIndex = chunkSample +
+              chunkLine * getChunkCountInSampleDimension() +
+              chunkBand * getChunkCountInSampleDimension() * getChunkCountInLineDimension();
+
+          bool notWritten = (m_dataIsOnDiskMap && !m_dataIsOnDiskMap->value(chunkIndex)) ||
+                            (m_chunkPresence && !m_chunkPresence->testBit(chunkIndex));
+
+          if(!notWritten && !m_rawData->contains(chunkIndex) &&
+             !chunkIndices.contains(chunkIndex)) {
+            chunkIndices.append(chunkIndex);
+          }
+        }
+      }
+    }
+
+    CubeCacheManager::instance()->prefetch(this, chunkIndices);
+  }
+
+
   /**
    * This changes the virtual band list.
    *
@@ -465,6 +586,67 @@ namespace Isis {
       m_virtualBands = new QList<int>(*virtualBandList);
   }
 
+
+  /**
+   * @return True if this cube only stores the chunks that are not all NULL
+   */
+  bool CubeIoHandler::isSparse() const {
+    return m_chunkPresence != NULL;
+  }
+
+
+  /**
+   * Store which chunks of a sparse cube are in the file in the cube labels.
+   *   The bitmap is compressed and written in hex as the values of the
+   *   ChunkPresence keyword. The cache should be cleared first so that every
+   *   chunk in memory has been written. This does nothing if the cube is not
+   *   sparse.
+   *
+   * @param labels The "Core" object in this Pvl will be updated
+   */
+  void CubeIoHandler::updateChunkPresence(Pvl &labels) const {
+    if(m_chunkPresence) {
+      QByteArray presence((m_chunkPresence->size() + 7) / 8, '\0');
+      for(int i = 0; i < m_chunkPresence->size(); i++) {
+        if(m_chunkPresence->testBit(i)) {
+          presence[i / 8] = presence[i / 8] | (1 << (i % 8));
+        }
+      }
+
+      QByteArray encodedPresence = qCompress(presence).toHex();
+
+      PvlKeyword presenceKeyword("ChunkPresence");
+      for(int i = 0; i < encodedPresence.size(); i += 64) {
+        presenceKeyword += QString(encodedPresence.mid(i, 64));
+      }
+
+      PvlObject &core = labels.findObject("IsisCube").findObject("Core");
+      core.addKeyword(presenceKeyword, PvlContainer::Replace);
+    }
+  }
+
+  /**
+   * Returns the most bytes the ChunkPresence keyword written by
+   *   updateChunkPresence() can take in the labels of this cube, whatever
+   *   chunks are stored. The bitmap may not compress at all, so this allows
+   *   for zlib's worst case, the hex encoding and the formatting of one value
+   *   per label line.
+   *
+   * @return The label bytes to set aside, or 0 if the cube is not sparse
+   */
+  int CubeIoHandler::chunkPresenceLabelBytes() const {
+    if(!m_chunkPresence) {
+      return 0;
+    }
+
+    int presenceBytes = (getChunkCount() + 7) / 8;
+    int compressedBytes = presenceBytes + presenceBytes / 1000 + 13 + 4;
+    int values = (2 * compressedBytes + 63) / 64;
+
+    return 64 + values * 128;
+  }
+
+
   /**
    * Get the mutex that this IO handler is using around I/Os on the given
    *   data file. A lock should be acquired before doing any reads/writes on
@@ -663,7 +845,27 @@ namespace Isis {
       m_linesInChunk = numLines;
       m_bandsInChunk = numBands;
 
-      if(m_dataIsOnDiskMap) {
+      if(m_chunkPresence) {
+        // The labels store whole bytes of presence bits, so a cube read from
+        //   disk must have exactly the bytes that hold one bit per chunk. A new
+        //   cube has no bits yet.
+        int presenceBytes = m_chunkPresence->size() / 8;
+        if(m_chunkPresence->size() > 0 &&
+           presenceBytes != (getChunkCount() + 7) / 8) {
+          IString msg = "The ChunkPresence keyword of the sparse cube labels "
+              "has [" + IString(m_chunkPresence->size()) + "] bits, which do "
+              "not match the [" + IString(getChunkCount()) + "] chunks of the "
+              "cube";
+          throw IException(IException::Io, msg, _FILEINFO_);
+        }
+
+        m_chunkPresence->resize(getChunkCount());
+      }
+
+      // Sparse cubes are only resized; the chunks that are never written take
+      //   no disk space on file systems that support sparse files.
+      if(m_dataIsOnDiskMap ||
+         (m_chunkPresence && m_dataFile->size() < getDataStartByte() + getDataSize())) {
         m_dataFile->resize(getDataStartByte() + getDataSize());
       }
       else if(m_dataFile->size() < getDataStartByte() + getDataSize()) {
@@ -1044,7 +1246,7 @@ namespace Isis {
       m_rawData->erase(m_rawData->find(chunkIndex));
 
       if(chunkToFree->isDirty())
-        (const_cast<CubeIoHandler *>(this))->writeRaw(*chunkToFree);
+        writeChunks(QList<RawCubeChunk *>() << chunkToFree);
 
       delete chunkToFree;
 
@@ -1056,6 +1258,38 @@ namespace Isis {
   }
 
 
+  /**
+   * Removes chunks from memory, writing the dirty ones to disk together with
+   *   writeRawChunks().
+   *
+   * @param chunksToFree The chunks we're removing from memory
+   */
+  void CubeIoHandler::freeChunks(const QList<RawCubeChunk *> &chunksToFree) const {
+    if(m_rawData && !chunksToFree.isEmpty()) {
+      QList<RawCubeChunk *> dirtyChunks;
+      foreach(RawCubeChunk *chunkToFree, chunksToFree) {
+        if(chunkToFree) {
+          m_rawData->erase(m_rawData->find(getChunkIndex(*chunkToFree)));
+
+          if(chunkToFree->isDirty())
+            dirtyChunks.append(chunkToFree);
+        }
+      }
+
+      writeChunks(dirtyChunks);
+
+      foreach(RawCubeChunk *chunkToFree, chunksToFree) {
+        delete chunkToFree;
+      }
+
+      if(m_lastProcessByLineChunks) {
+        delete m_lastProcessByLineChunks;
+        m_lastProcessByLineChunks = NULL;
+      }
+    }
+  }
+
+
   /**
    * Retrieve the cached chunk at the given chunk index, if there is one.
    *
@@ -1078,6 +1312,12 @@ namespace Isis {
         chunk = getNullChunk(chunkIndex);
         (*m_dataIsOnDiskMap)[chunkIndex] = true;
       }
+      else if(m_chunkPresence && !m_chunkPresence->testBit(chunkIndex)) {
+        // Absent chunks of sparse cubes are NULL and only need stored once
+        //   something else is written into them.
+        chunk = getNullChunk(chunkIndex);
+        chunk->setDirty(false);
+      }
       else {
         int startSample;
         int startLine;
@@ -1091,7 +1331,15 @@ namespace Isis {
                                     endSample, endLine, endBand,
                                     getBytesPerChunk());
 
-        (const_cast<CubeIoHandler *>(this))->readRaw(*chunk);
+        QByteArray cachedData;
+        if(CubeCacheManager::instance()->find(this, chunkIndex, cachedData)) {
+          chunk->setRawData(cachedData);
+        }
+        else {
+          (const_cast<CubeIoHandler *>(this))->readRaw(*chunk);
+          CubeCacheManager::instance()->insert(this, chunkIndex, chunk->getRawData());
+        }
+
         chunk->setDirty(false);
       }
 
@@ -1200,6 +1448,46 @@ namespace Isis {
   }
 
 
+  /**
+   * @param chunk A chunk of this cube
+   * @return True if every byte of the chunk matches a NULL chunk
+   */
+  bool CubeIoHandler::isNullChunk(const RawCubeChunk &chunk) const {
+    if(!m_nullChunkData) {
+      delete getNullChunk(getChunkIndex(chunk));
+    }
+
+    return chunk.getRawData() == *m_nullChunkData;
+  }
+
+
+  /**
+   * Reads a chunk for the process wide cache on the prefetch thread. This
+   *   holds the data file mutex while it reads.
+   *
+   * @param chunkIndex The chunk to read
+   * @return QByteArray The raw chunk data
+   */
+  QByteArray CubeIoHandler::prefetchChunk(int chunkIndex) {
+    QMutexLocker locker(m_writeThreadMutex);
+
+    int startSample;
+    int startLine;
+    int startBand;
+    int endSample;
+    int endLine;
+    int endBand;
+    getChunkPlacement(chunkIndex, startSample, startLine, startBand,
+                      endSample, endLine, endBand);
+
+    RawCubeChunk chunk(startSample, startLine, startBand,
+                       endSample, endLine, endBand, getBytesPerChunk());
+    readRaw(chunk);
+
+    return chunk.getRawData();
+  }
+
+
   /**
    * Apply the caching algorithms and get rid of excess cube data in memory.
    *   This is intended to be called after every IO operation.
@@ -1229,12 +1517,7 @@ namespace Isis {
         algorithmAccepted = result.algorithmUnderstoodData();
 
         if(algorithmAccepted) {
-          QList<RawCubeChunk *> chunksToFree = result.getChunksToFree();
-
-          RawCubeChunk *chunkToFree;
-          foreach(chunkToFree, chunksToFree) {
-            freeChunk(chunkToFree);
-          }
+          freeChunks(result.getChunksToFree());
         }
 
         algorithmIndex ++;
@@ -1247,6 +1530,31 @@ namespace Isis {
         clearCache(false);
       }
     }
+
+    // Stay within our share of the process wide cube cache budget. The chunks
+    //   of this IO operation are kept.
+    CubeCacheManager *cacheManager = CubeCacheManager::instance();
+    if (cacheManager->isEnabled()) {
+      BigInt heldBytes = (BigInt)m_rawData->size() * getBytesPerChunk();
+      BigInt allowedBytes = cacheManager->handlerAllowance(this, heldBytes);
+
+      if (allowedBytes >= 0 && heldBytes > allowedBytes) {
+        QList<RawCubeChunk *> chunksToFree;
+        foreach(RawCubeChunk *chunk, m_rawData->values()) {
+          if (heldBytes <= allowedBytes) {
+            break;
+          }
+
+          if (!justUsed.contains(chunk)) {
+            chunksToFree.append(chunk);
+            heldBytes -= getBytesPerChunk();
+          }
+        }
+
+        freeChunks(chunksToFree);
+        cacheManager->updateHandlerBytes(this, heldBytes);
+      }
+    }
   }
 
 
@@ -1400,7 +1708,7 @@ namespace Isis {
     int chunkBandSize = chunkLineSize * chunk.lineCount();
     //double *buffersDoubleBuf = output.p_buf;
     double *buffersDoubleBuf = output.DoubleBuffer();
-    const char *chunkBuf = chunk.getRawData().data();
+    const char *chunkBuf = chunk.getRawData().constData();
     char *buffersRawBuf = (char *)output.RawBuffer();
 
     for(int z = startZ; z <= endZ; z++) {
@@ -1775,16 +2083,74 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    // Write the chunks in small groups so they can be prepared together
     int numChunks = getChunkCount();
+    QList<RawCubeChunk *> nullChunks;
     for(int i = 0; i < numChunks; i++) {
       if(!(*m_dataIsOnDiskMap)[i]) {
-        RawCubeChunk *nullChunk = getNullChunk(i);
-        (const_cast<CubeIoHandler *>(this))->writeRaw(*nullChunk);
+        nullChunks.append(getNullChunk(i));
         (*m_dataIsOnDiskMap)[i] = true;
+      }
+
+      if(nullChunks.size() == 16 || (i == numChunks - 1 && !nullChunks.isEmpty())) {
+        try {
+          (const_cast<CubeIoHandler *>(this))->writeRawChunks(nullChunks);
+        }
+        catch(IException &) {
+          qDeleteAll(nullChunks);
+          throw;
+        }
+        qDeleteAll(nullChunks);
+        nullChunks.clear();
+      }
+    }
+  }
 
-        delete nullChunk;
-        nullChunk = NULL;
+
+  /**
+   * Puts dirty chunks on disk with writeRawChunks(). Sparse cubes skip the
+   *   chunks that are all NULL and mark them absent instead, so they are never
+   *   stored.
+   *
+   * @param chunksToWrite The dirty chunks leaving the cache
+   */
+  void CubeIoHandler::writeChunks(const QList<RawCubeChunk *> &chunksToWrite) const {
+    if(!m_chunkPresence) {
+      (const_cast<CubeIoHandler *>(this))->writeRawChunks(chunksToWrite);
+    }
+    else {
+      QList<RawCubeChunk *> storedChunks;
+      foreach(RawCubeChunk *chunk, chunksToWrite) {
+        int chunkIndex = getChunkIndex(*chunk);
+        bool isNull = isNullChunk(*chunk);
+
+        m_chunkPresence->setBit(chunkIndex, !isNull);
+
+        if(!isNull) {
+          storedChunks.append(chunk);
+        }
       }
+
+      (const_cast<CubeIoHandler *>(this))->writeRawChunks(storedChunks);
+    }
+
+    // What the process wide cache has for these chunks is out of date now
+    foreach(RawCubeChunk *chunk, chunksToWrite) {
+      CubeCacheManager::instance()->invalidate(this, getChunkIndex(*chunk));
+    }
+  }
+
+
+  /**
+   * Writes a group of chunks to disk. By default each chunk is written in
+   *   turn with writeRaw(); children can override this to prepare the chunks
+   *   in parallel before writing them.
+   *
+   * @param chunksToWrite The dirty chunks to put on disk
+   */
+  void CubeIoHandler::writeRawChunks(const QList<RawCubeChunk *> &chunksToWrite) {
+    foreach(RawCubeChunk *chunkToWrite, chunksToWrite) {
+      writeRaw(*chunkToWrite);
     }
   }
 
@@ -31,6 +31,8 @@
 #include "Endian.h"
 #include "PixelType.h"
 
+class QBitArray;
+class QByteArray;
 class QFile;
 class QMutex;
 class QTime;
@@ -116,6 +118,29 @@ namespace Isis {
    *                           implementation causing warnings in clang. Part of OS X 10.11 porting.
    *                           QPair forward declaration now properly claims it as a struct.
    *   @history 2017-09-22 Cole Neubauer - Fixed documentation. References #4807
+   *   @history 2018-09-07 Isis Development Team - The chunk dimension accessors are now
+   *                           public so Cube can report them.
+   *   @history 2018-09-07 Isis Development Team - Dirty chunks that leave the cache
+   *                           together are now written with writeRawChunks(), which
+   *                           children can override to prepare the chunks in parallel.
+   *                           getDataSize() is now virtual for formats that store more
+   *                           than the raw chunks.
+   *   @history 2018-09-07 Isis Development Team - Added sparse cubes. Cubes with a Sparse
+   *                           keyword in their Core keep a chunk presence bitmap in the
+   *                           label; chunks that were never written, or that are all NULL,
+   *                           are not stored and are read as NULL without any IO.
+   *   @history 2018-09-07 Isis Development Team - Chunks read from disk are shared through
+   *                           the process wide CubeCacheManager. Added prefetch().
+   *                           writeIntoDouble() no longer detaches the chunk data.
+   *   @history 2018-09-07 Isis Development Team - A ChunkPresence keyword that can not be
+   *                           decoded, or whose bits do not match the chunk count, is now an
+   *                           I/O error, and I/O errors from the labels are no longer reported
+   *                           as programmer errors.
+   *   @history 2018-09-07 Isis Development Team - minimizeCache() frees chunks beyond the
+   *                           allowance CubeCacheManager gives this cube when the process
+   *                           wide cube cache is on.
+   *   @history 2018-09-07 Isis Development Team - Added chunkPresenceLabelBytes() so cubes
+   *                           can set aside label space for the ChunkPresence keyword.
    */
   class CubeIoHandler {
     public:
@@ -125,11 +150,18 @@ namespace Isis {
 
       void read(Buffer &bufferToFill) const;
       void write(const Buffer &bufferToWrite);
+      void prefetch(const Buffer &bufferToRead) const;
 
       void addCachingAlgorithm(CubeCachingAlgorithm *algorithm);
       void clearCache(bool blockForWriteCache = true) const;
-      BigInt getDataSize() const;
+      virtual BigInt getDataSize() const;
       void setVirtualBands(const QList<int> *virtualBandList);
+      int getBandCountInChunk() const;
+      int getLineCountInChunk() const;
+      int getSampleCountInChunk() const;
+      bool isSparse() const;
+      void updateChunkPresence(Pvl &labels) const;
+      int chunkPresenceLabelBytes() const;
       /**
        * Function to update the labels with a Pvl object
        *
@@ -141,7 +173,6 @@ namespace Isis {
 
     protected:
       int bandCount() const;
-      int getBandCountInChunk() const;
       BigInt getBytesPerChunk() const;
       int getChunkCountInBandDimension() const;
       int getChunkCountInLineDimension() const;
@@ -150,10 +181,8 @@ namespace Isis {
       BigInt getDataStartByte() const;
       QFile * getDataFile();
       int lineCount() const;
-      int getLineCountInChunk() const;
       PixelType pixelType() const;
       int sampleCount() const;
-      int getSampleCountInChunk() const;
 
       void setChunkSizes(int numSamples, int numLines, int numBands);
 
@@ -176,7 +205,11 @@ namespace Isis {
        */
       virtual void writeRaw(const RawCubeChunk &chunkToWrite) = 0;
 
+      virtual void writeRawChunks(const QList<RawCubeChunk *> &chunksToWrite);
+
     private:
+      friend class CubeCacheManager;
+
       /**
        * This class is designed to handle write() asynchronously.
        *
@@ -255,6 +288,7 @@ namespace Isis {
       void flushWriteCache(bool force = false) const;
 
       void freeChunk(RawCubeChunk *chunkToFree) const;
+      void freeChunks(const QList<RawCubeChunk *> &chunksToFree) const;
 
       RawCubeChunk *getChunk(int chunkIndex, bool allocateIfNecessary) const;
 
@@ -265,6 +299,8 @@ namespace Isis {
         int &endSample, int &endLine, int &endBand) const;
 
       RawCubeChunk *getNullChunk(int chunkIndex) const;
+      QByteArray prefetchChunk(int chunkIndex);
+      bool isNullChunk(const RawCubeChunk &chunk) const;
 
       void minimizeCache(const QList<RawCubeChunk *> &justUsed,
                          const Buffer &justRequested) const;
@@ -277,6 +313,8 @@ namespace Isis {
 
       void writeNullDataToDisk() const;
 
+      void writeChunks(const QList<RawCubeChunk *> &chunksToWrite) const;
+
     private:
       //! The file containing cube data.
       QFile * m_dataFile;
@@ -321,6 +359,12 @@ namespace Isis {
       //! The map from chunk index to on-disk status, all true if not allocated.
       mutable QMap<int, bool> * m_dataIsOnDiskMap;
 
+      /**
+       * For sparse cubes, which chunks are stored in the file. This is NULL
+       *   for cubes that store every chunk.
+       */
+      mutable QBitArray * m_chunkPresence;
+
       //! Converts from virtual band to physical band.
       QList<int> * m_virtualBands;
 
@@ -48,7 +48,40 @@ namespace Isis {
   CubeTileHandler::CubeTileHandler(QFile * dataFile,
       const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk)
       : CubeIoHandler(dataFile, virtualBandList, labels, alreadyOnDisk) {
+    setTileSizes(labels);
+  }
+
 
+  /**
+   * Construct a tile handler for a child class. Setting the tile size resizes
+   *   or checks the data file with getDataSize(), so a child class that
+   *   stores the tiles differently passes false and calls setTileSizes() from
+   *   its own constructor.
+   *
+   * @param dataFile The file with cube DN data in it
+   * @param virtualBandList The mapping from virtual band to physical band, see
+   *          CubeIoHandler's description.
+   * @param labels The Pvl labels for the cube
+   * @param alreadyOnDisk True if the cube is allocated on the disk, false
+   *          otherwise
+   * @param setSizes True to set the tile size now
+   */
+  CubeTileHandler::CubeTileHandler(QFile * dataFile,
+      const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk,
+      bool setSizes)
+      : CubeIoHandler(dataFile, virtualBandList, labels, alreadyOnDisk) {
+    if(setSizes) {
+      setTileSizes(labels);
+    }
+  }
+
+
+  /**
+   * Sets the tile size from the labels, or chooses a good one for a new cube.
+   *
+   * @param labels The Pvl labels for the cube
+   */
+  void CubeTileHandler::setTileSizes(const Pvl &labels) {
     const PvlObject &core = labels.findObject("IsisCube").findObject("Core");
 
     if(core.hasKeyword("Format")) {
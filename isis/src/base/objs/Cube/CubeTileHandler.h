@@ -47,6 +47,10 @@ namespace Isis {
    *   @history 2011-07-18 Jai Rideout and Steven Lambright - Added
    *                           unimplemented copy constructor and assignment
    *                           operator.
+   *   @history 2018-09-07 Isis Development Team - Added a protected constructor
+   *                           that leaves the tile size to the child class, so
+   *                           the file size is checked against the child's
+   *                           getDataSize(). Added setTileSizes().
    */
 
   class CubeTileHandler : public CubeIoHandler {
@@ -58,6 +62,11 @@ namespace Isis {
       void updateLabels(Pvl &label);
 
     protected:
+      CubeTileHandler(QFile * dataFile, const QList<int> *virtualBandList,
+          const Pvl &label, bool alreadyOnDisk, bool setSizes);
+
+      void setTileSizes(const Pvl &label);
+
       virtual void readRaw(RawCubeChunk &chunkToFill);
       virtual void writeRaw(const RawCubeChunk &chunkToWrite);
 
@@ -711,6 +711,16 @@ int main(int argc, char *argv[]) {
     catch (IException &e) {
       e.print();
     }
+    try {
+      Cube in;
+      in.open("IsisCube_01", "label");
+      LineManager labelOnlyLine(in);
+      labelOnlyLine.begin();
+      in.read(labelOnlyLine);
+    }
+    catch (IException &e) {
+      e.print();
+    }
     try {
       Cube in;
       in.setDimensions(0, 0, 0);
@@ -948,6 +958,167 @@ int main(int argc, char *argv[]) {
     
   }
 
+  cerr << endl << "Test creating a compressed tile cube" << endl;
+  {
+    Cube compressedCube;
+    compressedCube.setDimensions(300, 200, 2);
+    compressedCube.setPixelType(Real);
+    compressedCube.setFormat(Cube::CompressedTile);
+    compressedCube.create("IsisCube_compressed");
+
+    LineManager line(compressedCube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = (line.Line() > 100) ? Null : (double)((i + line.Line()) % 7);
+      }
+      compressedCube.write(line);
+    }
+    compressedCube.close();
+
+    compressedCube.open("IsisCube_compressed.cub", "rw");
+    PvlObject &core = compressedCube.label()->findObject("IsisCube").findObject("Core");
+    cerr << "Format:          " << core["Format"][0] << endl;
+    cerr << "TileCompression: " << core["TileCompression"][0] << endl;
+    cerr << "Format():        " << (compressedCube.format() == Cube::CompressedTile) << endl;
+
+    // Rewrite one line in place, then check every pixel after reopening
+    LineManager rewrite(compressedCube);
+    rewrite.SetLine(150, 2);
+    for (int i = 0; i < rewrite.size(); i++) {
+      rewrite[i] = i;
+    }
+    compressedCube.write(rewrite);
+    compressedCube.close();
+
+    compressedCube.open("IsisCube_compressed.cub");
+    bool matches = true;
+    LineManager readLine(compressedCube);
+    for (readLine.begin(); !readLine.end(); readLine++) {
+      compressedCube.read(readLine);
+      for (int i = 0; i < readLine.size(); i++) {
+        double expected = (readLine.Line() > 100) ? Null :
+                          (double)((i + readLine.Line()) % 7);
+        if (readLine.Line() == 150 && readLine.Band() == 2) {
+          expected = i;
+        }
+        if (readLine[i] != expected) {
+          matches = false;
+        }
+      }
+    }
+    cerr << "Values match:    " << matches << endl;
+    compressedCube.close();
+
+    // The tiles are packed, so the file is much smaller than the raw pixels
+    BigInt rawBytes = 300 * 200 * 2 * 4;
+    cerr << "Packed:          "
+         << (QFileInfo("IsisCube_compressed.cub").size() < 65536 + rawBytes / 4) << endl;
+  }
+
+  cerr << endl << "Test creating a sparse cube" << endl;
+  {
+    Cube sparseCube;
+    sparseCube.setDimensions(1000, 1000, 1);
+    sparseCube.setSparse(true);
+    sparseCube.create("IsisCube_sparse");
+
+    Brick brick(10, 10, 1, sparseCube.pixelType());
+    brick.SetBasePosition(501, 501, 1);
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = i;
+    }
+    sparseCube.write(brick);
+    sparseCube.close();
+
+    sparseCube.open("IsisCube_sparse.cub", "rw");
+    PvlObject &core = sparseCube.label()->findObject("IsisCube").findObject("Core");
+    cerr << "Sparse:          " << core["Sparse"][0] << endl;
+    cerr << "isSparse():      " << sparseCube.isSparse() << endl;
+    cerr << "ChunkPresence:   " << core.hasKeyword("ChunkPresence") << endl;
+    cerr << "Label space:     " << sparseCube.labelSize() << endl;
+
+    bool matches = true;
+    LineManager readLine(sparseCube);
+    for (readLine.begin(); !readLine.end(); readLine++) {
+      sparseCube.read(readLine);
+      for (int i = 0; i < readLine.size(); i++) {
+        double expected = Null;
+        if (readLine.Line() > 500 && readLine.Line() <= 510 && i >= 500 && i < 510) {
+          expected = (readLine.Line() - 501) * 10 + (i - 500);
+        }
+        if (readLine[i] != expected) {
+          matches = false;
+        }
+      }
+    }
+    cerr << "Values match:    " << matches << endl;
+
+    // Writing NULLs over the only data leaves nothing stored
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = Null;
+    }
+    sparseCube.write(brick);
+    sparseCube.close();
+
+    sparseCube.open("IsisCube_sparse.cub");
+    int nullCount = 0;
+    LineManager nullLine(sparseCube);
+    for (nullLine.begin(); !nullLine.end(); nullLine++) {
+      sparseCube.read(nullLine);
+      for (int i = 0; i < nullLine.size(); i++) {
+        if (nullLine[i] == Null) {
+          nullCount++;
+        }
+      }
+    }
+    cerr << "Null pixels:     " << nullCount << endl;
+    sparseCube.close();
+  }
+
+  cerr << endl << "Test a sparse cube whose ChunkPresence does not match its chunks" << endl;
+  {
+    Cube sparseCube;
+    sparseCube.setDimensions(1000, 1000, 1);
+    sparseCube.setSparse(true);
+    sparseCube.setLabelsAttached(false);
+    sparseCube.create("IsisCube_sparseDetached");
+
+    Brick brick(10, 10, 1, sparseCube.pixelType());
+    brick.SetBasePosition(1, 1, 1);
+    for (int i = 0; i < brick.size(); i++) {
+      brick[i] = i;
+    }
+    sparseCube.write(brick);
+    sparseCube.close();
+
+    // Three bytes of presence bits for a cube of four chunks
+    Pvl label("IsisCube_sparseDetached.lbl");
+    PvlObject &core = label.findObject("IsisCube").findObject("Core");
+    core["ChunkPresence"] = QString(qCompress(QByteArray(3, '\0')).toHex());
+    label.write("IsisCube_sparseDetached.lbl");
+
+    try {
+      sparseCube.open("IsisCube_sparseDetached.lbl");
+      sparseCube.read(brick);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+    sparseCube.close();
+
+    core.deleteKeyword("ChunkPresence");
+    label.write("IsisCube_sparseDetached.lbl");
+
+    try {
+      sparseCube.open("IsisCube_sparseDetached.lbl");
+      sparseCube.read(brick);
+    }
+    catch (IException &e) {
+      e.print();
+    }
+    sparseCube.close();
+  }
+
   remove("IsisCube_00.cub");
   remove("IsisCube_01.cub");
   remove("IsisCube_02.cub");
@@ -958,6 +1129,10 @@ int main(int argc, char *argv[]) {
   remove("IsisCube_06.cub");
   remove("IsisCube_boundary.cub");
   remove("IsisCube_bsq.cub");
+  remove("IsisCube_compressed.cub");
+  remove("IsisCube_sparse.cub");
+  remove("IsisCube_sparseDetached.cub");
+  remove("IsisCube_sparseDetached.lbl");
   remove("IsisCube_bsqOneLine.cub");
   remove("IsisCube_largebsq.cub");
   remove("isisTruth_external.ecub");
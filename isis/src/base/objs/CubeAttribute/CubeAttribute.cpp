@@ -290,6 +290,8 @@ namespace Isis {
 
       if (formatString == "BSQ" || formatString == "BANDSEQUENTIAL")
         result = Cube::Bsq;
+      else if (formatString == "COMPRESSEDTILE")
+        result = Cube::CompressedTile;
     }
 
     return result;
@@ -302,8 +304,7 @@ namespace Isis {
 
 
   void CubeAttributeOutput::setFileFormat(Cube::Format fmt) {
-    setAttribute((fmt == Cube::Tile)? "Tile" : "BandSequential",
-                 &CubeAttributeOutput::isFileFormat);
+    setAttribute(toString(fmt), &CubeAttributeOutput::isFileFormat);
   }
 
 
@@ -424,13 +425,30 @@ namespace Isis {
   }
 
 
+  bool CubeAttributeOutput::sparse() const {
+    bool result = false;
+
+    QStringList sparseAtts = attributeList(&CubeAttributeOutput::isSparse);
+    if (!sparseAtts.isEmpty()) {
+      result = (sparseAtts.last() == "SPARSE");
+    }
+
+    return result;
+  }
+
+
+  void CubeAttributeOutput::setSparse(bool sparse) {
+    setAttribute(sparse? "Sparse" : "Dense", &CubeAttributeOutput::isSparse);
+  }
+
+
   bool CubeAttributeOutput::isByteOrder(QString attribute) const {
     return QRegExp("(M|L)SB").exactMatch(attribute);
   }
 
 
   bool CubeAttributeOutput::isFileFormat(QString attribute) const {
-    return QRegExp("(BANDSEQUENTIAL|BSQ|TILE)").exactMatch(attribute);
+    return QRegExp("(BANDSEQUENTIAL|BSQ|TILE|COMPRESSEDTILE)").exactMatch(attribute);
   }
 
 
@@ -450,11 +468,18 @@ namespace Isis {
   }
 
 
+  bool CubeAttributeOutput::isSparse(QString attribute) const {
+    return QRegExp("(SPARSE|DENSE)").exactMatch(attribute);
+  }
+
+
   QString CubeAttributeOutput::toString(Cube::Format format) {
     QString result = "Tile";
 
     if (format == Cube::Bsq)
       result = "BandSequential";
+    else if (format == Cube::CompressedTile)
+      result = "CompressedTile";
 
     return result;
   }
@@ -493,6 +518,7 @@ namespace Isis {
     result.append(&CubeAttributeOutput::isLabelAttachment);
     result.append(&CubeAttributeOutput::isPixelType);
     result.append(&CubeAttributeOutput::isRange);
+    result.append(&CubeAttributeOutput::isSparse);
 
     return result;
   }
@@ -481,6 +481,9 @@ namespace Isis {
    *                           CubeAttribute parent class now. Updated to match current
    *                           coding standards. Added the "+External+ attribute. Added safety
    *                           checks for unrecognized attributes. References #961.
+   *   @history 2018-09-07 Isis Development Team - Added the CompressedTile file format
+   *                           attribute.
+   *   @history 2018-09-07 Isis Development Team - Added the Sparse and Dense attributes.
    */
   class CubeAttributeOutput : public CubeAttribute<CubeAttributeOutput> {
 
@@ -555,6 +558,12 @@ namespace Isis {
 
       LabelAttachment labelAttachment() const;
 
+      //! Return true if chunks that are all NULL are not to be stored
+      bool sparse() const;
+
+      //! Set whether chunks that are all NULL are not to be stored
+      void setSparse(bool sparse);
+
       using CubeAttribute<CubeAttributeOutput>::toString;
 
 
@@ -564,6 +573,7 @@ namespace Isis {
       bool isLabelAttachment(QString attribute) const;
       bool isPixelType(QString attribute) const;
       bool isRange(QString attribute) const;
+      bool isSparse(QString attribute) const;
 
       static QString toString(Cube::Format);
 
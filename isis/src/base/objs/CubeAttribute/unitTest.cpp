@@ -214,6 +214,13 @@ int main(int argc, char *argv[]) {
 
     att.setLabelAttachment(ExternalLabel);
     cout << att.toString() << endl;
+
+    att.setSparse(true);
+    cout << att.toString() << " Sparse = " << att.sparse() << endl;
+
+    att.setFileFormat(Cube::CompressedTile);
+    att.setSparse(false);
+    cout << att.toString() << " Sparse = " << att.sparse() << endl;
   }
   catch (IException &e) {
     e.print();
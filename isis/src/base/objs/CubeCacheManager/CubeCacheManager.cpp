@@ -0,0 +1,555 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include "CubeCacheManager.h"
+
+#include <cstdlib>
+
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#include "CubeIoHandler.h"
+#include "IException.h"
+#include "IString.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+
+namespace Isis {
+
+  /**
+   * Returns the process wide cache manager, creating it the first time. The
+   *   manager is created once even if several threads open cubes at the same
+   *   time, and it is never deleted, so cubes closed after shutdown() can
+   *   still use it.
+   *
+   * @return CubeCacheManager* The cache manager
+   */
+  CubeCacheManager *CubeCacheManager::instance() {
+    static CubeCacheManager *manager = new CubeCacheManager;
+    return manager;
+  }
+
+
+  /**
+   * Creates the manager with the budget from the CubeCacheSize preference.
+   */
+  CubeCacheManager::CubeCacheManager() {
+    m_prefetchingHandler = NULL;
+    m_prefetchRunning = false;
+    m_useCounter = 0;
+    m_cachedBytes = 0;
+    m_heldBytes = 0;
+    m_hits = 0;
+    m_misses = 0;
+    m_prefetches = 0;
+    m_evictions = 0;
+
+    // Off unless the preferences say otherwise
+    m_budget = 0;
+
+    PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+    if (performance.hasKeyword("CubeCacheSize")) {
+      m_budget = (BigInt)(toDouble(performance["CubeCacheSize"][0]) * 1024 * 1024);
+    }
+    m_enabled.storeRelease(m_budget > 0 ? 1 : 0);
+
+    m_prefetchThreadPool = new QThreadPool;
+    m_prefetchThreadPool->setMaxThreadCount(1);
+
+    atexit(shutdown);
+  }
+
+
+  /**
+   * Turns the cache off when the program exits: queued prefetches are
+   *   cancelled, the prefetch in progress is waited for and the cached chunks
+   *   are freed.
+   */
+  void CubeCacheManager::shutdown() {
+    CubeCacheManager *manager = instance();
+
+    {
+      QMutexLocker locker(&manager->m_mutex);
+      manager->m_prefetchQueue.clear();
+      manager->m_budget = 0;
+      manager->m_enabled.storeRelease(0);
+      manager->evict();
+    }
+
+    manager->m_prefetchThreadPool->waitForDone();
+  }
+
+
+  /**
+   * @return The most bytes of chunk data that will be cached
+   */
+  BigInt CubeCacheManager::budget() const {
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+  }
+
+
+  /**
+   * Changes the most bytes of chunk data that will be cached. The least
+   *   recently used chunks are evicted until the cache fits. A budget of zero
+   *   turns the cache off.
+   *
+   * @param bytes The new budget
+   */
+  void CubeCacheManager::setBudget(BigInt bytes) {
+    if (bytes < 0) {
+      QString msg = "The cube cache budget [" + toString(bytes) + " bytes] cannot be negative";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_budget = bytes;
+    m_enabled.storeRelease(m_budget > 0 ? 1 : 0);
+    evict();
+  }
+
+
+  /**
+   * Returns whether the budget is more than zero. This does not lock the
+   *   manager, so IO handlers can skip the cache cheaply when it is off.
+   *
+   * @return bool True if the cache is on
+   */
+  bool CubeCacheManager::isEnabled() const {
+    return m_enabled.loadAcquire() != 0;
+  }
+
+
+  /**
+   * @return The bytes of chunk data cached now
+   */
+  BigInt CubeCacheManager::cachedBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_cachedBytes;
+  }
+
+
+  /**
+   * @return The bytes of chunks the IO handlers hold in their own caches, as
+   *   last reported with handlerAllowance() or setHandlerBytes()
+   */
+  BigInt CubeCacheManager::heldBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_heldBytes;
+  }
+
+
+  /**
+   * @return The number of chunks cached now
+   */
+  int CubeCacheManager::cachedChunkCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_chunks.size();
+  }
+
+
+  /**
+   * @return The number of chunks IO handlers found in the cache
+   */
+  BigInt CubeCacheManager::hitCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+  }
+
+
+  /**
+   * @return The number of chunks IO handlers had to read from disk
+   */
+  BigInt CubeCacheManager::missCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+  }
+
+
+  /**
+   * @return The number of chunks read by prefetches
+   */
+  BigInt CubeCacheManager::prefetchCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_prefetches;
+  }
+
+
+  /**
+   * @return The number of chunks evicted to stay within the budget
+   */
+  BigInt CubeCacheManager::evictionCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_evictions;
+  }
+
+
+  /**
+   * Sets the hit, miss, prefetch and eviction counts back to zero.
+   */
+  void CubeCacheManager::resetCounters() {
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+    m_prefetches = 0;
+    m_evictions = 0;
+  }
+
+
+  /**
+   * Reports the budget, usage and counts of the cache.
+   *
+   * @return PvlGroup A CubeCache group suitable for the application log
+   */
+  PvlGroup CubeCacheManager::report() const {
+    QMutexLocker locker(&m_mutex);
+
+    PvlGroup result("CubeCache");
+    result += PvlKeyword("Budget", toString(m_budget), "bytes");
+    result += PvlKeyword("CachedBytes", toString(m_cachedBytes), "bytes");
+    result += PvlKeyword("CachedChunks", toString(m_chunks.size()));
+    result += PvlKeyword("HeldBytes", toString(m_heldBytes), "bytes");
+    result += PvlKeyword("Hits", toString(m_hits));
+    result += PvlKeyword("Misses", toString(m_misses));
+    result += PvlKeyword("Prefetches", toString(m_prefetches));
+    result += PvlKeyword("Evictions", toString(m_evictions));
+
+    BigInt requests = m_hits + m_misses;
+    result += PvlKeyword("HitRatio",
+                         toString(requests ? (double)m_hits / (double)requests : 0.0));
+
+    return result;
+  }
+
+
+  /**
+   * Looks for the raw data of a chunk. This counts a hit or a miss while the
+   *   cache is on; when it is off this returns false without locking.
+   *
+   * @param handler The IO handler of the chunk's cube
+   * @param chunkIndex The index of the chunk in the cube
+   * @param data (output) The raw chunk data, if it was cached
+   *
+   * @return bool True if the chunk was cached
+   */
+  bool CubeCacheManager::find(const CubeIoHandler *handler, int chunkIndex, QByteArray &data) {
+    if (!isEnabled()) {
+      return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    QHash<ChunkKey, CachedChunk>::iterator chunk = m_chunks.find(ChunkKey(handler, chunkIndex));
+    if (chunk == m_chunks.end()) {
+      m_misses++;
+      return false;
+    }
+
+    m_hits++;
+
+    m_useOrder.remove(chunk->lastUse);
+    chunk->lastUse = ++m_useCounter;
+    m_useOrder.insert(chunk->lastUse, chunk.key());
+
+    data = chunk->data;
+    return true;
+  }
+
+
+  /**
+   * Caches the raw data of a chunk that was just read from disk.
+   *
+   * @param handler The IO handler of the chunk's cube
+   * @param chunkIndex The index of the chunk in the cube
+   * @param data The raw chunk data
+   */
+  void CubeCacheManager::insert(const CubeIoHandler *handler, int chunkIndex,
+                                const QByteArray &data) {
+    if (!isEnabled()) {
+      return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    store(ChunkKey(handler, chunkIndex), data);
+  }
+
+
+  /**
+   * Drops the cached data of a chunk because the chunk has been written.
+   *   Prefetches of the cube's chunks that are reading at the same time are
+   *   not cached.
+   *
+   * @param handler The IO handler of the chunk's cube
+   * @param chunkIndex The index of the chunk in the cube
+   */
+  void CubeCacheManager::invalidate(const CubeIoHandler *handler, int chunkIndex) {
+    QMutexLocker locker(&m_mutex);
+    m_generations[handler]++;
+    remove(ChunkKey(handler, chunkIndex));
+  }
+
+
+  /**
+   * Queues chunks to be read into the cache on the prefetch thread. Chunks
+   *   that are already cached or queued are skipped.
+   *
+   * @param handler The IO handler of the chunks' cube
+   * @param chunkIndices The indices of the chunks that will be read soon
+   */
+  void CubeCacheManager::prefetch(const CubeIoHandler *handler, const QList<int> &chunkIndices) {
+    if (!isEnabled()) {
+      return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_budget == 0) {
+      return;
+    }
+
+    foreach (int chunkIndex, chunkIndices) {
+      ChunkKey key(handler, chunkIndex);
+      if (!m_chunks.contains(key) && !m_prefetchQueue.contains(key)) {
+        m_prefetchQueue.append(key);
+      }
+    }
+
+    if (!m_prefetchRunning && !m_prefetchQueue.isEmpty()) {
+      m_prefetchRunning = true;
+      m_prefetchThreadPool->start(new PrefetchRunner(this));
+    }
+  }
+
+
+  /**
+   * Forgets an IO handler: its queued prefetches are cancelled, a prefetch
+   *   reading from it is waited for, and its cached chunks are dropped. IO
+   *   handlers call this before they stop being able to read.
+   *
+   * @param handler The IO handler to forget
+   */
+  void CubeCacheManager::removeHandler(const CubeIoHandler *handler) {
+    QMutexLocker locker(&m_mutex);
+
+    QMutableListIterator<ChunkKey> queueIterator(m_prefetchQueue);
+    while (queueIterator.hasNext()) {
+      if (queueIterator.next().first == handler) {
+        queueIterator.remove();
+      }
+    }
+
+    while (m_prefetchingHandler == handler) {
+      m_prefetchFinished.wait(&m_mutex);
+    }
+
+    QList<ChunkKey> keys = m_chunks.keys();
+    foreach (const ChunkKey &key, keys) {
+      if (key.first == handler) {
+        remove(key);
+      }
+    }
+
+    m_generations.remove(handler);
+    setHandlerBytes(handler, 0);
+  }
+
+
+  /**
+   * Records the bytes of chunks an IO handler holds in its own cache and
+   *   returns how many it may keep. The budget covers these chunks as well as
+   *   the chunks of this cache, so cached chunks are evicted first. If the IO
+   *   handlers alone hold more than the budget, the handler may keep what the
+   *   other handlers leave of the budget, or an even share of the budget,
+   *   whichever is more. A chunk that is in both caches is counted twice, so
+   *   the budget errs on the side of using less memory.
+   *
+   * @param handler The IO handler
+   * @param heldBytes The bytes of chunks the IO handler holds now
+   *
+   * @return BigInt The most bytes of chunks the IO handler should hold, or -1
+   *   if the cache is off
+   */
+  BigInt CubeCacheManager::handlerAllowance(const CubeIoHandler *handler, BigInt heldBytes) {
+    if (!isEnabled()) {
+      return -1;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    setHandlerBytes(handler, heldBytes);
+    evict();
+
+    if (m_budget == 0) {
+      return -1;
+    }
+
+    BigInt otherBytes = m_heldBytes - heldBytes;
+    BigInt share = m_budget / qMax(1, m_handlerBytes.size());
+    return qMax(m_budget - m_cachedBytes - otherBytes, share);
+  }
+
+
+  /**
+   * Records the bytes of chunks an IO handler holds in its own cache after it
+   *   freed chunks to stay within its allowance.
+   *
+   * @param handler The IO handler
+   * @param heldBytes The bytes of chunks the IO handler holds now
+   */
+  void CubeCacheManager::updateHandlerBytes(const CubeIoHandler *handler, BigInt heldBytes) {
+    QMutexLocker locker(&m_mutex);
+    setHandlerBytes(handler, heldBytes);
+  }
+
+
+  /**
+   * Blocks until every queued prefetch has been read.
+   */
+  void CubeCacheManager::waitForPrefetches() {
+    QMutexLocker locker(&m_mutex);
+
+    while (m_prefetchRunning) {
+      m_prefetchFinished.wait(&m_mutex);
+    }
+  }
+
+
+  /**
+   * Reads the queued prefetches one at a time. The manager is not locked
+   *   while a chunk is read, so IO handlers can use the cache meanwhile. A
+   *   chunk is only cached if its cube was not written during the read.
+   */
+  void CubeCacheManager::runPrefetches() {
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_prefetchQueue.isEmpty()) {
+      ChunkKey key = m_prefetchQueue.takeFirst();
+
+      if (m_chunks.contains(key)) {
+        continue;
+      }
+
+      quint64 generation = m_generations.value(key.first);
+      m_prefetchingHandler = key.first;
+      locker.unlock();
+
+      QByteArray data;
+      bool success = false;
+      try {
+        data = const_cast<CubeIoHandler *>(key.first)->prefetchChunk(key.second);
+        success = true;
+      }
+      catch (IException &) {
+        // Prefetches are only hints; the read will be tried again when needed
+      }
+
+      locker.relock();
+      if (success && generation == m_generations.value(key.first) &&
+          !m_chunks.contains(key)) {
+        m_prefetches++;
+        store(key, data);
+      }
+
+      m_prefetchingHandler = NULL;
+      m_prefetchFinished.wakeAll();
+    }
+
+    m_prefetchRunning = false;
+    m_prefetchFinished.wakeAll();
+  }
+
+
+  /**
+   * Caches a chunk as the most recently used, then evicts chunks to stay
+   *   within the budget. The mutex must be locked.
+   *
+   * @param key The chunk
+   * @param data The raw chunk data
+   */
+  void CubeCacheManager::store(const ChunkKey &key, const QByteArray &data) {
+    if (m_budget == 0) {
+      return;
+    }
+
+    remove(key);
+
+    CachedChunk chunk;
+    chunk.data = data;
+    chunk.lastUse = ++m_useCounter;
+
+    m_chunks.insert(key, chunk);
+    m_useOrder.insert(chunk.lastUse, key);
+    m_cachedBytes += data.size();
+
+    evict();
+  }
+
+
+  /**
+   * Records the bytes of chunks an IO handler holds. The mutex must be
+   *   locked.
+   *
+   * @param handler The IO handler
+   * @param heldBytes The bytes of chunks the IO handler holds, 0 to forget it
+   */
+  void CubeCacheManager::setHandlerBytes(const CubeIoHandler *handler, BigInt heldBytes) {
+    m_heldBytes -= m_handlerBytes.value(handler, 0);
+
+    if (heldBytes > 0) {
+      m_handlerBytes[handler] = heldBytes;
+      m_heldBytes += heldBytes;
+    }
+    else {
+      m_handlerBytes.remove(handler);
+    }
+  }
+
+
+  /**
+   * Drops a chunk from the cache if it is cached. The mutex must be locked.
+   *
+   * @param key The chunk
+   */
+  void CubeCacheManager::remove(const ChunkKey &key) {
+    QHash<ChunkKey, CachedChunk>::iterator chunk = m_chunks.find(key);
+    if (chunk != m_chunks.end()) {
+      m_cachedBytes -= chunk->data.size();
+      m_useOrder.remove(chunk->lastUse);
+      m_chunks.erase(chunk);
+    }
+  }
+
+
+  /**
+   * Evicts the least recently used chunks until the cache and the chunks the
+   *   IO handlers hold are within the budget, or the cache is empty. The mutex
+   *   must be locked.
+   */
+  void CubeCacheManager::evict() {
+    while (m_cachedBytes + m_heldBytes > m_budget && !m_useOrder.isEmpty()) {
+      ChunkKey oldest = m_useOrder.begin().value();
+      remove(oldest);
+      m_evictions++;
+    }
+  }
+}
@@ -0,0 +1,193 @@
+#ifndef CubeCacheManager_h
+#define CubeCacheManager_h
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QRunnable>
+#include <QWaitCondition>
+
+#include "Constants.h"
+
+class QThreadPool;
+
+namespace Isis {
+  class CubeIoHandler;
+  class PvlGroup;
+
+  /**
+   * @brief A process wide cache of cube chunks with a memory budget
+   *
+   * Every CubeIoHandler keeps the chunks it is using in its own small cache
+   * and frees them as soon as its caching algorithm allows. This class keeps
+   * a second, process wide cache of the raw data of chunks read from disk,
+   * shared by every open cube, so programs that hold many cubes open, or read
+   * the same areas of a cube more than once, do not read chunks from disk
+   * again. The cache is limited to a byte budget across all cubes and evicts
+   * the least recently used chunks first. The budget comes from the
+   * CubeCacheSize keyword, in megabytes, of the Performance preferences group.
+   * A budget of zero, the default, turns the cache off.
+   *
+   * The budget covers the chunks the IO handlers hold in their own caches as
+   * well as the chunks of this cache. After each read or write, an IO handler
+   * reports the chunks it holds with handlerAllowance(), which evicts cached
+   * chunks first and then tells the handler how much it may keep, so the
+   * handler frees the chunks it did not just use. The chunks of the read or
+   * write in progress are always kept, so a program whose single reads need
+   * more than the budget uses more.
+   *
+   * Programs that know which areas they will read next can give prefetch
+   * hints with Cube::prefetch(). The chunks of the area are read into this
+   * cache on a separate thread, so a later read of the area does not wait for
+   * the disk. Prefetches are only hints: chunks that are already cached, or
+   * that have never been written, are skipped, and read errors are ignored.
+   *
+   * The cached data of a chunk is dropped when the chunk is written to disk,
+   * and all of a cube's chunks are dropped when its IO cache is cleared or
+   * the cube is closed. The raw data is implicitly shared with the chunks of
+   * the IO handlers, so a chunk in both caches is only in memory once.
+   *
+   * The counts of hits, misses, prefetches and evictions are reported with
+   * report(). Application writes the report into the program log after each
+   * run that used the cache.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version.
+   *   @history 2018-09-07 Isis Development Team - The budget now also covers the
+   *                           chunks IO handlers hold. instance() creates the
+   *                           manager once under concurrent use, and find(), insert()
+   *                           and prefetch() return without locking when the cache
+   *                           is off.
+   */
+  class CubeCacheManager {
+    public:
+      static CubeCacheManager *instance();
+
+      BigInt budget() const;
+      void setBudget(BigInt bytes);
+      bool isEnabled() const;
+      BigInt cachedBytes() const;
+      BigInt heldBytes() const;
+      int cachedChunkCount() const;
+
+      BigInt hitCount() const;
+      BigInt missCount() const;
+      BigInt prefetchCount() const;
+      BigInt evictionCount() const;
+      void resetCounters();
+      PvlGroup report() const;
+
+      bool find(const CubeIoHandler *handler, int chunkIndex, QByteArray &data);
+      void insert(const CubeIoHandler *handler, int chunkIndex, const QByteArray &data);
+      void invalidate(const CubeIoHandler *handler, int chunkIndex);
+      void prefetch(const CubeIoHandler *handler, const QList<int> &chunkIndices);
+      void removeHandler(const CubeIoHandler *handler);
+      BigInt handlerAllowance(const CubeIoHandler *handler, BigInt heldBytes);
+      void updateHandlerBytes(const CubeIoHandler *handler, BigInt heldBytes);
+      void waitForPrefetches();
+
+    private:
+      //! Identifies a chunk: the IO handler of its cube and its chunk index
+      typedef QPair<const CubeIoHandler *, int> ChunkKey;
+
+      //! The raw data of a cached chunk
+      struct CachedChunk {
+        QByteArray data;  //!< The raw chunk bytes, as read from disk
+        quint64 lastUse;  //!< The use counter value when last used
+      };
+
+      /**
+       * Reads the queued prefetches on the prefetch thread until the queue
+       *   is empty.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      class PrefetchRunner : public QRunnable {
+        public:
+          /**
+           * @param manager The manager with the prefetch queue
+           */
+          PrefetchRunner(CubeCacheManager *manager) : m_manager(manager) {
+          }
+
+          //! Reads every queued prefetch
+          void run() {
+            m_manager->runPrefetches();
+          }
+
+        private:
+          CubeCacheManager *m_manager; //!< The manager with the prefetch queue
+      };
+
+      CubeCacheManager();
+      // Never destroyed, see instance()
+      ~CubeCacheManager();
+
+      CubeCacheManager(const CubeCacheManager &other);
+      CubeCacheManager &operator=(const CubeCacheManager &other);
+
+      static void shutdown();
+
+      void runPrefetches();
+      void store(const ChunkKey &key, const QByteArray &data);
+      void setHandlerBytes(const CubeIoHandler *handler, BigInt heldBytes);
+      void remove(const ChunkKey &key);
+      void evict();
+
+      QAtomicInt m_enabled;                //!< 1 while the budget is more than zero
+      mutable QMutex m_mutex;              //!< Guards everything below
+      QWaitCondition m_prefetchFinished;   //!< Signaled after each prefetch read
+
+      QHash<ChunkKey, CachedChunk> m_chunks;      //!< The cached chunks
+      QMap<quint64, ChunkKey> m_useOrder;         //!< Chunks by last use, oldest first
+      QHash<const CubeIoHandler *, quint64> m_generations; //!< Writes seen per handler
+      QHash<const CubeIoHandler *, BigInt> m_handlerBytes; //!< Bytes each handler holds
+      QList<ChunkKey> m_prefetchQueue;            //!< Chunks waiting to be prefetched
+      const CubeIoHandler *m_prefetchingHandler;  //!< Handler being read by a prefetch
+      bool m_prefetchRunning;                     //!< True while a PrefetchRunner runs
+      QThreadPool *m_prefetchThreadPool;          //!< Runs the PrefetchRunner
+
+      quint64 m_useCounter;  //!< Increases with every use of a chunk
+      BigInt m_budget;       //!< The most bytes to cache
+      BigInt m_cachedBytes;  //!< The bytes cached now
+      BigInt m_heldBytes;    //!< The bytes the IO handlers hold now
+      BigInt m_hits;         //!< Chunks found in the cache
+      BigInt m_misses;       //!< Chunks not found in the cache
+      BigInt m_prefetches;   //!< Chunks read by prefetches
+      BigInt m_evictions;    //!< Chunks evicted to stay in the budget
+  };
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include <iostream>
+
+#include <QFile>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "CubeCacheManager.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+
+using namespace std;
+using namespace Isis;
+
+void readAll(Cube &cube);
+
+int main() {
+  Preference::Preferences(true);
+
+  CubeCacheManager *manager = CubeCacheManager::instance();
+  cout << "Default budget: " << manager->budget() << endl;
+  manager->setBudget(256 * 1024 * 1024);
+  cout << "Budget: " << manager->budget() << endl;
+  cout << endl;
+
+  cout << "Creating test cube" << endl;
+  {
+    Cube cube;
+    cube.setDimensions(1024, 1024, 1);
+    cube.create("junk.cub");
+    LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = i + line.Line();
+      }
+      cube.write(line);
+    }
+    cube.close();
+  }
+  cout << endl;
+
+  Cube cube;
+  cube.open("junk.cub");
+  int chunkCount = (1024 / cube.sampleCountInChunk()) * (1024 / cube.lineCountInChunk());
+  cout << "Chunks in cube: " << chunkCount << endl;
+  cout << endl;
+
+  cout << "Testing reading the cube twice" << endl;
+  manager->resetCounters();
+  readAll(cube);
+  cout << "Misses after the first read:  " << manager->missCount() << endl;
+  cout << "Hits after the first read:    " << manager->hitCount() << endl;
+  readAll(cube);
+  cout << "Misses after the second read: " << manager->missCount() << endl;
+  cout << "Hits after the second read:   " << manager->hitCount() << endl;
+  cout << "Cached chunks:                " << manager->cachedChunkCount() << endl;
+  cout << endl;
+
+  cout << "Held bytes:                   " << manager->heldBytes() << endl;
+  cout << endl;
+
+  cout << "Testing a smaller budget" << endl;
+  manager->setBudget(4 * 512 * 512 * 4);
+  cout << "Cached chunks: " << manager->cachedChunkCount() << endl;
+  cout << "Cached bytes:  " << manager->cachedBytes() << endl;
+  cout << "Evictions:     " << manager->evictionCount() << endl;
+  manager->setBudget(256 * 1024 * 1024);
+  cout << endl;
+
+  cout << "Testing clearing the cube's IO cache" << endl;
+  cube.clearIoCache();
+  cout << "Cached chunks: " << manager->cachedChunkCount() << endl;
+  cout << endl;
+
+  cout << "Testing prefetching the cube" << endl;
+  manager->resetCounters();
+  Brick area(1024, 1024, 1, cube.pixelType());
+  area.SetBasePosition(1, 1, 1);
+  cube.prefetch(area);
+  manager->waitForPrefetches();
+  readAll(cube);
+  PvlGroup report = manager->report();
+  for (int i = 0; i < report.keywords(); i++) {
+    cout << report[i].name() << " = " << report[i][0] << endl;
+  }
+  cout << endl;
+
+  cout << "Testing writing invalidates the cache" << endl;
+  cube.close();
+  cube.open("junk.cub", "rw");
+  readAll(cube);
+  LineManager line(cube);
+  line.SetLine(1);
+  for (int i = 0; i < line.size(); i++) {
+    line[i] = -1.0;
+  }
+  cube.write(line);
+  // Reading the bottom of the cube writes the top chunks out of the IO cache
+  line.SetLine(1000);
+  cube.read(line);
+  line.SetLine(1);
+  cube.read(line);
+  cout << "First pixel after writing: " << line[0] << endl;
+  cube.close();
+  cout << endl;
+
+  cout << "Testing the budget limits the chunks the cube holds" << endl;
+  manager->setBudget(512 * 512 * 4);
+  cube.open("junk.cub");
+  line.SetLine(1);
+  cube.read(line);
+  line.SetLine(513);
+  cube.read(line);
+  cout << "Held bytes while reading lines: " << manager->heldBytes() << endl;
+  // Overlaps the right edge of the cube, so only one chunk is used
+  Brick wide(1024, 1, 1, cube.pixelType());
+  wide.SetBasePosition(513, 1, 1);
+  cube.read(wide);
+  cout << "Held bytes after a smaller read: " << manager->heldBytes() << endl;
+  cout << "Cached bytes:                    " << manager->cachedBytes() << endl;
+  cube.close();
+  cout << "Held bytes after closing:        " << manager->heldBytes() << endl;
+  manager->setBudget(256 * 1024 * 1024);
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  try {
+    manager->setBudget(-1);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    Cube closedCube;
+    closedCube.prefetch(area);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  QFile::remove("junk.cub");
+
+  return 0;
+}
+
+
+/**
+ * Reads every line of a cube.
+ */
+void readAll(Cube &cube) {
+  LineManager line(cube);
+  for (line.begin(); !line.end(); line++) {
+    cube.read(line);
+  }
+}
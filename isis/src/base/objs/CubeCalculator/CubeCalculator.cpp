@@ -24,6 +24,7 @@
 #include <QVector>
 
 #include "Angle.h"
+#include "CalculatorProgram.h"
 #include "Camera.h"
 #include "Distance.h"
 #include "IString.h"
@@ -41,6 +42,10 @@ namespace Isis {
     m_cubeStats       = NULL;
     m_cubeCameras     = NULL;
     m_cameraBuffers   = NULL;
+    m_program         = NULL;
+    m_programInputs   = NULL;
+    m_programInputSizes = NULL;
+    m_sampleValues    = NULL;
 
     m_calculations    = new QVector<Calculations>();
     m_methods         = new QVector<void (Calculator:: *)(void)>();
@@ -48,8 +53,14 @@ namespace Isis {
     m_cubeStats       = new QVector<Statistics *>();
     m_cubeCameras     = new QVector<Camera *>();
     m_cameraBuffers   = new QVector<CameraBuffers *>();
+    m_program         = new CalculatorProgram();
+    m_programInputs   = new QVector<const double *>();
+    m_programInputSizes = new QVector<int>();
+    m_sampleValues    = new QVector<double>();
 
     m_outputSamples = 0;
+    m_currentLine = 0.0;
+    m_currentBand = 0.0;
   }
 
   
@@ -63,6 +74,10 @@ namespace Isis {
     delete m_cubeStats;
     delete m_cubeCameras;
     delete m_cameraBuffers;
+    delete m_program;
+    delete m_programInputs;
+    delete m_programInputSizes;
+    delete m_sampleValues;
     
     m_calculations = NULL;
     m_methods = NULL;
@@ -70,6 +85,10 @@ namespace Isis {
     m_cubeStats = NULL;
     m_cubeCameras = NULL;
     m_cameraBuffers = NULL;
+    m_program = NULL;
+    m_programInputs = NULL;
+    m_programInputSizes = NULL;
+    m_sampleValues = NULL;
   }
   
   
@@ -112,11 +131,17 @@ namespace Isis {
       }
       m_cameraBuffers->clear();
     }
+
+    if (m_program) {
+      m_program->clear();
+    }
   }
 
   
   /**
    * This method will execute the calculations built up when PrepareCalculations was called.
+   *   When the calculations were compiled into a CalculatorProgram, the line is evaluated
+   *   by the program without using the calculator's stack.
    *
    * @param cubeData The input cubes' data
    * @param curLine The current line in the output cube
@@ -129,6 +154,10 @@ namespace Isis {
   QVector<double> CubeCalculator::runCalculations(QVector<Buffer *> &cubeData,
                                                   int curLine, 
                                                   int curBand) {
+    if (m_program->isValid() && StackSize() == 0) {
+      return runProgram(cubeData, curLine, curBand);
+    }
+
     // For now we'll only process a single line in this method for our results. In order
     //    to do more powerful indexing, passing a list of cubes and the output cube will
     //    be necessary.
@@ -154,84 +183,16 @@ namespace Isis {
           Push(curLine);
         }
         else if (data.type() == DataValue::Sample) {
-          QVector<double> samples;
-          samples.resize(m_outputSamples);
-
-          for (int i = 0; i < m_outputSamples; i++) {
-            samples[i] = i + 1;
-          }
-
-          Push(samples);
+          Push(*m_sampleValues);
         }
         else if (data.type() == DataValue::CubeData) {
           Push(*cubeData[data.cubeIndex()]);
         }
-        else if (data.type() == DataValue::InaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::EmaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::PhaData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phaBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::InalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::EmalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::PhalData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phalBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::LatData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->latBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::LonData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->lonBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::ResData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->resBuffer(curLine,
-                                                                 m_outputSamples,
-                                                                 curBand)));
-        }
-        else if (data.type() == DataValue::RadiusData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->radiusBuffer(curLine,
-                                                                    m_outputSamples,
-                                                                    curBand)));
-        }
-        else if (data.type() == DataValue::InacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->inacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::EmacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->emacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
-        else if (data.type() == DataValue::PhacData) {
-          Push(*((*m_cameraBuffers)[data.cubeIndex()]->phacBuffer(curLine,
-                                                                  m_outputSamples,
-                                                                  curBand)));
-        }
         else {
+          QVector<double> *buffer = cameraBuffer(data, curLine, curBand);
+          if (buffer) {
+            Push(*buffer);
+          }
         }
 
         dataIndex ++;
@@ -247,6 +208,118 @@ namespace Isis {
   }
 
 
+  /**
+   * Evaluates the compiled calculations for a line. Each data definition is an input of
+   *   the program: cube data is read from the buffers in place, and the line, band, sample
+   *   and camera values are passed without copying them onto a stack.
+   *
+   * @param cubeData The input cubes' data
+   * @param curLine The current line in the output cube
+   * @param curBand The current band in the output cube
+   *
+   * @return QVector<double> The results of the calculations (with Isis Special Pixels)
+   */
+  QVector<double> CubeCalculator::runProgram(QVector<Buffer *> &cubeData,
+                                             int curLine, int curBand) {
+    m_currentLine = curLine;
+    m_currentBand = curBand;
+
+    for (int dataIndex = 0; dataIndex < m_dataDefinitions->size(); dataIndex++) {
+      DataValue &data = (*m_dataDefinitions)[dataIndex];
+      const double *values = NULL;
+      int size = 0;
+
+      if (data.type() == DataValue::Band) {
+        values = &m_currentBand;
+        size = 1;
+      }
+      else if (data.type() == DataValue::Line) {
+        values = &m_currentLine;
+        size = 1;
+      }
+      else if (data.type() == DataValue::Sample) {
+        values = m_sampleValues->constData();
+        size = m_sampleValues->size();
+      }
+      else if (data.type() == DataValue::CubeData) {
+        Buffer *buffer = cubeData[data.cubeIndex()];
+        values = buffer->DoubleBuffer();
+        size = buffer->size();
+      }
+      else if (data.type() != DataValue::Constant) {
+        QVector<double> *buffer = cameraBuffer(data, curLine, curBand);
+        if (buffer) {
+          values = buffer->constData();
+          size = buffer->size();
+        }
+      }
+
+      (*m_programInputs)[dataIndex] = values;
+      (*m_programInputSizes)[dataIndex] = size;
+    }
+
+    QVector<double> results;
+    m_program->evaluate(*m_programInputs, *m_programInputSizes, results);
+    return results;
+  }
+
+
+  /**
+   * Loads and returns the camera buffer for a camera data definition.
+   *
+   * @param data The data definition
+   * @param curLine The current line in the output cube
+   * @param curBand The current band in the output cube
+   *
+   * @return QVector<double>* The camera values for the line, or NULL if the data definition
+   *                          is not camera data
+   */
+  QVector<double> *CubeCalculator::cameraBuffer(DataValue &data, int curLine, int curBand) {
+    if (data.type() == DataValue::InaData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->inaBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::EmaData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->emaBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::PhaData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->phaBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::InalData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->inalBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::EmalData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->emalBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::PhalData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->phalBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::LatData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->latBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::LonData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->lonBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::ResData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->resBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::RadiusData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->radiusBuffer(curLine, m_outputSamples,
+                                                                curBand);
+    }
+    else if (data.type() == DataValue::InacData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->inacBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::EmacData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->emacBuffer(curLine, m_outputSamples, curBand);
+    }
+    else if (data.type() == DataValue::PhacData) {
+      return (*m_cameraBuffers)[data.cubeIndex()]->phacBuffer(curLine, m_outputSamples, curBand);
+    }
+
+    return NULL;
+  }
+
+
   /**
    * This method builds a list of actions to perform based on the postfix expression.
    *   Error checking is done using the inCubeInfos, and the outCubeInfo is necessary
@@ -268,6 +341,11 @@ namespace Isis {
 
     m_outputSamples = outCube->sampleCount();
 
+    m_sampleValues->resize(m_outputSamples);
+    for (int i = 0; i < m_outputSamples; i++) {
+      (*m_sampleValues)[i] = i + 1;
+    }
+
     IString eq = equation;
     while (eq != "") {
       IString token = eq.Token(" ");
@@ -696,6 +774,120 @@ namespace Isis {
         throw IException(IException::Unknown, msg, _FILEINFO_);
       }
     } // while loop
+
+    compileCalculations();
+  }
+
+
+  /**
+   * Compiles the list of actions built by prepareCalculations(...) into a CalculatorProgram.
+   *   Each data definition becomes an input of the program; cube data is mapped from
+   *   special pixels the same way Calculator::Push(Buffer &) maps it. If the actions can't
+   *   be compiled, for example because the equation is missing operands, the program is
+   *   left invalid and runCalculations(...) uses the calculator's stack, which reports the
+   *   error.
+   */
+  void CubeCalculator::compileCalculations() {
+    m_program->clear();
+    m_programInputs->fill(NULL, m_dataDefinitions->size());
+    m_programInputSizes->fill(0, m_dataDefinitions->size());
+
+    int methodIndex = 0;
+    int dataIndex = 0;
+    bool compiled = true;
+
+    for (int currentCalculation = 0;
+         compiled && currentCalculation < m_calculations->size();
+         currentCalculation++) {
+      if ((*m_calculations)[currentCalculation] == CallNextMethod) {
+        CalculatorProgram::Operation operation;
+        compiled = programOperation((*m_methods)[methodIndex], operation) &&
+                   m_program->addOperation(operation);
+        methodIndex++;
+      }
+      else {
+        DataValue &data = (*m_dataDefinitions)[dataIndex];
+        if (data.type() == DataValue::Constant) {
+          m_program->pushConstant(data.constant());
+        }
+        else {
+          m_program->pushInput(dataIndex, data.type() == DataValue::CubeData);
+        }
+        dataIndex++;
+      }
+    }
+
+    if (!compiled) {
+      m_program->clear();
+    }
+  }
+
+
+  /**
+   * Finds the CalculatorProgram operation for a calculator method.
+   *
+   * @param method The calculator method, i.e. &Calculator::Multiply
+   * @param operation [out] The matching operation
+   *
+   * @return bool False if the method has no matching operation
+   */
+  bool CubeCalculator::programOperation(void (Calculator::*method)(void),
+                                        CalculatorProgram::Operation &operation) {
+    struct MethodOperation {
+      void (Calculator::*method)(void);
+      CalculatorProgram::Operation operation;
+    };
+
+    static const MethodOperation methodOperations[] = {
+      { &Calculator::Add,                CalculatorProgram::Add },
+      { &Calculator::Subtract,           CalculatorProgram::Subtract },
+      { &Calculator::Multiply,           CalculatorProgram::Multiply },
+      { &Calculator::Divide,             CalculatorProgram::Divide },
+      { &Calculator::Modulus,            CalculatorProgram::Modulus },
+      { &Calculator::Exponent,           CalculatorProgram::Exponent },
+      { &Calculator::Negative,           CalculatorProgram::Negative },
+      { &Calculator::LeftShift,          CalculatorProgram::LeftShift },
+      { &Calculator::RightShift,         CalculatorProgram::RightShift },
+      { &Calculator::MaximumLine,        CalculatorProgram::MaximumLine },
+      { &Calculator::MaximumPixel,       CalculatorProgram::MaximumPixel },
+      { &Calculator::MinimumLine,        CalculatorProgram::MinimumLine },
+      { &Calculator::MinimumPixel,       CalculatorProgram::MinimumPixel },
+      { &Calculator::AbsoluteValue,      CalculatorProgram::AbsoluteValue },
+      { &Calculator::SquareRoot,         CalculatorProgram::SquareRoot },
+      { &Calculator::Log,                CalculatorProgram::Log },
+      { &Calculator::Log10,              CalculatorProgram::Log10 },
+      { &Calculator::Sine,               CalculatorProgram::Sine },
+      { &Calculator::Cosine,             CalculatorProgram::Cosine },
+      { &Calculator::Tangent,            CalculatorProgram::Tangent },
+      { &Calculator::Secant,             CalculatorProgram::Secant },
+      { &Calculator::Cosecant,           CalculatorProgram::Cosecant },
+      { &Calculator::Cotangent,          CalculatorProgram::Cotangent },
+      { &Calculator::Arcsine,            CalculatorProgram::Arcsine },
+      { &Calculator::Arccosine,          CalculatorProgram::Arccosine },
+      { &Calculator::Arctangent,         CalculatorProgram::Arctangent },
+      { &Calculator::Arctangent2,        CalculatorProgram::Arctangent2 },
+      { &Calculator::SineH,              CalculatorProgram::SineH },
+      { &Calculator::CosineH,            CalculatorProgram::CosineH },
+      { &Calculator::TangentH,           CalculatorProgram::TangentH },
+      { &Calculator::LessThan,           CalculatorProgram::LessThan },
+      { &Calculator::GreaterThan,        CalculatorProgram::GreaterThan },
+      { &Calculator::LessThanOrEqual,    CalculatorProgram::LessThanOrEqual },
+      { &Calculator::GreaterThanOrEqual, CalculatorProgram::GreaterThanOrEqual },
+      { &Calculator::Equal,              CalculatorProgram::Equal },
+      { &Calculator::NotEqual,           CalculatorProgram::NotEqual },
+      { &Calculator::And,                CalculatorProgram::And },
+      { &Calculator::Or,                 CalculatorProgram::Or }
+    };
+
+    int count = sizeof(methodOperations) / sizeof(methodOperations[0]);
+    for (int i = 0; i < count; i++) {
+      if (methodOperations[i].method == method) {
+        operation = methodOperations[i].operation;
+        return true;
+      }
+    }
+
+    return false;
   }
 
 
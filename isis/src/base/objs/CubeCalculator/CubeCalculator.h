@@ -25,6 +25,7 @@
 #define CUBE_CALCULATOR_H_
 
 #include "Calculator.h"
+#include "CalculatorProgram.h"
 #include "Cube.h"
 
 class QString;
@@ -68,6 +69,11 @@ namespace Isis {
    *                          changes for correctly calculating camera angles for band-dependent
    *                          images. Quick documentation and coding standards review (moved
    *                          inline implementations to cpp). Fixes #1301.
+   *  @history 2018-09-07 Isis Development Team - prepareCalculations() now compiles the
+   *                          calculations into a CalculatorProgram, which runCalculations()
+   *                          evaluates a line at a time without pushing vectors on the
+   *                          calculator's stack. Equations that can't be compiled still run
+   *                          on the stack.
    */
   class CubeCalculator : Calculator {
     public:
@@ -102,6 +108,13 @@ namespace Isis {
 
       void addMethodCall(void (Calculator::*method)(void));
 
+      void compileCalculations();
+      static bool programOperation(void (Calculator::*method)(void),
+                                   CalculatorProgram::Operation &operation);
+
+      QVector<double> runProgram(QVector<Buffer *> &cubeData, int curLine, int curBand);
+      QVector<double> *cameraBuffer(DataValue &data, int curLine, int curBand);
+
       int lastPushToCubeStats(QVector<Cube *> &inCubes);
 
       int lastPushToCubeCameras(QVector<Cube *> &inCubes);
@@ -135,6 +148,21 @@ namespace Isis {
       QVector<CameraBuffers *> *m_cameraBuffers;
 
       int m_outputSamples; //!< Number of samples in the output cube.
+
+      //! The compiled calculations, not valid if they could not be compiled.
+      CalculatorProgram *m_program;
+
+      //! The program's input arrays, one per data definition.
+      QVector<const double *> *m_programInputs;
+
+      //! The number of values in each of the program's inputs.
+      QVector<int> *m_programInputSizes;
+
+      //! The sample numbers of the output cube, pushed for the sample token.
+      QVector<double> *m_sampleValues;
+
+      double m_currentLine; //!< The line being calculated, an input of the program.
+      double m_currentBand; //!< The band being calculated, an input of the program.
   };
 
 
@@ -0,0 +1,282 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "CubeStatisticsCache.h"
+
+#include <cstring>
+
+#include <QByteArray>
+#include <QDataStream>
+
+#include "Cube.h"
+#include "CubeStatisticsDriver.h"
+#include "Histogram.h"
+#include "IException.h"
+#include "IString.h"
+#include "Progress.h"
+#include "Statistics.h"
+
+using namespace std;
+
+namespace Isis {
+
+  /**
+   * Constructs an empty cache, ready to be read from a cube.
+   */
+  CubeStatisticsCache::CubeStatisticsCache() : Isis::Blob("IsisCube", "BandStatistics") {
+  }
+
+
+  /**
+   * Constructs a cache by gathering the statistics and histogram of every band
+   * of a cube. The results are the same as those of Cube::statistics(band) and
+   * Cube::histogram(band).
+   *
+   * Each band is read once, or twice for Real pixels, whose histogram range
+   * comes from the statistics.
+   *
+   * @param cube The cube to gather from. It must be open.
+   * @param progress Reports each pass over each band, may be NULL
+   */
+  CubeStatisticsCache::CubeStatisticsCache(Cube &cube, Progress *progress) :
+      Isis::Blob("IsisCube", "BandStatistics") {
+    try {
+      CubeStatisticsDriver driver(cube, progress);
+
+      for (int band = 1; band <= cube.bandCount(); band++) {
+        int physicalBand = cube.physicalBand(band);
+
+        Statistics *stats = new Statistics();
+        m_statistics.insert(physicalBand, stats);
+
+        // This matches Cube::histogram(band): the bin range comes from the
+        //   pixel type, or for Real pixels from the minimum and maximum, and
+        //   the valid range is the bin range.
+        Histogram *hist = NULL;
+        if (cube.pixelType() == Real) {
+          // The minimum and maximum come from the statistics, so the band is
+          //   read once for them and once for the histogram
+          if (progress != NULL) {
+            progress->SetText("Gathering statistics");
+            progress->SetMaximumSteps(cube.lineCount());
+            progress->CheckStatus();
+          }
+          driver.addData(band, *stats);
+
+          if (stats->ValidPixels() == 0) {
+            hist = new Histogram(0.0, 1.0, 65536);
+          }
+          else {
+            hist = new Histogram(stats->Minimum(), stats->Maximum(), 65536);
+          }
+          m_histograms.insert(physicalBand, hist);
+          hist->SetValidRange(hist->BinRangeStart(), hist->BinRangeEnd());
+
+          if (progress != NULL) {
+            progress->SetText("Gathering histogram");
+            progress->SetMaximumSteps(cube.lineCount());
+            progress->CheckStatus();
+          }
+          driver.addData(band, *hist);
+        }
+        else {
+          // The bin range does not depend on the pixels, so the statistics
+          //   and histogram are gathered from one read of the band
+          hist = new Histogram(cube, band);
+          m_histograms.insert(physicalBand, hist);
+          hist->SetValidRange(hist->BinRangeStart(), hist->BinRangeEnd());
+
+          if (progress != NULL) {
+            progress->SetText("Gathering statistics and histogram");
+            progress->SetMaximumSteps(cube.lineCount());
+            progress->CheckStatus();
+          }
+          driver.addData(band, *stats, *hist);
+        }
+      }
+    }
+    catch (IException &e) {
+      clear();
+      QString msg = "Unable to gather the statistics cache of [" + cube.fileName() + "]";
+      throw IException(e, IException::Programmer, msg, _FILEINFO_);
+    }
+  }
+
+
+  //! Destroys the cache.
+  CubeStatisticsCache::~CubeStatisticsCache() {
+    clear();
+  }
+
+
+  /**
+   * Returns the number of bands in the cache.
+   *
+   * @return int The number of bands
+   */
+  int CubeStatisticsCache::bands() const {
+    return m_statistics.size();
+  }
+
+
+  /**
+   * Returns true if the cache holds the statistics of a physical band.
+   *
+   * @param band The physical band number
+   *
+   * @return bool True if the band is cached
+   */
+  bool CubeStatisticsCache::hasBand(int band) const {
+    return m_statistics.contains(band);
+  }
+
+
+  /**
+   * Returns a copy of the cached statistics of a physical band. The caller
+   * takes ownership of the returned object.
+   *
+   * @param band The physical band number
+   *
+   * @return Statistics* The statistics of the band
+   *
+   * @throws IException::Programmer "The statistics cache does not have band"
+   */
+  Statistics *CubeStatisticsCache::statistics(int band) const {
+    checkBand(band);
+    return new Statistics(*m_statistics[band]);
+  }
+
+
+  /**
+   * Returns a copy of the cached histogram of a physical band. The caller
+   * takes ownership of the returned object.
+   *
+   * @param band The physical band number
+   *
+   * @return Histogram* The histogram of the band
+   *
+   * @throws IException::Programmer "The statistics cache does not have band"
+   */
+  Histogram *CubeStatisticsCache::histogram(int band) const {
+    checkBand(band);
+    return new Histogram(*m_histograms[band]);
+  }
+
+
+  /**
+   * Reads the compressed blob data and unpacks the statistics and histograms.
+   *
+   * @param stream The stream to read from
+   *
+   * @throws IException::Io "The statistics cache is not valid"
+   */
+  void CubeStatisticsCache::ReadData(std::istream &stream) {
+    Blob::ReadData(stream);
+    clear();
+
+    QByteArray data = qUncompress(QByteArray::fromRawData(p_buffer, p_nbytes));
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    qint32 version = 0;
+    qint32 bands = 0;
+    in >> version >> bands;
+    if (data.isEmpty() || version != 1) {
+      QString msg = "The statistics cache is not valid";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    for (int i = 0; i < bands; i++) {
+      qint32 band;
+      in >> band;
+
+      Statistics *stats = new Statistics();
+      m_statistics.insert(band, stats);
+      stats->read(in);
+
+      Histogram *hist = new Histogram(0.0, 1.0, 1);
+      m_histograms.insert(band, hist);
+      hist->read(in);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+      clear();
+      QString msg = "The statistics cache is not valid";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Packs the statistics and histograms into the compressed blob data.
+   */
+  void CubeStatisticsCache::WriteInit() {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    out << (qint32)1 << (qint32)m_statistics.size();
+    foreach (int band, m_statistics.keys()) {
+      out << (qint32)band;
+      m_statistics[band]->write(out);
+      m_histograms[band]->write(out);
+    }
+
+    QByteArray compressed = qCompress(data);
+
+    delete [] p_buffer;
+    p_nbytes = compressed.size();
+    p_buffer = new char[p_nbytes];
+    memcpy(p_buffer, compressed.constData(), p_nbytes);
+  }
+
+
+  /**
+   * Deletes the statistics and histograms.
+   */
+  void CubeStatisticsCache::clear() {
+    foreach (Statistics *stats, m_statistics) {
+      delete stats;
+    }
+    m_statistics.clear();
+
+    foreach (Histogram *hist, m_histograms) {
+      delete hist;
+    }
+    m_histograms.clear();
+  }
+
+
+  /**
+   * Throws if the cache does not have a band.
+   *
+   * @param band The physical band number
+   *
+   * @throws IException::Programmer "The statistics cache does not have band"
+   */
+  void CubeStatisticsCache::checkBand(int band) const {
+    if (!hasBand(band)) {
+      QString msg = "The statistics cache does not have band [" + toString(band) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+  }
+}
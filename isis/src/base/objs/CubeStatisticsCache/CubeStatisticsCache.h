@@ -0,0 +1,95 @@
+#ifndef CubeStatisticsCache_h
+#define CubeStatisticsCache_h
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+
+#include <QMap>
+
+#include "Blob.h"
+
+namespace Isis {
+  class Cube;
+  class Histogram;
+  class Progress;
+  class Statistics;
+
+  /**
+   * @brief Band statistics and histograms stored with a cube
+   *
+   * This blob holds the statistics and histogram of each band of a cube so
+   * they do not have to be gathered again every time the cube is stretched or
+   * exported. The statistics are those of Cube::statistics(band) and the
+   * histograms are those of Cube::histogram(band), both with the default
+   * valid range. Once the cache is written to a cube, those Cube methods
+   * return copies of the cached results instead of reading the cube.
+   *
+   * The cache describes the pixels at the time it was gathered. Cube removes
+   * it from the labels as soon as any pixels are written, so a cache in the
+   * labels is always current. Histogram bins are only stored from the first
+   * to the last nonzero bin and the blob is compressed.
+   *
+   * @code
+   *   CubeStatisticsCache cache(cube);
+   *   cube.write(cache);
+   * @endcode
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version.
+   *   @history 2018-09-07 Isis Development Team - Gathers the statistics and histogram of a
+   *                           band in one read, or two for Real pixels, instead of three.
+   */
+  class CubeStatisticsCache : public Isis::Blob {
+    public:
+      CubeStatisticsCache();
+      CubeStatisticsCache(Cube &cube, Progress *progress = 0);
+      ~CubeStatisticsCache();
+
+      int bands() const;
+      bool hasBand(int band) const;
+      Statistics *statistics(int band) const;
+      Histogram *histogram(int band) const;
+
+    protected:
+      void ReadData(std::istream &stream);
+      void WriteInit();
+
+    private:
+      CubeStatisticsCache(const CubeStatisticsCache &other);
+      CubeStatisticsCache &operator=(const CubeStatisticsCache &other);
+
+      void clear();
+      void checkBand(int band) const;
+
+      //! The statistics of each physical band, keyed by band number
+      QMap<int, Statistics *> m_statistics;
+      //! The histogram of each physical band, keyed by band number
+      QMap<int, Histogram *> m_histograms;
+  };
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <iostream>
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include "Cube.h"
+#include "CubeStatisticsCache.h"
+#include "CubeStatisticsDriver.h"
+#include "Histogram.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+#include "Statistics.h"
+
+using namespace std;
+using namespace Isis;
+
+double pixel(int sample, int line, int band);
+bool matches(const Statistics &a, const Statistics &b);
+bool matches(const Histogram &a, const Histogram &b);
+
+int main() {
+  Preference::Preferences(true);
+
+  cout << "Creating test cube" << endl;
+  Cube cube;
+  cube.setDimensions(64, 50, 2);
+  cube.create("junk.cub");
+  LineManager line(cube);
+  for (line.begin(); !line.end(); line++) {
+    for (int i = 0; i < line.size(); i++) {
+      line[i] = pixel(i + 1, line.Line(), line.Band());
+    }
+    cube.write(line);
+  }
+
+  // Gather the same results as Cube::statistics() and Cube::histogram()
+  QList<Statistics *> expectedStats;
+  QList<Histogram *> expectedHists;
+  CubeStatisticsDriver driver(cube);
+  for (int band = 1; band <= 2; band++) {
+    Statistics *stats = new Statistics();
+    driver.addData(band, *stats);
+    expectedStats.append(stats);
+
+    Histogram *hist = new Histogram(cube, band);
+    hist->SetValidRange(hist->BinRangeStart(), hist->BinRangeEnd());
+    driver.addData(band, *hist);
+    expectedHists.append(hist);
+  }
+  cout << "Has cache: " << cube.hasStatisticsCache() << endl;
+  cout << endl;
+
+  cout << "Writing the cache" << endl;
+  CubeStatisticsCache cache(cube);
+  cube.write(cache);
+  cout << "Bands:     " << cache.bands() << endl;
+  cout << "Has cache: " << cube.hasStatisticsCache() << endl;
+  cube.close();
+  cout << endl;
+
+  cout << "Reading the cache" << endl;
+  cube.open("junk.cub");
+  cout << "Has cache: " << cube.hasStatisticsCache() << endl;
+  for (int band = 1; band <= 2; band++) {
+    Statistics *stats = cube.statistics(band);
+    Histogram *hist = cube.histogram(band);
+    cout << "Band " << band << " valid pixels:      " << stats->ValidPixels() << endl;
+    cout << "Band " << band << " null pixels:       " << stats->NullPixels() << endl;
+    cout << "Band " << band << " statistics match:  "
+         << matches(*stats, *expectedStats[band - 1]) << endl;
+    cout << "Band " << band << " histogram matches: "
+         << matches(*hist, *expectedHists[band - 1]) << endl;
+    delete stats;
+    delete hist;
+  }
+  cube.close();
+  cout << endl;
+
+  cout << "Reading the cache through virtual band 2" << endl;
+  Cube virtualCube;
+  QList<QString> virtualBands;
+  virtualBands.append("2");
+  virtualCube.setVirtualBands(virtualBands);
+  virtualCube.open("junk.cub");
+  Statistics *virtualStats = virtualCube.statistics(1);
+  Histogram *virtualHist = virtualCube.histogram(0);
+  cout << "Statistics match: " << matches(*virtualStats, *expectedStats[1]) << endl;
+  cout << "Histogram matches: " << matches(*virtualHist, *expectedHists[1]) << endl;
+  delete virtualStats;
+  delete virtualHist;
+  virtualCube.close();
+  cout << endl;
+
+  cout << "Writing pixels removes the cache" << endl;
+  cube.open("junk.cub", "rw");
+  line.SetLine(1, 1);
+  cube.read(line);
+  cube.write(line);
+  cout << "Has cache after writing:   " << cube.hasStatisticsCache() << endl;
+  cube.close();
+  cube.open("junk.cub");
+  cout << "Has cache after reopening: " << cube.hasStatisticsCache() << endl;
+  cube.close();
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  try {
+    cache.statistics(3);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    cache.histogram(0);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  foreach (Statistics *stats, expectedStats) {
+    delete stats;
+  }
+  foreach (Histogram *hist, expectedHists) {
+    delete hist;
+  }
+  QFile::remove("junk.cub");
+
+  return 0;
+}
+
+
+/**
+ * The value of a test cube pixel.
+ */
+double pixel(int sample, int line, int band) {
+  if ((sample + line + band) % 17 == 0) {
+    return Null;
+  }
+  return (double)((sample * 3 + line * 5 + band * 7) % 41);
+}
+
+
+/**
+ * Compares the accumulators, counters and valid ranges of two Statistics objects.
+ */
+bool matches(const Statistics &a, const Statistics &b) {
+  return a.TotalPixels() == b.TotalPixels() && a.ValidPixels() == b.ValidPixels() &&
+         a.NullPixels() == b.NullPixels() && a.HisPixels() == b.HisPixels() &&
+         a.LisPixels() == b.LisPixels() && a.HrsPixels() == b.HrsPixels() &&
+         a.LrsPixels() == b.LrsPixels() &&
+         a.OverRangePixels() == b.OverRangePixels() &&
+         a.UnderRangePixels() == b.UnderRangePixels() &&
+         a.Sum() == b.Sum() && a.SumSquare() == b.SumSquare() &&
+         a.Minimum() == b.Minimum() && a.Maximum() == b.Maximum() &&
+         a.ValidMinimum() == b.ValidMinimum() && a.ValidMaximum() == b.ValidMaximum();
+}
+
+
+/**
+ * Compares the statistics, bin range and bins of two histograms.
+ */
+bool matches(const Histogram &a, const Histogram &b) {
+  if (!matches((const Statistics &)a, (const Statistics &)b) || a.Bins() != b.Bins() ||
+      a.BinRangeStart() != b.BinRangeStart() || a.BinRangeEnd() != b.BinRangeEnd()) {
+    return false;
+  }
+  for (int i = 0; i < a.Bins(); i++) {
+    if (a.BinCount(i) != b.BinCount(i)) {
+      return false;
+    }
+  }
+  return true;
+}
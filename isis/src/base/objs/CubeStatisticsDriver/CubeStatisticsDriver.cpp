@@ -0,0 +1,595 @@
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "CubeStatisticsDriver.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "Histogram.h"
+#include "IException.h"
+#include "IString.h"
+#include "Preference.h"
+#include "Progress.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+#include "Statistics.h"
+
+using namespace std;
+
+namespace Isis {
+
+  /**
+   * Constructs a driver that reads the whole of a cube. The chunks are merged
+   * in parallel if the ParallelStatistics preference is On.
+   *
+   * @param cube The cube to gather statistics from. It must be open.
+   * @param progress Stepped once for every line read, may be NULL
+   */
+  CubeStatisticsDriver::CubeStatisticsDriver(Cube &cube, Progress *progress) {
+    m_cube = &cube;
+    m_progress = progress;
+    m_parallel = parallelPreference();
+    m_startSample = 1;
+    m_startLine = 1;
+    m_endSample = cube.sampleCount();
+    m_endLine = cube.lineCount();
+    m_lineIncrement = 1;
+    m_valueLimit = 1048576;
+  }
+
+
+  //! Destroys the driver.
+  CubeStatisticsDriver::~CubeStatisticsDriver() {
+  }
+
+
+  /**
+   * Returns whether the ParallelStatistics keyword of the Performance
+   * preferences is On. It is Off if the keyword is missing.
+   *
+   * @return @b bool True if statistics should be gathered in parallel
+   */
+  bool CubeStatisticsDriver::parallelPreference() {
+    PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+    if (performance.hasKeyword("ParallelStatistics")) {
+      return performance["ParallelStatistics"][0].toUpper() == "ON";
+    }
+    return false;
+  }
+
+
+  /**
+   * Chooses whether addData() accumulates chunks in parallel and merges them,
+   * or adds the lines to the caller's object in order.
+   *
+   * @param parallel True to merge chunks gathered on the global thread pool
+   */
+  void CubeStatisticsDriver::setParallel(bool parallel) {
+    m_parallel = parallel;
+  }
+
+
+  /**
+   * Returns whether chunks are gathered in parallel and merged.
+   *
+   * @return @b bool True if the chunks are merged
+   */
+  bool CubeStatisticsDriver::isParallel() const {
+    return m_parallel;
+  }
+
+
+  /**
+   * Limits the pixels read to a rectangle of the cube. Pixels of the
+   * rectangle that are outside of the cube are read as Null, like they are by
+   * a Brick.
+   *
+   * @param startSample The first sample to read
+   * @param startLine The first line to read
+   * @param endSample The last sample to read
+   * @param endLine The last line to read
+   *
+   * @throws IException::Programmer "The region is empty"
+   */
+  void CubeStatisticsDriver::setRegion(int startSample, int startLine,
+                                       int endSample, int endLine) {
+    if (startSample > endSample || startLine > endLine) {
+      QString msg = "The region from sample [" + toString(startSample) + "] line [" +
+                    toString(startLine) + "] to sample [" + toString(endSample) +
+                    "] line [" + toString(endLine) + "] is empty";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    m_startSample = startSample;
+    m_startLine = startLine;
+    m_endSample = endSample;
+    m_endLine = endLine;
+  }
+
+
+  /**
+   * Samples the region by lines. Only the first line and every increment
+   * lines after it are used, plus the last line of the region.
+   *
+   * @param increment The line increment, 1 to use every line
+   *
+   * @throws IException::Programmer "The line increment must be greater than 0"
+   */
+  void CubeStatisticsDriver::setLineIncrement(int increment) {
+    if (increment < 1) {
+      QString msg = "The line increment [" + toString(increment) +
+                    "] must be greater than 0";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    m_lineIncrement = increment;
+  }
+
+
+  /**
+   * Sets the most distinct valid values that streamingHistogram() counts. A
+   * count takes 16 bytes. Bands with more distinct values are read twice.
+   *
+   * @param limit The most distinct values to count
+   *
+   * @throws IException::Programmer "The value limit must be greater than 0"
+   */
+  void CubeStatisticsDriver::setValueLimit(int limit) {
+    if (limit < 1) {
+      QString msg = "The value limit [" + toString(limit) + "] must be greater than 0";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    m_valueLimit = limit;
+  }
+
+
+  /**
+   * Adds the pixels of a band to a Statistics object. Serially this is the
+   * same as adding the lines of the band to the object in order. In parallel
+   * the counts, minimum and maximum are the same, and the sums are added chunk
+   * by chunk and can differ in the last bits.
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param statistics The statistics to add the pixels to. Its valid range is
+   *                   used for every chunk.
+   */
+  void CubeStatisticsDriver::addData(int band, Statistics &statistics) {
+    checkBand(band);
+
+    if (m_parallel) {
+      gather(band, StatisticsMode, &statistics, NULL, NULL);
+    }
+    else {
+      readLines(band, &statistics, NULL);
+    }
+  }
+
+
+  /**
+   * Adds the pixels of a band to a Histogram. Serially this is the same as
+   * adding the lines of the band to the histogram in order. In parallel the
+   * bin counts are the same, and the sums are added chunk by chunk and can
+   * differ in the last bits.
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param histogram The histogram to add the pixels to. Its bins and bin
+   *                  range are used for every chunk.
+   */
+  void CubeStatisticsDriver::addData(int band, Histogram &histogram) {
+    checkBand(band);
+
+    if (m_parallel) {
+      gather(band, HistogramMode, NULL, &histogram, NULL);
+    }
+    else {
+      readLines(band, NULL, &histogram);
+    }
+  }
+
+
+  /**
+   * Adds the pixels of a band to a Statistics object and a Histogram, reading
+   * the band once. Each gets the same result as from its own addData().
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param statistics The statistics to add the pixels to. Its valid range is
+   *                   used for every chunk.
+   * @param histogram The histogram to add the pixels to. Its bins and bin
+   *                  range are used for every chunk.
+   */
+  void CubeStatisticsDriver::addData(int band, Statistics &statistics,
+                                     Histogram &histogram) {
+    checkBand(band);
+
+    if (m_parallel) {
+      gather(band, BothMode, &statistics, &histogram, NULL);
+    }
+    else {
+      readLines(band, &statistics, &histogram);
+    }
+  }
+
+
+  /**
+   * Builds a histogram of a band whose range is not known, reading the cube
+   * once. The bin range of the histogram is the minimum to the maximum valid
+   * pixel, and every bin count is the same as in a histogram with that range
+   * filled by a second read of the cube. The sums are merged chunk by chunk
+   * and can differ from a serial histogram in the last bits.
+   *
+   * If the band has more distinct valid values than the value limit, the band
+   * is read a second time to fill the bins. The second read does not step the
+   * progress.
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param bins The number of bins in the histogram
+   *
+   * @return @b Histogram* The histogram, owned by the caller
+   *
+   * @throws IException::Programmer "The number of histogram bins must be greater than 0"
+   */
+  Histogram *CubeStatisticsDriver::streamingHistogram(int band, int bins) {
+    if (bins < 1) {
+      QString msg = "The number of histogram bins must be greater than 0";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    checkBand(band);
+
+    Statistics statistics;
+    QVector<ValueCount> values;
+    bool counted = gather(band, StreamingMode, &statistics, NULL, &values);
+
+    Histogram *histogram = NULL;
+    if (statistics.ValidPixels() > 0) {
+      histogram = new Histogram(statistics.Minimum(), statistics.Maximum(), bins);
+    }
+    else {
+      histogram = new Histogram(0.0, 1.0, bins);
+    }
+
+    if (counted) {
+      histogram->Statistics::Merge(statistics);
+      for (int i = 0; i < values.size(); i++) {
+        histogram->p_bins[histogram->BinIndex(values[i].first)] += values[i].second;
+      }
+    }
+    else {
+      Progress *progress = m_progress;
+      m_progress = NULL;
+      try {
+        gather(band, HistogramMode, NULL, histogram, NULL);
+      }
+      catch (...) {
+        m_progress = progress;
+        delete histogram;
+        throw;
+      }
+      m_progress = progress;
+    }
+
+    return histogram;
+  }
+
+
+  /**
+   * Adds the used lines of a band to a Statistics, a Histogram or both in
+   * line order.
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param statistics The statistics to add the lines to, or NULL
+   * @param histogram The histogram to add the lines to, or NULL
+   */
+  void CubeStatisticsDriver::readLines(int band, Statistics *statistics,
+                                       Histogram *histogram) {
+    int startBand = band;
+    int endBand = band;
+    if (band == 0) {
+      startBand = 1;
+      endBand = m_cube->bandCount();
+    }
+
+    Brick brick(m_endSample - m_startSample + 1, 1, 1, m_cube->pixelType());
+
+    for (int b = startBand; b <= endBand; b++) {
+      for (int line = m_startLine; line <= m_endLine; line++) {
+        if (useLine(line)) {
+          brick.SetBasePosition(m_startSample, line, b);
+          m_cube->read(brick);
+
+          if (statistics) {
+            statistics->AddData(brick.DoubleBuffer(), brick.size());
+          }
+          if (histogram) {
+            histogram->AddData(brick.DoubleBuffer(), brick.size());
+          }
+        }
+
+        if (m_progress) {
+          m_progress->CheckStatus();
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Reads the band in chunks of lines, on the global thread pool if the
+   * driver is parallel, and merges the chunk results in line order. The reads
+   * are serialized by the cube's mutex.
+   *
+   * @param band The band to read, or 0 for all bands
+   * @param mode What to accumulate
+   * @param statistics The statistics to fill, except in HistogramMode
+   * @param histogram The histogram to fill in HistogramMode and BothMode
+   * @param values The distinct value counts to fill in StreamingMode
+   *
+   * @return @b bool False if StreamingMode found more distinct values than the
+   *                 value limit and dropped the counts, otherwise true
+   */
+  bool CubeStatisticsDriver::gather(int band, ChunkMode mode, Statistics *statistics,
+                                    Histogram *histogram, QVector<ValueCount> *values) {
+    QVector<Chunk> allChunks = chunks(band);
+    ChunkFunctor functor(this, mode, statistics, histogram);
+    bool counted = true;
+
+    // Chunks are processed in groups to bound the memory held by chunk results
+    int threads = m_parallel ? QThreadPool::globalInstance()->maxThreadCount() : 1;
+    int groupSize = 4 * qMax(1, threads);
+
+    for (int groupStart = 0; groupStart < allChunks.size(); groupStart += groupSize) {
+      QVector<Chunk> group = allChunks.mid(groupStart, groupSize);
+
+      if (threads > 1) {
+        QtConcurrent::blockingMap(group, functor);
+      }
+      else {
+        for (int i = 0; i < group.size(); i++) {
+          functor(group[i]);
+        }
+      }
+
+      for (int i = 0; i < group.size(); i++) {
+        Chunk &chunk = group[i];
+
+        if (chunk.histogram) {
+          histogram->Merge(*chunk.histogram);
+        }
+        if (chunk.statistics) {
+          statistics->Merge(*chunk.statistics);
+        }
+
+        if (mode == StreamingMode && counted) {
+          *values = mergeValues(*values, chunk.values);
+          if (values->size() > m_valueLimit) {
+            values->clear();
+            counted = false;
+          }
+        }
+
+        delete chunk.statistics;
+        delete chunk.histogram;
+        chunk.values.clear();
+
+        if (m_progress) {
+          for (int line = chunk.startLine; line <= chunk.endLine; line++) {
+            m_progress->CheckStatus();
+          }
+        }
+      }
+    }
+
+    return counted;
+  }
+
+
+  /**
+   * Splits the region of a band into chunks of lines. A chunk holds about a
+   * quarter of a million pixels, so the streaming mode can buffer it and the
+   * histogram mode copies of the bins stay small next to the data.
+   *
+   * @param band The band to split, or 0 for all bands
+   *
+   * @return @b QVector<Chunk> The chunks in band and line order
+   */
+  QVector<CubeStatisticsDriver::Chunk> CubeStatisticsDriver::chunks(int band) const {
+    int startBand = band;
+    int endBand = band;
+    if (band == 0) {
+      startBand = 1;
+      endBand = m_cube->bandCount();
+    }
+
+    int samples = m_endSample - m_startSample + 1;
+    int chunkLines = qMax(1, 262144 / samples);
+
+    QVector<Chunk> result;
+    for (int b = startBand; b <= endBand; b++) {
+      for (int line = m_startLine; line <= m_endLine; line += chunkLines) {
+        Chunk chunk;
+        chunk.band = b;
+        chunk.startLine = line;
+        chunk.endLine = qMin(m_endLine, line + chunkLines - 1);
+        chunk.statistics = NULL;
+        chunk.histogram = NULL;
+        result.append(chunk);
+      }
+    }
+
+    return result;
+  }
+
+
+  /**
+   * Returns whether a line is used with the line increment: the first line of
+   * the region, every increment lines after it, and the last line.
+   *
+   * @param line The line of the cube
+   *
+   * @return @b bool True if the line is read
+   */
+  bool CubeStatisticsDriver::useLine(int line) const {
+    return (line - m_startLine) % m_lineIncrement == 0 || line == m_endLine;
+  }
+
+
+  /**
+   * Makes sure a band number is valid for the cube.
+   *
+   * @param band The band number, 0 meaning all bands
+   *
+   * @throws IException::Programmer "Cannot gather statistics for band"
+   */
+  void CubeStatisticsDriver::checkBand(int band) const {
+    if (band < 0 || band > m_cube->bandCount()) {
+      QString msg = "Cannot gather statistics for band [" + toString(band) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Merges two lists of distinct value counts that are in value order.
+   *
+   * @param first A list of value counts in value order
+   * @param second A list of value counts in value order
+   *
+   * @return @b QVector<ValueCount> The counts of both lists in value order
+   */
+  QVector<CubeStatisticsDriver::ValueCount> CubeStatisticsDriver::mergeValues(
+      const QVector<ValueCount> &first, const QVector<ValueCount> &second) {
+    QVector<ValueCount> merged;
+    merged.reserve(first.size() + second.size());
+
+    int i = 0;
+    int j = 0;
+    while (i < first.size() && j < second.size()) {
+      if (first[i].first < second[j].first) {
+        merged.append(first[i++]);
+      }
+      else if (second[j].first < first[i].first) {
+        merged.append(second[j++]);
+      }
+      else {
+        merged.append(ValueCount(first[i].first, first[i].second + second[j].second));
+        i++;
+        j++;
+      }
+    }
+
+    while (i < first.size()) {
+      merged.append(first[i++]);
+    }
+    while (j < second.size()) {
+      merged.append(second[j++]);
+    }
+
+    return merged;
+  }
+
+
+  /**
+   * Constructs a ChunkFunctor.
+   *
+   * @param driver The driver with the cube and region to read
+   * @param mode What to accumulate
+   * @param statistics The prototype to copy in StatisticsMode and BothMode
+   * @param histogram The prototype to copy in HistogramMode and BothMode
+   */
+  CubeStatisticsDriver::ChunkFunctor::ChunkFunctor(const CubeStatisticsDriver *driver,
+                                                   ChunkMode mode,
+                                                   const Statistics *statistics,
+                                                   const Histogram *histogram) {
+    m_driver = driver;
+    m_mode = mode;
+    m_statistics = statistics;
+    m_histogram = histogram;
+  }
+
+
+  /**
+   * Reads the used lines of a chunk and accumulates them.
+   *
+   * @param chunk The chunk to read
+   */
+  void CubeStatisticsDriver::ChunkFunctor::operator()(Chunk &chunk) const {
+    Cube *cube = m_driver->m_cube;
+    int samples = m_driver->m_endSample - m_driver->m_startSample + 1;
+    Brick brick(samples, 1, 1, cube->pixelType());
+
+    if (m_mode == StatisticsMode || m_mode == BothMode) {
+      chunk.statistics = new Statistics(*m_statistics);
+      chunk.statistics->Reset();
+    }
+    if (m_mode == HistogramMode || m_mode == BothMode) {
+      chunk.histogram = new Histogram(*m_histogram);
+      chunk.histogram->Reset();
+    }
+    if (m_mode == StreamingMode) {
+      chunk.statistics = new Statistics();
+    }
+
+    // The valid pixels of the chunk, sorted and counted once it is read
+    vector<double> valid;
+
+    for (int line = chunk.startLine; line <= chunk.endLine; line++) {
+      if (!m_driver->useLine(line)) continue;
+
+      brick.SetBasePosition(m_driver->m_startSample, line, chunk.band);
+      cube->read(brick);
+
+      if (chunk.histogram) {
+        chunk.histogram->AddData(brick.DoubleBuffer(), brick.size());
+      }
+      if (chunk.statistics) {
+        chunk.statistics->AddData(brick.DoubleBuffer(), brick.size());
+      }
+
+      if (m_mode == StreamingMode) {
+        for (int i = 0; i < brick.size(); i++) {
+          if (IsValidPixel(brick[i])) {
+            valid.push_back(brick[i]);
+          }
+        }
+      }
+    }
+
+    if (m_mode == StreamingMode) {
+      sort(valid.begin(), valid.end());
+
+      for (unsigned int i = 0; i < valid.size(); i++) {
+        if (chunk.values.isEmpty() || chunk.values.last().first != valid[i]) {
+          chunk.values.append(ValueCount(valid[i], 1));
+        }
+        else {
+          chunk.values.last().second++;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,177 @@
+#ifndef CubeStatisticsDriver_h
+#define CubeStatisticsDriver_h
+/**
+ * @file
+ * $Revision$
+ * $Date$
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <functional>
+
+#include <QPair>
+#include <QVector>
+
+#include "Constants.h"
+
+namespace Isis {
+  class Cube;
+  class Histogram;
+  class Progress;
+  class Statistics;
+
+  /**
+   * @brief Gathers cube statistics and histograms in chunks of lines
+   *
+   * This class reads a region of a cube once, in chunks of lines. By default
+   * the lines are added to the caller's Statistics or Histogram one at a time
+   * in line order, which gives exactly the same result as a loop over the
+   * lines. If the ParallelStatistics preference in the Performance group is
+   * On, or setParallel() is called, each chunk is accumulated into its own
+   * object on the global thread pool and the chunks are merged in line order.
+   * The chunks depend only on the region, so the parallel result does not
+   * depend on the number of threads, but it is not bit-identical to the
+   * serial one: the counts, minimum, maximum and histogram bins are exact,
+   * while the sums can differ in the last bits.
+   *
+   * Cube::read() holds the cube's mutex, so the chunks are read one at a time
+   * and only the pixel classification and binning run in parallel. The
+   * speedup is bounded by how much of the time goes to reading the cube.
+   *
+   * addData() fills a Statistics or Histogram that has already been set up,
+   * for example with a valid range or bin range, or both from one read of the
+   * cube. streamingHistogram() builds a
+   * histogram of data with an unknown range in a single read of the cube
+   * instead of a min/max read followed by a binning read. It keeps the count
+   * of every distinct valid value, so once the range is known each value is
+   * put in exactly the bin a two pass histogram would put it in. Integer
+   * pixel types never have more than 65536 distinct values. If a band has
+   * more distinct values than the value limit, the counts are dropped and the
+   * band is read a second time to bin it, so the result is always exact.
+   *
+   * If a Progress is given, CheckStatus() is called once for every line of
+   * the first read. The caller sets up the text and the maximum steps.
+   *
+   * @code
+   *   CubeStatisticsDriver driver(cube);
+   *   Statistics stats;
+   *   driver.addData(1, stats);
+   * @endcode
+   *
+   * @ingroup Statistics
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version.
+   *   @history 2018-09-07 Isis Development Team - Made the serial line order
+   *                           accumulation the default and the chunk merging
+   *                           opt in with the ParallelStatistics preference or
+   *                           setParallel(). Made streamingHistogram() exact by
+   *                           counting distinct values instead of rebinning
+   *                           power of two grids. Added setLineIncrement() for
+   *                           sampled statistics.
+   *   @history 2018-09-07 Isis Development Team - Added addData() for a Statistics
+   *                           and a Histogram at once, so both are filled from one read.
+   */
+  class CubeStatisticsDriver {
+    public:
+      CubeStatisticsDriver(Cube &cube, Progress *progress = 0);
+      ~CubeStatisticsDriver();
+
+      static bool parallelPreference();
+
+      void setParallel(bool parallel);
+      bool isParallel() const;
+      void setRegion(int startSample, int startLine, int endSample, int endLine);
+      void setLineIncrement(int increment);
+      void setValueLimit(int limit);
+
+      void addData(int band, Statistics &statistics);
+      void addData(int band, Histogram &histogram);
+      void addData(int band, Statistics &statistics, Histogram &histogram);
+      Histogram *streamingHistogram(int band, int bins);
+
+    private:
+      //! What a chunk accumulates
+      enum ChunkMode {
+        StatisticsMode,   //!< Copy and fill the Statistics prototype
+        HistogramMode,    //!< Copy and fill the Histogram prototype
+        BothMode,         //!< Copy and fill both prototypes
+        StreamingMode     //!< Count the distinct valid values of the chunk
+      };
+
+      //! A valid pixel value and the number of times it was read
+      typedef QPair<double, BigInt> ValueCount;
+
+      /**
+       * A group of lines of one band and the statistics gathered from them.
+       */
+      struct Chunk {
+        int band;                    //!< The band of the lines
+        int startLine;               //!< The first line of the chunk
+        int endLine;                 //!< The last line of the chunk
+        Statistics *statistics;      //!< The chunk statistics, except in HistogramMode
+        Histogram *histogram;        //!< The chunk histogram in HistogramMode and BothMode
+        QVector<ValueCount> values;  //!< The distinct values in value order in StreamingMode
+      };
+
+      /**
+       * Reads and accumulates a Chunk. This is designed to be passed into
+       * QtConcurrent::blockingMap.
+       */
+      class ChunkFunctor : public std::unary_function<Chunk &, void> {
+        public:
+          ChunkFunctor(const CubeStatisticsDriver *driver, ChunkMode mode,
+                       const Statistics *statistics, const Histogram *histogram);
+          void operator()(Chunk &chunk) const;
+
+        private:
+          const CubeStatisticsDriver *m_driver;  //!< The driver with the cube and region
+          ChunkMode m_mode;                      //!< What to accumulate
+          const Statistics *m_statistics;        //!< Prototype for StatisticsMode and BothMode
+          const Histogram *m_histogram;          //!< Prototype for HistogramMode and BothMode
+      };
+
+      CubeStatisticsDriver(const CubeStatisticsDriver &other);
+      CubeStatisticsDriver &operator=(const CubeStatisticsDriver &other);
+
+      void readLines(int band, Statistics *statistics, Histogram *histogram);
+      bool gather(int band, ChunkMode mode, Statistics *statistics,
+                  Histogram *histogram, QVector<ValueCount> *values);
+      QVector<Chunk> chunks(int band) const;
+      bool useLine(int line) const;
+      void checkBand(int band) const;
+
+      static QVector<ValueCount> mergeValues(const QVector<ValueCount> &first,
+                                             const QVector<ValueCount> &second);
+
+      Cube *m_cube;            //!< The cube to read
+      Progress *m_progress;    //!< Stepped once per line read, may be NULL
+      bool m_parallel;         //!< Accumulate chunks on the global thread pool
+      int m_startSample;       //!< The first sample of the region
+      int m_startLine;         //!< The first line of the region
+      int m_endSample;         //!< The last sample of the region
+      int m_endLine;           //!< The last line of the region
+      int m_lineIncrement;     //!< Only every this many lines are used
+      int m_valueLimit;        //!< Most distinct values kept by streamingHistogram()
+  };
+}
+
+#endif
@@ -0,0 +1,316 @@
+#include <iostream>
+
+#include <QFile>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "CubeStatisticsDriver.h"
+#include "Histogram.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+#include "Statistics.h"
+
+using namespace std;
+using namespace Isis;
+
+double pixel(int sample, int line, int band);
+double fraction(int sample, int line);
+void serialData(Cube &cube, int band, int startSample, int startLine,
+                int endSample, int endLine, int increment, Statistics &stats);
+void serialData(Cube &cube, int band, Histogram &hist);
+bool matches(const Statistics &a, const Statistics &b);
+bool matchesCounts(const Statistics &a, const Statistics &b);
+int binDifferences(const Histogram &a, const Histogram &b);
+
+int main() {
+  Preference::Preferences(true);
+
+  cout << "Creating test cube" << endl;
+  Cube cube;
+  cube.setDimensions(512, 1100, 2);
+  cube.create("junk.cub");
+  LineManager line(cube);
+  for (line.begin(); !line.end(); line++) {
+    for (int i = 0; i < line.size(); i++) {
+      line[i] = pixel(i + 1, line.Line(), line.Band());
+    }
+    cube.write(line);
+  }
+  cout << endl;
+
+  cout << "Testing serial statistics of band 1" << endl;
+  CubeStatisticsDriver driver(cube);
+  cout << "Parallel:       " << driver.isParallel() << endl;
+  Statistics serialStats;
+  serialData(cube, 1, 1, 1, cube.sampleCount(), cube.lineCount(), 1, serialStats);
+  Statistics lineStats;
+  driver.addData(1, lineStats);
+  cout << "Matches serial: " << matches(lineStats, serialStats) << endl;
+  cout << endl;
+
+  driver.setParallel(true);
+
+  cout << "Testing statistics of band 1" << endl;
+  Statistics stats;
+  driver.addData(1, stats);
+  cout << "Parallel:       " << driver.isParallel() << endl;
+  cout << "Average:        " << stats.Average() << endl;
+  cout << "Minimum:        " << stats.Minimum() << endl;
+  cout << "Maximum:        " << stats.Maximum() << endl;
+  cout << "Valid Pixels:   " << stats.ValidPixels() << endl;
+  cout << "Null Pixels:    " << stats.NullPixels() << endl;
+  cout << "His Pixels:     " << stats.HisPixels() << endl;
+  cout << "Matches serial: " << matches(stats, serialStats) << endl;
+  cout << endl;
+
+  cout << "Testing statistics of all bands with a valid range" << endl;
+  Statistics allStats;
+  allStats.SetValidRange(10.0, 89.0);
+  driver.addData(0, allStats);
+  Statistics serialAllStats;
+  serialAllStats.SetValidRange(10.0, 89.0);
+  serialData(cube, 0, 1, 1, cube.sampleCount(), cube.lineCount(), 1, serialAllStats);
+  cout << "Total Pixels:   " << allStats.TotalPixels() << endl;
+  cout << "Valid Pixels:   " << allStats.ValidPixels() << endl;
+  cout << "Matches serial: " << matches(allStats, serialAllStats) << endl;
+  cout << endl;
+
+  cout << "Testing histogram of band 2" << endl;
+  Histogram hist(0.0, 99.0, 100);
+  driver.addData(2, hist);
+  Histogram serialHist(0.0, 99.0, 100);
+  serialData(cube, 2, serialHist);
+  cout << "Median:           " << hist.Median() << endl;
+  cout << "Bin differences:  " << binDifferences(hist, serialHist) << endl;
+  cout << "Matches serial:   " << matches(hist, serialHist) << endl;
+  cout << endl;
+
+  cout << "Testing statistics and histogram of band 2 from one read" << endl;
+  Statistics band2Stats;
+  driver.addData(2, band2Stats);
+  Statistics bothStats;
+  Histogram bothHist(0.0, 99.0, 100);
+  driver.addData(2, bothStats, bothHist);
+  cout << "Statistics match: " << matches(bothStats, band2Stats) << endl;
+  cout << "Bin differences:  " << binDifferences(bothHist, hist) << endl;
+  cout << "Histogram match:  " << matches(bothHist, hist) << endl;
+  driver.setParallel(false);
+  Statistics serialBothStats;
+  Histogram serialBothHist(0.0, 99.0, 100);
+  driver.addData(2, serialBothStats, serialBothHist);
+  driver.setParallel(true);
+  Statistics serialBand2Stats;
+  serialData(cube, 2, 1, 1, cube.sampleCount(), cube.lineCount(), 1, serialBand2Stats);
+  cout << "Serial stats:     " << matches(serialBothStats, serialBand2Stats) << endl;
+  cout << "Serial histogram: " << matches(serialBothHist, serialHist) << endl;
+  cout << endl;
+
+  cout << "Testing statistics of a region of band 2" << endl;
+  CubeStatisticsDriver regionDriver(cube);
+  regionDriver.setParallel(true);
+  regionDriver.setRegion(10, 20, 300, 700);
+  Statistics regionStats;
+  regionDriver.addData(2, regionStats);
+  Statistics serialRegionStats;
+  serialData(cube, 2, 10, 20, 300, 700, 1, serialRegionStats);
+  cout << "Total Pixels:   " << regionStats.TotalPixels() << endl;
+  cout << "Matches serial: " << matches(regionStats, serialRegionStats) << endl;
+  cout << endl;
+
+  cout << "Testing statistics of every seventh line of band 1" << endl;
+  CubeStatisticsDriver sampledDriver(cube);
+  sampledDriver.setParallel(true);
+  sampledDriver.setLineIncrement(7);
+  Statistics sampledStats;
+  sampledDriver.addData(1, sampledStats);
+  Statistics serialSampledStats;
+  serialData(cube, 1, 1, 1, cube.sampleCount(), cube.lineCount(), 7, serialSampledStats);
+  cout << "Total Pixels:   " << sampledStats.TotalPixels() << endl;
+  cout << "Matches serial: " << matches(sampledStats, serialSampledStats) << endl;
+  cout << endl;
+
+  cout << "Testing streaming histogram of band 1" << endl;
+  Histogram *streamed = driver.streamingHistogram(1, 100);
+  Histogram twoPass(serialStats.Minimum(), serialStats.Maximum(), 100);
+  serialData(cube, 1, twoPass);
+  cout << "Bins:             " << streamed->Bins() << endl;
+  cout << "Bin range start:  " << streamed->BinRangeStart() << endl;
+  cout << "Bin range end:    " << streamed->BinRangeEnd() << endl;
+  cout << "Bin differences:  " << binDifferences(*streamed, twoPass) << endl;
+  cout << "Matches two pass: " << matches(*streamed, twoPass) << endl;
+  delete streamed;
+  cout << endl;
+
+  cout << "Testing streaming histogram of fractional values" << endl;
+  Cube fractionCube;
+  fractionCube.setDimensions(300, 900, 1);
+  fractionCube.create("junk2.cub");
+  LineManager fractionLine(fractionCube);
+  for (fractionLine.begin(); !fractionLine.end(); fractionLine++) {
+    for (int i = 0; i < fractionLine.size(); i++) {
+      fractionLine[i] = fraction(i + 1, fractionLine.Line());
+    }
+    fractionCube.write(fractionLine);
+  }
+  CubeStatisticsDriver fractionDriver(fractionCube);
+  Statistics fractionStats;
+  fractionDriver.addData(1, fractionStats);
+  Histogram fractionTwoPass(fractionStats.Minimum(), fractionStats.Maximum(), 37);
+  serialData(fractionCube, 1, fractionTwoPass);
+  Histogram *fractionStreamed = fractionDriver.streamingHistogram(1, 37);
+  cout << "Bin differences:  " << binDifferences(*fractionStreamed, fractionTwoPass) << endl;
+  cout << "Valid Pixels:     " << fractionStreamed->ValidPixels() << endl;
+  cout << "Matches counts:   " << matchesCounts(*fractionStreamed, fractionTwoPass) << endl;
+  delete fractionStreamed;
+
+  cout << "With a value limit of 1000:" << endl;
+  fractionDriver.setValueLimit(1000);
+  fractionStreamed = fractionDriver.streamingHistogram(1, 37);
+  cout << "Bin differences:  " << binDifferences(*fractionStreamed, fractionTwoPass) << endl;
+  cout << "Matches counts:   " << matchesCounts(*fractionStreamed, fractionTwoPass) << endl;
+  delete fractionStreamed;
+  fractionCube.close();
+  QFile::remove("junk2.cub");
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  try {
+    Statistics badBand;
+    driver.addData(3, badBand);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    driver.setRegion(10, 1, 5, 10);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    driver.streamingHistogram(1, 0);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    driver.setLineIncrement(0);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  try {
+    driver.setValueLimit(0);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  cube.close();
+  QFile::remove("junk.cub");
+
+  return 0;
+}
+
+
+/**
+ * The value of a test cube pixel. Values are integers from 0 to 99 with some
+ * Null and His pixels.
+ */
+double pixel(int sample, int line, int band) {
+  if ((sample + 3 * line + band) % 53 == 0) {
+    return Null;
+  }
+  if ((sample * line + band) % 97 == 0) {
+    return His;
+  }
+  return (double)((sample * 7 + line * 13 + band * 29) % 100);
+}
+
+
+/**
+ * The value of a fractional test cube pixel. The values have many distinct
+ * fractions, so some fall close to histogram bin edges.
+ */
+double fraction(int sample, int line) {
+  if ((sample + line) % 61 == 0) {
+    return Null;
+  }
+  return ((sample * 31 + line * 17) % 2003) / 7.0 - 100.0;
+}
+
+
+/**
+ * Gathers statistics line by line, using the first line, every increment
+ * lines after it and the last line.
+ */
+void serialData(Cube &cube, int band, int startSample, int startLine,
+                int endSample, int endLine, int increment, Statistics &stats) {
+  int startBand = (band == 0) ? 1 : band;
+  int endBand = (band == 0) ? cube.bandCount() : band;
+  Brick brick(endSample - startSample + 1, 1, 1, cube.pixelType());
+  for (int b = startBand; b <= endBand; b++) {
+    for (int l = startLine; l <= endLine; l++) {
+      if ((l - startLine) % increment != 0 && l != endLine) continue;
+      brick.SetBasePosition(startSample, l, b);
+      cube.read(brick);
+      stats.AddData(brick.DoubleBuffer(), brick.size());
+    }
+  }
+}
+
+
+/**
+ * Gathers a histogram line by line.
+ */
+void serialData(Cube &cube, int band, Histogram &hist) {
+  LineManager line(cube);
+  for (int l = 1; l <= cube.lineCount(); l++) {
+    line.SetLine(l, band);
+    cube.read(line);
+    hist.AddData(line.DoubleBuffer(), line.size());
+  }
+}
+
+
+/**
+ * Compares the accumulators and counters of two Statistics objects.
+ */
+bool matches(const Statistics &a, const Statistics &b) {
+  return a.TotalPixels() == b.TotalPixels() && a.ValidPixels() == b.ValidPixels() &&
+         a.NullPixels() == b.NullPixels() && a.HisPixels() == b.HisPixels() &&
+         a.OverRangePixels() == b.OverRangePixels() &&
+         a.UnderRangePixels() == b.UnderRangePixels() &&
+         a.Sum() == b.Sum() && a.SumSquare() == b.SumSquare() &&
+         a.Minimum() == b.Minimum() && a.Maximum() == b.Maximum();
+}
+
+
+/**
+ * Compares the counters, minimum and maximum of two Statistics objects.
+ */
+bool matchesCounts(const Statistics &a, const Statistics &b) {
+  return a.TotalPixels() == b.TotalPixels() && a.ValidPixels() == b.ValidPixels() &&
+         a.NullPixels() == b.NullPixels() &&
+         a.Minimum() == b.Minimum() && a.Maximum() == b.Maximum();
+}
+
+
+/**
+ * Counts the bins of two histograms with the same bins that differ.
+ */
+int binDifferences(const Histogram &a, const Histogram &b) {
+  int count = 0;
+  for (int i = 0; i < a.Bins(); i++) {
+    if (a.BinCount(i) != b.BinCount(i)) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -9,6 +9,7 @@
 
 #include "Buffer.h"
 #include "Cube.h"
+#include "CubeStatisticsDriver.h"
 #include "FileList.h"
 #include "IException.h"
 #include "LeastSquares.h"
@@ -17,6 +18,7 @@
 #include "OverlapStatistics.h"
 #include "Process.h"
 #include "ProcessByLine.h"
+#include "Progress.h"
 #include "Projection.h"
 #include "Pvl.h"
 #include "PvlGroup.h"
@@ -210,21 +212,37 @@ namespace Isis {
       // OverlapNormalization will take ownership of these pointers
       vector<Statistics *> statsList;
       for (int img = 0; img < (int) m_imageList.size(); img++) {
-        ProcessByLine p;
         QString bandStr(toString(band));
         QString statMsg = "Calculating Statistics for Band " + bandStr +
             " of " + toString(m_maxBand) + " in Cube " + toString(img + 1) +
             " of " + toString(m_maxCube);
-        p.Progress()->SetText(statMsg);
-        CubeAttributeInput att("+" + bandStr);
         QString inp = m_imageList[img].toString();
-        p.SetInputCube(inp, att);
 
         Statistics *stats = new Statistics();
 
-        CalculateFunctor func(stats, m_samplingPercent);
-        p.ProcessCubeInPlace(func, false);
-        p.EndProcess();
+        if (CubeStatisticsDriver::parallelPreference()) {
+          // Reads the same lines as CalculateFunctor
+          Cube cube;
+          cube.open(inp);
+          Progress progress;
+          progress.SetText(statMsg);
+          progress.SetMaximumSteps(cube.lineCount());
+          progress.CheckStatus();
+
+          CubeStatisticsDriver driver(cube, &progress);
+          driver.setLineIncrement((int) (100.0 / m_samplingPercent + 0.5));
+          driver.addData(band, *stats);
+        }
+        else {
+          ProcessByLine p;
+          p.Progress()->SetText(statMsg);
+          CubeAttributeInput att("+" + bandStr);
+          p.SetInputCube(inp, att);
+
+          CalculateFunctor func(stats, m_samplingPercent);
+          p.ProcessCubeInPlace(func, false);
+          p.EndProcess();
+        }
 
         statsList.push_back(stats);
       }
@@ -134,6 +134,9 @@ namespace Isis {
    *                           in output PVL  on lines 100 and 123 to allow the test to pass when
    *                           not using the standard data areas. Added ReportError method to
    *                           remove paths when outputting errors. Fixes #4738.
+   *   @history 2018-09-07 Isis Development Team - calculateBandStatistics() reads the sampled
+   *                           lines with CubeStatisticsDriver in parallel when the
+   *                           ParallelStatistics preference is On.
    */
   class Equalization {
     public:
@@ -0,0 +1,129 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "FxKernel.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+#include <QVector>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "CubeInfixToPostfix.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the EQUATION parameter.
+   *
+   * @param parameters The parameters of the run
+   */
+  FxKernel::FxKernel(const QMap<QString, QString> &parameters) {
+    CubeInfixToPostfix infixToPostfix;
+    m_equation = infixToPostfix.convert(parameters["EQUATION"]);
+  }
+
+
+  //! Destroys the FxKernel
+  FxKernel::~FxKernel() {
+  }
+
+
+  /**
+   * Returns F1, the parameter of the input cube.
+   *
+   * @return QString The parameter name
+   */
+  QString FxKernel::InputParameter() const {
+    return "F1";
+  }
+
+
+  /**
+   * Returns true if the equation uses statistics of the input cube, such as
+   * cubemin.
+   *
+   * @return bool True if Prepare() reads the input pixels
+   */
+  bool FxKernel::PrepareReadsPixels() const {
+    foreach (QString token, m_equation.split(" ", QString::SkipEmptyParts)) {
+      if (token.startsWith("cube")) return true;
+    }
+    return false;
+  }
+
+
+  /**
+   * Prepares the calculations of the equation for the input cube.
+   *
+   * @param input The input cube
+   */
+  void FxKernel::Prepare(Cube &input) {
+    QVector<Cube *> cubes;
+    cubes.push_back(&input);
+    m_calculator.prepareCalculations(m_equation, cubes, &input);
+  }
+
+
+  /**
+   * Evaluates the equation for a line. A scalar result sets every pixel. The
+   * calculator is not thread safe, so lines are evaluated one at a time.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void FxKernel::Apply(Buffer &in, Buffer &out) const {
+    QVector<Buffer *> inputs;
+    inputs.push_back(&in);
+
+    QMutexLocker locker(&m_calculatorMutex);
+    QVector<double> results = m_calculator.runCalculations(inputs, in.Line(), in.Band());
+
+    if (results.size() == 1) {
+      for (int i = 0; i < out.size(); i++) {
+        out[i] = results[0];
+      }
+    }
+    else {
+      for (int i = 0; i < results.size(); i++) {
+        out[i] = results[i];
+      }
+    }
+  }
+}
+
+
+/**
+ * Creates an fx kernel, or NULL unless MODE is CUBES with only F1.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *FxKernelPlugin(const QMap<QString, QString> &parameters) {
+  if (parameters.value("MODE", "CUBES").toUpper() != "CUBES" ||
+      !parameters.contains("EQUATION") || parameters.contains("F2") ||
+      parameters.contains("F3") || parameters.contains("F4") ||
+      parameters.contains("F5")) {
+    return NULL;
+  }
+  return new Isis::FxKernel(parameters);
+}
@@ -0,0 +1,64 @@
+#ifndef FxKernel_h
+#define FxKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QMutex>
+#include <QString>
+
+#include "CubeCalculator.h"
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the fx program
+   *
+   * This kernel evaluates an equation for each pixel when fx reads the single
+   * cube F1.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class FxKernel : public PixelKernel {
+    public:
+      FxKernel(const QMap<QString, QString> &parameters);
+      ~FxKernel();
+
+      QString InputParameter() const;
+      bool PrepareReadsPixels() const;
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+
+    private:
+      QString m_equation;                  //!< The equation in postfix
+      mutable CubeCalculator m_calculator; //!< Evaluates the equation
+      mutable QMutex m_calculatorMutex;    //!< Guards the calculator
+  };
+};
+
+#endif
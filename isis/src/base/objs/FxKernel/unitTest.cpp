@@ -0,0 +1,84 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Cube.h"
+#include "FxKernel.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+using namespace std;
+
+extern "C" PixelKernel *FxKernelPlugin(const QMap<QString, QString> &parameters);
+
+
+/**
+ * Applies a kernel to a line of ones and prints the null pixels and the sum of
+ * the other pixels of the output.
+ */
+void printLine(const PixelKernel &kernel, Cube &cube, int line) {
+  LineManager in(cube);
+  LineManager out(cube);
+  in.SetLine(line);
+  out.SetLine(line);
+  for (int i = 0; i < in.size(); i++) {
+    in[i] = 1.0;
+  }
+
+  kernel.Apply(in, out);
+
+  int nulls = 0;
+  double sum = 0.0;
+  for (int i = 0; i < out.size(); i++) {
+    if (IsNullPixel(out[i])) {
+      nulls++;
+    }
+    else {
+      sum += out[i];
+    }
+  }
+
+  cout << "Line " << line << ": null pixels = " << nulls
+       << ", sum of the other pixels = " << sum << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+
+  cout << "Testing an fx kernel ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["EQUATION"] = "f1*3+1";
+
+  FxKernel fx(parameters);
+  fx.Prepare(cube);
+  printLine(fx, cube, 1);
+  cout << "Input parameter = " << fx.InputParameter() << endl;
+  cout << "Prepare reads pixels? " << fx.PrepareReadsPixels() << endl;
+  cout << endl;
+
+  cout << "Testing the plugin ..." << endl;
+  PixelKernel *kernel = FxKernelPlugin(parameters);
+  cout << "Kernel for MODE=CUBES? " << (kernel ? "Yes" : "No") << endl;
+  delete kernel;
+
+  parameters["MODE"] = "LIST";
+  kernel = FxKernelPlugin(parameters);
+  cout << "Kernel for MODE=LIST? " << (kernel ? "Yes" : "No") << endl;
+  delete kernel;
+
+  parameters["MODE"] = "CUBES";
+  parameters["F2"] = "$base/testData/isisTruth.cub";
+  kernel = FxKernelPlugin(parameters);
+  cout << "Kernel for F2? " << (kernel ? "Yes" : "No") << endl;
+  delete kernel;
+
+  cube.close();
+  return 0;
+}
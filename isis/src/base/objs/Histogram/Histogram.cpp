@@ -22,10 +22,12 @@
  */
 #include "Histogram.h"
 
-#include "Brick.h"
+#include <QDataStream>
+
 #include "ControlMeasure.h"
 #include "ControlNet.h"
 #include "ControlPoint.h"
+#include "CubeStatisticsDriver.h"
 #include "LineManager.h"
 #include "Message.h"
 #include "SpecialPixel.h"
@@ -85,9 +87,6 @@ namespace Isis {
                        endSample, endLine);
 
     if (addCubeData) {
-      Brick cubeDataBrick((int)(endSample - startSample + 1),
-                          1, 1, cube.pixelType());
-
       // if band == 0, then we're gathering data for all bands.
       int startBand = statsBand;
       int endBand = statsBand;
@@ -104,16 +103,10 @@ namespace Isis {
         progress->CheckStatus();
       }
 
-      for (int band = startBand; band <= endBand; band++) {
-        for (int line = (int)startLine; line <= endLine; line++) {
-          cubeDataBrick.SetBasePosition(qRound(startSample), line, band);
-          cube.read(cubeDataBrick);
-          AddData(cubeDataBrick.DoubleBuffer(), cubeDataBrick.size());
-          if (progress != NULL) {
-            progress->CheckStatus();
-          }
-        }
-      }
+      CubeStatisticsDriver driver(cube, progress);
+      driver.setRegion(qRound(startSample), (int)startLine,
+                       qRound(startSample) + (int)(endSample - startSample), (int)endLine);
+      driver.addData(statsBand, *this);
     }
   }
 
@@ -336,8 +329,6 @@ namespace Isis {
     // If we still need our min/max DN values, find them.
     if (minDnValue == Null || maxDnValue == Null) {
 
-      Brick cubeDataBrick((int)(endSample - startSample + 1),
-                          1, 1, cube.pixelType() );
       Statistics stats;
 
       // if band == 0, then we're gathering stats for all bands. I'm really
@@ -359,18 +350,10 @@ namespace Isis {
         progress->CheckStatus();
       }
 
-      for (int band = startBand; band <= endBand; band++) {
-        for (int line = (int)startLine; line <= endLine; line++) {
-
-          cubeDataBrick.SetBasePosition(qRound(startSample), line, band);
-          cube.read(cubeDataBrick);
-          stats.AddData(cubeDataBrick.DoubleBuffer(), cubeDataBrick.size());
-
-          if (progress != NULL) {
-            progress->CheckStatus();
-          }
-        }
-      }
+      CubeStatisticsDriver driver(cube, progress);
+      driver.setRegion(qRound(startSample), (int)startLine,
+                       qRound(startSample) + (int)(endSample - startSample), (int)endLine);
+      driver.addData(statsBand, stats);
 
       if (stats.ValidPixels() == 0) {
         minDnValue = 0.0;
@@ -450,20 +433,9 @@ namespace Isis {
                           const unsigned int count) {
     Statistics::AddData(data, count);
 
-    int nbins = p_bins.size();
-    int index;
     for (unsigned int i = 0; i < count; i++) {
       if (IsValidPixel(data[i]) && InRange(data[i]) ) {
-        if (BinRangeStart() == BinRangeEnd() ) {
-          index = 0;
-        }
-        else {
-          index = (int) floor((double)(nbins - 1) / (BinRangeEnd() - BinRangeStart()) *
-                              (data[i] - BinRangeStart() ) + 0.5);
-        }
-        if (index < 0) index = 0;
-        if (index >= nbins) index = nbins - 1;
-        p_bins[index] += 1;
+        p_bins[BinIndex(data[i])] += 1;
       }
     }
   }
@@ -479,19 +451,8 @@ namespace Isis {
   void Histogram::AddData(const double data) {
     Statistics::AddData(data);
 
-    int nbins = p_bins.size();
-    int index;
     if (IsValidPixel(data) && InRange(data) ) {
-      if (BinRangeStart() == BinRangeEnd() ) {
-        index = 0;
-      }
-      else {
-        index = (int) floor((double)(nbins - 1) / (BinRangeEnd() - BinRangeStart() ) *
-                            (data - BinRangeStart() ) + 0.5);
-      }
-      if (index < 0) index = 0;
-      if (index >= nbins) index = nbins - 1;
-      p_bins[index] += 1;
+      p_bins[BinIndex(data)] += 1;
     }
   }
 
@@ -509,25 +470,74 @@ namespace Isis {
                              const unsigned int count) {
     Statistics::RemoveData(data, count);
 
-    int nbins = p_bins.size();
-    int index;
     for (unsigned int i = 0; i < count; i++) {
       if (IsValidPixel(data[i]) ) {
+        p_bins[BinIndex(data[i])] -= 1;
+      }
+    }
+  }
+
+
+  /**
+   * Adds the counts of another histogram to this one. If both histograms have
+   * the same bins and bin range, the bin counts are the same as adding the
+   * other histogram's data to this one; the statistics are merged with
+   * Statistics::Merge(), so their sums can differ in the last bits. Otherwise
+   * the count of each of the other histogram's bins is added to the bin of
+   * this histogram that holds the middle of that bin, so the counts may be off
+   * by one bin where the bins of the two histograms overlap.
+   *
+   * @param other The histogram to merge into this one
+   */
+  void Histogram::Merge(const Histogram &other) {
+    Statistics::Merge(other);
+
+    if (other.Bins() == Bins() && other.BinRangeStart() == BinRangeStart() &&
+        other.BinRangeEnd() == BinRangeEnd()) {
+      for (int i = 0; i < (int)p_bins.size(); i++) {
+        p_bins[i] += other.p_bins[i];
+      }
+      return;
+    }
+
+    for (int i = 0; i < other.Bins(); i++) {
+      if (other.p_bins[i] == 0) continue;
 
-        if (BinRangeStart() == BinRangeEnd() ) {
-          index = 0;
-        }
-        else {
-          index = (int) floor((double)(nbins - 1) / (BinRangeEnd() - BinRangeStart()) *
-                              (data[i] - BinRangeStart()) + 0.5);
-        }
-        if (index < 0) index = 0;
-        if (index >= nbins) index = nbins - 1;
-        p_bins[index] -= 1;
+      double middle;
+      if (other.Bins() == 1) {
+        middle = (other.BinRangeStart() + other.BinRangeEnd()) / 2.0;
+      }
+      else {
+        middle = other.BinMiddle(i);
       }
+      p_bins[BinIndex(middle)] += other.p_bins[i];
     }
   }
 
+
+  /**
+   * Returns the index of the bin that a value falls in. Values outside of the
+   * bin range are put in the first or last bin.
+   *
+   * @param data The value to find the bin for
+   *
+   * @return @b int The bin index
+   */
+  int Histogram::BinIndex(const double data) const {
+    int nbins = p_bins.size();
+    int index;
+    if (BinRangeStart() == BinRangeEnd() ) {
+      index = 0;
+    }
+    else {
+      index = (int) floor((double)(nbins - 1) / (BinRangeEnd() - BinRangeStart()) *
+                          (data - BinRangeStart()) + 0.5);
+    }
+    if (index < 0) index = 0;
+    if (index >= nbins) index = nbins - 1;
+    return index;
+  }
+
   /**
    * Returns the median.
    *
@@ -716,4 +726,72 @@ namespace Isis {
 
     return maxBinCount;
   }
+
+
+  /**
+   * Writes the statistics, the bin range and the bin counts to a binary
+   * stream. Only the counts from the first to the last nonzero bin are
+   * written.
+   *
+   * @param stream The stream to write to
+   *
+   * @return The stream
+   */
+  QDataStream &Histogram::write(QDataStream &stream) const {
+    Statistics::write(stream);
+
+    qint32 firstBin = 0;
+    qint32 lastBin = -1;
+    for (int i = 0; i < (int)p_bins.size(); i++) {
+      if (p_bins[i] != 0) {
+        if (lastBin < 0) firstBin = i;
+        lastBin = i;
+      }
+    }
+
+    stream << p_binRangeStart
+           << p_binRangeEnd
+           << (qint32)p_bins.size()
+           << firstBin
+           << lastBin;
+    for (int i = firstBin; i <= lastBin; i++) {
+      stream << (qint64)p_bins[i];
+    }
+    return stream;
+  }
+
+
+  /**
+   * Reads a histogram written by write(), replacing the statistics, bin range
+   * and bin counts of this histogram.
+   *
+   * @param stream The stream to read from
+   *
+   * @return The stream
+   *
+   * @throws IException::Io "Unable to read histogram"
+   */
+  QDataStream &Histogram::read(QDataStream &stream) {
+    Statistics::read(stream);
+
+    qint32 bins, firstBin, lastBin;
+    stream >> p_binRangeStart
+           >> p_binRangeEnd
+           >> bins
+           >> firstBin
+           >> lastBin;
+
+    if (bins < 1 || firstBin < 0 || lastBin >= bins) {
+      string msg = "Unable to read histogram with [" + IString((int)bins) + "] bins";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    p_bins.assign(bins, 0);
+    for (int i = firstBin; i <= lastBin; i++) {
+      qint64 count;
+      stream >> count;
+      p_bins[i] = count;
+    }
+    return stream;
+  }
 }
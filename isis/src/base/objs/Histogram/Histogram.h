@@ -79,6 +79,15 @@ namespace Isis {
    *   @history 2017-09-08 Summer Stapleton - Included test for Isis::Null being returned from
    *                            accessor method call in Histogram::rangesFromNet(). Fixes #5123,
    *                            #1673.
+   *   @history 2018-09-07 Isis Development Team - Added Merge() to combine histograms gathered
+   *                            separately, for example by separate threads. The min/max and
+   *                            binning passes of the cube constructor now read the cube with
+   *                            CubeStatisticsDriver, in parallel when the ParallelStatistics
+   *                            preference is On.
+   *   @history 2018-09-07 Isis Development Team - Added QDataStream write() and read() so
+   *                            histograms can be stored in a cube's statistics cache.
+   *   @history 2018-09-07 Isis Development Team - Made CubeStatisticsDriver a friend so its
+   *                            streaming histogram can add counted values to the bins.
    */
 
   class Histogram : public Statistics {
@@ -103,6 +112,8 @@ namespace Isis {
       void AddData(const double data);
       void RemoveData(const double *data, const unsigned int count);
 
+      void Merge(const Histogram &other);
+
       double Median() const;
       double Mode() const;
       double Percent(const double percent) const;
@@ -115,6 +126,9 @@ namespace Isis {
       int Bins() const;
       BigInt MaxBinCount() const;
 
+      QDataStream &write(QDataStream &stream) const;
+      QDataStream &read(QDataStream &stream);
+
       double BinRangeStart() const {
         return p_binRangeStart;
       }
@@ -126,10 +140,15 @@ namespace Isis {
                                        const double maximum = Isis::ValidMaximum);
 
     private:
+      // Adds the distinct value counts of a streaming histogram to p_bins
+      friend class CubeStatisticsDriver;
+
       void InitializeFromCube(Cube &cube, int statsBand, Progress *progress,
           int nbins = 0, double startSample = Null, double startLine = Null,
           double endSample = Null, double endLine = Null);
 
+      int BinIndex(const double data) const;
+
       void addMeasureDataFromNet(ControlNet &net, double(ControlMeasure::*statFunc)() const);
       void rangesFromNet(ControlNet &net, double(ControlMeasure::*statFunc)() const);
 
@@ -347,6 +347,25 @@ int main(int argc, char *argv[]) {
 
     delete(ahist); delete(bhist);
 
+    cout << "Merging the histograms of a and b..." << endl;
+    Isis::Histogram merged(low1, high1, nbins);
+    merged.AddData(a, 9);
+    Isis::Histogram bMerge(low1, high1, nbins);
+    bMerge.AddData(b, 9);
+    merged.Merge(bMerge);
+    histDisplay(&merged);
+    cout << "Valid Pixels: " << merged.ValidPixels() << endl;
+    cout << endl;
+
+    cout << "Merging a 21 bin histogram of b into a 5 bin histogram..." << endl;
+    Isis::Histogram fine(low1, high1, 21);
+    fine.AddData(b, 9);
+    Isis::Histogram coarse(low1, high1, nbins);
+    coarse.Merge(fine);
+    histDisplay(&coarse);
+    cout << "Valid Pixels: " << coarse.ValidPixels() << endl;
+    cout << endl;
+
 
   }//end try block
 
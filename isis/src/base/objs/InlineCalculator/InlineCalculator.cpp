@@ -133,6 +133,7 @@ namespace Isis {
     Clear();  // Clear the stack
     m_equation = equation;
     m_functions.clear();  // Clear function list
+    m_program.clear();
  
     QStringList tokenList = tokenOps.split(" ");
     while ( !tokenList.isEmpty() ) {
@@ -150,11 +151,13 @@ namespace Isis {
         // they do not already exist (they would be found above then)
         else if ( isScalar(token)  ) {
           fx = addFunction(new ParameterFx(token, &InlineCalculator::scalar, this));
+          m_parameters.insert(fx);
           m_functions.push_back(fx);
         }
         else if ( isVariable(token)  ) {
           // Will also get line, sample, band, etc...
           fx = addFunction(new ParameterFx(token, &InlineCalculator::variable, this));
+          m_parameters.insert(fx);
           m_functions.push_back(fx);
         }
         else {
@@ -181,6 +184,8 @@ namespace Isis {
     if (nerrors > 0) {  
       throw errList;
     }
+
+    compileProgram(tokenOps.split(" "));
     return (nerrors == 0);
   }
  
@@ -233,6 +238,9 @@ namespace Isis {
    *  
    */
   QVector<double> InlineCalculator::evaluate() {
+    if ( m_program.isValid() && StackSize() == 0 ) {
+      return (evaluateProgram());
+    }
  
     BOOST_FOREACH (FxTypePtr function,  m_functions) {
       function->execute();
@@ -324,17 +332,8 @@ namespace Isis {
    * @throw IException::User "Could not find variable in variable pool."
    */  
   void InlineCalculator::variable(const QVariant &variable) {
-    CalculatorVariablePool *variablePool = variables();
-    QString key = variable.toString();
-    if (variablePool->exists(key)) {
-      QVector<double> values = variablePool->value(key);
-      Push(values);
-      return;
-    }
- 
-    // Error!
-    QString error = "Could not find variable [" + key + "] in variable pool.";
-    throw IException(IException::User, error, _FILEINFO_);
+    QVector<double> values = variableValue(variable.toString());
+    Push(values);
   }
  
 
@@ -572,6 +571,184 @@ namespace Isis {
   }
  
  
+  /**
+   * Looks up the values of a variable in the current variable pool.
+   *
+   * @param key The name of the variable
+   *
+   * @return QVector<double> The values of the variable
+   *
+   * @throw IException::User "Could not find variable in variable pool."
+   */
+  QVector<double> InlineCalculator::variableValue(const QString &key) {
+    CalculatorVariablePool *variablePool = variables();
+    if (variablePool->exists(key)) {
+      return (variablePool->value(key));
+    }
+
+    // Error!
+    QString error = "Could not find variable [" + key + "] in variable pool.";
+    throw IException(IException::User, error, _FILEINFO_);
+  }
+
+
+  /**
+   * @brief Compiles the postfix tokens into a CalculatorProgram
+   *
+   * Scalars and the pi and e constants become program constants, each
+   * variable becomes an input of the program, and the operators become program
+   * operations. If a token is a function added by a derived class, or the
+   * equation is missing operands, the program is left invalid and evaluate()
+   * runs the functions on the stack instead.
+   *
+   * @param tokens The equation's tokens, in postfix order
+   */
+  void InlineCalculator::compileProgram(const QStringList &tokens) {
+    m_program.clear();
+    m_programVariables.clear();
+
+    bool compiled = true;
+    for (int i = 0; compiled && i < tokens.size(); i++) {
+      const QString &token = tokens[i];
+      if ( token.isEmpty() ) {
+        continue;
+      }
+
+      CalculatorProgram::Operation operation;
+      if ( m_parameters.contains(find(token)) ) {
+        if ( isScalar(token) ) {
+          m_program.pushConstant(toDouble(token));
+        }
+        else {
+          m_program.pushInput(m_programVariables.size(), false);
+          m_programVariables.append(token);
+        }
+      }
+      else if ( token == "pi" ) {
+        m_program.pushConstant(pi_c());
+      }
+      else if ( token == "e" ) {
+        m_program.pushConstant(E);
+      }
+      else if ( token == "rads" ) {
+        m_program.pushConstant(rpd_c());
+        compiled = m_program.addOperation(CalculatorProgram::Multiply);
+      }
+      else if ( token == "degs" ) {
+        m_program.pushConstant(dpr_c());
+        compiled = m_program.addOperation(CalculatorProgram::Multiply);
+      }
+      else if ( programOperation(token, operation) ) {
+        compiled = m_program.addOperation(operation);
+      }
+      else {
+        compiled = false;
+      }
+    }
+
+    if ( !compiled ) {
+      m_program.clear();
+      m_programVariables.clear();
+    }
+
+    m_programValues.resize(m_programVariables.size());
+    m_programInputs.resize(m_programVariables.size());
+    m_programInputSizes.resize(m_programVariables.size());
+  }
+
+
+  /**
+   * Evaluates the compiled program with the variables in the current pool.
+   * Each variable is looked up once for every time it occurs in the equation,
+   * just as the stack evaluation does.
+   *
+   * @return QVector \< double \> Result of the stored equation.
+   */
+  QVector<double> InlineCalculator::evaluateProgram() {
+    for (int i = 0; i < m_programVariables.size(); i++) {
+      m_programValues[i] = variableValue(m_programVariables[i]);
+      m_programInputs[i] = m_programValues[i].constData();
+      m_programInputSizes[i] = m_programValues[i].size();
+    }
+
+    QVector<double> results;
+    m_program.evaluate(m_programInputs, m_programInputSizes, results);
+    return (results);
+  }
+
+
+  /**
+   * Finds the CalculatorProgram operation for an operator or function added by
+   * initialize().
+   *
+   * @param token The operator or function name
+   * @param operation [out] The matching operation
+   *
+   * @return bool False if the token has no matching operation
+   */
+  bool InlineCalculator::programOperation(const QString &token,
+                                          CalculatorProgram::Operation &operation) {
+    struct TokenOperation {
+      const char *token;
+      CalculatorProgram::Operation operation;
+    };
+
+    static const TokenOperation tokenOperations[] = {
+      { "^",      CalculatorProgram::Exponent },
+      { "/",      CalculatorProgram::Divide },
+      { "*",      CalculatorProgram::Multiply },
+      { "<<",     CalculatorProgram::LeftShift },
+      { ">>",     CalculatorProgram::RightShift },
+      { "+",      CalculatorProgram::Add },
+      { "-",      CalculatorProgram::Subtract },
+      { ">",      CalculatorProgram::GreaterThan },
+      { "<",      CalculatorProgram::LessThan },
+      { ">=",     CalculatorProgram::GreaterThanOrEqual },
+      { "<=",     CalculatorProgram::LessThanOrEqual },
+      { "==",     CalculatorProgram::Equal },
+      { "!=",     CalculatorProgram::NotEqual },
+      { "&",      CalculatorProgram::And },
+      { "and",    CalculatorProgram::And },
+      { "|",      CalculatorProgram::Or },
+      { "or",     CalculatorProgram::Or },
+      { "%",      CalculatorProgram::FloatModulus },
+      { "mod",    CalculatorProgram::Modulus },
+      { "fmod",   CalculatorProgram::FloatModulus },
+      { "--",     CalculatorProgram::Negative },
+      { "neg",    CalculatorProgram::Negative },
+      { "min",    CalculatorProgram::MinimumPixel },
+      { "max",    CalculatorProgram::MaximumPixel },
+      { "abs",    CalculatorProgram::AbsoluteValue },
+      { "sqrt",   CalculatorProgram::SquareRoot },
+      { "log",    CalculatorProgram::Log },
+      { "ln",     CalculatorProgram::Log },
+      { "log10",  CalculatorProgram::Log10 },
+      { "sin",    CalculatorProgram::Sine },
+      { "cos",    CalculatorProgram::Cosine },
+      { "tan",    CalculatorProgram::Tangent },
+      { "sec",    CalculatorProgram::Secant },
+      { "csc",    CalculatorProgram::Cosecant },
+      { "cot",    CalculatorProgram::Cotangent },
+      { "asin",   CalculatorProgram::Arcsine },
+      { "acos",   CalculatorProgram::Arccosine },
+      { "atan",   CalculatorProgram::Arctangent },
+      { "atan2",  CalculatorProgram::Arctangent2 },
+      { "||",     CalculatorProgram::LogicalOr },
+      { "&&",     CalculatorProgram::LogicalAnd }
+    };
+
+    int count = sizeof(tokenOperations) / sizeof(tokenOperations[0]);
+    for (int i = 0; i < count; i++) {
+      if ( token == tokenOperations[i].token ) {
+        operation = tokenOperations[i].operation;
+        return (true);
+      }
+    }
+
+    return (false);
+  }
+ 
+ 
   /**
    * Gets a pointer to the function from the current pool that corresponds
    * to the given function name. This method returns null if no function
@@ -666,6 +843,8 @@ namespace Isis {
  
     m_fxPool.clear();
     m_functions.clear();
+    m_parameters.clear();
+    m_program.clear();
     return;
   }
 
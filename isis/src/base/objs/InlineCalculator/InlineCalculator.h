@@ -30,9 +30,13 @@
 
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
+#include "CalculatorProgram.h"
+
 class QVariant;
 
 namespace Isis {
@@ -63,6 +67,11 @@ namespace Isis {
    *   @history 2016-02-21 Kristin Berry - Added unit test and minor coding standard updates.
    *                                       Fixes #2401.
    *   @history 2017-01-09 Jesse Mapel - Added logical and, or operators. Fixes #4581.
+   *   @history 2018-09-07 Isis Development Team - compile() now also compiles the equation
+   *                           into a CalculatorProgram, which evaluate() runs over whole
+   *                           variable arrays without building a vector for each operator.
+   *                           Equations with functions added by derived classes still run
+   *                           on the stack.
    */
   class InlineCalculator : public Calculator {
  
@@ -116,6 +125,12 @@ namespace Isis {
       void pushVariables(CalculatorVariablePool *variablePool);
       CalculatorVariablePool *variables();
       void popVariables();
+      QVector<double> variableValue(const QString &key);
+
+      void compileProgram(const QStringList &tokens);
+      QVector<double> evaluateProgram();
+      static bool programOperation(const QString &token,
+                                   CalculatorProgram::Operation &operation);
  
       FxTypePtr find(const QString &fxname);
       void initialize();
@@ -125,6 +140,13 @@ namespace Isis {
       FxPoolType  m_fxPool;    //!< The map between function names and equation lists.
       QString     m_equation;  //!< The equation to be evaluated.
       QList<CalculatorVariablePool *> m_variablePoolList; //!< The list of variable pool pointers.
+
+      CalculatorProgram m_program;         //!< The equation compiled for array evaluation.
+      QSet<FxTypePtr> m_parameters;        //!< Scalar and variable functions made by compile().
+      QStringList m_programVariables;      //!< Variables of the program's inputs, in order.
+      QVector< QVector<double> > m_programValues; //!< Values of the program's variables.
+      QVector<const double *> m_programInputs;    //!< The program's input arrays.
+      QVector<int> m_programInputSizes;           //!< The sizes of the program's inputs.
  
   };
  
@@ -32,6 +32,7 @@
 #include <QCoreApplication>
 
 #include "Application.h"
+#include "ApplicationDaemon.h"
 #include "UserInterface.h" // this is an unnecessary include
 
 #ifndef APPLICATION
@@ -81,6 +82,8 @@
  *                                      isis.astrogeology...
  *   @history 2006-03-18 Elizabeth Miller - Added gui helper stuff
  *   @history 2006-05-17 Elizabeth Miller - Removed .xml and documented .h file
+ *   @history 2018-09-07 Isis Development Team - Runs are sent to a resident
+ *                                      worker when ISISDAEMON names one
  */
 std::map<QString, void *> GuiHelpers();
 #ifndef GUIHELPERS
@@ -114,6 +117,12 @@ int main(int argc, char *argv[]) {
   signal(SIGINT, InterruptSignal);
 #endif
 
+  // Let a resident worker for this program do the run if there is one
+  int daemonStatus = 0;
+  if (Isis::ApplicationDaemon::RunRemote(argc, argv, daemonStatus)) {
+    return daemonStatus;
+  }
+
   Isis::Application::p_applicationForceGuiApp  = false;
 
 #ifdef USE_GUI_QAPP
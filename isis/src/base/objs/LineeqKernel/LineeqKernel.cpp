@@ -0,0 +1,213 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "LineeqKernel.h"
+
+#include <QScopedPointer>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "FileName.h"
+#include "IException.h"
+#include "IString.h"
+#include "LineManager.h"
+#include "Progress.h"
+#include "PvlKeyword.h"
+#include "QuickFilter.h"
+#include "SpecialPixel.h"
+#include "Statistics.h"
+#include "TextFile.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the BOXTYPE, BOXSIZE, AVERAGES and CSV parameters.
+   *
+   * @param parameters The parameters of the run
+   */
+  LineeqKernel::LineeqKernel(const QMap<QString, QString> &parameters) {
+    m_boxType = StringParameter(parameters, "BOXTYPE", "NONE");
+    m_boxSize = IntegerParameter(parameters, "BOXSIZE", 0);
+    m_averages = BooleanParameter(parameters, "AVERAGES", false);
+    m_csvFile = parameters.value("CSV");
+    m_boxcarSize = 0;
+  }
+
+
+  //! Destroys the LineeqKernel
+  LineeqKernel::~LineeqKernel() {
+  }
+
+
+  /**
+   * Returns true, as the line averages are read from the input cube.
+   *
+   * @return bool True
+   */
+  bool LineeqKernel::PrepareReadsPixels() const {
+    return true;
+  }
+
+
+  /**
+   * Gathers the average of each line of the input cube and smooths them with
+   * a boxcar, writing both to the CSV file if AVERAGES is true.
+   *
+   * @param input The input cube
+   *
+   * @throws Isis::IException::User - The cube has no valid data
+   */
+  void LineeqKernel::Prepare(Cube &input) {
+    int lineCount = input.lineCount();
+    int bandCount = input.bandCount();
+
+    if (m_boxType == "ABSOLUTE") {
+      m_boxcarSize = m_boxSize;
+    }
+    else if (m_boxType == "PERCENTAGE") {
+      m_boxcarSize = (int)(((double)m_boxSize / 100.0) * lineCount);
+    }
+    else {
+      m_boxcarSize = (int)(lineCount * 0.10);
+    }
+
+    // Boxcar must be odd size
+    if (m_boxcarSize % 2 != 1) {
+      m_boxcarSize++;
+    }
+
+    m_cubeAverages.assign(bandCount, 0.0);
+    m_lineAverages.assign(bandCount, std::vector<double>(lineCount));
+    int ignoredLines = 0;
+
+    Progress gathering;
+    gathering.SetText("Gathering line averages");
+    gathering.SetMaximumSteps(lineCount * bandCount);
+    gathering.CheckStatus();
+
+    LineManager lines(input);
+    for (lines.begin(); !lines.end(); lines++) {
+      input.read(lines);
+
+      Statistics lineStats;
+      lineStats.AddData(lines.DoubleBuffer(), lines.size());
+      double average = lineStats.Average();
+
+      // The cube average is finished once every line is gathered
+      m_lineAverages[lines.Band() - 1][lines.Line() - 1] = average;
+      if (!IsSpecial(average)) {
+        m_cubeAverages[lines.Band() - 1] += average;
+      }
+      else {
+        ignoredLines++;
+      }
+
+      gathering.CheckStatus();
+    }
+
+    if (lineCount <= ignoredLines) {
+      throw IException(IException::User, "Image does not contain any valid data.",
+                       _FILEINFO_);
+    }
+
+    QScopedPointer<TextFile> csvOutput;
+    if (m_averages) {
+      csvOutput.reset(new TextFile(FileName(m_csvFile).expanded(), "overwrite", ""));
+      csvOutput->PutLine("Average,SmoothedAvg");
+    }
+
+    Progress smoothing;
+    smoothing.SetText("Smoothing line averages");
+    smoothing.SetMaximumSteps(lineCount * bandCount);
+    smoothing.CheckStatus();
+
+    QuickFilter filter(lineCount, m_boxcarSize, 1);
+    for (int band = 0; band < bandCount; band++) {
+      m_cubeAverages[band] /= (lineCount - ignoredLines);
+      filter.AddLine(&m_lineAverages[band][0]);
+
+      for (int line = 0; line < lineCount; line++) {
+        double filteredLine = filter.Average(line);
+
+        if (!csvOutput.isNull()) {
+          csvOutput->PutLine(toString(m_lineAverages[band][line]) + (QString)"," +
+                             toString(filteredLine));
+        }
+
+        m_lineAverages[band][line] = filteredLine;
+        smoothing.CheckStatus();
+      }
+
+      filter.RemoveLine(&m_lineAverages[band][0]);
+    }
+  }
+
+
+  /**
+   * Scales the valid pixels of a line by the cube average over the smoothed
+   * line average.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void LineeqKernel::Apply(Buffer &in, Buffer &out) const {
+    double cubeAverage = m_cubeAverages[in.Band() - 1];
+    double lineAverage = m_lineAverages[in.Band() - 1][in.Line() - 1];
+
+    for (int i = 0; i < in.size(); i++) {
+      double value = in[i];
+      if (!IsSpecial(value)) {
+        out[i] = value * cubeAverage / lineAverage;
+      }
+      else {
+        out[i] = value;
+      }
+    }
+  }
+
+
+  /**
+   * Returns the boxcar size and the CSV file of the run.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup LineeqKernel::Results() const {
+    PvlGroup data("lineeq");
+    data += PvlKeyword("BoxcarSize", toString(m_boxcarSize), "lines");
+    data += PvlKeyword("OutputCsv", toString((int)m_averages));
+    if (m_averages) {
+      data += PvlKeyword("CsvFile", FileName(m_csvFile).expanded());
+    }
+    return data;
+  }
+}
+
+
+/**
+ * Creates a lineeq kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *LineeqKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::LineeqKernel(parameters);
+}
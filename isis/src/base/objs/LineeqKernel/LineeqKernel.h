@@ -0,0 +1,70 @@
+#ifndef LineeqKernel_h
+#define LineeqKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <vector>
+
+#include <QString>
+
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the lineeq program
+   *
+   * This kernel scales each line so its average matches the smoothed averages
+   * of the lines around it. The line averages are gathered from the input cube
+   * in Prepare().
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class LineeqKernel : public PixelKernel {
+    public:
+      LineeqKernel(const QMap<QString, QString> &parameters);
+      ~LineeqKernel();
+
+      bool PrepareReadsPixels() const;
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+      PvlGroup Results() const;
+
+    private:
+      QString m_boxType;    //!< NONE, ABSOLUTE or PERCENTAGE
+      int m_boxSize;        //!< The boxcar size in lines or percent
+      bool m_averages;      //!< True if the averages are written to a CSV file
+      QString m_csvFile;    //!< The CSV file name
+      int m_boxcarSize;     //!< The boxcar size in lines
+      std::vector<double> m_cubeAverages; //!< The average of each band
+      //! The smoothed average of each line of each band
+      std::vector< std::vector<double> > m_lineAverages;
+  };
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "LineeqKernel.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+
+using namespace Isis;
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  cout << "Testing a lineeq kernel ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["BOXTYPE"] = "absolute";
+  parameters["BOXSIZE"] = "10";
+
+  LineeqKernel lineeq(parameters);
+  cout << "Input parameter = " << lineeq.InputParameter() << endl;
+  cout << "Prepare reads pixels? " << lineeq.PrepareReadsPixels() << endl;
+  cout << lineeq.Results() << endl;
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "MaskKernel.h"
+
+#include <QMutexLocker>
+
+#include "Buffer.h"
+#include "IException.h"
+#include "IString.h"
+#include "LineManager.h"
+#include "PvlKeyword.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the MASK, MINIMUM, MAXIMUM, PRESERVE and SPIXELS
+   * parameters.
+   *
+   * @param parameters The parameters of the run
+   */
+  MaskKernel::MaskKernel(const QMap<QString, QString> &parameters) {
+    m_maskName = parameters.value("MASK");
+    m_minimum = DoubleParameter(parameters, "MINIMUM", VALID_MIN8);
+    m_maximum = DoubleParameter(parameters, "MAXIMUM", VALID_MAX8);
+    m_preserveInside = StringParameter(parameters, "PRESERVE", "INSIDE") != "OUTSIDE";
+
+    QString specialPixels = StringParameter(parameters, "SPIXELS", "NULL");
+    m_specialPixels = MaskNull;
+    if (specialPixels == "NONE") m_specialPixels = MaskNone;
+    if (specialPixels == "ALL") m_specialPixels = MaskAll;
+
+    m_pixelsMasked = 0;
+  }
+
+
+  //! Destroys the MaskKernel
+  MaskKernel::~MaskKernel() {
+  }
+
+
+  /**
+   * Opens the mask cube, which must be the size of the input cube and have
+   * one band.
+   *
+   * @param input The input cube
+   *
+   * @throws Isis::IException::User - The mask has more than one band
+   */
+  void MaskKernel::Prepare(Cube &input) {
+    if (m_maskName.isEmpty()) return;
+
+    m_mask.reset(OpenSecondaryCube(m_maskName, input));
+    if (m_mask->bandCount() != 1) {
+      QString msg = "The MASK input must be a single band.";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Masks the pixels of a line.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void MaskKernel::Apply(Buffer &in, Buffer &out) const {
+    BigInt masked = 0;
+
+    if (m_mask.isNull()) {
+      masked = applyMask(in, in, out);
+    }
+    else {
+      LineManager mask(*m_mask);
+      mask.SetLine(in.Line());
+      m_mask->read(mask);
+      masked = applyMask(in, mask, out);
+    }
+
+    QMutexLocker locker(&m_pixelsMaskedMutex);
+    m_pixelsMasked += masked;
+  }
+
+
+  /**
+   * Returns the number of pixels masked.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup MaskKernel::Results() const {
+    PvlGroup results("Results");
+    PvlKeyword pixelsMasked("PixelsMasked", toString((double) m_pixelsMasked));
+    if (m_pixelsMasked == 0) {
+      pixelsMasked.addComment("No pixels were masked for this image");
+    }
+    results += pixelsMasked;
+    return results;
+  }
+
+
+  /**
+   * Masks the pixels of a line with the pixels of a mask line, which can be
+   * the input line.
+   *
+   * @param in The input pixels
+   * @param mask The mask pixels
+   * @param out The output pixels
+   *
+   * @return BigInt The number of pixels masked
+   */
+  BigInt MaskKernel::applyMask(Buffer &in, Buffer &mask, Buffer &out) const {
+    BigInt masked = 0;
+
+    for (int i = 0; i < in.size(); i++) {
+      double value = in[i];
+      double maskValue = mask[i];
+
+      bool preserve;
+      if (IsSpecial(maskValue)) {
+        preserve = m_specialPixels == MaskNone ||
+                   (m_specialPixels == MaskNull && maskValue != NULL8);
+      }
+      else if (m_preserveInside) {
+        preserve = maskValue >= m_minimum && maskValue <= m_maximum;
+      }
+      else {
+        preserve = maskValue < m_minimum || maskValue > m_maximum;
+      }
+
+      if (preserve) {
+        out[i] = value;
+      }
+      else {
+        out[i] = NULL8;
+        masked++;
+      }
+    }
+
+    return masked;
+  }
+}
+
+
+/**
+ * Creates a mask kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *MaskKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::MaskKernel(parameters);
+}
@@ -0,0 +1,79 @@
+#ifndef MaskKernel_h
+#define MaskKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+
+#include "Constants.h"
+#include "Cube.h"
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the mask program
+   *
+   * This kernel sets the pixels to NULL where the MASK cube, or the input cube
+   * if there is no mask, is outside a range.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class MaskKernel : public PixelKernel {
+    public:
+      MaskKernel(const QMap<QString, QString> &parameters);
+      ~MaskKernel();
+
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+      PvlGroup Results() const;
+
+    private:
+      //! The special pixels of the mask that mask the input
+      enum SpecialPixels {
+        MaskNone,
+        MaskNull,
+        MaskAll
+      };
+
+      BigInt applyMask(Buffer &in, Buffer &mask, Buffer &out) const;
+
+      QString m_maskName;            //!< The mask file name, empty if none
+      QScopedPointer<Cube> m_mask;   //!< The mask cube
+      double m_minimum;              //!< The minimum of the range
+      double m_maximum;              //!< The maximum of the range
+      bool m_preserveInside;         //!< True if pixels inside the range are kept
+      SpecialPixels m_specialPixels; //!< The special pixels that mask
+      mutable BigInt m_pixelsMasked; //!< The number of pixels masked
+      mutable QMutex m_pixelsMaskedMutex; //!< Guards the number masked
+  };
+};
+
+#endif
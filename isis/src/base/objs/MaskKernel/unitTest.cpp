@@ -0,0 +1,72 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Cube.h"
+#include "LineManager.h"
+#include "MaskKernel.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+using namespace std;
+
+/**
+ * Applies a kernel to a line of ones and prints the null pixels and the sum of
+ * the other pixels of the output.
+ */
+void printLine(const PixelKernel &kernel, Cube &cube, int line) {
+  LineManager in(cube);
+  LineManager out(cube);
+  in.SetLine(line);
+  out.SetLine(line);
+  for (int i = 0; i < in.size(); i++) {
+    in[i] = 1.0;
+  }
+
+  kernel.Apply(in, out);
+
+  int nulls = 0;
+  double sum = 0.0;
+  for (int i = 0; i < out.size(); i++) {
+    if (IsNullPixel(out[i])) {
+      nulls++;
+    }
+    else {
+      sum += out[i];
+    }
+  }
+
+  cout << "Line " << line << ": null pixels = " << nulls
+       << ", sum of the other pixels = " << sum << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+
+  cout << "Testing a mask kernel without a mask cube ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["MINIMUM"] = "2";
+
+  MaskKernel mask(parameters);
+  mask.Prepare(cube);
+  printLine(mask, cube, 1);
+  cout << mask.Results()["PixelsMasked"] << endl;
+  cout << endl;
+
+  cout << "Testing a mask kernel that preserves outside the range ..." << endl;
+  parameters["PRESERVE"] = "outside";
+  MaskKernel outside(parameters);
+  outside.Prepare(cube);
+  printLine(outside, cube, 1);
+  cout << outside.Results()["PixelsMasked"] << endl;
+
+  cube.close();
+  return 0;
+}
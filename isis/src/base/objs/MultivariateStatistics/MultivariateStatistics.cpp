@@ -160,6 +160,25 @@ namespace Isis {
   }
 
 
+  /**
+   * Adds the accumulators and counters of another MultivariateStatistics
+   * object to this one. The counts are the same as if its data had been added
+   * to this object; the sums can differ in the last bits, as they do for
+   * Statistics::Merge().
+   *
+   * @param other The statistics to merge into this object
+   */
+  void MultivariateStatistics::Merge(const MultivariateStatistics &other) {
+    p_x.Merge(other.p_x);
+    p_y.Merge(other.p_y);
+    p_sumxy += other.p_sumxy;
+
+    p_validPixels += other.p_validPixels;
+    p_invalidPixels += other.p_invalidPixels;
+    p_totalPixels += other.p_totalPixels;
+  }
+
+
   /**
    * Computes and returns the covariance between the two data sets If there are
    * no valid data (pixels) then NULL8 is returned.
@@ -60,6 +60,8 @@ namespace Isis {
    *                           object from a PvlObject. Added fromPvl() and toPvl() methods to allow
    *                           for serialization/unserialization with PvlObjects. Updated unit test.
    *                           References #2282.
+   *   @history 2018-09-07 Isis Development Team - Added Merge() to combine statistics gathered
+   *                           separately, for example by separate threads.
    *
    *   @todo This class needs an example.
    *   @todo For the below methods we will need to compute log x, loy y, sumx3,
@@ -80,6 +82,7 @@ namespace Isis {
       void AddData(double x, double y, unsigned int count = 1);
       void RemoveData(const double *x, const double *y,
                       const unsigned int count);
+      void Merge(const MultivariateStatistics &other);
 
       Isis::Statistics X() const;
       Isis::Statistics Y() const;
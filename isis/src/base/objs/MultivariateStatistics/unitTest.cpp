@@ -59,4 +59,19 @@ int main(int argc, char *argv[]) {
   cout << "a = " << a << endl;
   cout << "b = " << b << endl;
 
+  cout << endl;
+
+  cout << endl << "Testing Merge..." << endl;
+  Isis::MultivariateStatistics first, second;
+  first.AddData(x, y, 4);
+  second.AddData(&x[4], &y[4], 6);
+  first.Merge(second);
+  cout << "SumX            = " << first.X().Sum() << endl;
+  cout << "SumY            = " << first.Y().Sum() << endl;
+  cout << "SumXY           = " << first.SumXY() << endl;
+  cout << "Covariance      = " << first.Covariance() << endl;
+  cout << "Correlation     = " << first.Correlation() << endl;
+  cout << "Valid Pixels    = " << first.ValidPixels() << endl;
+  cout << "Total Pixels    = " << first.TotalPixels() << endl;
+
 }
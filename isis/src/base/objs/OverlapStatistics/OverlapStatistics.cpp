@@ -22,6 +22,7 @@
 
 #include "OverlapStatistics.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <iomanip>
 
@@ -158,9 +159,19 @@ namespace Isis {
       for (int band = 1; band <= p_bands; band++) {
         Brick b1(p_sampRange, 1, 1, x.pixelType());
         Brick b2(p_sampRange, 1, 1, y.pixelType());
+        Brick ahead1(p_sampRange, 1, 1, x.pixelType());
+        Brick ahead2(p_sampRange, 1, 1, y.pixelType());
 
         int i = 0;
         while(i < p_lineRange) {
+          // Start reading the next row of chunks of each cube in the background
+          ahead1.SetBasePosition(p_minSampX,
+              min(i + x.lineCountInChunk(), p_lineRange - 1) + p_minLineX, band);
+          ahead2.SetBasePosition(p_minSampY,
+              min(i + y.lineCountInChunk(), p_lineRange - 1) + p_minLineY, band);
+          x.prefetch(ahead1);
+          y.prefetch(ahead2);
+
           b1.SetBasePosition(p_minSampX, (i + p_minLineX), band);
           b2.SetBasePosition(p_minSampY, (i + p_minLineY), band);
           x.read(b1);
@@ -71,6 +71,8 @@ namespace Isis {
    *                          object from a PvlObject. Added private fromPvl() method to implement
    *                          these details. Updated unitTest to test these changes. References 
    *                          #2282.
+   *  @history 2018-09-07 Isis Development Team - The next row of chunks of each cube is
+   *                          prefetched while the overlap is read.
    *
    */
 
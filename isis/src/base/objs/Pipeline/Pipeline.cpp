@@ -1,11 +1,23 @@
 #include <iostream>
+#include <stdlib.h>
+#include <sys/statvfs.h>
 
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMapIterator>
+#include <QRegExp>
+#include <QScopedPointer>
 
 #include "Pipeline.h"
 #include "PipelineApplication.h"
+#include "PixelKernel.h"
+#include "ProcessByLine.h"
 #include "ProgramLauncher.h"
+#include "Cube.h"
+#include "CubeAttribute.h"
 #include "IException.h"
+#include "IString.h"
 #include "Application.h"
 #include "Preference.h"
 #include "Progress.h"
@@ -33,6 +45,10 @@ namespace Isis {
     p_addedCubeatt = false;
     p_outputListNeedsModifiers = false;
     p_continue = false;
+    p_keepTemporary = false;
+    p_temporaryMemory = 0;
+    p_temporaryFilesInMemory = false;
+    p_fusePixelKernels = false;
   }
 
 
@@ -46,6 +62,10 @@ namespace Isis {
     }
 
     p_apps.clear();
+
+    if (!p_temporaryMemoryFolder.isEmpty()) {
+      QDir(p_temporaryMemoryFolder).removeRecursively();
+    }
   }
 
 
@@ -59,11 +79,39 @@ namespace Isis {
    *   @history 2011-08-15 Debbie A. Cook Added check for NULL pointers in p_apps
    *                                       vector since a [ause is added as a
    *                                       NULL pointer.
+   *   @history 2018-09-07 Isis Development Team - Decides here whether the
+   *                                       temporary files are written to memory.
    */
   void Pipeline::Prepare() {
     // Nothing in the pipeline? quit
     if (p_apps.size() == 0) return;
 
+    // Once the pipeline has started running, its temporary files stay where
+    //   they were put
+    if (p_pausePosition >= 0) {
+      PrepareApplications();
+      return;
+    }
+
+    // The parameters are built with the temporary files on disk first, so
+    //   the temporary files can be counted. If they fit in the memory budget,
+    //   the parameters are built again to write them to memory.
+    p_temporaryFilesInMemory = false;
+    PrepareApplications();
+
+    if (TemporaryFilesFitInMemory()) {
+      p_temporaryFilesInMemory = true;
+      PrepareApplications();
+    }
+  }
+
+
+  /**
+   * This tells each PipelineApplication to prepare itself. The applications
+   * are prepared in order, adding the "cubeatt" program to remove virtual
+   * bands if no application can do it.
+   */
+  void Pipeline::PrepareApplications() {
     // We might have to modify the pipeline and try again, so keep track of if this is necessary
     bool successfulPrepare = false;
 
@@ -211,7 +259,24 @@ namespace Isis {
         return;
       }
 
-      if (Application(i).Enabled()) {
+      // Run programs with pixel kernels in a single pass when possible
+      int lastFused = p_fusePixelKernels ? FusedApplications(i) : i;
+      if (lastFused > i) {
+        Progress appName;
+        appName.SetText("Running " + Application(i).Name() + " through " +
+                        Application(lastFused).Name());
+        appName.SetMaximumSteps(1);
+        appName.CheckStatus();
+
+        RunFusedApplications(i, lastFused);
+
+        if (TemporaryFilesInMemory()) {
+          RemoveUnusedTemporaryFiles(lastFused);
+        }
+
+        i = lastFused;
+      }
+      else if (Application(i).Enabled()) {
         Progress appName;
         appName.SetText("Running " + Application(i).Name());
         appName.SetMaximumSteps(1);
@@ -254,6 +319,10 @@ namespace Isis {
             }
           }
         }
+
+        if (TemporaryFilesInMemory()) {
+          RemoveUnusedTemporaryFiles(i);
+        }
       }
     }
 
@@ -552,6 +621,52 @@ namespace Isis {
   }
 
 
+  /**
+   * Allow temporary files to be written to a memory backed folder instead of
+   * the temporary folder on disk. The memory folder is only used if the
+   * estimated size of the temporary cubes fits in the budget and in the free
+   * memory when the pipeline is prepared, and temporary files that are kept
+   * are always written to disk. Each temporary file in memory is removed as
+   * soon as no later application reads it.
+   *
+   * @param budget The number of bytes the temporary files of the pipeline may
+   *               use, or 0 to always write them to disk
+   */
+  void Pipeline::SetTemporaryMemory(BigInt budget) {
+    p_temporaryMemory = budget;
+  }
+
+
+  /**
+   * Returns the number of bytes of temporary files the user prefers to write
+   * to memory, from the PipelineMemory keyword of the Performance group in
+   * megabytes. This is meant to be given to SetTemporaryMemory().
+   *
+   * @return BigInt The preferred memory budget, or 0 if there is none
+   */
+  BigInt Pipeline::PreferredTemporaryMemory() {
+    PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+    if (!performance.hasKeyword("PipelineMemory")) return 0;
+
+    return (BigInt)(toDouble(performance["PipelineMemory"][0]) * 1024 * 1024);
+  }
+
+
+  /**
+   * Set whether consecutive programs that have a PixelKernel are run as a
+   * single pass over the cube. Each line is then read once, passed through the
+   * kernels of all of the programs, and written once, instead of writing and
+   * reading a temporary cube between each program. This is only done when the
+   * temporary files are not kept, and a fused run writes the history of the
+   * pipeline instead of the history of each program.
+   *
+   * @param fuse True to run pixel kernels in a single pass
+   */
+  void Pipeline::FusePixelKernels(bool fuse) {
+    p_fusePixelKernels = fuse;
+  }
+
+
   /**
    * Add a pause to the pipeline.
    *
@@ -884,11 +999,352 @@ namespace Isis {
    * @return QString The temporary folder
    */
   QString Pipeline::TemporaryFolder() {
+    if (TemporaryFilesInMemory()) return p_temporaryMemoryFolder;
+
     Pvl &pref = Preference::Preferences();
     return pref.findGroup("DataDirectory")["Temporary"];
   }
 
 
+  /**
+   * Returns true if temporary files are written to a memory backed folder.
+   * This is decided when the pipeline is prepared.
+   *
+   * @return bool True if temporary files are written to memory
+   */
+  bool Pipeline::TemporaryFilesInMemory() {
+    return p_temporaryFilesInMemory;
+  }
+
+
+  /**
+   * Returns true if the temporary files of the prepared pipeline can be
+   * written to memory. A memory budget must be set, the temporary files must
+   * not be kept, and the most temporary cubes that exist at one time must fit
+   * in both the budget and the free space of the memory folder. The private
+   * folder of this pipeline is created in the memory folder the first time
+   * this is true.
+   *
+   * @return bool True if the temporary files can be written to memory
+   */
+  bool Pipeline::TemporaryFilesFitInMemory() {
+    if (p_temporaryMemory <= 0 || KeepTemporaryFiles()) return false;
+
+    BigInt estimate = EstimatedTemporarySize();
+    if (estimate <= 0 || estimate > p_temporaryMemory) return false;
+
+    QString memoryFolder = TemporaryMemoryFolder();
+    QFileInfo memoryFolderInfo(memoryFolder);
+    if (!memoryFolderInfo.isDir() || !memoryFolderInfo.isWritable()) return false;
+
+    struct statvfs stats;
+    if (statvfs(memoryFolder.toLatin1().data(), &stats) != 0) return false;
+    if ((BigInt) stats.f_bavail * (BigInt) stats.f_frsize < estimate) return false;
+
+    // Each run gets its own folder, only readable by this user, so pipelines
+    //   running at the same time can not overwrite each other's files
+    if (p_temporaryMemoryFolder.isEmpty()) {
+      QByteArray folder = (memoryFolder + "/isisPipelineXXXXXX").toLatin1();
+      if (mkdtemp(folder.data()) == NULL) return false;
+      p_temporaryMemoryFolder = folder;
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Returns the memory backed folder temporary files may be written to, from
+   * the PipelineMemoryFolder keyword of the Performance group. The default is
+   * /dev/shm.
+   *
+   * @return QString The expanded memory folder
+   */
+  QString Pipeline::TemporaryMemoryFolder() {
+    PvlGroup &performance = Preference::Preferences().findGroup("Performance");
+    if (!performance.hasKeyword("PipelineMemoryFolder")) return "/dev/shm";
+
+    return FileName(performance["PipelineMemoryFolder"][0]).expanded();
+  }
+
+
+  /**
+   * Estimates the number of bytes the temporary cubes of the prepared
+   * pipeline use at the most. Every temporary cube is assumed to be as large
+   * as the largest input cube with real pixels. Input files that are not
+   * cubes are assumed to grow four times when they are imported. A temporary
+   * cube exists from the application that writes it until the last
+   * application that reads it.
+   *
+   * @return BigInt The estimated bytes, or 0 if the size of an input is unknown
+   */
+  BigInt Pipeline::EstimatedTemporarySize() {
+    BigInt cubeSize = 0;
+    for (int i = 0; i < (int)p_originalInput.size(); i++) {
+      QString input = FileName(p_originalInput[i]).expanded();
+      BigInt inputSize = 0;
+
+      try {
+        Cube cube;
+        cube.open(input, "label");
+        inputSize = (BigInt) cube.sampleCount() * cube.lineCount() * cube.bandCount() *
+                    (BigInt) sizeof(float) + cube.labelSize();
+      }
+      catch (IException &) {
+        inputSize = QFileInfo(input).size() * (BigInt) sizeof(float);
+      }
+
+      if (inputSize <= 0) return 0;
+      cubeSize = max(cubeSize, inputSize);
+    }
+
+    int mostFiles = 0;
+    for (int i = 0; i < Size(); i++) {
+      if (p_apps[i] == NULL || !Application(i).Enabled()) continue;
+
+      int files = 0;
+      for (int j = 0; j <= i; j++) {
+        if (p_apps[j] == NULL || !Application(j).Enabled()) continue;
+
+        vector<QString> tmpFiles = Application(j).TemporaryFiles();
+        for (int file = 0; file < (int)tmpFiles.size(); file++) {
+          if (j == i || TemporaryFileUsed(tmpFiles[file], i - 1)) files++;
+        }
+      }
+
+      mostFiles = max(mostFiles, files);
+    }
+
+    return cubeSize * mostFiles;
+  }
+
+
+  /**
+   * Returns true if an application after the last one run reads the file.
+   *
+   * @param file The temporary file
+   * @param lastRun The index of the last application run
+   *
+   * @return bool True if the file is still needed
+   */
+  bool Pipeline::TemporaryFileUsed(const QString &file, int lastRun) {
+    for (int later = lastRun + 1; later < Size(); later++) {
+      if (p_apps[later] == NULL || !Application(later).Enabled()) continue;
+
+      const vector<QString> &params = Application(later).ParamString();
+      for (int j = 0; j < (int)params.size(); j++) {
+        if (params[j].contains(file)) return true;
+      }
+    }
+
+    return false;
+  }
+
+
+  /**
+   * Removes the temporary files in memory that no application after the last
+   * one run reads. This keeps the temporary files in memory down to the ones
+   * still needed.
+   *
+   * @param lastRun The index of the last application run
+   */
+  void Pipeline::RemoveUnusedTemporaryFiles(int lastRun) {
+    for (int i = 0; i <= lastRun; i++) {
+      if (p_apps[i] == NULL || !Application(i).Enabled()) continue;
+
+      vector<QString> tmpFiles = Application(i).TemporaryFiles();
+      for (int file = 0; file < (int)tmpFiles.size(); file++) {
+        if (!TemporaryFileUsed(tmpFiles[file], lastRun)) {
+          QFile::remove(tmpFiles[file]);
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Finds the last of the applications, starting at first, that can be run in
+   * a single pass. Each of these has a PixelKernel and one run that reads the
+   * kernel's input parameter and writes TO, and each one reads the temporary
+   * output of the application before it, which nothing else reads.
+   *
+   * The kernels pass pixels to each other as 4 byte reals, so the pass is only
+   * used when the first input and every temporary output are Real cubes,
+   * which gives the same output as running the applications one at a time. A
+   * kernel that reads the pixels of its input to prepare, or that writes a
+   * pixel type other than Real, ends the pass.
+   *
+   * @param first The index of the first application
+   *
+   * @return int The index of the last application of the pass, or first if
+   *             there is nothing to fuse
+   */
+  int Pipeline::FusedApplications(int first) {
+    if (KeepTemporaryFiles()) return first;
+
+    int last = first;
+    QString previousOutput;
+
+    for (int next = first; next < Size(); next++) {
+      if (p_apps[next] == NULL || !Application(next).Enabled() ||
+          !PixelKernel::IsRegistered(Application(next).Name())) {
+        break;
+      }
+
+      const vector<QString> &params = Application(next).ParamString();
+      if (params.size() != 1 || params[0].startsWith(">>LIST ")) break;
+
+      QMap<QString, QString> parameters = Parameters(next);
+      QScopedPointer<PixelKernel> kernel;
+      try {
+        kernel.reset(PixelKernel::Create(Application(next).Name(), parameters));
+      }
+      catch (IException &e) {
+        break;
+      }
+      if (kernel.isNull()) break;
+
+      QString inputParameter = kernel->InputParameter();
+      if (!parameters.contains(inputParameter) || !parameters.contains("TO")) break;
+
+      if (next == first) {
+        try {
+          FileName input(parameters[inputParameter]);
+          Cube inputCube;
+          inputCube.open(input.expanded(), "label");
+          if (inputCube.pixelType() != Real) break;
+        }
+        catch (IException &e) {
+          break;
+        }
+      }
+      else {
+        if (parameters[inputParameter] != previousOutput) break;
+        if (kernel->PrepareReadsPixels()) break;
+
+        bool otherUse = false;
+        QMapIterator<QString, QString> parameter(parameters);
+        while (parameter.hasNext()) {
+          parameter.next();
+          if (parameter.key() != inputParameter && parameter.value().contains(previousOutput)) {
+            otherUse = true;
+          }
+        }
+        if (otherUse) break;
+
+        vector<QString> tmpFiles = Application(next - 1).TemporaryFiles();
+        bool temporary = false;
+        for (int file = 0; file < (int)tmpFiles.size(); file++) {
+          if (tmpFiles[file] == previousOutput) temporary = true;
+        }
+        if (!temporary) break;
+
+        bool usedLater = false;
+        for (int later = next + 1; !usedLater && later < Size(); later++) {
+          if (p_apps[later] == NULL || !Application(later).Enabled()) continue;
+
+          const vector<QString> &laterParams = Application(later).ParamString();
+          for (int j = 0; !usedLater && j < (int)laterParams.size(); j++) {
+            usedLater = laterParams[j].contains(previousOutput);
+          }
+        }
+        if (usedLater) break;
+
+        last = next;
+      }
+
+      CubeAttributeOutput outputAttributes((FileName(parameters["TO"])));
+      kernel->SetOutputAttributes(outputAttributes);
+      if (!outputAttributes.propagatePixelType() && outputAttributes.pixelType() != Real) break;
+
+      previousOutput = parameters["TO"];
+    }
+
+    return last;
+  }
+
+
+  /**
+   * Runs the kernels of a range of applications as a single pass, reading the
+   * input of the first application and writing the output of the last one.
+   *
+   * @param first The index of the first application
+   * @param last The index of the last application
+   */
+  void Pipeline::RunFusedApplications(int first, int last) {
+    try {
+      QList<PixelKernel *> kernels;
+      try {
+        for (int i = first; i <= last; i++) {
+          kernels.append(PixelKernel::Create(Application(i).Name(), Parameters(i)));
+        }
+      }
+      catch (IException &e) {
+        qDeleteAll(kernels);
+        throw;
+      }
+
+      PixelKernelChain chain(kernels);
+      FileName input(Parameters(first)[kernels.first()->InputParameter()]);
+      FileName output(Parameters(last)["TO"]);
+
+      ProcessByLine p;
+      CubeAttributeInput inputAttributes(input);
+      Cube *icube = p.SetInputCube(input.expanded(), inputAttributes);
+      chain.Prepare(*icube);
+
+      CubeAttributeOutput outputAttributes(output);
+      chain.SetOutputAttributes(outputAttributes);
+      p.SetOutputCube(output.expanded(), outputAttributes,
+                      icube->sampleCount(), icube->lineCount(), icube->bandCount());
+
+      p.ProcessCube(chain);
+      chain.LogResults();
+      p.EndProcess();
+
+      // Give the errors the programs give after writing their output
+      chain.Finish();
+    }
+    catch (IException &e) {
+      bool canContinue = p_continue;
+      for (int i = first; i <= last; i++) {
+        canContinue = canContinue || Application(i).Continue();
+      }
+
+      if (!canContinue) {
+        throw;
+      }
+      else {
+        e.print();
+        cerr << "Continuing ......" << endl;
+      }
+    }
+  }
+
+
+  /**
+   * Returns the parameters of the run of an application, keyed by the upper
+   * case parameter name.
+   *
+   * @param index The index of the application
+   *
+   * @return QMap<QString, QString> The parameters
+   */
+  QMap<QString, QString> Pipeline::Parameters(int index) {
+    QMap<QString, QString> parameters;
+    QRegExp parameter("(\\S+)=\"([^\"]*)\"");
+
+    const QString &params = Application(index).ParamString()[0];
+    int position = 0;
+    while ((position = parameter.indexIn(params, position)) != -1) {
+      parameters[parameter.cap(1).toUpper()] = parameter.cap(2);
+      position += parameter.matchedLength();
+    }
+
+    return parameters;
+  }
+
+
   /**
    * This method re-enables all applications. This resets the effects of
    * PipelineApplication::Disable, SetFirstApplication and SetLastApplication.
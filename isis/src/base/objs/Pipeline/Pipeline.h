@@ -25,8 +25,10 @@
 
 #include <vector>
 
+#include <QMap>
 #include <QString>
 
+#include "Constants.h"
 #include "PipelineApplication.h"
 
 namespace Isis {
@@ -158,6 +160,27 @@ namespace Isis {
    *                           control statements. References # 795.
    *   @history 2016-08-28 Kelvin Rodriguez - Removed useless if statement comparing
    *                           a reference variable to Null. Part of porting to OS X 10.11.
+   *   @history 2018-09-07 Isis Development Team - Added SetTemporaryMemory() to write
+   *                           temporary files to a memory backed folder and remove each one
+   *                           as soon as no later application reads it.
+   *   @history 2018-09-07 Isis Development Team - Added FusePixelKernels() to run
+   *                           consecutive programs that have a PixelKernel as a single
+   *                           pass over the cube, without writing the cubes between them.
+   *   @history 2018-09-07 Isis Development Team - Temporary files in memory go to a private
+   *                           folder created for each pipeline, and only if the estimated
+   *                           size of the temporary cubes fits in the budget. Prepare()
+   *                           decides where they go.
+   *   @history 2018-09-07 Isis Development Team - Pixel kernels are only fused when the
+   *                           input and the temporary cubes are Real, so the output matches
+   *                           running the programs one at a time. The fused pass uses each
+   *                           kernel's input parameter and output attributes and logs its
+   *                           results.
+   *   @history 2018-09-07 Isis Development Team - The fused pass finishes its kernels after
+   *                           writing the output, so trim still gives its error when nothing
+   *                           is trimmed.
+   *   @history 2018-09-07 Isis Development Team - The memory backed folder comes from the
+   *                           PipelineMemoryFolder preference instead of always being
+   *                           /dev/shm. Added PreferredTemporaryMemory().
    */
   class Pipeline {
     public:
@@ -188,6 +211,28 @@ namespace Isis {
         return p_keepTemporary;
       }
 
+      void SetTemporaryMemory(BigInt budget);
+      static BigInt PreferredTemporaryMemory();
+      /**
+       * Returns the number of bytes temporary files may use in memory, or 0 if
+       * they are always written to the temporary folder on disk
+       *
+       * @return BigInt The memory budget for temporary files
+       */
+      BigInt TemporaryMemory() const {
+        return p_temporaryMemory;
+      }
+
+      void FusePixelKernels(bool fuse);
+      /**
+       * Returns true if programs with pixel kernels are run in a single pass
+       *
+       * @return bool True if pixel kernels are fused
+       */
+      bool FusesPixelKernels() const {
+        return p_fusePixelKernels;
+      }
+
       void AddPause();
       void AddToPipeline(const QString &appname);
       void AddToPipeline(const QString &appname, const QString &identifier);
@@ -250,6 +295,7 @@ namespace Isis {
 
       QString FinalOutput(int branch = 0, bool addModifiers = true);
       QString TemporaryFolder();
+      bool TemporaryFilesInMemory();
 
       void EnableAllApplications();
 
@@ -284,6 +330,16 @@ namespace Isis {
       };
 
     private:
+      void PrepareApplications();
+      bool TemporaryFilesFitInMemory();
+      QString TemporaryMemoryFolder();
+      BigInt EstimatedTemporarySize();
+      bool TemporaryFileUsed(const QString &file, int lastRun);
+      void RemoveUnusedTemporaryFiles(int lastRun);
+      int FusedApplications(int first);
+      void RunFusedApplications(int first, int last);
+      QMap<QString, QString> Parameters(int index);
+
       int p_pausePosition;
       QString p_procAppName; //!< The name of the pipeline
       std::vector<QString> p_originalInput; //!< The original input file
@@ -292,6 +348,10 @@ namespace Isis {
       std::vector<QString> p_finalOutput; //!< The final output file (empty if needs calculated)
       std::vector<QString> p_virtualBands;//!< The virtual bands string
       bool p_keepTemporary; //!< True if keeping temporary files
+      BigInt p_temporaryMemory; //!< Bytes temporary files may use in memory
+      bool p_temporaryFilesInMemory; //!< True if temporary files are written to memory
+      QString p_temporaryMemoryFolder; //!< The private memory folder of this pipeline
+      bool p_fusePixelKernels; //!< True if pixel kernels are run in one pass
       bool p_addedCubeatt; //!< True if the "cubeatt" program was added
       std::vector< PipelineApplication * > p_apps; //!< The pipeline applications
       std::vector< QString > p_appIdentifiers; //!< The strings to identify the pipeline applications
@@ -1,4 +1,12 @@
 #include "Isis.h"
+
+#include <sstream>
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "Cube.h"
+#include "LineManager.h"
 #include "Pipeline.h"
 #include "SpecialPixel.h"
 #include "UserInterface.h"
@@ -12,6 +20,8 @@ void PipeBranchDisabled();
 void PipeSimple();
 void PipeListed();
 void PipeContinue();
+QString PipeMemory();
+void PipeFused(bool fuse, const QString &output);
 
 void IsisMain() {
   UserInterface &ui = Application::GetUserInterface();
@@ -60,6 +70,50 @@ void IsisMain() {
   std::cout << "\n*** Continue option ***" << endl;
   cout << "input=" << ui.GetAsString("FROM") << endl;
   PipeContinue();
+
+  std::cout << "\n*** Temporary files in memory ***" << endl;
+  QString memoryFolder = PipeMemory();
+  cout << "Memory folder removed? " << (QFileInfo(memoryFolder).exists() ? "No" : "Yes") << endl;
+
+  std::cout << "\n*** Fused pixel kernels ***" << endl;
+  Cube input;
+  input.setDimensions(5, 4, 1);
+  input.setPixelType(Real);
+  input.create("./unitTestFuse.cub");
+  LineManager inputLine(input);
+  for (inputLine.begin(); !inputLine.end(); inputLine++) {
+    for (int i = 0; i < inputLine.size(); i++) {
+      inputLine[i] = (inputLine.Line() - 1) * 5 + i;
+    }
+    input.write(inputLine);
+  }
+  input.close();
+
+  PipeFused(false, "./unfused.cub");
+  PipeFused(true, "./fused.cub");
+
+  Cube unfused("./unfused.cub", "r");
+  Cube fused("./fused.cub", "r");
+  LineManager unfusedLine(unfused);
+  LineManager fusedLine(fused);
+  int nullPixels = 0;
+  int differentPixels = 0;
+  for (unfusedLine.begin(), fusedLine.begin(); !unfusedLine.end(); unfusedLine++, fusedLine++) {
+    unfused.read(unfusedLine);
+    fused.read(fusedLine);
+    for (int i = 0; i < unfusedLine.size(); i++) {
+      if (IsNullPixel(unfusedLine[i])) nullPixels++;
+      if (unfusedLine[i] != fusedLine[i]) differentPixels++;
+    }
+  }
+  cout << "Null pixels = " << nullPixels << endl;
+  cout << "Pixels that differ = " << differentPixels << endl;
+
+  unfused.close();
+  fused.close();
+  remove("./unitTestFuse.cub");
+  remove("./unfused.cub");
+  remove("./fused.cub");
 }
 
 void PipeBranched() {
@@ -385,3 +439,91 @@ void PipeContinue(void)
   pc2.Run();
   remove("./out.cub");
 }
+
+
+/**
+ * Writes the temporary cube of a pipeline to memory when it fits in the
+ * budget, and to disk when it does not. The test preferences make the
+ * current folder the memory folder, so this does not depend on the host.
+ *
+ * @return QString The memory folder the pipeline used
+ */
+QString PipeMemory(void)
+{
+  Pipeline p("unitTest8");
+
+  p.SetInputFile(FileName("$base/testData/isisTruth.cub"));
+  p.SetOutputFile("TO");
+  p.KeepTemporaryFiles(false);
+
+  p.AddToPipeline("lowpass");
+  p.Application("lowpass").SetInputParameter("FROM", true);
+  p.Application("lowpass").SetOutputParameter("TO", "lowpass");
+  p.Application("lowpass").AddConstParameter("SAMPLES", "3");
+  p.Application("lowpass").AddConstParameter("LINES", "3");
+
+  p.AddToPipeline("highpass");
+  p.Application("highpass").SetInputParameter("FROM", true);
+  p.Application("highpass").SetOutputParameter("TO", "highpass");
+  p.Application("highpass").AddConstParameter("SAMPLES", "3");
+  p.Application("highpass").AddConstParameter("LINES", "3");
+
+  // The temporary cube does not fit in one byte
+  p.SetTemporaryMemory(1);
+  cout << p << endl;
+  cout << "Temporary files in memory? " << (p.TemporaryFilesInMemory() ? "Yes" : "No") << endl;
+
+  p.SetTemporaryMemory(1024 * 1024 * 1024);
+  stringstream memoryPipeline;
+  memoryPipeline << p;
+  QString memoryFolder = p.TemporaryFolder();
+  cout << QString::fromStdString(memoryPipeline.str()).replace(memoryFolder, "$memory").toStdString()
+       << endl;
+  cout << "Temporary files in memory? " << (p.TemporaryFilesInMemory() ? "Yes" : "No") << endl;
+
+  QFile::Permissions shared = QFile::ReadGroup | QFile::WriteGroup | QFile::ExeGroup |
+                              QFile::ReadOther | QFile::WriteOther | QFile::ExeOther;
+  cout << "Memory folder is private? "
+       << ((QFileInfo(memoryFolder).permissions() & shared) ? "No" : "Yes") << endl;
+  cout << "Memory folder is in the preferred folder? "
+       << (QFileInfo(memoryFolder).absolutePath() == QDir::currentPath() ? "Yes" : "No") << endl;
+
+  return memoryFolder;
+}
+
+
+/**
+ * Runs stretch, specpix and trim on a Real cube, one program at a time or as
+ * a single pass of their pixel kernels.
+ *
+ * @param fuse True to fuse the pixel kernels
+ * @param output The output cube
+ */
+void PipeFused(bool fuse, const QString &output)
+{
+  Pipeline p("unitTestFuse");
+
+  p.SetInputFile(FileName("./unitTestFuse.cub"));
+  p.SetOutputFile(FileName(output));
+  p.KeepTemporaryFiles(false);
+  p.FusePixelKernels(fuse);
+
+  p.AddToPipeline("stretch");
+  p.Application("stretch").SetInputParameter("FROM", true);
+  p.Application("stretch").SetOutputParameter("TO", "stretch");
+  p.Application("stretch").AddConstParameter("PAIRS", "0:0 100:200");
+
+  p.AddToPipeline("specpix");
+  p.Application("specpix").SetInputParameter("FROM", true);
+  p.Application("specpix").SetOutputParameter("TO", "specpix");
+  p.Application("specpix").AddConstParameter("NULLMIN", "0");
+  p.Application("specpix").AddConstParameter("NULLMAX", "5");
+
+  p.AddToPipeline("trim");
+  p.Application("trim").SetInputParameter("FROM", true);
+  p.Application("trim").SetOutputParameter("TO", "trim");
+  p.Application("trim").AddConstParameter("TOP", "1");
+
+  cout << p << endl;
+  p.Run();
+}
@@ -0,0 +1,399 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "PixelKernel.h"
+
+#include <QScopedPointer>
+
+#include "Application.h"
+#include "Buffer.h"
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "FileName.h"
+#include "IException.h"
+#include "IString.h"
+#include "Plugin.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+
+namespace Isis {
+  //! Constructs a PixelKernel
+  PixelKernel::PixelKernel() {
+  }
+
+
+  //! Destroys the PixelKernel
+  PixelKernel::~PixelKernel() {
+  }
+
+
+  /**
+   * Returns the parameter that names the input cube of the program. The
+   * default is FROM.
+   *
+   * @return QString The upper case parameter name
+   */
+  QString PixelKernel::InputParameter() const {
+    return "FROM";
+  }
+
+
+  /**
+   * Returns true if Prepare() reads the pixels of the input cube, in which
+   * case the kernel must be the first kernel of a chain. The default is false.
+   *
+   * @return bool True if Prepare() reads pixels
+   */
+  bool PixelKernel::PrepareReadsPixels() const {
+    return false;
+  }
+
+
+  /**
+   * Prepares the kernel for an input cube before any lines are applied. The
+   * default does nothing.
+   *
+   * @param input The input cube
+   */
+  void PixelKernel::Prepare(Cube &input) {
+  }
+
+
+  /**
+   * Sets the attributes, such as the pixel type, that the program gives its
+   * output cube. This is called after Prepare(). The default does nothing.
+   *
+   * @param attributes The attributes of the output cube
+   */
+  void PixelKernel::SetOutputAttributes(CubeAttributeOutput &attributes) const {
+  }
+
+
+  /**
+   * Returns the valid range of the output values that the kernel sets with
+   * SetOutputAttributes(), as the exact values. This is called after
+   * Prepare(). The default is Null for both, which is no range.
+   *
+   * @param minimum Set to the smallest valid output value
+   * @param maximum Set to the largest valid output value
+   */
+  void PixelKernel::OutputRange(double &minimum, double &maximum) const {
+    minimum = Null;
+    maximum = Null;
+  }
+
+
+  /**
+   * Returns the results the program writes to the log once all lines are
+   * applied. The default is an empty group, which is not logged.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup PixelKernel::Results() const {
+    return PvlGroup("Results");
+  }
+
+
+  /**
+   * Checks the run once all lines are applied and the output cube is
+   * written. A kernel throws here the errors its program gives after writing
+   * its output, such as trim when nothing was trimmed. The default does
+   * nothing.
+   */
+  void PixelKernel::Finish() const {
+  }
+
+
+  /**
+   * Registers a kernel that is not a plugin, such as a kernel of a test,
+   * replacing any kernel already registered for the program. It is used
+   * instead of the plugin of the program.
+   *
+   * @param program The program name
+   * @param factory Creates the kernel of a run of the program
+   */
+  void PixelKernel::Register(const QString &program, Factory factory) {
+    Factories().insert(program.toLower(), factory);
+  }
+
+
+  /**
+   * Returns true if a kernel is registered for a program or a plugin is
+   * listed for it in PixelKernel.plugin.
+   *
+   * @param program The program name
+   *
+   * @return bool True if the program has a kernel
+   */
+  bool PixelKernel::IsRegistered(const QString &program) {
+    return Factories().contains(program.toLower()) || Plugins().hasGroup(program);
+  }
+
+
+  /**
+   * Creates the kernel for a run of a program. This returns NULL if the
+   * parameters ask for a run that the kernel can not do, such as fx reading
+   * more than one cube.
+   *
+   * @param program The program name
+   * @param parameters The parameters of the run, keyed by upper case name
+   *
+   * @throws Isis::IException::Programmer - No kernel is registered for the
+   *                                        program
+   *
+   * @return PixelKernel* The kernel, owned by the caller, or NULL
+   */
+  PixelKernel *PixelKernel::Create(const QString &program,
+                                   const QMap<QString, QString> &parameters) {
+    if (!IsRegistered(program)) {
+      QString msg = "There is no pixel kernel for program [" + program + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    if (Factories().contains(program.toLower())) {
+      return Factories()[program.toLower()](parameters);
+    }
+
+    Factory plugin = (Factory) Plugins().GetPlugin(program);
+    return (*plugin)(parameters);
+  }
+
+
+  /**
+   * Returns an integer parameter of a run, or a default if it was not given.
+   *
+   * @param parameters The parameters of the run
+   * @param name The parameter name
+   * @param defaultValue The value if the parameter was not given
+   *
+   * @return int The parameter value
+   */
+  int PixelKernel::IntegerParameter(const QMap<QString, QString> &parameters,
+                                    const QString &name, int defaultValue) {
+    if (!parameters.contains(name)) return defaultValue;
+    return toInt(parameters[name]);
+  }
+
+
+  /**
+   * Returns a double parameter of a run, or a default if it was not given.
+   *
+   * @param parameters The parameters of the run
+   * @param name The parameter name
+   * @param defaultValue The value if the parameter was not given
+   *
+   * @return double The parameter value
+   */
+  double PixelKernel::DoubleParameter(const QMap<QString, QString> &parameters,
+                                      const QString &name, double defaultValue) {
+    if (!parameters.contains(name)) return defaultValue;
+    return toDouble(parameters[name]);
+  }
+
+
+  /**
+   * Returns a boolean parameter of a run, or a default if it was not given.
+   *
+   * @param parameters The parameters of the run
+   * @param name The parameter name
+   * @param defaultValue The value if the parameter was not given
+   *
+   * @return bool The parameter value
+   */
+  bool PixelKernel::BooleanParameter(const QMap<QString, QString> &parameters,
+                                     const QString &name, bool defaultValue) {
+    if (!parameters.contains(name)) return defaultValue;
+    return toBool(parameters[name]);
+  }
+
+
+  /**
+   * Returns a string parameter of a run in upper case, or a default if it was
+   * not given.
+   *
+   * @param parameters The parameters of the run
+   * @param name The parameter name
+   * @param defaultValue The value if the parameter was not given
+   *
+   * @return QString The parameter value
+   */
+  QString PixelKernel::StringParameter(const QMap<QString, QString> &parameters,
+                                       const QString &name, const QString &defaultValue) {
+    if (!parameters.contains(name)) return defaultValue;
+    return parameters[name].toUpper();
+  }
+
+
+  /**
+   * Opens a cube, other than the input cube, that a kernel reads, such as a
+   * mask. The cube must have the same number of samples and lines as the
+   * input cube.
+   *
+   * @param name The file name of the cube, with any attributes
+   * @param input The input cube
+   *
+   * @throws Isis::IException::User - The cube is not the size of the input
+   *
+   * @return Cube* The opened cube, owned by the caller
+   */
+  Cube *PixelKernel::OpenSecondaryCube(const QString &name, Cube &input) {
+    FileName file(name);
+    QScopedPointer<Cube> cube(new Cube);
+    cube->setVirtualBands(CubeAttributeInput(file).bands());
+    cube->open(file.expanded());
+
+    if (cube->lineCount() != input.lineCount()) {
+      QString message = "The number of lines in the input cubes must match";
+      throw IException(IException::User, message, _FILEINFO_);
+    }
+    if (cube->sampleCount() != input.sampleCount()) {
+      QString message = "The number of samples in the input cubes must match";
+      throw IException(IException::User, message, _FILEINFO_);
+    }
+
+    return cube.take();
+  }
+
+
+  /**
+   * Returns the kernels added with Register().
+   *
+   * @return QMap<QString, Factory>& The kernels by program name
+   */
+  QMap<QString, PixelKernel::Factory> &PixelKernel::Factories() {
+    static QMap<QString, Factory> factories;
+    return factories;
+  }
+
+
+  /**
+   * Returns the kernel plugins, read from PixelKernel.plugin in the current
+   * working directory and then from $ISISROOT/lib the first time.
+   *
+   * @return Plugin& The kernel plugins by program name
+   */
+  Plugin &PixelKernel::Plugins() {
+    static Plugin plugins;
+    if (plugins.fileName() == "") {
+      FileName localFile("PixelKernel.plugin");
+      if (localFile.fileExists())
+        plugins.read(localFile.expanded());
+
+      FileName systemFile("$ISISROOT/lib/PixelKernel.plugin");
+      if (systemFile.fileExists())
+        plugins.read(systemFile.expanded());
+    }
+    return plugins;
+  }
+
+
+  /**
+   * Constructs a chain that applies kernels in order. The chain takes
+   * ownership of the kernels.
+   *
+   * @param kernels The kernels
+   */
+  PixelKernelChain::PixelKernelChain(const QList<PixelKernel *> &kernels) {
+    m_kernels = kernels;
+  }
+
+
+  //! Destroys the chain and its kernels
+  PixelKernelChain::~PixelKernelChain() {
+    qDeleteAll(m_kernels);
+  }
+
+
+  /**
+   * Prepares every kernel for the input cube.
+   *
+   * @param input The input cube
+   */
+  void PixelKernelChain::Prepare(Cube &input) {
+    for (int i = 0; i < m_kernels.size(); i++) {
+      m_kernels[i]->Prepare(input);
+    }
+  }
+
+
+  /**
+   * Sets the output attributes of the last kernel, which writes the output
+   * cube.
+   *
+   * @param attributes The attributes of the output cube
+   */
+  void PixelKernelChain::SetOutputAttributes(CubeAttributeOutput &attributes) const {
+    if (!m_kernels.isEmpty()) {
+      m_kernels.last()->SetOutputAttributes(attributes);
+    }
+  }
+
+
+  //! Writes the results of each kernel to the log, in the order applied
+  void PixelKernelChain::LogResults() const {
+    for (int i = 0; i < m_kernels.size(); i++) {
+      PvlGroup results = m_kernels[i]->Results();
+      if (results.keywords() > 0) {
+        Application::Log(results);
+      }
+    }
+  }
+
+
+  /**
+   * Finishes every kernel, in the order applied, once the output cube is
+   * written.
+   */
+  void PixelKernelChain::Finish() const {
+    for (int i = 0; i < m_kernels.size(); i++) {
+      m_kernels[i]->Finish();
+    }
+  }
+
+
+  /**
+   * Applies every kernel to a line. The first kernel reads the input and each
+   * later kernel works on the output of the one before it. Valid pixels passed
+   * between kernels are rounded to 4 byte reals, so the output is the same as
+   * when each program writes a Real cube that the next one reads.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void PixelKernelChain::operator()(Buffer &in, Buffer &out) const {
+    if (m_kernels.isEmpty()) {
+      for (int i = 0; i < in.size(); i++) {
+        out[i] = in[i];
+      }
+      return;
+    }
+
+    m_kernels[0]->Apply(in, out);
+    for (int i = 1; i < m_kernels.size(); i++) {
+      for (int j = 0; j < out.size(); j++) {
+        if (IsValidPixel(out[j])) out[j] = (double) (float) out[j];
+      }
+      m_kernels[i]->Apply(out, out);
+    }
+  }
+}
@@ -0,0 +1,180 @@
+#ifndef PixelKernel_h
+#define PixelKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "PvlGroup.h"
+
+namespace Isis {
+  class Buffer;
+  class Cube;
+  class CubeAttributeOutput;
+  class Plugin;
+
+  /**
+   * @brief The per pixel operation of an Isis program
+   *
+   * A PixelKernel is the processing function of a program that reads a cube
+   * with FROM, writes a cube of the same size with TO, and computes each
+   * output pixel from the input pixel at the same position. This lets the
+   * Pipeline run several of these programs in a row as a single pass over the
+   * cube instead of writing and reading a cube between each of them.
+   *
+   * Kernels are plugins. Each kernel is built in its own object directory
+   * with a PixelKernel.plugin file, which names the group of its program, the
+   * shared library and the routine that creates the kernel. For example:
+   * @code
+   * Group = trim
+   *   Library = TrimKernel
+   *   Routine = TrimKernelPlugin
+   * EndGroup
+   * @endcode
+   * The routine is declared extern "C" and takes the parameters of a run of
+   * the program, keyed by the upper case parameter name. It returns NULL for a
+   * run that the kernel can not do. Kernels that are not plugins, such as
+   * those of a test, can be added with Register().
+   *
+   * Apply() is called from several threads at once and must not change the
+   * kernel. It must also work when the in and out buffers are the same
+   * buffer.
+   *
+   * Prepare() is given the input cube of a whole chain of kernels. A kernel
+   * whose Prepare() reads the pixels of that cube, such as one that needs a
+   * histogram, can only be the first kernel of a chain. Other cubes a program
+   * reads, such as a mask, are opened by the kernel itself.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version. Added the
+   *                           trim kernel.
+   *   @history 2018-09-07 Isis Development Team - Added the stretch, ratio, lineeq,
+   *                           fx, mask, bit2bit and specpix kernels. Added
+   *                           InputParameter(), PrepareReadsPixels(),
+   *                           SetOutputAttributes() and Results().
+   *   @history 2018-09-07 Isis Development Team - Kernels are now plugins listed in
+   *                           PixelKernel.plugin, and each kernel moved to its own
+   *                           object directory. Added Finish(), OutputRange() and
+   *                           the parameter helpers for kernels.
+   */
+  class PixelKernel {
+    public:
+      //! Creates a kernel from the parameters of a run of its program
+      typedef PixelKernel *(*Factory)(const QMap<QString, QString> &parameters);
+
+      PixelKernel();
+      virtual ~PixelKernel();
+
+      virtual QString InputParameter() const;
+      virtual bool PrepareReadsPixels() const;
+      virtual void Prepare(Cube &input);
+      virtual void SetOutputAttributes(CubeAttributeOutput &attributes) const;
+      virtual void OutputRange(double &minimum, double &maximum) const;
+      virtual PvlGroup Results() const;
+      virtual void Finish() const;
+
+      /**
+       * Computes the output pixels of a line from the input pixels.
+       *
+       * @param in The input pixels
+       * @param out The output pixels
+       */
+      virtual void Apply(Buffer &in, Buffer &out) const = 0;
+
+      static void Register(const QString &program, Factory factory);
+      static bool IsRegistered(const QString &program);
+      static PixelKernel *Create(const QString &program,
+                                 const QMap<QString, QString> &parameters);
+
+    protected:
+      static int IntegerParameter(const QMap<QString, QString> &parameters,
+                                  const QString &name, int defaultValue);
+      static double DoubleParameter(const QMap<QString, QString> &parameters,
+                                    const QString &name, double defaultValue);
+      static bool BooleanParameter(const QMap<QString, QString> &parameters,
+                                   const QString &name, bool defaultValue);
+      static QString StringParameter(const QMap<QString, QString> &parameters,
+                                     const QString &name, const QString &defaultValue);
+      static Cube *OpenSecondaryCube(const QString &name, Cube &input);
+
+    private:
+      static QMap<QString, Factory> &Factories();
+      static Plugin &Plugins();
+  };
+
+
+  /**
+   * @brief Applies a list of pixel kernels in one pass
+   *
+   * This functor applies each kernel in turn to the pixels of a line, so a
+   * ProcessByLine reads and writes each line once for the whole list. The
+   * kernels are deleted with the chain.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version
+   *   @history 2018-09-07 Isis Development Team - Added SetOutputAttributes() and
+   *                           LogResults().
+   *   @history 2018-09-07 Isis Development Team - Added Finish().
+   */
+  class PixelKernelChain {
+    public:
+      PixelKernelChain(const QList<PixelKernel *> &kernels);
+      ~PixelKernelChain();
+
+      void Prepare(Cube &input);
+      void SetOutputAttributes(CubeAttributeOutput &attributes) const;
+      void LogResults() const;
+      void Finish() const;
+      void operator()(Buffer &in, Buffer &out) const;
+
+    private:
+      /**
+       * Copy construction is not allowed
+       *
+       * @param other
+       */
+      PixelKernelChain(const PixelKernelChain &other);
+
+      /**
+       * Assignment is not allowed
+       *
+       * @param other
+       * @returns
+       */
+      PixelKernelChain &operator=(const PixelKernelChain &other);
+
+      QList<PixelKernel *> m_kernels; //!< The kernels, in the order applied
+  };
+};
+
+#endif
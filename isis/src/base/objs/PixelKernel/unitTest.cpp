@@ -0,0 +1,186 @@
+#include <iostream>
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "PixelKernel.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+using namespace std;
+
+/**
+ * Doubles every pixel, for testing kernels registered by a program.
+ */
+class DoubleKernel : public PixelKernel {
+  public:
+    void Apply(Buffer &in, Buffer &out) const {
+      for (int i = 0; i < in.size(); i++) {
+        out[i] = IsSpecial(in[i]) ? in[i] : 2.0 * in[i];
+      }
+    }
+
+    static PixelKernel *create(const QMap<QString, QString> &parameters) {
+      return new DoubleKernel;
+    }
+};
+
+
+void printLine(const PixelKernelChain &chain, Cube &cube, int line) {
+  LineManager in(cube);
+  LineManager out(cube);
+  in.SetLine(line);
+  out.SetLine(line);
+  for (int i = 0; i < in.size(); i++) {
+    in[i] = 1.0;
+  }
+
+  chain(in, out);
+
+  int nulls = 0;
+  double sum = 0.0;
+  for (int i = 0; i < out.size(); i++) {
+    if (IsNullPixel(out[i])) {
+      nulls++;
+    }
+    else {
+      sum += out[i];
+    }
+  }
+
+  cout << "Line " << line << ": null pixels = " << nulls
+       << ", sum of the other pixels = " << sum << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  cout << "Testing the registry ..." << endl;
+  cout << "trim registered? " << PixelKernel::IsRegistered("trim") << endl;
+  cout << "TRIM registered? " << PixelKernel::IsRegistered("TRIM") << endl;
+  cout << "double registered? " << PixelKernel::IsRegistered("double") << endl;
+  PixelKernel::Register("double", &DoubleKernel::create);
+  cout << "double registered? " << PixelKernel::IsRegistered("double") << endl;
+
+  QStringList programs;
+  programs << "bit2bit" << "fx" << "lineeq" << "mask" << "ratio" << "specpix" << "stretch";
+  foreach (QString program, programs) {
+    cout << program << " registered? " << PixelKernel::IsRegistered(program) << endl;
+  }
+
+  try {
+    QMap<QString, QString> parameters;
+    PixelKernel::Create("lowpass", parameters);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+  cout << endl;
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+  int lines = cube.lineCount();
+  int samples = cube.sampleCount();
+  cout << "Input is " << samples << " samples by " << lines << " lines" << endl;
+  cout << endl;
+
+  cout << "Testing a trim kernel ..." << endl;
+  {
+    QMap<QString, QString> parameters;
+    parameters["TOP"] = "2";
+    parameters["BOTTOM"] = "3";
+    parameters["LEFT"] = "4";
+    parameters["RIGHT"] = "5";
+
+    QList<PixelKernel *> kernels;
+    kernels.append(PixelKernel::Create("trim", parameters));
+    PixelKernelChain chain(kernels);
+    chain.Prepare(cube);
+
+    printLine(chain, cube, 2);
+    printLine(chain, cube, 3);
+    printLine(chain, cube, lines - 3);
+    printLine(chain, cube, lines - 2);
+  }
+  cout << endl;
+
+  cout << "Testing a chain of kernels ..." << endl;
+  {
+    QMap<QString, QString> parameters;
+    parameters["LEFT"] = "10";
+
+    QList<PixelKernel *> kernels;
+    kernels.append(PixelKernel::Create("trim", parameters));
+    kernels.append(PixelKernel::Create("double", parameters));
+    kernels.append(PixelKernel::Create("Double", parameters));
+    PixelKernelChain chain(kernels);
+    chain.Prepare(cube);
+
+    printLine(chain, cube, 1);
+    printLine(chain, cube, lines);
+  }
+  cout << endl;
+
+  cout << "Testing the kernels that read their input to prepare ..." << endl;
+  {
+    QMap<QString, QString> parameters;
+    parameters["DENOMINATOR"] = "$base/testData/isisTruth.cub";
+    QStringList programs;
+    programs << "bit2bit" << "lineeq" << "ratio";
+    foreach (QString program, programs) {
+      PixelKernel *kernel = PixelKernel::Create(program, parameters);
+      cout << program << ": input parameter = " << kernel->InputParameter()
+           << ", Prepare reads pixels? " << kernel->PrepareReadsPixels() << endl;
+      delete kernel;
+    }
+
+    cout << "Kernel for fx with MODE=LIST? ";
+    parameters["MODE"] = "LIST";
+    PixelKernel *fx = PixelKernel::Create("fx", parameters);
+    cout << (fx ? "Yes" : "No") << endl;
+    delete fx;
+  }
+  cout << endl;
+
+  cout << "Testing finishing a chain ..." << endl;
+  {
+    QList<PixelKernel *> kernels;
+    kernels.append(PixelKernel::Create("double", QMap<QString, QString>()));
+    kernels.append(PixelKernel::Create("trim", QMap<QString, QString>()));
+    PixelKernelChain chain(kernels);
+    chain.Prepare(cube);
+
+    double minimum = 0.0;
+    double maximum = 0.0;
+    kernels[0]->OutputRange(minimum, maximum);
+    cout << "Default output range is Null? "
+         << (IsNullPixel(minimum) && IsNullPixel(maximum)) << endl;
+
+    try {
+      chain.Finish();
+    }
+    catch (IException &e) {
+      e.print();
+    }
+  }
+  cout << endl;
+
+  cout << "Testing an empty chain ..." << endl;
+  {
+    PixelKernelChain chain((QList<PixelKernel *>()));
+    chain.Prepare(cube);
+    printLine(chain, cube, 1);
+  }
+
+  cube.close();
+  return 0;
+}
@@ -33,6 +33,8 @@
 #include "IString.h"
 #include "Preference.h"
 #include "Application.h"
+#include "CubeStatisticsCache.h"
+#include "CubeStatisticsDriver.h"
 #include "History.h"
 #include "OriginalLabel.h"
 #include "LineManager.h"
@@ -52,11 +54,20 @@ namespace Isis {
     p_propagateHistory = true;
     p_propagateOriginalLabel = true;
 
+    p_cacheStatistics = false;
+    PvlGroup &cubePrefs = Preference::Preferences().findGroup("CubeCustomization");
+    if (cubePrefs.hasKeyword("StatisticsCache")) {
+      p_cacheStatistics = cubePrefs["StatisticsCache"][0].toUpper() == "ON";
+    }
+
     m_ownedCubes = new QSet<Cube *>;
   }
 
   //! Destroys the Process Object. It will close all opened cubes
   Process::~Process() {
+    // Output cubes still open here were not finished, for example because an
+    //   exception is unwinding the stack, so they do not get a cache
+    p_cacheStatistics = false;
     EndProcess();
     delete p_progress;
 
@@ -349,6 +360,7 @@ namespace Isis {
       cube->setDimensions(ns, nl, nb);
       cube->setByteOrder(att.byteOrder());
       cube->setFormat(att.fileFormat());
+      cube->setSparse(att.sparse());
       cube->setLabelsAttached(att.labelAttachment() == AttachedLabel);
 
       if(att.propagatePixelType()) {
@@ -532,6 +544,9 @@ namespace Isis {
     // Close the cubes
     for (unsigned int i = 0; i < OutputCubes.size(); i++) {
       if (m_ownedCubes->contains(OutputCubes[i])) {
+        if (p_cacheStatistics) {
+          WriteStatisticsCache(*OutputCubes[i]);
+        }
         OutputCubes[i]->close();
         delete OutputCubes[i];
       }
@@ -661,6 +676,19 @@ namespace Isis {
     p_propagateOriginalLabel = prop;
   }
 
+  /**
+   * This method allows the programmer to write a statistics cache to the
+   * output cubes when they are cleared (default comes from the StatisticsCache
+   * keyword of the CubeCustomization preferences, off if it is missing).
+   * Programs that open their output cube again later, like stretches, can then
+   * get the statistics and histogram of a band without reading the pixels.
+   *
+   * @param cache Flag indicating if output cubes get a statistics cache.
+   */
+  void Process::CacheStatistics(const bool cache) {
+    p_cacheStatistics = cache;
+  }
+
   /**
    * This method reads the mission specific data directory from the user
    * preference file, makes sure that mission is available in the Isis
@@ -722,6 +750,27 @@ namespace Isis {
     }
   }
 
+  /**
+   * Writes a statistics cache of the current pixels to an output cube. The
+   * cache is optional, so a cube that can't be read back or that takes its DNs
+   * from another file is left without one.
+   *
+   * @param cube The output cube
+   */
+  void Process::WriteStatisticsCache(Cube &cube) {
+    if (!cube.isOpen() || !cube.isReadWrite() || !cube.storesDnData()) {
+      return;
+    }
+
+    try {
+      CubeStatisticsCache cache(cube);
+      cube.write(cache);
+    }
+    catch (IException &) {
+      // The cube is still usable without the cache
+    }
+  }
+
   /**
    * Calculates and stores off statistics on every band of every
    * cube added to this process via the SetInputCube method.
@@ -736,8 +785,6 @@ namespace Isis {
     for(unsigned cubeNum = 0; cubeNum < InputCubes.size(); cubeNum++) {
       Cube *cube = InputCubes[cubeNum];
 
-      // Construct a line buffer manager and a statistics object
-      Isis::LineManager line(*cube);
       Isis::Statistics *cubeStats = new Isis::Statistics();
 
       int bandStart = 1;
@@ -754,16 +801,26 @@ namespace Isis {
       progress.CheckStatus();
 
       // Loop and get the statistics for a good minimum/maximum
+      // The cube statistics are merged from the band statistics only when the
+      // driver merges chunks anyway, so serial results stay line by line
+      CubeStatisticsDriver driver(*cube, &progress);
+      Isis::LineManager line(*cube);
       vector<Statistics *> allBandStats;
       for(int useBand = bandStart; useBand <= bandStop; useBand++) {
         Isis::Statistics *bandStats = new Isis::Statistics();
 
-        for(int i = 1; i <= cube->lineCount(); i++) {
-          line.SetLine(i, useBand);
-          cube->read(line);
-          bandStats->AddData(line.DoubleBuffer(), line.size());
-          cubeStats->AddData(line.DoubleBuffer(), line.size());
-          progress.CheckStatus();
+        if (driver.isParallel()) {
+          driver.addData(useBand, *bandStats);
+          cubeStats->Merge(*bandStats);
+        }
+        else {
+          for(int i = 1; i <= cube->lineCount(); i++) {
+            line.SetLine(i, useBand);
+            cube->read(line);
+            bandStats->AddData(line.DoubleBuffer(), line.size());
+            cubeStats->AddData(line.DoubleBuffer(), line.size());
+            progress.CheckStatus();
+          }
         }
 
         allBandStats.push_back(bandStats);
@@ -153,6 +153,18 @@ namespace Isis {
    *                          PropagateTables(QString, QList<QString>). A default value of an
    *                          empty QList is provided to this parameter which will propagate all
    *                          tables. Updated unitTest to test this change. References #4433.
+   *  @history 2018-09-07 Isis Development Team - CalculateStatistics() reads each band in
+   *                          parallel with CubeStatisticsDriver and merges the band statistics
+   *                          into the cube statistics when the ParallelStatistics preference
+   *                          is On. Otherwise the lines are added in order as before.
+   *  @history 2018-09-07 Isis Development Team - Added CacheStatistics() and
+   *                          WriteStatisticsCache(). When caching is on, owned
+   *                          output cubes get a CubeStatisticsCache blob when they are cleared.
+   *                          The default comes from the StatisticsCache keyword of the
+   *                          CubeCustomization preferences group. Cubes still open when the
+   *                          Process is destroyed do not get a cache.
+   *  @history 2018-09-07 Isis Development Team - SetOutputCube() applies the Sparse output
+   *                          cube attribute.
    */
   class Process {
     protected:
@@ -177,6 +189,11 @@ namespace Isis {
        * Flag indicating if original lable is to be propagated to output cubes.
        */
       bool p_propagateOriginalLabel;
+      /**
+       * Flag indicating if a statistics cache is written to output cubes
+       * when they are cleared.
+       */
+      bool p_cacheStatistics;
 
       /**
        * Holds the calculated statistics for each band separately of
@@ -260,6 +277,7 @@ namespace Isis {
       void PropagatePolygons(const bool prop);
       void PropagateHistory(const bool prop);
       void PropagateOriginalLabel(const bool prop);
+      void CacheStatistics(const bool cache);
 
       /**
        * This method returns a pointer to a Progress object
@@ -274,6 +292,7 @@ namespace Isis {
                               bool highestVersion = false);
 
       void WriteHistory(Cube &cube);
+      void WriteStatisticsCache(Cube &cube);
 
       void CalculateStatistics();
 
@@ -20,12 +20,21 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 #include "BoxcarCachingAlgorithm.h"
 #include "BoxcarManager.h"
 #include "Buffer.h"
+#include "IException.h"
 #include "LineManager.h"
 #include "Process.h"
 #include "ProcessByBoxcar.h"
+#include "SpecialPixel.h"
 
 using namespace std;
 namespace Isis {
@@ -51,11 +60,266 @@ namespace Isis {
    * and p_boxLines. The input and output cube must be initialized prior to
    * calling this method.
    *
+   * The input lines under the boxcar are kept in a ring buffer, so each line
+   * of the input cube is read once per band.
+   *
    * @param funct (Isis::Buffer &in, double &out) Name of your processing function
    *
    * @throws Isis::IException::Programmer
    */
   void ProcessByBoxcar::StartProcess(void funct(Isis::Buffer &in, double &out)) {
+    VerifyCubes();
+
+    // Construct boxcar buffer and line buffer managers
+    Isis::BoxcarManager box(*InputCubes[0], p_boxSamples, p_boxLines);
+    Isis::LineManager line(*OutputCubes[0]);
+    Isis::LineManager inputLine(*InputCubes[0]);
+    double out;
+
+    InputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+    OutputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+
+    // The boxcar covers the input lines [line + lineOffset, line + lineOffset + p_boxLines - 1]
+    // and each line in the ring is padded so that sample i of the output starts the boxcar
+    // at index i of the padded line
+    int lineOffset = -((p_boxLines - 1) / 2);
+    int paddedSamples = InputCubes[0]->sampleCount() + p_boxSamples - 1;
+    vector<double> ring(p_boxLines * paddedSamples);
+    int currentBand = 0;
+
+    // Loop and let the app programmer use the boxcar to change output pixel
+    p_progress->SetMaximumSteps(InputCubes[0]->lineCount()*InputCubes[0]->bandCount());
+    p_progress->CheckStatus();
+
+    box.begin();
+    for(line.begin(); !line.end(); line.next()) {
+      int firstLine = line.Line() + lineOffset;
+
+      // Fill the ring at the start of each band, then read the one new line
+      if (line.Band() != currentBand) {
+        currentBand = line.Band();
+        for (int i = 0; i < p_boxLines; i++) {
+          int inputLineNumber = firstLine + i;
+          int slot = ((inputLineNumber % p_boxLines) + p_boxLines) % p_boxLines;
+          ReadPaddedLine(inputLine, inputLineNumber, currentBand, &ring[slot * paddedSamples]);
+        }
+      }
+      else {
+        int inputLineNumber = firstLine + p_boxLines - 1;
+        int slot = ((inputLineNumber % p_boxLines) + p_boxLines) % p_boxLines;
+        ReadPaddedLine(inputLine, inputLineNumber, currentBand, &ring[slot * paddedSamples]);
+      }
+
+      for(int i = 0; i < line.size(); i++) {
+        double *boxData = box.DoubleBuffer();
+        for (int j = 0; j < p_boxLines; j++) {
+          int inputLineNumber = firstLine + j;
+          int slot = ((inputLineNumber % p_boxLines) + p_boxLines) % p_boxLines;
+          memcpy(boxData + j * p_boxSamples, &ring[slot * paddedSamples + i],
+                 p_boxSamples * sizeof(double));
+        }
+
+        funct(box, out);
+        line[i] = out;
+        box++;
+      }
+      OutputCubes[0]->write(line);
+      p_progress->CheckStatus();
+    }
+
+  }
+
+
+  /**
+   * Filters the input cube with a separable linear kernel. The kernel is the
+   * outer product of the line weights and the sample weights; the pixel at
+   * (line j, sample i) of the boxcar is weighted by lineWeights[j] *
+   * sampleWeights[i]. The boxcar is positioned the same as for StartProcess(),
+   * so this gives the same result as a StartProcess() function that sums the
+   * weighted boxcar pixels.
+   *
+   * The lines of each band are processed in groups. The input lines of a group
+   * are read, filtered by the sample weights, and the filtered lines combined
+   * by the line weights, with both filter steps split across the global thread
+   * pool. The filtered input lines that the next group also needs are kept.
+   *
+   * @param sampleWeights The kernel weights across a line of the boxcar
+   * @param lineWeights The kernel weights down a sample of the boxcar
+   * @param mode How special pixels, including those outside of the cube, are
+   *             handled
+   *
+   * @throws Isis::IException::Programmer
+   */
+  void ProcessByBoxcar::StartSeparableProcess(const std::vector<double> &sampleWeights,
+                                              const std::vector<double> &lineWeights,
+                                              SpecialPixelMode mode) {
+    if (sampleWeights.empty() || lineWeights.empty()) {
+      string m = "The separable kernel weights must not be empty";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    SetBoxcarSize(sampleWeights.size(), lineWeights.size());
+    VerifyCubes();
+
+    p_sampleWeights = sampleWeights;
+    p_lineWeights = lineWeights;
+    p_specialPixelMode = mode;
+
+    Cube *inputCube = InputCubes[0];
+    Cube *outputCube = OutputCubes[0];
+    int lines = inputCube->lineCount();
+    int bands = inputCube->bandCount();
+    int lineOffset = -((p_boxLines - 1) / 2);
+    int paddedSamples = inputCube->sampleCount() + p_boxSamples - 1;
+
+    inputCube->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+    outputCube->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+
+    p_progress->SetMaximumSteps(lines * bands);
+    p_progress->CheckStatus();
+
+    bool threaded = QThreadPool::globalInstance()->maxThreadCount() > 1;
+    int groupLines = 16 * qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    LineManager inputLine(*inputCube);
+    LineManager outputLine(*outputCube);
+
+    for (int band = 1; band <= bands; band++) {
+      // rows[i] holds input line firstRowLine + i
+      QList<SeparableRow *> rows;
+      int firstRowLine = 1 + lineOffset;
+
+      for (int groupStart = 1; groupStart <= lines; groupStart += groupLines) {
+        int groupEnd = qMin(lines, groupStart + groupLines - 1);
+
+        // drop the rows above the group's boxcars
+        while (!rows.isEmpty() && firstRowLine < groupStart + lineOffset) {
+          delete rows.takeFirst();
+          firstRowLine++;
+        }
+
+        // read and filter the rows below the previous group's boxcars
+        QList<SeparableRow *> newRows;
+        int lastRowLine = groupEnd + lineOffset + p_boxLines - 1;
+        for (int rowLine = firstRowLine + rows.size(); rowLine <= lastRowLine; rowLine++) {
+          SeparableRow *row = new SeparableRow;
+          row->pixels.resize(paddedSamples);
+          ReadPaddedLine(inputLine, rowLine, band, &row->pixels[0]);
+          newRows.append(row);
+        }
+
+        if (threaded) {
+          QtConcurrent::blockingMap(newRows, SampleFilterFunctor(this));
+        }
+        else {
+          for (int i = 0; i < newRows.size(); i++) {
+            SampleFilterFunctor(this)(newRows[i]);
+          }
+        }
+        rows.append(newRows);
+
+        QVector<SeparableLine> outputLines(groupEnd - groupStart + 1);
+        for (int i = 0; i < outputLines.size(); i++) {
+          outputLines[i].line = groupStart + i;
+        }
+
+        if (threaded) {
+          QtConcurrent::blockingMap(outputLines,
+                                    LineFilterFunctor(this, &rows, firstRowLine));
+        }
+        else {
+          for (int i = 0; i < outputLines.size(); i++) {
+            LineFilterFunctor(this, &rows, firstRowLine)(outputLines[i]);
+          }
+        }
+
+        for (int i = 0; i < outputLines.size(); i++) {
+          outputLine.SetLine(outputLines[i].line, band);
+          for (int j = 0; j < outputLine.size(); j++) {
+            outputLine[j] = outputLines[i].values[j];
+          }
+          outputCube->write(outputLine);
+          p_progress->CheckStatus();
+        }
+      }
+
+      qDeleteAll(rows);
+    }
+  }
+
+
+  /**
+   * Determines whether a kernel is separable, that is, whether it is the outer
+   * product of a column of line weights and a row of sample weights, and finds
+   * the weights if it is.
+   *
+   * @param kernel The kernel, ordered by line and then sample like a boxcar
+   *               Buffer
+   * @param ns Number of samples in the kernel
+   * @param nl Number of lines in the kernel
+   * @param sampleWeights Set to the sample weights if the kernel is separable
+   * @param lineWeights Set to the line weights if the kernel is separable
+   * @param tolerance The largest difference, relative to the largest kernel
+   *                  value, between the kernel and the product of the weights
+   *
+   * @return @b bool True if the kernel is separable
+   *
+   * @throws Isis::IException::Programmer
+   */
+  bool ProcessByBoxcar::SeparateKernel(const std::vector<double> &kernel,
+                                       const int ns, const int nl,
+                                       std::vector<double> &sampleWeights,
+                                       std::vector<double> &lineWeights,
+                                       const double tolerance) {
+    if (ns < 1 || nl < 1 || (int)kernel.size() != ns * nl) {
+      string m = "The kernel must have samples * lines values";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    // the largest value is used as the pivot
+    int pivot = 0;
+    for (int i = 1; i < (int)kernel.size(); i++) {
+      if (fabs(kernel[i]) > fabs(kernel[pivot])) {
+        pivot = i;
+      }
+    }
+
+    int pivotLine = pivot / ns;
+    int pivotSample = pivot % ns;
+    double largest = fabs(kernel[pivot]);
+
+    vector<double> samples(ns, 0.0);
+    vector<double> linesWeights(nl, 0.0);
+    if (largest > 0.0) {
+      for (int i = 0; i < ns; i++) {
+        samples[i] = kernel[pivotLine * ns + i];
+      }
+      for (int j = 0; j < nl; j++) {
+        linesWeights[j] = kernel[j * ns + pivotSample] / kernel[pivot];
+      }
+    }
+
+    for (int j = 0; j < nl; j++) {
+      for (int i = 0; i < ns; i++) {
+        if (fabs(kernel[j * ns + i] - linesWeights[j] * samples[i]) > tolerance * largest) {
+          return false;
+        }
+      }
+    }
+
+    sampleWeights = samples;
+    lineWeights = linesWeights;
+    return true;
+  }
+
+
+  /**
+   * Verifies that there is one input and one output cube of the same size and
+   * that the boxcar size has been set.
+   *
+   * @throws Isis::IException::Programmer
+   */
+  void ProcessByBoxcar::VerifyCubes() {
     // Error checks ... there must be one input and output
     if(InputCubes.size() != 1) {
       string m = "You must specify exactly one input cube";
@@ -92,33 +356,148 @@ namespace Isis {
       string m = "Use the SetBoxcarSize method to set the boxcar size";
       throw IException(IException::Programmer, m, _FILEINFO_);
     }
+  }
 
-    // Construct boxcar buffer and line buffer managers
-    Isis::BoxcarManager box(*InputCubes[0], p_boxSamples, p_boxLines);
-    Isis::LineManager line(*OutputCubes[0]);
-    double out;
 
-    InputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
-    OutputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+  /**
+   * Reads a line of the input cube into a buffer that is padded with Null on
+   * both sides, so that the boxcar for sample i starts at index i. Lines
+   * outside of the cube are all Null.
+   *
+   * @param manager A line manager for the input cube
+   * @param line The line to read
+   * @param band The band to read
+   * @param padded The buffer, samples + p_boxSamples - 1 values long
+   */
+  void ProcessByBoxcar::ReadPaddedLine(LineManager &manager, int line, int band,
+                                       double *padded) {
+    int samples = InputCubes[0]->sampleCount();
+    int leftPad = (p_boxSamples - 1) / 2;
+    int paddedSamples = samples + p_boxSamples - 1;
 
-    // Loop and let the app programmer use the boxcar to change output pixel
-    p_progress->SetMaximumSteps(InputCubes[0]->lineCount()*InputCubes[0]->bandCount());
-    p_progress->CheckStatus();
+    if (line < 1 || line > InputCubes[0]->lineCount()) {
+      fill(padded, padded + paddedSamples, Null);
+      return;
+    }
 
-    box.begin();
-    for(line.begin(); !line.end(); line.next()) {
-      for(int i = 0; i < line.size(); i++) {
-        InputCubes[0]->read(box);
-        funct(box, out);
-        line[i] = out;
-        box++;
+    manager.SetLine(line, band);
+    InputCubes[0]->read(manager);
+
+    fill(padded, padded + leftPad, Null);
+    memcpy(padded + leftPad, manager.DoubleBuffer(), samples * sizeof(double));
+    fill(padded + leftPad + samples, padded + paddedSamples, Null);
+  }
+
+
+  /**
+   * Constructs a SampleFilterFunctor.
+   *
+   * @param process The process with the separable kernel weights
+   */
+  ProcessByBoxcar::SampleFilterFunctor::SampleFilterFunctor(const ProcessByBoxcar *process) {
+    m_process = process;
+  }
+
+
+  /**
+   * Filters an input row with the sample weights. The special pixels are
+   * replaced by zero and counted separately, so the weighted sum is a plain
+   * multiply-add over contiguous memory that the compiler can vectorize. The
+   * padded input pixels are released once they are filtered.
+   *
+   * @param row The input row
+   */
+  void ProcessByBoxcar::SampleFilterFunctor::operator()(SeparableRow *&row) const {
+    const vector<double> &weights = m_process->p_sampleWeights;
+    int numWeights = weights.size();
+    int paddedSamples = row->pixels.size();
+    int samples = paddedSamples - numWeights + 1;
+
+    vector<double> values(paddedSamples);
+    vector<int> specialCount(paddedSamples + 1, 0);
+    for (int i = 0; i < paddedSamples; i++) {
+      bool special = IsSpecial(row->pixels[i]);
+      values[i] = special ? 0.0 : row->pixels[i];
+      specialCount[i + 1] = specialCount[i] + (special ? 1 : 0);
+    }
+
+    row->sums.assign(samples, 0.0);
+    double *sums = &row->sums[0];
+    for (int j = 0; j < numWeights; j++) {
+      double weight = weights[j];
+      const double *in = &values[j];
+      for (int i = 0; i < samples; i++) {
+        sums[i] += weight * in[i];
+      }
+    }
+
+    if (m_process->p_specialPixelMode == NullIfAnySpecial) {
+      row->specials.resize(samples);
+      for (int i = 0; i < samples; i++) {
+        row->specials[i] = specialCount[i + numWeights] - specialCount[i];
+      }
+    }
+
+    vector<double>().swap(row->pixels);
+  }
+
+
+  /**
+   * Constructs a LineFilterFunctor.
+   *
+   * @param process The process with the separable kernel weights
+   * @param rows The input rows filtered by a SampleFilterFunctor
+   * @param firstRowLine The input line of the first row
+   */
+  ProcessByBoxcar::LineFilterFunctor::LineFilterFunctor(const ProcessByBoxcar *process,
+                                                        const QList<SeparableRow *> *rows,
+                                                        int firstRowLine) {
+    m_process = process;
+    m_rows = rows;
+    m_firstRowLine = firstRowLine;
+  }
+
+
+  /**
+   * Computes an output line by combining the filtered input rows under its
+   * boxcar with the line weights.
+   *
+   * @param line The output line
+   */
+  void ProcessByBoxcar::LineFilterFunctor::operator()(SeparableLine &line) const {
+    const vector<double> &weights = m_process->p_lineWeights;
+    int numWeights = weights.size();
+    int firstRow = line.line - (numWeights - 1) / 2 - m_firstRowLine;
+    int samples = m_rows->at(firstRow)->sums.size();
+
+    line.values.assign(samples, 0.0);
+    double *values = &line.values[0];
+    for (int j = 0; j < numWeights; j++) {
+      double weight = weights[j];
+      const double *in = &m_rows->at(firstRow + j)->sums[0];
+      for (int i = 0; i < samples; i++) {
+        values[i] += weight * in[i];
       }
-      OutputCubes[0]->write(line);
-      p_progress->CheckStatus();
     }
 
+    if (m_process->p_specialPixelMode == NullIfAnySpecial) {
+      vector<int> specials(samples, 0);
+      for (int j = 0; j < numWeights; j++) {
+        const int *in = &m_rows->at(firstRow + j)->specials[0];
+        for (int i = 0; i < samples; i++) {
+          specials[i] += in[i];
+        }
+      }
+
+      for (int i = 0; i < samples; i++) {
+        if (specials[i] > 0) {
+          values[i] = Null;
+        }
+      }
+    }
   }
 
+
   /**
    * End the boxcar processing sequence and cleans up by closing cubes, freeing
    * memory, etc.
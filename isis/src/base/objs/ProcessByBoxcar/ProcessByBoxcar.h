@@ -22,16 +22,36 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+#include <functional>
+#include <vector>
+
+#include <QList>
+#include <QVector>
+
 #include "Process.h"
 #include "Buffer.h"
 
 namespace Isis {
+  class LineManager;
+
   /**
    * @brief Process cubes by boxcar
    *
    * This is the processing class used to move a boxcar through cube data. This
    * class allows only one input cube and one output cube.
    *
+   * StartProcess() keeps the input lines covered by the boxcar in a ring buffer,
+   * so each input line is read from the cube once and the boxcar passed to the
+   * processing function is copied from memory.
+   *
+   * Linear filters whose kernel is the outer product of a column of line weights
+   * and a row of sample weights can use StartSeparableProcess() instead. It
+   * filters each input line with the sample weights and then combines the
+   * filtered lines with the line weights, which costs samples + lines
+   * multiplications per pixel rather than samples * lines. The lines are
+   * processed in bands on the global thread pool. SeparateKernel() finds the
+   * weights for a kernel if it is separable.
+   *
    * @ingroup HighLevelCubeIO
    *
    * @author 2003-01-03 Tracie Sucharski
@@ -50,21 +70,91 @@ namespace Isis {
    *                                           inheritance between Process and its
    *                                           child classes.  Also made destructor
    *                                           virtual.  References #2215.
+   *   @history 2018-09-07 Isis Development Team - StartProcess() now reads each
+   *                           input line once into a ring buffer instead of
+   *                           reading the boxcar from the cube for every pixel.
+   *                           Added StartSeparableProcess() and SeparateKernel().
    */
 
   class ProcessByBoxcar : public Isis::Process {
 
+    public:
+      //! How StartSeparableProcess() handles special pixels in the boxcar
+      enum SpecialPixelMode {
+        IgnoreSpecialPixels, //!< Special pixels do not contribute to the sum
+        NullIfAnySpecial     //!< The output is Null if the boxcar has a special pixel
+      };
+
     private:
       bool p_boxsizeSet; //!< Indicates whether the boxcar size has been set
       int p_boxSamples;  //!< Number of samples in boxcar
       int p_boxLines;    //!< Number of lines in boxcar
 
+      std::vector<double> p_sampleWeights; //!< Separable kernel sample weights
+      std::vector<double> p_lineWeights;   //!< Separable kernel line weights
+      SpecialPixelMode p_specialPixelMode; //!< Separable kernel special pixel mode
+
+      /**
+       * An input line of a separable process, padded with Null on both sides
+       * for the boxcar, and the result of filtering it with the sample weights.
+       */
+      struct SeparableRow {
+        std::vector<double> pixels;  //!< The padded input line
+        std::vector<double> sums;    //!< The line filtered by the sample weights
+        std::vector<int> specials;   //!< Special pixels under the sample weights
+      };
+
+      /**
+       * An output line of a separable process.
+       */
+      struct SeparableLine {
+        int line;                    //!< The output line number
+        std::vector<double> values;  //!< The output pixels
+      };
+
+      /**
+       * Filters a SeparableRow with the sample weights. This is designed to be
+       * passed into QtConcurrent::blockingMap.
+       */
+      class SampleFilterFunctor :
+          public std::unary_function<SeparableRow *&, void> {
+        public:
+          SampleFilterFunctor(const ProcessByBoxcar *process);
+          void operator()(SeparableRow *&row) const;
+
+        private:
+          const ProcessByBoxcar *m_process; //!< The process with the weights
+      };
+
+      /**
+       * Combines the filtered rows under a SeparableLine with the line weights.
+       * This is designed to be passed into QtConcurrent::blockingMap.
+       */
+      class LineFilterFunctor :
+          public std::unary_function<SeparableLine &, void> {
+        public:
+          LineFilterFunctor(const ProcessByBoxcar *process,
+                            const QList<SeparableRow *> *rows,
+                            int firstRowLine);
+          void operator()(SeparableLine &line) const;
+
+        private:
+          const ProcessByBoxcar *m_process;        //!< The process with the weights
+          const QList<SeparableRow *> *m_rows;     //!< The filtered input rows
+          int m_firstRowLine;                      //!< Input line of the first row
+      };
+
+      void VerifyCubes();
+      void ReadPaddedLine(LineManager &manager, int line, int band,
+                          double *padded);
+
 
     public:
 
       //! Constructs a ProcessByBoxcar object
       ProcessByBoxcar() {
         p_boxsizeSet = false;
+        p_specialPixelMode = IgnoreSpecialPixels;
       };
 
       //! Destroys the ProcessByBoxcar object.
@@ -78,6 +168,16 @@ namespace Isis {
         StartProcess(funct);
       }
 
+      void StartSeparableProcess(const std::vector<double> &sampleWeights,
+                                 const std::vector<double> &lineWeights,
+                                 SpecialPixelMode mode);
+
+      static bool SeparateKernel(const std::vector<double> &kernel,
+                                 const int ns, const int nl,
+                                 std::vector<double> &sampleWeights,
+                                 std::vector<double> &lineWeights,
+                                 const double tolerance = 1.0e-12);
+
       void EndProcess();
       void Finalize();
   };
@@ -1,9 +1,19 @@
 #include "Isis.h"
 #include "ProcessByBoxcar.h"
+#include "CubeAttribute.h"
+#include "LineManager.h"
+#include "SpecialPixel.h"
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <vector>
 
 using namespace std;
 void oneInAndOut(Isis::Buffer &ib, double &ob);
+void weightedSum(Isis::Buffer &ib, double &ob);
+void printWeights(const vector<double> &weights);
+
+vector<double> kernel;
 
 void IsisMain() {
 
@@ -132,6 +142,78 @@ void IsisMain() {
     cout << endl;
   }
 
+  cout << "Testing separable kernels ..." << endl;
+  double lineWeights[] = {1.0, 2.0, 1.0};
+  double sampleWeights[] = {1.0, 4.0, 6.0, 4.0, 1.0};
+  for (int j = 0; j < 3; j++) {
+    for (int i = 0; i < 5; i++) {
+      kernel.push_back(lineWeights[j] * sampleWeights[i]);
+    }
+  }
+
+  vector<double> sws, lws;
+  bool separable = Isis::ProcessByBoxcar::SeparateKernel(kernel, 5, 3, sws, lws);
+  cout << "Separable: " << separable << endl;
+  cout << "Sample weights: ";
+  printWeights(sws);
+  cout << "Line weights: ";
+  printWeights(lws);
+
+  vector<double> identity(9, 0.0);
+  identity[0] = identity[4] = identity[8] = 1.0;
+  vector<double> identitySws, identityLws;
+  cout << "Separable: "
+       << Isis::ProcessByBoxcar::SeparateKernel(identity, 3, 3, identitySws, identityLws)
+       << endl;
+
+  try {
+    p.SetInputCube("FROM");
+    p.SetOutputCube("TO");
+    p.StartSeparableProcess(vector<double>(), lws, Isis::ProcessByBoxcar::IgnoreSpecialPixels);
+  }
+  catch(Isis::IException &e) {
+    e.print();
+    p.EndProcess();
+    cout << endl;
+  }
+
+  cout << "Comparing the separable and boxcar filters ..." << endl;
+  Isis::CubeAttributeOutput real("+Real");
+  p.SetInputCube("FROM");
+  p.SetOutputCube("$temporary/isisProcessByBoxcar_03.cub", real, 126, 126, 2);
+  p.SetBoxcarSize(5, 3);
+  p.StartProcess(weightedSum);
+  p.EndProcess();
+
+  p.SetInputCube("FROM");
+  p.SetOutputCube("$temporary/isisProcessByBoxcar_04.cub", real, 126, 126, 2);
+  p.StartSeparableProcess(sws, lws, Isis::ProcessByBoxcar::IgnoreSpecialPixels);
+  p.EndProcess();
+
+  Isis::Cube boxcarCube("$temporary/isisProcessByBoxcar_03.cub");
+  Isis::Cube separableCube("$temporary/isisProcessByBoxcar_04.cub");
+  Isis::LineManager boxcarLine(boxcarCube);
+  Isis::LineManager separableLine(separableCube);
+  int differences = 0;
+  for (boxcarLine.begin(), separableLine.begin(); !boxcarLine.end();
+       boxcarLine.next(), separableLine.next()) {
+    boxcarCube.read(boxcarLine);
+    separableCube.read(separableLine);
+    for (int i = 0; i < boxcarLine.size(); i++) {
+      double a = boxcarLine[i];
+      double b = separableLine[i];
+      if (Isis::IsSpecial(a) || Isis::IsSpecial(b)) {
+        if (a != b) differences++;
+      }
+      else if (fabs(a - b) > 1.0e-5 * max(1.0, fabs(a))) {
+        differences++;
+      }
+    }
+  }
+  cout << "Differences: " << differences << endl;
+  boxcarCube.close(true);
+  separableCube.close(true);
+
   Isis::Cube cube;
   cube.open("$temporary/isisProcessByBoxcar_01");
   cube.close(true);
@@ -159,3 +241,19 @@ void oneInAndOut(Isis::Buffer &ib, double &ob) {
   }
 }
 
+
+void weightedSum(Isis::Buffer &ib, double &ob) {
+  ob = 0.0;
+  for (int i = 0; i < ib.size(); i++) {
+    if (!Isis::IsSpecial(ib[i])) {
+      ob += kernel[i] * ib[i];
+    }
+  }
+}
+
+void printWeights(const vector<double> &weights) {
+  for (unsigned int i = 0; i < weights.size(); i++) {
+    cout << (i == 0 ? "" : " ") << weights[i];
+  }
+  cout << endl;
+}
@@ -22,12 +22,38 @@
 
 #include "ProcessByBrick.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "Brick.h"
 #include "Cube.h"
+#include "IString.h"
+#include "PixelType.h"
 
 using namespace std;
 
 namespace Isis {
+
+  /**
+   * The most bytes a chunk aligned brick holds as doubles. Bricks covering
+   * more chunks than this use fewer lines, bands or samples.
+   */
+  static const BigInt OptimalBrickBytes = 4 * 1024 * 1024;
+
+  /**
+   * The least common multiple of two sizes, or the cap if it is larger.
+   */
+  static BigInt LeastCommonMultiple(BigInt a, BigInt b, BigInt cap) {
+    BigInt x = a;
+    BigInt y = b;
+    while (y != 0) {
+      BigInt remainder = x % y;
+      x = y;
+      y = remainder;
+    }
+    return min(a / x * b, cap);
+  }
+
   ProcessByBrick::ProcessByBrick() {
     p_inputBrickSamples.clear();
     p_inputBrickLines.clear();
@@ -42,6 +68,8 @@ namespace Isis {
     p_outputBrickSizeSet = false;
     p_wrapOption = false;
     p_reverse = false;
+    p_pipelineMemory = 64 * 1024 * 1024;
+    p_optimalBrickSize = false;
   }
 
 
@@ -114,10 +142,33 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
 
 }
 
+  /**
+   * Sets the brick sizes before processing. Child classes override this to
+   *   set the bricks their processing needs. When SetOptimalBrickSize() is on,
+   *   the bricks of all cubes are set to a size aligned to the cube chunks;
+   *   otherwise the sizes set with SetBrickSize() are used.
+   *
+   * @param cn The cubes being processed
+   */
   void ProcessByBrick::SetBricks(IOCubes cn){
+    if (!p_optimalBrickSize) {
+      return;
+    }
 
-      ;
+    vector<Cube *> cubes;
+    if (cn == InPlace) {
+      cubes.push_back((InputCubes.size() == 1) ? InputCubes[0] : OutputCubes[0]);
+    }
+    else {
+      cubes = InputCubes;
+      for (unsigned int i = 0; i < OutputCubes.size(); i++) {
+        cubes.push_back(OutputCubes[i]);
+      }
+    }
 
+    int samples, lines, bands;
+    ChunkAlignedBrickSize(cubes, samples, lines, bands);
+    SetBrickSize(samples, lines, bands);
   }
 
   /**
@@ -450,30 +501,7 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(void funct(Buffer &in)) {
-    Cube *cube = NULL;
-    Brick *brick = NULL;
-
-    bool haveInput = PrepProcessCubeInPlace(&cube, &brick);
-
-    // Loop and let the app programmer work with the bricks
-    p_progress->SetMaximumSteps(brick->Bricks());
-    p_progress->CheckStatus();
-
-    for (brick->begin(); !brick->end(); (*brick)++) {
-      if (haveInput) 
-        cube->read(*brick);  // input only
-   
-      funct(*brick);
-
-      // output only or input/output
-      if ((!haveInput) || (cube->isReadWrite())) {
-        cube->write(*brick);
-      }
-
-      p_progress->CheckStatus();
-    }
-
-    delete brick;
+    ProcessCubeInPlace(funct, false);
   }
 
 
@@ -492,29 +520,7 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    * @throws iException::Programmer
    */
   void ProcessByBrick::StartProcess(void funct(Buffer &in, Buffer &out)) {
-    Brick *ibrick = NULL;
-    Brick *obrick = NULL;
-
-    int numBricks = PrepProcessCube(&ibrick, &obrick);
-
-    // Loop and let the app programmer work with the bricks
-    p_progress->SetMaximumSteps(numBricks);
-    p_progress->CheckStatus();
-
-    ibrick->begin();
-    obrick->begin();
-
-    for (int i = 0; i < numBricks; i++) {
-      InputCubes[0]->read(*ibrick);
-      funct(*ibrick, *obrick);
-      OutputCubes[0]->write(*obrick);
-      p_progress->CheckStatus();
-      (*ibrick)++;
-      (*obrick)++;
-    }
-
-    delete ibrick;
-    delete obrick;
+    ProcessCube(funct, false);
   }
 
 
@@ -533,66 +539,150 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
    */
   void ProcessByBrick::StartProcess(void funct(std::vector<Buffer *> &in,
                                                std::vector<Buffer *> &out)) {
-    // Construct two vectors of brick buffer managers
-    // The input buffer managers
-    vector<Brick *> imgrs;
-    vector<Buffer *> ibufs;
+    ProcessCubes(funct, false);
+  }
 
-    // And the output buffer managers
-    vector<Brick *> omgrs;
-    vector<Buffer *> obufs;
 
-    int numBricks = PrepProcessCubes(ibufs, obufs, imgrs, omgrs);
+  /**
+   * Sets how much memory the bricks in flight may use while reading,
+   *   processing and writing overlap. While one batch of brick positions is
+   *   processed, the next batch is read and the previous batch is written, so
+   *   up to three batches are held at once. Larger budgets let the I/O threads
+   *   run further ahead of the processing. The default is 64MB.
+   *
+   * @param bytes The memory budget in bytes. 0 turns the pipeline off, so
+   *              each position is read, processed and written before the next.
+   *
+   * @throws IException::Programmer
+   */
+  void ProcessByBrick::SetPipelineMemory(BigInt bytes) {
+    if (bytes < 0) {
+      QString msg = "The pipeline memory [" + toString(bytes) + "] can not be negative";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
 
-    // Loop and let the app programmer process the bricks
-    p_progress->SetMaximumSteps(numBricks);
-    p_progress->CheckStatus();
+    p_pipelineMemory = bytes;
+  }
 
-    for(int t = 0; t < numBricks; t++) {
-      // Read the input buffers
-      for(unsigned int i = 0; i < InputCubes.size(); i++) {
-        InputCubes[i]->read(*ibufs[i]);
-      }
 
-      // Pass them to the application function
-      funct(ibufs, obufs);
+  /**
+   * Turns on or off choosing brick sizes aligned to the chunks the cubes are
+   *   stored in. When it is on, the brick sizes are chosen with
+   *   ChunkAlignedBrickSize() when processing starts, replacing any set with
+   *   SetBrickSize(). Bricks may then hold more than one band. Child classes
+   *   that set their own bricks do not use this.
+   *
+   * @param optimal True to choose chunk aligned brick sizes
+   */
+  void ProcessByBrick::SetOptimalBrickSize(bool optimal) {
+    p_optimalBrickSize = optimal;
+  }
 
-      // And copy them into the output cubes
-      for(unsigned int i = 0; i < OutputCubes.size(); i++) {
-        OutputCubes[i]->write(*obufs[i]);
-        omgrs[i]->next();
-      }
 
-      for(unsigned int i = 0; i < InputCubes.size(); i++) {
-        imgrs[i]->next();
+  /**
+   * Returns true if brick sizes aligned to the cube chunks are chosen when
+   *   processing starts.
+   *
+   * @return bool
+   */
+  bool ProcessByBrick::OptimalBrickSize() {
+    return p_optimalBrickSize;
+  }
 
-        // if the manager has reached the end and the
-        // wrap option is on, wrap around to the beginning
-        if(Wraps() && imgrs[i]->end())
-          imgrs[i]->begin();
 
-        // Enforce same band
-        if(imgrs[i]->Band() != imgrs[0]->Band() &&
-           InputCubes[i]->bandCount() != 1) {
-          imgrs[i]->SetBaseBand(imgrs[0]->Band());
-        }
-      }
-      p_progress->CheckStatus();
+  /**
+   * Chooses a brick size aligned to the chunks a set of cubes is stored in, so
+   *   bricks do not straddle chunk boundaries. Each dimension is the least
+   *   common multiple of the chunk sizes of the cubes, and at most the largest
+   *   cube. When a brick of doubles would hold more than a few megabytes, it
+   *   uses fewer lines, then fewer bands, then fewer samples; a dimension is
+   *   only cut to a whole fraction of its chunks unless every chunk covers it.
+   *   Applications can call this before processing to learn the brick size
+   *   their functors will be given.
+   *
+   * @param cubes The cubes that will be processed
+   * @param samples Returns the samples in a brick
+   * @param lines Returns the lines in a brick
+   * @param bands Returns the bands in a brick
+   * @param singleBand True for bricks of one band, as with ProcessByTile
+   *
+   * @throws IException::Programmer "No cubes to choose a brick size for"
+   */
+  void ProcessByBrick::ChunkAlignedBrickSize(const vector<Cube *> &cubes,
+                                             int &samples, int &lines, int &bands,
+                                             bool singleBand) {
+    if (cubes.empty()) {
+      string msg = "No cubes to choose a brick size for";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
-    for(unsigned int i = 0; i < ibufs.size(); i++) {
-      delete ibufs[i];
+    BigInt alignedSamples = 1;
+    BigInt alignedLines = 1;
+    BigInt alignedBands = 1;
+    int maxSamples = 0;
+    int maxLines = 0;
+    int maxBands = 0;
+    bool wholeSamples = true;
+    bool wholeLines = true;
+    bool wholeBands = true;
+    for (unsigned int i = 0; i < cubes.size(); i++) {
+      Cube *cube = cubes[i];
+      maxSamples = max(maxSamples, cube->sampleCount());
+      maxLines = max(maxLines, cube->lineCount());
+      maxBands = max(maxBands, cube->bandCount());
+      wholeSamples = wholeSamples && cube->sampleCountInChunk() >= cube->sampleCount();
+      wholeLines = wholeLines && cube->lineCountInChunk() >= cube->lineCount();
+      wholeBands = wholeBands && cube->bandCountInChunk() >= cube->bandCount();
+
+      alignedSamples = LeastCommonMultiple(alignedSamples, cube->sampleCountInChunk(),
+                                           INT_MAX);
+      alignedLines = LeastCommonMultiple(alignedLines, cube->lineCountInChunk(), INT_MAX);
+      alignedBands = LeastCommonMultiple(alignedBands, cube->bandCountInChunk(), INT_MAX);
+    }
+
+    samples = (int)min(alignedSamples, (BigInt)maxSamples);
+    lines = (int)min(alignedLines, (BigInt)maxLines);
+    bands = singleBand ? 1 : (int)min(alignedBands, (BigInt)maxBands);
+
+    BigInt pixels = OptimalBrickBytes / (BigInt)sizeof(double);
+    lines = FitDimension(lines, pixels / ((BigInt)samples * bands),
+                         wholeLines && lines == maxLines);
+    bands = FitDimension(bands, pixels / ((BigInt)samples * lines),
+                         wholeBands && bands == maxBands);
+    samples = FitDimension(samples, pixels / ((BigInt)lines * bands),
+                           wholeSamples && samples == maxSamples);
+  }
+
+
+  /**
+   * Shrinks one dimension of a brick to fit a limit.
+   *
+   * @param size The chunk aligned size of the dimension
+   * @param limit The most the dimension may be
+   * @param anySize True if the chunks cover the dimension, so any size is
+   *                aligned; otherwise the result divides size
+   *
+   * @return int The largest allowed size within the limit, and at least 1
+   */
+  int ProcessByBrick::FitDimension(int size, BigInt limit, bool anySize) {
+    if (size <= limit) {
+      return size;
+    }
+    if (limit < 1) {
+      return 1;
+    }
+    if (anySize) {
+      return (int)limit;
     }
-    ibufs.clear();
-    imgrs.clear();
 
-    for(unsigned int i = 0; i < obufs.size(); i++) {
-      delete obufs[i];
+    int fit = (int)limit;
+    while (size % fit != 0) {
+      fit--;
     }
-    obufs.clear();
-    omgrs.clear();
+    return fit;
   }
 
+
   /**
    * End the processing sequence and cleans up by closing cubes, freeing memory,
    *   etc.
@@ -654,6 +744,69 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
   }
 
 
+  /**
+   * The memory used by a brick, counting both its double buffer and its raw
+   *   buffer.
+   *
+   * @param brick The brick to measure
+   *
+   * @return BigInt The number of bytes
+   */
+  BigInt ProcessByBrick::BrickBytes(const Buffer &brick) {
+    return (BigInt)brick.size() * (sizeof(double) + SizeOf(brick.PixelType()));
+  }
+
+
+  /**
+   * The number of positions in a pipeline batch. Three batches must fit in
+   *   the pipeline memory, and there is always at least one position in a
+   *   batch.
+   *
+   * @param stepBytes The memory used by the bricks of one position
+   * @param numSteps The number of positions being processed
+   *
+   * @return int The number of positions per batch
+   */
+  int ProcessByBrick::PipelineBatchSize(BigInt stepBytes, int numSteps) const {
+    BigInt batchSize = 1;
+    if (stepBytes > 0) {
+      batchSize = p_pipelineMemory / (3 * stepBytes);
+    }
+
+    if (batchSize > numSteps) {
+      batchSize = numSteps;
+    }
+
+    if (batchSize < 1) {
+      batchSize = 1;
+    }
+
+    return (int)batchSize;
+  }
+
+
+  /**
+   * Creates the steps for the next batch of positions.
+   *
+   * @param firstPosition The first position in the batch
+   * @param batchSize The most positions in the batch
+   * @param numSteps The number of positions being processed
+   *
+   * @return QList<PipelineStep *> The new steps, owned by the caller
+   */
+  QList<ProcessByBrick::PipelineStep *> ProcessByBrick::PipelineBatch(int firstPosition,
+      int batchSize, int numSteps) const {
+    QList<PipelineStep *> batch;
+    for (int position = firstPosition;
+         position < numSteps && position < firstPosition + batchSize;
+         position++) {
+      batch.append(new PipelineStep(position));
+    }
+
+    return batch;
+  }
+
+
   /**
    * Calculates the maximum dimensions of all the cubes and returns them in a
    * vector where position 0 is the max sample, position 1 is the max line, and
@@ -22,13 +22,18 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+#include <exception>
 #include <functional>
+#include <QList>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QtConcurrentMap>
 #include <QTime>
 
 #include "Brick.h"
 #include "Buffer.h"
 #include "Cube.h"
+#include "IException.h"
 #include "Process.h"
 #include "Progress.h"
 
@@ -93,6 +98,17 @@ namespace Isis {
    *   @history 2017-05-08 Tyler Wilson - Added a call to the virtual method SetBricks inside
    *                          the functions PreProcessCubeInPlace/PreProcessCube/PreProcessCubes.
    *                          Fixes #4698.
+   *   @history 2018-09-07 Isis Development Team - ProcessCubeInPlace(), ProcessCube() and
+   *                          ProcessCubes() now run as a three stage pipeline: bricks are read
+   *                          ahead on an I/O thread, processed, and written in order on another
+   *                          I/O thread, bounded by SetPipelineMemory(). The deprecated
+   *                          StartProcess() methods now use these methods without threading, so
+   *                          they get the same read-ahead and write-behind.
+   *   @history 2018-09-07 Isis Development Team - Added SetOptimalBrickSize() and
+   *                          ChunkAlignedBrickSize() to choose brick sizes aligned to the
+   *                          chunks the cubes are stored in.
+   *   @history 2018-09-07 Isis Development Team - The read and write stages of the pipeline
+   *                          keep errors of any type and rethrow them on the processing thread.
    */
   class ProcessByBrick : public Process {
     public:
@@ -145,6 +161,14 @@ namespace Isis {
       void SetWrap(bool wrap);
       bool Wraps();
 
+      void SetPipelineMemory(BigInt bytes);
+
+      void SetOptimalBrickSize(bool optimal);
+      bool OptimalBrickSize();
+      static void ChunkAlignedBrickSize(const std::vector<Cube *> &cubes,
+                                        int &samples, int &lines, int &bands,
+                                        bool singleBand = false);
+
       using Isis::Process::StartProcess;  // make parents virtual function visable
       virtual void StartProcess(void funct(Buffer &in));
       virtual void StartProcess(void funct(Buffer &in, Buffer &out));
@@ -278,10 +302,41 @@ namespace Isis {
 
 
     private:
+      /**
+       * The bricks of one position in the cubes while it moves through
+       *   RunPipeline(). In place processing only uses inputs. The bricks are
+       *   deleted with the step.
+       */
+      struct PipelineStep {
+        /**
+         * Creates a step with no bricks yet.
+         *
+         * @param brickPosition The position of the bricks in the cubes
+         */
+        PipelineStep(int brickPosition) : position(brickPosition) {
+        }
+
+        //! Deletes the bricks
+        ~PipelineStep() {
+          for (int i = 0; i < (int)inputs.size(); i++) {
+            delete inputs[i];
+          }
+          for (int i = 0; i < (int)outputs.size(); i++) {
+            delete outputs[i];
+          }
+        }
+
+        int position;                   //!< The position of the bricks
+        std::vector<Buffer *> inputs;   //!< The bricks read from the input cubes
+        std::vector<Buffer *> outputs;  //!< The bricks written to the output cubes
+      };
+
+
       /**
        * This method runs the given wrapper functor numSteps times with
-       *   or without threading, reporting progress in both cases. This method
-       *   is a blocking call.
+       *   or without threading, reporting progress in both cases. Unless the
+       *   pipeline memory is 0, the positions are run through RunPipeline().
+       *   This method is a blocking call.
        *
        * @param wrapperFunctor A functor that does the reading, processing, and
        *            writing required given a ProcessIterator position in the
@@ -300,7 +355,10 @@ namespace Isis {
         p_progress->CheckStatus();
 
         int threadCount = QThreadPool::globalInstance()->maxThreadCount();
-        if (threaded && threadCount > 1) {
+        if (p_pipelineMemory > 0) {
+          RunPipeline(wrapperFunctor, numSteps, threaded && threadCount > 1);
+        }
+        else if (threaded && threadCount > 1) {
           QFuture<void> result = QtConcurrent::mapped(begin, end,
               wrapperFunctor);
           BlockingReportProgress(result);
@@ -315,6 +373,223 @@ namespace Isis {
       }
 
 
+      /**
+       * This method runs the given wrapper functor numSteps times as a three
+       *   stage pipeline. The positions are split into batches. While one
+       *   batch is processed, the next batch is read on an I/O thread and the
+       *   previous batch is written, in order, on another I/O thread. At most
+       *   three batches are held at once, and the batch size keeps them within
+       *   the pipeline memory. This method is a blocking call.
+       *
+       * @param wrapperFunctor A functor with read(), process() and write()
+       *            stages for a PipelineStep, and stepBytes().
+       * @param numSteps The number of brick positions.
+       * @param threaded True to process the positions of a batch on the global
+       *            thread pool, false to process them in order on this thread.
+       */
+      template <typename Functor>
+      void RunPipeline(const Functor &wrapperFunctor, int numSteps, bool threaded) {
+        int batchSize = PipelineBatchSize(wrapperFunctor.stepBytes(), numSteps);
+
+        QThreadPool readPool;
+        readPool.setMaxThreadCount(1);
+        QThreadPool writePool;
+        writePool.setMaxThreadCount(1);
+
+        PipelineStage<Functor> *reader = NULL;
+        PipelineStage<Functor> *writer = NULL;
+        QList<PipelineStep *> reading;
+        QList<PipelineStep *> processing;
+        QList<PipelineStep *> writing;
+
+        try {
+          int nextPosition = 0;
+          reading = PipelineBatch(nextPosition, batchSize, numSteps);
+          nextPosition += reading.size();
+          reader = new PipelineStage<Functor>(wrapperFunctor, &Functor::read, reading);
+          readPool.start(reader);
+
+          while (!reading.isEmpty()) {
+            readPool.waitForDone();
+            reader->checkError();
+            delete reader;
+            reader = NULL;
+
+            processing = reading;
+            reading.clear();
+
+            // Start reading the next batch before processing this one
+            if (nextPosition < numSteps) {
+              reading = PipelineBatch(nextPosition, batchSize, numSteps);
+              nextPosition += reading.size();
+              reader = new PipelineStage<Functor>(wrapperFunctor, &Functor::read, reading);
+              readPool.start(reader);
+            }
+
+            if (threaded) {
+              QtConcurrent::blockingMap(processing,
+                                        PipelineProcessFunctor<Functor>(wrapperFunctor));
+              for (int i = 0; i < processing.size(); i++) {
+                p_progress->CheckStatus();
+              }
+            }
+            else {
+              for (int i = 0; i < processing.size(); i++) {
+                wrapperFunctor.process(*processing[i]);
+                p_progress->CheckStatus();
+              }
+            }
+
+            // The previous batch has to be written before this one
+            if (writer) {
+              writePool.waitForDone();
+              writer->checkError();
+              delete writer;
+              writer = NULL;
+            }
+            qDeleteAll(writing);
+
+            writing = processing;
+            processing.clear();
+            writer = new PipelineStage<Functor>(wrapperFunctor, &Functor::write, writing);
+            writePool.start(writer);
+          }
+
+          if (writer) {
+            writePool.waitForDone();
+            writer->checkError();
+            delete writer;
+            writer = NULL;
+          }
+          qDeleteAll(writing);
+          writing.clear();
+        }
+        catch (...) {
+          readPool.waitForDone();
+          writePool.waitForDone();
+          delete reader;
+          delete writer;
+          qDeleteAll(reading);
+          qDeleteAll(processing);
+          qDeleteAll(writing);
+          throw;
+        }
+      }
+
+
+      /**
+       * Runs the read or write stage of a wrapper functor over a batch of
+       *   PipelineSteps, in order, on an I/O thread. Errors of any type are
+       *   kept so the pipeline can throw them on its own thread.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      template <typename T>
+      class PipelineStage : public QRunnable {
+        public:
+          //! The read or write stage of a wrapper functor
+          typedef void (T::*Stage)(PipelineStep &) const;
+
+          /**
+           * Construct a PipelineStage. The stage doesn't take ownership of
+           *   the steps.
+           *
+           * @param wrapperFunctor The functor with the stage to run
+           * @param stage The stage to run on each step
+           * @param steps The batch of steps, in position order
+           */
+          PipelineStage(const T &wrapperFunctor, Stage stage,
+                        const QList<PipelineStep *> &steps) :
+              m_wrapperFunctor(wrapperFunctor),
+              m_stage(stage),
+              m_steps(steps) {
+            setAutoDelete(false);
+          }
+
+
+          //! Destructor
+          virtual ~PipelineStage() {
+          }
+
+
+          //! Runs the stage on each step until one fails.
+          void run() {
+            try {
+              for (int i = 0; i < m_steps.size(); i++) {
+                (m_wrapperFunctor.*m_stage)(*m_steps[i]);
+              }
+            }
+            catch (...) {
+              // Nothing may escape run() on a pool thread
+              m_error = std::current_exception();
+            }
+          }
+
+
+          /**
+           * Throws the error that stopped the stage, if there was one, as it
+           *   was thrown.
+           */
+          void checkError() const {
+            if (m_error) {
+              std::rethrow_exception(m_error);
+            }
+          }
+
+        private:
+          PipelineStage(const PipelineStage &other);
+          PipelineStage &operator=(const PipelineStage &rhs);
+
+          //! The functor with the stage to run
+          const T &m_wrapperFunctor;
+          //! The stage to run on each step
+          Stage m_stage;
+          //! The batch of steps
+          QList<PipelineStep *> m_steps;
+          //! The error that stopped the stage, null if there wasn't one
+          std::exception_ptr m_error;
+      };
+
+
+      /**
+       * Runs the process stage of a wrapper functor on a PipelineStep. This
+       *   is designed to be passed into QtConcurrent::blockingMap.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      template <typename T>
+      class PipelineProcessFunctor :
+          public std::unary_function<PipelineStep *&, void> {
+        public:
+          /**
+           * Construct a PipelineProcessFunctor.
+           *
+           * @param wrapperFunctor The functor with the process stage
+           */
+          PipelineProcessFunctor(const T &wrapperFunctor) :
+              m_wrapperFunctor(&wrapperFunctor) {
+          }
+
+
+          /**
+           * Process one step.
+           *
+           * @param step The step to process
+           */
+          void operator()(PipelineStep *&step) const {
+            m_wrapperFunctor->process(*step);
+          }
+
+        private:
+          //! The functor with the process stage
+          const T *m_wrapperFunctor;
+      };
+
+
       /**
        * Process a cube in place (one input/zero output or zero input/one
        *   output or one cube that acts both as input and output). Given a
@@ -390,18 +665,59 @@ namespace Isis {
            *                      currently.
            */
           void *operator()(const int &brickPosition) const {
-            Brick cubeData(*m_templateBrick);
-            cubeData.setpos(brickPosition);
+            PipelineStep step(brickPosition);
+            read(step);
+            process(step);
+            write(step);
+
+            return NULL;
+          }
+
+
+          /**
+           * Create the brick for a position and read it from the cube if
+           *   there is input.
+           *
+           * @param step The position and bricks to fill in
+           */
+          void read(PipelineStep &step) const {
+            Brick *cubeData = new Brick(*m_templateBrick);
+            step.inputs.push_back(cubeData);
+            cubeData->setpos(step.position);
 
             if (m_readInput)
-              m_cube->read(cubeData);
+              m_cube->read(*cubeData);
+          }
+
+
+          /**
+           * Run the processing functor on the brick of a position.
+           *
+           * @param step The position and bricks from read()
+           */
+          void process(PipelineStep &step) const {
+            m_processingFunctor(*step.inputs[0]);
+          }
 
-            m_processingFunctor(cubeData);
 
+          /**
+           * Write the brick of a position to the cube if there is output.
+           *
+           * @param step The position and bricks from process()
+           */
+          void write(PipelineStep &step) const {
             if (m_writeOutput)
-              m_cube->write(cubeData);
+              m_cube->write(*step.inputs[0]);
+          }
 
-            return NULL;
+
+          /**
+           * The memory used by the bricks of one position.
+           *
+           * @return BigInt The number of bytes
+           */
+          BigInt stepBytes() const {
+            return BrickBytes(*m_templateBrick);
           }
 
 
@@ -515,19 +831,60 @@ namespace Isis {
            *                      currently.
            */
           void *operator()(const int &brickPosition) const {
-            Brick inputCubeData(*m_inputTemplateBrick);
-            Brick outputCubeData(*m_outputTemplateBrick);
+            PipelineStep step(brickPosition);
+            read(step);
+            process(step);
+            write(step);
+
+            return NULL;
+          }
+
 
-            inputCubeData.setpos(brickPosition);
-            outputCubeData.setpos(brickPosition);
+          /**
+           * Create the bricks for a position and read the input brick.
+           *
+           * @param step The position and bricks to fill in
+           */
+          void read(PipelineStep &step) const {
+            Brick *inputCubeData = new Brick(*m_inputTemplateBrick);
+            step.inputs.push_back(inputCubeData);
+            Brick *outputCubeData = new Brick(*m_outputTemplateBrick);
+            step.outputs.push_back(outputCubeData);
 
-            m_inputCube->read(inputCubeData);
+            inputCubeData->setpos(step.position);
+            outputCubeData->setpos(step.position);
 
-            m_processingFunctor(inputCubeData, outputCubeData);
+            m_inputCube->read(*inputCubeData);
+          }
 
-            m_outputCube->write(outputCubeData);
 
-            return NULL;
+          /**
+           * Run the processing functor on the bricks of a position.
+           *
+           * @param step The position and bricks from read()
+           */
+          void process(PipelineStep &step) const {
+            m_processingFunctor(*step.inputs[0], *step.outputs[0]);
+          }
+
+
+          /**
+           * Write the output brick of a position.
+           *
+           * @param step The position and bricks from process()
+           */
+          void write(PipelineStep &step) const {
+            m_outputCube->write(*step.outputs[0]);
+          }
+
+
+          /**
+           * The memory used by the bricks of one position.
+           *
+           * @return BigInt The number of bytes
+           */
+          BigInt stepBytes() const {
+            return BrickBytes(*m_inputTemplateBrick) + BrickBytes(*m_outputTemplateBrick);
           }
 
 
@@ -647,24 +1004,37 @@ namespace Isis {
            *                      currently.
            */
           void *operator()(const int &brickPosition) const {
-            QPair< std::vector<Buffer *>, std::vector<Buffer *> > functorBricks;
+            PipelineStep step(brickPosition);
+            read(step);
+            process(step);
+            write(step);
+
+            return NULL;
+          }
 
+
+          /**
+           * Create the bricks for a position and read the input bricks.
+           *
+           * @param step The position and bricks to fill in
+           */
+          void read(PipelineStep &step) const {
             for (int i = 0; i < (int)m_inputTemplateBricks.size(); i++) {
               Brick *inputBrick = new Brick(*m_inputTemplateBricks[i]);
-              functorBricks.first.push_back(inputBrick);
+              step.inputs.push_back(inputBrick);
 
               if (m_wraps) {
-                inputBrick->setpos(brickPosition % inputBrick->Bricks());
+                inputBrick->setpos(step.position % inputBrick->Bricks());
               }
               else {
-                inputBrick->setpos(brickPosition);
+                inputBrick->setpos(step.position);
               }
 
               if (i != 0 &&
-                  functorBricks.first.size() &&
-                  inputBrick->Band() != functorBricks.first[0]->Band() &&
+                  step.inputs.size() &&
+                  inputBrick->Band() != step.inputs[0]->Band() &&
                   m_inputCubes[i]->bandCount() != 1) {
-                inputBrick->SetBaseBand(functorBricks.first[0]->Band());
+                inputBrick->SetBaseBand(step.inputs[0]->Band());
               }
 
               m_inputCubes[i]->read(*inputBrick);
@@ -672,24 +1042,48 @@ namespace Isis {
 
             for (int i = 0; i < (int)m_outputTemplateBricks.size(); i++) {
               Brick *outputBrick = new Brick(*m_outputTemplateBricks[i]);
-              functorBricks.second.push_back(outputBrick);
-              outputBrick->setpos(brickPosition);
+              step.outputs.push_back(outputBrick);
+              outputBrick->setpos(step.position);
             }
+          }
 
-            // Pass them to the application function
-            m_processingFunctor(functorBricks.first, functorBricks.second);
 
-            // And copy them into the output cubes
-            for (int i = 0; i < (int)functorBricks.second.size(); i++) {
-              m_outputCubes[i]->write(*functorBricks.second[i]);
-              delete functorBricks.second[i];
-            }
+          /**
+           * Pass the bricks of a position to the application function.
+           *
+           * @param step The position and bricks from read()
+           */
+          void process(PipelineStep &step) const {
+            m_processingFunctor(step.inputs, step.outputs);
+          }
 
-            for (int i = 0; i < (int)functorBricks.first.size(); i++) {
-              delete functorBricks.first[i];
+
+          /**
+           * Copy the output bricks of a position into the output cubes.
+           *
+           * @param step The position and bricks from process()
+           */
+          void write(PipelineStep &step) const {
+            for (int i = 0; i < (int)step.outputs.size(); i++) {
+              m_outputCubes[i]->write(*step.outputs[i]);
             }
+          }
 
-            return NULL;
+
+          /**
+           * The memory used by the bricks of one position.
+           *
+           * @return BigInt The number of bytes
+           */
+          BigInt stepBytes() const {
+            BigInt bytes = 0;
+            for (int i = 0; i < (int)m_inputTemplateBricks.size(); i++) {
+              bytes += BrickBytes(*m_inputTemplateBricks[i]);
+            }
+            for (int i = 0; i < (int)m_outputTemplateBricks.size(); i++) {
+              bytes += BrickBytes(*m_outputTemplateBricks[i]);
+            }
+            return bytes;
           }
 
 
@@ -740,7 +1134,12 @@ namespace Isis {
 
 
       void BlockingReportProgress(QFuture<void> &future);
+      static BigInt BrickBytes(const Buffer &brick);
+      int PipelineBatchSize(BigInt stepBytes, int numSteps) const;
+      QList<PipelineStep *> PipelineBatch(int firstPosition, int batchSize,
+                                          int numSteps) const;
       std::vector<int> CalculateMaxDimensions(std::vector<Cube *> cubes) const;
+      static int FitDimension(int size, BigInt limit, bool anySize);
       bool PrepProcessCubeInPlace(Cube **cube, Brick **bricks);
       int PrepProcessCube(Brick **ibrick, Brick **obrick);
       int PrepProcessCubes(std::vector<Buffer *> & ibufs,
@@ -836,6 +1235,11 @@ namespace Isis {
 
       int p_outputRequirements;
 
+      BigInt p_pipelineMemory; /**< The most memory RunPipeline() holds bricks
+                                    in, 0 to turn pipelining off*/
+      bool p_optimalBrickSize; /**< Indicates whether SetBricks() chooses brick
+                                    sizes aligned to the cube chunks*/
+
 
       std::vector<int> p_inputBrickSamples;  /**< Number of samples in the input
                                                   bricks*/
@@ -8,6 +8,7 @@ using namespace std;
 using namespace Isis;
 void oneInAndOut(Buffer &ob, Buffer &ib);
 void twoInAndOut(vector<Buffer *> &ib, vector<Buffer *> &ob);
+bool aligned(Cube *cube, int samples, int lines, int bands);
 
 class Functor2 {
   public:
@@ -326,6 +327,59 @@ void IsisMain() {
     cout << "\n";
   }
 
+  {
+    cout << "Functor4 - ProcessCube Pipelined\n";
+    p.SetPipelineMemory(1);
+    Cube *icube = p.SetInputCube("FROM");
+    p.SetBrickSize(10, 10, 2);
+    p.SetOutputCube("TO", icube->sampleCount(), icube->lineCount(),
+                    icube->bandCount());
+    Functor4 functor;
+    p.ProcessCube(functor);
+    p.EndProcess();
+    Cube cube;
+    cube.open(Application::GetUserInterface().GetFileName("TO"));
+    Statistics *statsBand1 = cube.statistics(1);
+    Statistics *statsBand2 = cube.statistics(2);
+    std::cerr << "Averages: " << statsBand1->Average() << ", " <<
+                                 statsBand2->Average() << "\n";
+    cout << "\n";
+  }
+
+  {
+    cout << "Functor4 - ProcessCube Optimal Brick Size\n";
+    Cube *icube = p.SetInputCube("FROM");
+    Cube *ocube = p.SetOutputCube("TO", icube->sampleCount(), icube->lineCount(),
+                                  icube->bandCount());
+    vector<Cube *> cubes;
+    cubes.push_back(icube);
+    cubes.push_back(ocube);
+    int samples, lines, bands;
+    ProcessByBrick::ChunkAlignedBrickSize(cubes, samples, lines, bands);
+    cout << "Bricks aligned: " << (aligned(icube, samples, lines, bands) &&
+                                   aligned(ocube, samples, lines, bands)) << "\n";
+    p.SetOptimalBrickSize(true);
+    Functor4 functor;
+    p.ProcessCube(functor);
+    p.EndProcess();
+    p.SetOptimalBrickSize(false);
+    Cube cube;
+    cube.open(Application::GetUserInterface().GetFileName("TO"));
+    Statistics *statsBand1 = cube.statistics(1);
+    Statistics *statsBand2 = cube.statistics(2);
+    std::cerr << "Averages: " << statsBand1->Average() << ", " <<
+                                 statsBand2->Average() << "\n";
+
+    try {
+      cubes.clear();
+      ProcessByBrick::ChunkAlignedBrickSize(cubes, samples, lines, bands);
+    }
+    catch(IException &ex) {
+      cout << ex.toString().toStdString() << endl;
+    }
+    cout << "\n";
+  }
+
   cout << "End Testing Functors\n\n";
   cout << "Testing StartProcess\n";
 
@@ -402,3 +456,19 @@ void twoInAndOut(vector<Buffer *> &ib, vector<Buffer *> &ob) {
     cout << "Bogus error #3" << endl;
   }
 }
+
+
+/**
+ * True if bricks of the given size do not straddle the chunks of a cube.
+ */
+bool aligned(Cube *cube, int samples, int lines, int bands) {
+  return (samples >= cube->sampleCount() ||
+          samples % cube->sampleCountInChunk() == 0 ||
+          cube->sampleCountInChunk() % samples == 0) &&
+         (lines >= cube->lineCount() ||
+          lines % cube->lineCountInChunk() == 0 ||
+          cube->lineCountInChunk() % lines == 0) &&
+         (bands >= cube->bandCount() ||
+          bands % cube->bandCountInChunk() == 0 ||
+          cube->bandCountInChunk() % bands == 0);
+}
@@ -23,15 +23,32 @@
 
 #include "ProcessBySpectra.h"
 
+#include <algorithm>
+
 #include "Buffer.h"
 #include "Cube.h"
 #include "IException.h"
+#include "IString.h"
 #include "Process.h"
 #include "ProcessByBrick.h"
+#include "SpecialPixel.h"
 
 using namespace std;
 namespace Isis {
 
+  /**
+   * The most bytes an automatically sized tile of ProcessSpectra() holds for
+   * all of its input and output bands.
+   */
+  static const BigInt AutomaticTileBytes = 8 * 1024 * 1024;
+
+  /**
+   * Pixels transposed together when interleaving a tile. Each band of this
+   * many pixels is read in order while the spectra being written stay in
+   * cache.
+   */
+  static const int InterleavePixels = 64;
+
 /**
    * Opens an input cube specified by the user and verifies requirements are
    * met. This method is overloaded and adds the requirements of
@@ -98,6 +115,7 @@ namespace Isis {
 
 
     VerifyCubes(InPlace);
+    p_tileMode = false;
     SetBricks(InPlace);
     //SetBrickSizesForProcessCubeInPlace();
     ProcessByBrick::StartProcess(funct);
@@ -121,6 +139,7 @@ namespace Isis {
                                             Isis::Buffer &out)) {
 
       VerifyCubes(InputOutput);
+      p_tileMode = false;
       SetBricks(InputOutput);
     //SetBrickSizesForProcessCube();
     ProcessByBrick::StartProcess(funct);
@@ -142,6 +161,7 @@ namespace Isis {
                                       std::vector<Isis::Buffer *> &out)) {
     //SetBrickSizesForProcessCubes();
       VerifyCubes(InputOutputList);
+      p_tileMode = false;
       SetBricks(InputOutputList);
       ProcessByBrick::StartProcess(funct);
   }
@@ -165,8 +185,124 @@ namespace Isis {
   }
 
 
+  /**
+   * Sets the samples and lines of the tiles of ProcessSpectraInPlace() and
+   * ProcessSpectra(). Tiles always hold every band. By default, and when both
+   * sizes are 0, tiles are whole lines of the cube and hold as many lines as
+   * fit in a few megabytes, rounded to the chunks of lines the cubes are
+   * stored in.
+   *
+   * @param samples The samples in each tile
+   * @param lines The lines in each tile
+   *
+   * @throws IException::Programmer "The tile size is invalid"
+   */
+  void ProcessBySpectra::SetTileSize(const int samples, const int lines) {
+    bool automatic = (samples == 0 && lines == 0);
+    if (!automatic && (samples < 1 || lines < 1)) {
+      QString m = "The tile size [" + toString(samples) + ", " + toString(lines) +
+                  "] is invalid";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+    p_tileSamples = samples;
+    p_tileLines = lines;
+  }
+
+
+  /**
+   * Sets the brick sizes of the cubes to the tiles of ProcessSpectraInPlace()
+   * or ProcessSpectra().
+   *
+   * @param cn The cubes being processed
+   */
+  void ProcessBySpectra::SetTileBricks(IOCubes cn) {
+    vector<Cube *> cubes;
+    if (cn == InPlace) {
+      cubes.push_back((InputCubes.size() == 1) ? InputCubes[0] : OutputCubes[0]);
+    }
+    else {
+      cubes.push_back(InputCubes[0]);
+      cubes.push_back(OutputCubes[0]);
+    }
+
+    int samples = p_tileSamples;
+    int lines = p_tileLines;
+    if (samples == 0) {
+      BigInt bandCount = 0;
+      for (unsigned int i = 0; i < cubes.size(); i++) {
+        bandCount += cubes[i]->bandCount();
+      }
+
+      samples = cubes[0]->sampleCount();
+      BigInt lineBytes = (BigInt)samples * bandCount * sizeof(double);
+      lines = (int)max((BigInt)1, AutomaticTileBytes / lineBytes);
+      lines = min(lines, cubes[0]->lineCount());
+      lines = ChunkAlignedLines(cubes, lines);
+    }
+
+    if (cn == InPlace) {
+      SetBrickSize(samples, lines, cubes[0]->bandCount());
+    }
+    else {
+      SetInputBrickSize(samples, lines, cubes[0]->bandCount());
+      SetOutputBrickSize(samples, lines, cubes[1]->bandCount());
+    }
+  }
+
+
+  /**
+   * Rounds the lines of an automatically sized tile so tiles do not straddle
+   * the chunks the cubes are stored in. Tiles of at least one chunk of lines
+   * are cut to whole chunks; smaller tiles are cut to a whole fraction of a
+   * chunk. Tiles holding every line of the cube are left alone.
+   *
+   * @param cubes The cubes being processed
+   * @param lines The lines that fit in a tile
+   *
+   * @return int The chunk aligned lines of a tile, at least 1
+   */
+  int ProcessBySpectra::ChunkAlignedLines(const vector<Cube *> &cubes, int lines) {
+    if (lines >= cubes[0]->lineCount()) {
+      return lines;
+    }
+
+    // The least common multiple of the chunk lines of the cubes
+    BigInt chunkLines = 1;
+    for (unsigned int i = 0; i < cubes.size(); i++) {
+      BigInt x = chunkLines;
+      BigInt y = cubes[i]->lineCountInChunk();
+      while (y != 0) {
+        BigInt remainder = x % y;
+        x = y;
+        y = remainder;
+      }
+      chunkLines = chunkLines / x * cubes[i]->lineCountInChunk();
+    }
+
+    if (lines >= chunkLines) {
+      return lines - (int)(lines % chunkLines);
+    }
+
+    while (chunkLines % lines != 0) {
+      lines--;
+    }
+    return lines;
+  }
+
+
+  /**
+   * Sets the brick sizes of the cubes to single spectra of the spectra type,
+   * or to the tiles while ProcessSpectra() or ProcessSpectraInPlace() runs.
+   * ProcessByBrick calls this again before it processes the cubes.
+   *
+   * @param cn The cubes being processed
+   */
   void ProcessBySpectra::SetBricks(IOCubes cn){
 
+      if (p_tileMode) {
+        SetTileBricks(cn);
+        return;
+      }
 
 
 
@@ -359,4 +495,74 @@ namespace Isis {
   */
 
 
+
+
+  /**
+   * Creates the spectra of a tile.
+   *
+   * @param tile A tile with every band of the cube
+   * @param copyData True to interleave the values of the tile, false to start
+   *                 with Null spectra
+   */
+  ProcessBySpectra::SpectraBlock::SpectraBlock(const Buffer &tile, bool copyData) {
+    m_sample = tile.Sample(0);
+    m_line = tile.Line(0);
+    m_tileSamples = tile.SampleDimension();
+    m_tileLines = tile.LineDimension();
+    m_bandCount = tile.BandDimension();
+
+    if (copyData) {
+      interleave(tile);
+    }
+    else {
+      m_data.assign(tile.size(), Null);
+    }
+  }
+
+
+  /**
+   * Copies the values of a tile into the spectra, transposing them from band
+   * sequential to pixel interleaved order.
+   *
+   * @param tile A tile the same size as the block
+   */
+  void ProcessBySpectra::SpectraBlock::interleave(const Buffer &tile) {
+    int pixelCount = spectrumCount();
+    m_data.resize(tile.size());
+    const double *bands = tile.DoubleBuffer();
+    double *spectra = &m_data[0];
+
+    for (int start = 0; start < pixelCount; start += InterleavePixels) {
+      int end = min(start + InterleavePixels, pixelCount);
+      for (int band = 0; band < m_bandCount; band++) {
+        const double *bandValues = bands + (size_t)band * pixelCount;
+        for (int pixel = start; pixel < end; pixel++) {
+          spectra[(size_t)pixel * m_bandCount + band] = bandValues[pixel];
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Copies the spectra into a tile, transposing them from pixel interleaved
+   * back to band sequential order.
+   *
+   * @param tile A tile the same size as the block
+   */
+  void ProcessBySpectra::SpectraBlock::deinterleave(Buffer &tile) const {
+    int pixelCount = spectrumCount();
+    double *bands = tile.DoubleBuffer();
+    const double *spectra = &m_data[0];
+
+    for (int start = 0; start < pixelCount; start += InterleavePixels) {
+      int end = min(start + InterleavePixels, pixelCount);
+      for (int band = 0; band < m_bandCount; band++) {
+        double *bandValues = bands + (size_t)band * pixelCount;
+        for (int pixel = start; pixel < end; pixel++) {
+          bandValues[pixel] = spectra[(size_t)pixel * m_bandCount + band];
+        }
+      }
+    }
+  }
 }
@@ -22,6 +22,8 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+#include <vector>
+
 #include "ProcessByBrick.h"
 #include "Buffer.h"
 
@@ -36,6 +38,14 @@ namespace Isis {
    * the ProcessByBrick class which give many functions for setting up input and
    * output cubes.
    *
+   * ProcessSpectraInPlace() and ProcessSpectra() process many spectra per call
+   * instead. A tile of samples and lines is read across all bands with one
+   * read, then transposed once so the bands of each pixel are next to each
+   * other in memory. The processing functor is given a SpectraBlock holding
+   * every spectrum of the tile, and output blocks are transposed back before
+   * they are written. This avoids a strided read per pixel on band sequential
+   * cubes.
+   *
    *
    * @ingroup HighLevelCubeIO
    *
@@ -49,12 +59,27 @@ namespace Isis {
    *   @history 2011-08-19 Jeannie Backer - Modified unitTest to use
    *                            $temporary variable instead of /tmp directory.
    *                            Added some documentation to methods.
+   *   @history 2018-09-07 Isis Development Team - Added ProcessSpectraInPlace(),
+   *                            ProcessSpectra(), SetTileSize() and SpectraBlock to
+   *                            process a tile of pixel interleaved spectra per call.
+   *   @history 2018-09-07 Isis Development Team - SetBricks() sets the tiles while
+   *                            ProcessSpectra() or ProcessSpectraInPlace() runs, since
+   *                            ProcessByBrick calls it again before processing.
+   *   @history 2018-09-07 Isis Development Team - Automatically sized tiles are
+   *                            rounded to the chunks of lines the cubes are stored in.
    *
    */
   class ProcessBySpectra : public Isis::ProcessByBrick {
     private:
       int p_spectraType; /**< Spectra type: valid values are 0 (PerPixel),
                               1 (ByLine), or 2 (BySample)*/
+      int p_tileSamples; /**< Samples in a tile of ProcessSpectra(), or 0 to
+                              choose automatically*/
+      int p_tileLines;   /**< Lines in a tile of ProcessSpectra(), or 0 to
+                              choose automatically*/
+      bool p_tileMode;   /**< True while ProcessSpectra() or
+                              ProcessSpectraInPlace() runs, so SetBricks()
+                              sets tiles instead of single spectra*/
 
     public:
       /**
@@ -70,6 +95,95 @@ namespace Isis {
        */
       ProcessBySpectra(const int type = PerPixel): ProcessByBrick() {
         SetType(type);
+        p_tileSamples = 0;
+        p_tileLines = 0;
+        p_tileMode = false;
+      };
+
+
+      /**
+       * The spectra of a tile of a cube, stored pixel interleaved. The values
+       *   of all bands of a spectrum are contiguous, and the spectra are in
+       *   the order of the pixels of the tile, sample by sample and then line
+       *   by line. Spectra of a tile that extends past the edge of the cube
+       *   are Null on input and are not written on output.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      class SpectraBlock {
+        public:
+          SpectraBlock(const Buffer &tile, bool copyData);
+
+          void interleave(const Buffer &tile);
+          void deinterleave(Buffer &tile) const;
+
+          /**
+           * Returns the number of spectra in the block.
+           *
+           * @return @b int The number of pixels in the tile
+           */
+          int spectrumCount() const {
+            return m_tileSamples * m_tileLines;
+          }
+
+          /**
+           * Returns the number of values in each spectrum.
+           *
+           * @return @b int The number of bands of the cube
+           */
+          int bandCount() const {
+            return m_bandCount;
+          }
+
+          /**
+           * Returns the values of one spectrum.
+           *
+           * @param index The spectrum, from 0 to spectrumCount() - 1
+           * @return @b double* The bandCount() values of the spectrum
+           */
+          double *spectrum(int index) {
+            return &m_data[(size_t)index * m_bandCount];
+          }
+
+          /**
+           * Returns the values of one spectrum.
+           *
+           * @param index The spectrum, from 0 to spectrumCount() - 1
+           * @return @b const double* The bandCount() values of the spectrum
+           */
+          const double *spectrum(int index) const {
+            return &m_data[(size_t)index * m_bandCount];
+          }
+
+          /**
+           * Returns the cube sample of a spectrum.
+           *
+           * @param index The spectrum, from 0 to spectrumCount() - 1
+           * @return @b int The sample
+           */
+          int sample(int index) const {
+            return m_sample + index % m_tileSamples;
+          }
+
+          /**
+           * Returns the cube line of a spectrum.
+           *
+           * @param index The spectrum, from 0 to spectrumCount() - 1
+           * @return @b int The line
+           */
+          int line(int index) const {
+            return m_line + index / m_tileSamples;
+          }
+
+        private:
+          std::vector<double> m_data; //!< The spectra, pixel interleaved
+          int m_sample;               //!< The first sample of the tile
+          int m_line;                 //!< The first line of the tile
+          int m_tileSamples;          //!< The samples in the tile
+          int m_tileLines;            //!< The lines in the tile
+          int m_bandCount;            //!< The bands in each spectrum
       };
 
       using Isis::ProcessByBrick::SetInputCube; // Make parent functions visable
@@ -94,6 +208,8 @@ namespace Isis {
         return p_spectraType;
       };
 
+      void SetTileSize(const int samples, const int lines);
+
       void StartProcess(void funct(Isis::Buffer &in));
 
       void StartProcess(void funct(Isis::Buffer &in, Isis::Buffer &out));
@@ -111,6 +227,7 @@ namespace Isis {
       void ProcessCubeInPlace(const Functor & funct, bool threaded = true) {
         //SetBrickSizesForProcessCubeInPlace();
           VerifyCubes(InPlace);
+          p_tileMode = false;
           SetBricks(InPlace);
         ProcessByBrick::ProcessCubeInPlace(funct, threaded);
       }
@@ -124,6 +241,7 @@ namespace Isis {
       void ProcessCube(const Functor & funct, bool threaded = true) {
         //SetBrickSizesForProcessCube();
           VerifyCubes(InputOutput);
+          p_tileMode = false;
           SetBricks(InputOutput);
           ProcessByBrick::ProcessCube(funct, threaded);
       }
@@ -136,17 +254,140 @@ namespace Isis {
       template <typename Functor>
       void ProcessCubes(const Functor & funct, bool threaded = true) {
           VerifyCubes(InputOutputList);
+          p_tileMode = false;
           SetBricks(InputOutputList);
         //SetBrickSizesForProcessCubes();
         ProcessByBrick::ProcessCubes(funct, threaded);
       }
 
+
+      /**
+       * Operate over a single cube in place, many spectra at a time. The
+       *   functor is called once for every tile of the cube with all of the
+       *   spectra of the tile. If threaded is true, there is no guarantee to
+       *   the sequence or timing of the functor's calls. The spectra type is
+       *   not used.
+       *
+       * If you are using a function, the prototype should look like:
+       *   void SomeFunc(ProcessBySpectra::SpectraBlock &spectra);
+       * If you are using a functor, the () operator should look like:
+       *   void operator()(ProcessBySpectra::SpectraBlock &spectra) const;
+       *
+       * @param funct The processing function or functor
+       * @param threaded True if multi-threading is supported, false otherwise.
+       */
+      template <typename Functor>
+      void ProcessSpectraInPlace(const Functor & funct, bool threaded = true) {
+        VerifyCubes(InPlace);
+        p_tileMode = true;
+        SetBricks(InPlace);
+        SpectraInPlaceFunctor<Functor> spectraFunctor(funct);
+        ProcessByBrick::ProcessCubeInPlace(spectraFunctor, threaded);
+      }
+
+
+      /**
+       * Operate over an input cube creating a separate output cube, many
+       *   spectra at a time. The functor is called once for every tile of the
+       *   cubes with all of the input and output spectra of the tile. The
+       *   output spectra start as Null. If threaded is true, there is no
+       *   guarantee to the sequence or timing of the functor's calls. The
+       *   spectra type is not used.
+       *
+       * If you are using a function, the prototype should look like:
+       *   void SomeFunc(ProcessBySpectra::SpectraBlock &in,
+       *                 ProcessBySpectra::SpectraBlock &out);
+       * If you are using a functor, the () operator should look like:
+       *   void operator()(ProcessBySpectra::SpectraBlock &in,
+       *                   ProcessBySpectra::SpectraBlock &out) const;
+       *
+       * @param funct The processing function or functor
+       * @param threaded True if multi-threading is supported, false otherwise.
+       */
+      template <typename Functor>
+      void ProcessSpectra(const Functor & funct, bool threaded = true) {
+        VerifyCubes(InputOutput);
+        p_tileMode = true;
+        SetBricks(InputOutput);
+        SpectraFunctor<Functor> spectraFunctor(funct);
+        ProcessByBrick::ProcessCube(spectraFunctor, threaded);
+      }
+
       static const int PerPixel = 0; //!< PerPixel spectra type (equal to 0)
       static const int ByLine = 1;   //!< ByLine spectra type (equal to 1)
       static const int BySample = 2; //!< BySample spectra type (equal to 2)
 
     private:
+      /**
+       * Runs a SpectraBlock functor on the tiles of ProcessSpectraInPlace().
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      template <typename T>
+      class SpectraInPlaceFunctor {
+        public:
+          /**
+           * @param processingFunctor The functor given to ProcessSpectraInPlace()
+           */
+          SpectraInPlaceFunctor(const T &processingFunctor) :
+              m_processingFunctor(processingFunctor) {
+          }
+
+          /**
+           * Interleaves a tile, processes it and puts the results back.
+           *
+           * @param tile The tile of the cube
+           */
+          void operator()(Buffer &tile) const {
+            SpectraBlock spectra(tile, true);
+            m_processingFunctor(spectra);
+            spectra.deinterleave(tile);
+          }
+
+        private:
+          const T &m_processingFunctor; //!< The functor doing the work
+      };
+
+
+      /**
+       * Runs a SpectraBlock functor on the tiles of ProcessSpectra().
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       */
+      template <typename T>
+      class SpectraFunctor {
+        public:
+          /**
+           * @param processingFunctor The functor given to ProcessSpectra()
+           */
+          SpectraFunctor(const T &processingFunctor) :
+              m_processingFunctor(processingFunctor) {
+          }
+
+          /**
+           * Interleaves an input tile, processes it and puts the results in
+           *   the output tile.
+           *
+           * @param in The tile of the input cube
+           * @param out The tile of the output cube
+           */
+          void operator()(Buffer &in, Buffer &out) const {
+            SpectraBlock inSpectra(in, true);
+            SpectraBlock outSpectra(out, false);
+            m_processingFunctor(inSpectra, outSpectra);
+            outSpectra.deinterleave(out);
+          }
+
+        private:
+          const T &m_processingFunctor; //!< The functor doing the work
+      };
 
+      void SetTileBricks(IOCubes cn);
+      static int ChunkAlignedLines(const std::vector<Cube *> &cubes, int lines);
       void SetBricks(IOCubes cn);
       void SetBrickSizesForProcessCubeInPlace();
       void SetBrickSizesForProcessCube();
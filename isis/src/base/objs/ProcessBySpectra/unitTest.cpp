@@ -1,12 +1,14 @@
 #include "Isis.h"
 #include "ProcessBySpectra.h"
 #include "Cube.h"
+#include "LineManager.h"
 #include <string>
 
 using namespace std;
 void oneInput(Isis::Buffer &b);
 void oneInAndOut(Isis::Buffer &ob, Isis::Buffer &ib);
 void twoInAndOut(vector<Isis::Buffer *> &ib, vector<Isis::Buffer *> &ob);
+bool bandsReversed(QString from, QString to);
 
 class InPlaceFunctor{
 public:
@@ -44,6 +46,37 @@ public:
 
 };
 
+class PrintSpectraFunctor{
+public:
+    void operator() (Isis::ProcessBySpectra::SpectraBlock &spectra) const{
+        int last = spectra.spectrumCount() - 1;
+        if((spectra.sample(0) == 1) && (spectra.line(0) == 1)) {
+          cout << "Testing spectra in place ... " << endl;
+          cout << "Spectra:         " << spectra.spectrumCount() << endl;
+          cout << "Bands:           " << spectra.bandCount() << endl;
+          cout << "Last Spectrum:   Sample:  " << spectra.sample(last)
+               << "  Line:  " << spectra.line(last) << endl;
+          cout << endl;
+        }
+        cout << "Sample:  " << spectra.sample(0)
+             << "  Line:  " << spectra.line(0) << endl;
+    }
+};
+
+class ReverseSpectraFunctor{
+public:
+    void operator() (Isis::ProcessBySpectra::SpectraBlock &in,
+                     Isis::ProcessBySpectra::SpectraBlock &out) const{
+        for(int i = 0; i < in.spectrumCount(); i++) {
+          const double *inSpectrum = in.spectrum(i);
+          double *outSpectrum = out.spectrum(i);
+          for(int b = 0; b < in.bandCount(); b++) {
+            outSpectrum[b] = inSpectrum[in.bandCount() - 1 - b];
+          }
+        }
+    }
+};
+
 void IsisMain() {
 
   InPlaceFunctor inPlace;
@@ -163,6 +196,44 @@ void IsisMain() {
   p.EndProcess();
 
 
+  //Spectra blocks
+
+  cout << endl;
+  PrintSpectraFunctor printSpectra;
+  ReverseSpectraFunctor reverseSpectra;
+
+  p.SetInputCube("FROM");
+  p.SetTileSize(50, 40);
+  p.ProcessSpectraInPlace(printSpectra, false);
+  p.EndProcess();
+
+  cout << endl << "Testing spectra input and output ... " << endl;
+  p.SetInputCube("FROM");
+  p.SetOutputCube("TO");
+  p.ProcessSpectra(reverseSpectra, false);
+  p.EndProcess();
+  cout << "Bands reversed:  "
+       << bandsReversed("$base/testData/isisTruth.cub",
+                        "$temporary/isisProcessBySpectra_01.cub") << endl;
+
+  cout << endl << "Testing threaded spectra with automatic tiles ... " << endl;
+  p.SetTileSize(0, 0);
+  p.SetInputCube("FROM");
+  p.SetOutputCube("TO");
+  p.ProcessSpectra(reverseSpectra, true);
+  p.EndProcess();
+  cout << "Bands reversed:  "
+       << bandsReversed("$base/testData/isisTruth.cub",
+                        "$temporary/isisProcessBySpectra_01.cub") << endl;
+
+  try {
+    p.SetTileSize(0, 5);
+  }
+  catch(Isis::IException &ex) {
+    cout << ex.toString().toStdString() << endl;
+  }
+
+
 
   Isis::Cube cube;
   cube.open("$temporary/isisProcessBySpectra_01");
@@ -241,3 +312,27 @@ void twoInAndOut(vector<Isis::Buffer *> &ib, vector<Isis::Buffer *> &ob) {
     cout << "Bogus error #3" << endl;
   }
 }
+
+bool bandsReversed(QString from, QString to) {
+  Isis::Cube fromCube;
+  fromCube.open(from);
+  Isis::Cube toCube;
+  toCube.open(to);
+
+  Isis::LineManager fromLine(fromCube);
+  Isis::LineManager toLine(toCube);
+  int nb = fromCube.bandCount();
+  bool reversed = true;
+  for(int b = 1; b <= nb; b++) {
+    for(int l = 1; l <= fromCube.lineCount(); l++) {
+      fromLine.SetLine(l, nb + 1 - b);
+      fromCube.read(fromLine);
+      toLine.SetLine(l, b);
+      toCube.read(toLine);
+      for(int i = 0; i < fromLine.size(); i++) {
+        if(fromLine[i] != toLine[i]) reversed = false;
+      }
+    }
+  }
+  return reversed;
+}
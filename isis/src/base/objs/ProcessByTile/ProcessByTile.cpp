@@ -131,39 +131,62 @@ namespace Isis {
 
   void ProcessByTile::SetBricks(IOCubes cn){
 
+      int tileSamples = p_tileSamples;
+      int tileLines = p_tileLines;
+      bool tileSizeSet = p_tileSizeSet;
+
+      // Tiles aligned to the cube chunks are used for this run only; the tile
+      //   size set with SetTileSize() is kept for later runs
+      if (OptimalBrickSize()) {
+        vector<Cube *> cubes;
+        if (cn == InPlace) {
+          cubes.push_back((InputCubes.size() == 1) ? InputCubes[0] : OutputCubes[0]);
+        }
+        else {
+          cubes = InputCubes;
+          for (unsigned int i = 0; i < OutputCubes.size(); i++) {
+            cubes.push_back(OutputCubes[i]);
+          }
+        }
+
+        int bands;
+        ChunkAlignedBrickSize(cubes, tileSamples, tileLines, bands, true);
+        tileSizeSet = true;
+      }
+
       switch(cn) {
 
         case InPlace:
 
           //  Make sure the tile size has been set
-          if(!p_tileSizeSet) {
+          if(!tileSizeSet) {
             string m = "Use the SetTileSize method to set the tile size";
             throw IException(IException::Programmer, m, _FILEINFO_);
           }
 
-          ProcessByBrick::SetBrickSize(p_tileSamples, p_tileLines, 1);
+          ProcessByBrick::SetBrickSize(tileSamples, tileLines, 1);
 
           break;
 
 
         case InputOutput:
-          if(!p_tileSizeSet) {
+          if(!tileSizeSet) {
             string m = "Use the SetTileSize method to set the tile size";
             throw IException(IException::Programmer, m, _FILEINFO_);
           }
 
-          ProcessByBrick::SetBrickSize(p_tileSamples, p_tileLines, 1);
+          ProcessByBrick::SetBrickSize(tileSamples, tileLines, 1);
 
           break;
 
         case InputOutputList:
 
-          if(!p_tileSizeSet) {
+          if(!tileSizeSet) {
             string m = "Use the SetTileSize method to set the tile size";
             throw IException(IException::Programmer, m, _FILEINFO_);
           }
 
-           ProcessByBrick::SetBrickSize(p_tileSamples, p_tileLines, 1);
+           ProcessByBrick::SetBrickSize(tileSamples, tileLines, 1);
 
           break;
 
@@ -48,6 +48,11 @@ namespace Isis {
    *                           ProcessByBrick class
    *   @history 2011-08-19 Jeannie Backer - Modified unitTest to use
    *                           $temporary variable instead of /tmp directory.
+   *   @history 2018-09-07 Isis Development Team - When SetOptimalBrickSize() is on,
+   *                           the tile size is chosen to align with the cube chunks
+   *                           instead of being set with SetTileSize(). The aligned size
+   *                           is used for that run only and does not replace the tile
+   *                           size set with SetTileSize().
    *  
    *  
    *  @todo 2005-02-08 Jeff Anderson - add coded example, and implementation
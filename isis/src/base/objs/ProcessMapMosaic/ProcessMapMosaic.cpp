@@ -582,7 +582,10 @@ namespace Isis {
       Cube *ocube = p.SetOutputCube(mosaicFile, oAtt, samps, lines, nbands);
       p.Progress()->SetText("Initializing mosaic");
       p.ClearInputCubes();
-      p.StartProcess(ProcessMapMosaic::FillNull);
+      // Sparse mosaics read as NULL without storing anything
+      if (!ocube->isSparse()) {
+        p.StartProcess(ProcessMapMosaic::FillNull);
+      }
 
       // CreateForCube created some keywords in the mapping group that needs to be added
       ocube->putGroup(newMap.findGroup("Mapping", Pvl::Traverse));
@@ -664,7 +667,10 @@ namespace Isis {
       Cube *ocube = p.SetOutputCube(mosaicFile, oAtt, samps, lines, nbands);
       p.Progress()->SetText("Initializing mosaic");
       p.ClearInputCubes();
-      p.StartProcess(ProcessMapMosaic::FillNull);
+      // Sparse mosaics read as NULL without storing anything
+      if (!ocube->isSparse()) {
+        p.StartProcess(ProcessMapMosaic::FillNull);
+      }
 
       // CreateForCube created some keywords in the mapping group that needs to be added
       ocube->putGroup(newMap.findGroup("Mapping", Pvl::Traverse));
@@ -726,7 +732,10 @@ namespace Isis {
       p.Progress()->SetText("Initializing mosaic");
       p.ClearInputCubes();
 
-      p.StartProcess(ProcessMapMosaic::FillNull);
+      // Sparse mosaics read as NULL without storing anything
+      if (!ocube->isSparse()) {
+        p.StartProcess(ProcessMapMosaic::FillNull);
+      }
 
       // CreateForCube created some keywords in the mapping group that needs to be added
       ocube->putGroup(newMap.findGroup("Mapping", Pvl::Traverse));
@@ -788,7 +797,10 @@ namespace Isis {
       p.Progress()->SetText("Initializing mosaic");
       p.ClearInputCubes();
 
-      p.StartProcess(ProcessMapMosaic::FillNull);
+      // Sparse mosaics read as NULL without storing anything
+      if (!ocube->isSparse()) {
+        p.StartProcess(ProcessMapMosaic::FillNull);
+      }
 
       // CreateForCube created some keywords in the mapping group that needs to be added
       ocube->putGroup(newMap.findGroup("Mapping", Pvl::Traverse));
@@ -101,6 +101,8 @@ namespace Isis {
    * @history 2016-08-28 Kelvin Rodriguez - Changed SetOutputCube default parameters to
    *                         avoid hidden virtual function warnings in clang and the abiguous called
    *                         errors. Part of porting to OS X 10.11.
+   * @history 2018-09-07 Isis Development Team - New sparse mosaics are no longer filled
+   *                         with NULLs, since they already read as NULL.
    */
 
   class ProcessMapMosaic : public Isis::ProcessMosaic {
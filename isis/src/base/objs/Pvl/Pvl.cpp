@@ -25,6 +25,7 @@
 
 #include <locale>
 #include <fstream>
+#include <vector>
 
 #include "FileName.h"
 #include "IException.h"
@@ -67,7 +68,9 @@ namespace Isis {
 
 
   /**
-   * Loads PVL information from a stream
+   * Loads PVL information from a file. Reading stops at the End keyword, or at
+   * the first binary character, so for a cube with an attached label only the
+   * label and at most one 64k read block after it are read.
    *
    * @param file A file containing PVL information
    *
@@ -78,8 +81,10 @@ namespace Isis {
     Isis::FileName temp(file);
     m_filename = temp.expanded();
 
-    // Open the file
+    // Open the file, reading it in large blocks
+    vector<char> streamBuffer(65536);
     ifstream istm;
+    istm.rdbuf()->pubsetbuf(&streamBuffer[0], streamBuffer.size());
     istm.open(m_filename.toLatin1().data(), std::ios::in);
     if(!istm) {
       QString message = Message::FileOpen(temp.expanded());
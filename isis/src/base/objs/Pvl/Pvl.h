@@ -131,6 +131,9 @@ namespace Isis {
    *  @history 2010-09-27 Sharmila Prasad - Validate a Pvl with the Template Pvl
    *  @history 2013-03-11 Steven Lambright and Mathew Eis - Brought method names and member variable
    *                          names up to the current Isis 3 coding standards. Fixes #1533.
+   *  @history 2018-09-07 Isis Development Team - read() gives the file stream a 64k buffer.
+   *                          Labels are read through it by PvlKeyword::readLine() a block at
+   *                          a time.
    */
   class Pvl : public Isis::PvlObject {
     public:
@@ -2,6 +2,7 @@
 #include "IException.h"
 #include "Preference.h"
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -141,4 +142,27 @@ int main() {
   Pvl pvlResults;
   pvlTmpl.validatePvl(pvlUser, pvlResults);
   cout << "\n\n**Result PVL**\n" << pvlResults << endl;
+
+  cout << "\nTesting labels read from a stream with data after them..." << endl;
+  {
+    ifstream messenger("unitTest4.pvl");
+    Pvl p8;
+    messenger >> p8;
+    cout << p8["PRODUCT_ID"] << endl;
+    cout << "Stream position after the label = " << messenger.tellg() << endl;
+
+    char data[5] = {0};
+    messenger.read(data, 4);
+    cout << "Data after the label = " << data << endl;
+  }
+
+  {
+    stringstream labelAndData;
+    labelAndData << "Object = Test\n  Value = 1\nEnd_Object\nEnd\n" << '\0' << "DATA";
+    Pvl p9;
+    labelAndData >> p9;
+    cout << p9.findObject("Test")["Value"] << endl;
+    cout << "Stream position after the label = " << labelAndData.tellg() << endl;
+    cout << "Next byte = " << labelAndData.get() << endl;
+  }
 }
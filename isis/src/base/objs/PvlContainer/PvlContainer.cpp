@@ -63,6 +63,46 @@ namespace Isis {
 
 
 
+  //! Constructs an invalid index.
+  PvlContainer::NameIndex::NameIndex() {
+    m_valid = false;
+    m_hasUnnamed = false;
+    m_nameChanges = 0;
+  }
+
+
+  /**
+   * Constructs an invalid index. The index of another list is of no use.
+   *
+   * @param other The index being copied
+   */
+  PvlContainer::NameIndex::NameIndex(const NameIndex &other) {
+    m_valid = false;
+    m_hasUnnamed = false;
+    m_nameChanges = 0;
+  }
+
+
+  /**
+   * Invalidates this index. The index of another list is of no use.
+   *
+   * @param other The index being assigned
+   * @return NameIndex& This index
+   */
+  PvlContainer::NameIndex &PvlContainer::NameIndex::operator=(const NameIndex &other) {
+    invalidate();
+    return *this;
+  }
+
+
+  //! Marks the index out of date, so it is rebuilt by the next lookup.
+  void PvlContainer::NameIndex::invalidate() {
+    QMutexLocker locker(&m_mutex);
+    m_valid = false;
+    m_index.clear();
+  }
+
+
   //! Sets the filename to blank.
   void PvlContainer::init() {
     m_filename = "";
@@ -76,15 +116,15 @@ namespace Isis {
    * @throws iException::Pvl The keyword doesn't exist.
    */
   Isis::PvlKeyword &PvlContainer::findKeyword(const QString &name) {
-    PvlKeywordIterator key = findKeyword(name, begin(), end());
-    if(key == end()) {
+    int index = m_keywordIndex.indexOf(name, m_keywords);
+    if(index == -1) {
       QString msg = "PVL Keyword [" + name + "] does not exist in [" +
                    type() + " = " + this->name() + "]";
       if(m_filename.size() > 0) msg += " in file [" + m_filename + "]";
       throw IException(IException::Unknown, msg, _FILEINFO_);
     }
 
-    return *key;
+    return m_keywords[index];
   }
 
   /**
@@ -94,15 +134,15 @@ namespace Isis {
    * @throws IException The keyword doesn't exist.
    */
   const Isis::PvlKeyword &PvlContainer::findKeyword(const QString &name) const {
-    ConstPvlKeywordIterator key = findKeyword(name, begin(), end());
-    if(key == end()) {
+    int index = m_keywordIndex.indexOf(name, m_keywords);
+    if(index == -1) {
       QString msg = "PVL Keyword [" + name + "] does not exist in [" +
                    type() + " = " + this->name() + "]";
       if(m_filename.size() > 0) msg += " in file [" + m_filename + "]";
       throw IException(IException::Unknown, msg, _FILEINFO_);
     }
 
-    return *key;
+    return m_keywords[index];
   }
 
   /**
@@ -111,15 +151,16 @@ namespace Isis {
    * @throws iException::Pvl Keyword doesn't exist.
    */
   void PvlContainer::deleteKeyword(const QString &name) {
-    PvlKeywordIterator key = findKeyword(name, begin(), end());
-    if(key == end()) {
+    int index = m_keywordIndex.indexOf(name, m_keywords);
+    if(index == -1) {
       QString msg = "PVL Keyword [" + name + "] does not exist in [" +
                    type() + " = " + this->name() + "]";
       if(m_filename.size() > 0) msg += " in file [" + m_filename + "]";
       throw IException(IException::Unknown, msg, _FILEINFO_);
     }
 
-    m_keywords.erase(key);
+    m_keywords.removeAt(index);
+    m_keywordIndex.invalidate();
   }
 
 
@@ -140,6 +181,7 @@ namespace Isis {
     for(int i = 0; i < index; i++) key++;
 
     m_keywords.erase(key);
+    m_keywordIndex.invalidate();
   }
 
 
@@ -163,6 +205,8 @@ namespace Isis {
       }
     }
 
+    if(keywordDeleted) m_keywordIndex.invalidate();
+
     return keywordDeleted;
   }
 
@@ -173,9 +217,7 @@ namespace Isis {
    * @return True if the keyword exists, false if it doesn't.
    */
   bool PvlContainer::hasKeyword(const QString &name) const {
-    ConstPvlKeywordIterator key = findKeyword(name, begin(), end());
-    if(key == end()) return false;
-    return true;
+    return m_keywordIndex.indexOf(name, m_keywords) != -1;
   }
 
 
@@ -217,15 +259,14 @@ namespace Isis {
    */
   void PvlContainer::addKeyword(const Isis::PvlKeyword &key,
                                 const InsertMode mode) {
-    if(mode == Append) {
-      m_keywords.push_back(key);
-    }
-    else if(hasKeyword(key.name())) {
-      Isis::PvlKeyword &outkey = findKeyword(key.name());
-      outkey = key;
+    int index = (mode == Append) ? -1 : m_keywordIndex.indexOf(key.name(), m_keywords);
+
+    if(index != -1) {
+      m_keywords[index] = key;
     }
     else {
       m_keywords.push_back(key);
+      m_keywordIndex.appended(m_keywords);
     }
   }
 
@@ -248,6 +289,7 @@ namespace Isis {
    */
   PvlContainer::PvlKeywordIterator PvlContainer::addKeyword(const Isis::PvlKeyword &key,
       PvlKeywordIterator pos) {
+    m_keywordIndex.invalidate();
     return (m_keywords.insert(pos, key));
   }
 
@@ -367,8 +409,13 @@ namespace Isis {
   PvlContainer::PvlKeywordIterator PvlContainer::findKeyword(const QString &name,
       PvlContainer::PvlKeywordIterator beg,
       PvlContainer::PvlKeywordIterator end) {
-    PvlKeyword temp(name);
-    return find(beg, end, temp);
+    if(beg == begin() && end == this->end()) {
+      int index = m_keywordIndex.indexOf(name, m_keywords);
+      return (index == -1) ? end : beg + index;
+    }
+
+    while(beg != end && !beg->isNamed(name)) beg++;
+    return beg;
   };
 
 
@@ -382,16 +429,27 @@ namespace Isis {
   PvlContainer::ConstPvlKeywordIterator PvlContainer::findKeyword(const QString &name,
       PvlContainer::ConstPvlKeywordIterator beg,
       PvlContainer::ConstPvlKeywordIterator end) const {
-    PvlKeyword temp(name);
-    return find(beg, end, temp);
+    if(beg == begin() && end == this->end()) {
+      int index = m_keywordIndex.indexOf(name, m_keywords);
+      return (index == -1) ? end : beg + index;
+    }
+
+    while(beg != end && !beg->isNamed(name)) beg++;
+    return beg;
   };
 
 
   //! This is an assignment operator
   const PvlContainer &PvlContainer::operator=(const PvlContainer &other) {
     m_filename = other.m_filename;
+    // Renaming a container in a list may make the index of that list stale
+    if(m_name.size() > 0 && other.m_name.size() > 0 && !m_name[0].isEmpty() &&
+       !other.m_name[0].isEmpty() && m_name[0] != other.m_name[0]) {
+      PvlKeyword::nameChanged();
+    }
     m_name = other.m_name;
     m_keywords = other.m_keywords;
+    m_keywordIndex.invalidate();
     m_formatTemplate = other.m_formatTemplate;
 
     return *this;
@@ -20,9 +20,12 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
-#include "PvlKeyword.h"
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
 
-template<typename T> class QList;
+#include "PvlKeyword.h"
 
 namespace Isis {
   /**
@@ -59,6 +62,10 @@ namespace Isis {
    *  @history 2013-03-11 Steven Lambright and Mathew Eis - Brought method names and member variable
    *                          names up to the current Isis 3 coding standards. Fixes #1533.
    *  @history 2015-05-15 J Bonn - fixed usage of iterator that had been deleted.
+   *  @history 2018-09-07 Isis Development Team - Keyword lookups by name in containers
+   *                          with many keywords use a lazily built NameIndex of folded
+   *                          keyword names instead of comparing against every keyword.
+   *                          Mutations invalidate the index.
    */
   class PvlContainer {
     public:
@@ -68,6 +75,10 @@ namespace Isis {
 
       //! Set the name of the container.
       void setName(const QString &name) {
+        if (m_name.size() > 0 && !m_name[0].isEmpty() && !name.isEmpty() &&
+            m_name[0] != name) {
+          PvlKeyword::nameChanged();
+        }
         m_name.setValue(name);
       };
       /**
@@ -104,6 +115,7 @@ namespace Isis {
       //! Clears PvlKeywords
       void clear() {
         m_keywords.clear();
+        m_keywordIndex.invalidate();
       };
       //! Contains both modes: Append or Replace.
       enum InsertMode { Append, Replace };
@@ -294,6 +306,153 @@ namespace Isis {
       const PvlContainer &operator=(const PvlContainer &other);
 
     protected:
+      /**
+       * A lazily built hash from folded names to the index of the first
+       * element of a list with that name. Lists shorter than
+       * MinimumIndexedSize are searched linearly instead. The owner
+       * invalidates the index whenever it changes the list, and the index
+       * rebuilds itself when PvlKeyword::nameChanges() shows that an element
+       * may have been renamed through a reference. An unnamed element could be
+       * named without counting as a change, so lists with unnamed elements are
+       * also searched linearly. Lookups lock the index, so const lookups from
+       * several threads are safe.
+       *
+       * Copies of an index start out invalid.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       *   @history 2018-09-07 Isis Development Team - Original version.
+       */
+      class NameIndex {
+        public:
+          NameIndex();
+          NameIndex(const NameIndex &other);
+          NameIndex &operator=(const NameIndex &other);
+
+          void invalidate();
+
+          /**
+           * Returns the index of the first element of a list with a name.
+           *
+           * @param name The name to find
+           * @param list The list the index is for
+           *
+           * @return int The index of the element, or -1 if there is none
+           */
+          template <typename T>
+          int indexOf(const QString &name, const QList<T> &list) const {
+            if (list.size() < MinimumIndexedSize) return linearIndexOf(name, list);
+
+            QString folded = PvlKeyword::foldedString(name);
+            QMutexLocker locker(&m_mutex);
+
+            if (!m_valid || m_nameChanges != PvlKeyword::nameChanges()) build(list);
+
+            // A hit on an element that no longer has the name means it was
+            // renamed without counting as a change
+            int index = m_index.value(folded, -1);
+            if (index != -1 && !PvlKeyword::stringEqual(name, indexedName(list[index]))) {
+              build(list);
+              index = m_index.value(folded, -1);
+            }
+
+            if (m_hasUnnamed) {
+              locker.unlock();
+              return linearIndexOf(name, list);
+            }
+
+            return index;
+          }
+
+          /**
+           * Adds the last element of a list to a valid index after it was
+           * appended, so building a list does not rebuild its index.
+           *
+           * @param list The list the index is for
+           */
+          template <typename T>
+          void appended(const QList<T> &list) {
+            QMutexLocker locker(&m_mutex);
+            if (!m_valid) return;
+
+            QString folded = PvlKeyword::foldedString(indexedName(list.last()));
+            if (folded.isEmpty()) m_hasUnnamed = true;
+            if (!m_index.contains(folded)) m_index.insert(folded, list.size() - 1);
+          }
+
+        private:
+          //! Lists shorter than this are searched without an index
+          static const int MinimumIndexedSize = 16;
+
+          /**
+           * Indexes every element of a list, keeping the first of each name.
+           * The mutex must be locked.
+           *
+           * @param list The list to index
+           */
+          template <typename T>
+          void build(const QList<T> &list) const {
+            m_nameChanges = PvlKeyword::nameChanges();
+            m_index.clear();
+            m_index.reserve(list.size());
+            m_hasUnnamed = false;
+
+            for (int i = 0; i < list.size(); i++) {
+              QString folded = PvlKeyword::foldedString(indexedName(list[i]));
+              if (folded.isEmpty()) m_hasUnnamed = true;
+              if (!m_index.contains(folded)) m_index.insert(folded, i);
+            }
+
+            m_valid = true;
+          }
+
+          /**
+           * Returns the index of the first element of a list with a name,
+           * comparing the name to every element.
+           *
+           * @param name The name to find
+           * @param list The list to search
+           *
+           * @return int The index of the element, or -1 if there is none
+           */
+          template <typename T>
+          static int linearIndexOf(const QString &name, const QList<T> &list) {
+            for (int i = 0; i < list.size(); i++) {
+              if (PvlKeyword::stringEqual(name, indexedName(list[i]))) return i;
+            }
+            return -1;
+          }
+
+          /**
+           * Returns the name of a keyword.
+           *
+           * @param keyword The keyword
+           * @return QString The name of the keyword
+           */
+          static QString indexedName(const PvlKeyword &keyword) {
+            return keyword.name();
+          }
+
+          /**
+           * Returns the name of a group or object, or an empty QString if it
+           * has none.
+           *
+           * @param container The group or object
+           * @return QString The name of the container
+           */
+          static QString indexedName(const PvlContainer &container) {
+            const PvlKeyword &name = container.nameKeyword();
+            return name.size() > 0 ? name[0] : QString();
+          }
+
+          mutable QHash<QString, int> m_index; //!< Folded names to indexes
+          mutable bool m_valid;                //!< True if m_index is current
+          mutable bool m_hasUnnamed;           //!< True if an element has no name
+          mutable int m_nameChanges;           //!< nameChanges() when built
+          mutable QMutex m_mutex;              //!< Serializes lookups
+      };
+
       QString m_filename;                   /**<This contains the filename
                                                     used to initialize
                                                     the pvl object. If the
@@ -304,6 +463,7 @@ namespace Isis {
       QList<PvlKeyword> m_keywords; /**<This is the vector of
                                                     PvlKeywords the container is
                                                     holding. */
+      NameIndex m_keywordIndex;     //!< The index of m_keywords by name
 
       void init();
 
@@ -54,4 +54,24 @@ int main() {
   else
     cout << "FAILURE: Pointer to DOG changed after multiple adds" << endl; 
 
+  cout << endl << "Test name index ..." << endl;
+  PvlContainer big("Big");
+  for (int i = 0; i < 40; i++)
+    big += PvlKeyword("Key_" + toString(i), toString(i));
+  big += PvlKeyword("KEY5", "duplicate");
+
+  cout << "key 5 = " << big["key5"][0] << endl;
+  cout << "Has KEY 39? " << big.hasKeyword("KEY 39") << endl;
+  cout << "Has Key_40? " << big.hasKeyword("Key_40") << endl;
+
+  big["Key_7"].setName("Key_40");
+  cout << "After rename, has Key_40? " << big.hasKeyword("Key_40") << endl;
+  cout << "After rename, has Key_7? " << big.hasKeyword("Key_7") << endl;
+
+  big -= "Key_5";
+  cout << "After delete, key 5 = " << big["key5"][0] << endl;
+
+  big.addKeyword(PvlKeyword("Key_40", "replaced"), PvlContainer::Replace);
+  cout << "After replace, Key_40 = " << big["Key_40"][0] << endl;
+  cout << "Keywords = " << big.keywords() << endl;
 }
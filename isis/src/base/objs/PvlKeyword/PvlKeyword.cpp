@@ -22,6 +22,8 @@
 
 #include "IsisDebug.h"
 
+#include <QAtomicInt>
+#include <QByteArray>
 #include <QDebug>
 #include <QString>
 
@@ -34,6 +36,34 @@
 
 using namespace std;
 namespace Isis {
+  /**
+   * Returns true if stringEqual() skips the character. These are the
+   * characters IString::ConvertWhiteSpace() and Remove(" _") drop.
+   *
+   * @param c The character to test
+   * @return <B>bool</B> True if the character is ignored
+   */
+  static inline bool isIgnoredInComparison(QChar c) {
+    ushort u = c.unicode();
+    return u == ' ' || u == '_' || u == '\n' || u == '\r' || u == '\t' ||
+           u == '\f' || u == '\v' || u == '\b';
+  }
+
+
+  /**
+   * Returns a character as stringEqual() compares it. Only ASCII letters are
+   * made upper case, the same as toupper() in the C locale.
+   *
+   * @param c The character to fold
+   * @return <B>QChar</B> The folded character
+   */
+  static inline QChar foldedCharacter(QChar c) {
+    ushort u = c.unicode();
+    if (u >= 'a' && u <= 'z') return QChar(u - 'a' + 'A');
+    return c;
+  }
+
+
   //! Constructs a blank PvlKeyword object.
   PvlKeyword::PvlKeyword() {
     init();
@@ -87,17 +117,11 @@ namespace Isis {
       delete m_comments;
       m_comments = NULL;
     }
-
-    if (m_name) {
-      delete [] m_name;
-      m_name = NULL;
-    }
   }
 
 
   //! Clears all PvlKeyword data.
   void PvlKeyword::init() {
-    m_name = NULL;
     m_units = NULL;
     m_comments = NULL;
     m_width = 0;
@@ -141,16 +165,9 @@ namespace Isis {
       throw IException(IException::User, msg, _FILEINFO_);
     }
 
-    if (m_name) {
-      delete [] m_name;
-      m_name = NULL;
-    }
+    if (!m_name.isEmpty() && !final.isEmpty() && final != m_name) nameChanged();
 
-    if (final != "") {
-      QByteArray finalAscii = final.toLatin1();
-      m_name = new char[finalAscii.size() + 1];
-      strncpy(m_name, finalAscii.data(), final.size() + 1);
-    }
+    m_name = final;
   }
 
   /**
@@ -550,20 +567,67 @@ namespace Isis {
    */
   bool PvlKeyword::stringEqual(const QString &QString1,
                                const QString &QString2) {
-    Isis::IString s1(QString1);
-    Isis::IString s2(QString2);
+    const QChar *c1 = QString1.constData();
+    const QChar *end1 = c1 + QString1.size();
+    const QChar *c2 = QString2.constData();
+    const QChar *end2 = c2 + QString2.size();
 
-    s1.ConvertWhiteSpace();
-    s2.ConvertWhiteSpace();
+    while (true) {
+      while (c1 != end1 && isIgnoredInComparison(*c1)) c1++;
+      while (c2 != end2 && isIgnoredInComparison(*c2)) c2++;
 
-    s1.Remove(" _");
-    s2.Remove(" _");
+      if (c1 == end1 || c2 == end2) return (c1 == end1 && c2 == end2);
+      if (foldedCharacter(*c1) != foldedCharacter(*c2)) return false;
 
-    s1.UpCase();
-    s2.UpCase();
+      c1++;
+      c2++;
+    }
+  }
 
-    if (s1 == s2) return true;
-    return false;
+
+  /**
+   * Returns a QString in the form that stringEqual() compares: whitespace and
+   * underscores are removed and lower case ASCII letters are made upper case.
+   * Two QStrings are equal by stringEqual() exactly when their folded QStrings
+   * are the same, so the folded QString can be used as a hash key.
+   *
+   * @param string The QString to fold
+   * @return <B>QString</B> The folded QString
+   */
+  QString PvlKeyword::foldedString(const QString &string) {
+    QString folded;
+    folded.reserve(string.size());
+
+    const QChar *c = string.constData();
+    const QChar *end = c + string.size();
+    for (; c != end; c++) {
+      if (!isIgnoredInComparison(*c)) folded += foldedCharacter(*c);
+    }
+
+    return folded;
+  }
+
+
+  //! The number of times a keyword was given a different name
+  static QAtomicInt s_nameChanges;
+
+
+  /**
+   * Returns the number of times any keyword or container name was changed
+   * from one non-empty name to another. Name indexes compare this to the
+   * count they were built with to know when a name may have changed under
+   * them through a reference.
+   *
+   * @return <B>int</B> The number of name changes so far
+   */
+  int PvlKeyword::nameChanges() {
+    return s_nameChanges.load();
+  }
+
+
+  //! Counts a change from one non-empty name to another
+  void PvlKeyword::nameChanged() {
+    s_nameChanges.ref();
   }
 
   /**
@@ -1717,27 +1781,28 @@ namespace Isis {
    * @return QString The first encountered line of data
    */
   QString PvlKeyword::readLine(std::istream &is, bool insideComment) {
-    QString lineOfData;
+    // Characters are taken straight from the stream's buffer, which is
+    //   filled a block at a time, rather than through get() and peek()
+    std::streambuf *buffer = is.rdbuf();
+    QByteArray lineOfData;
 
     while(is.good() && lineOfData.isEmpty()) {
 
       // read until \n (works for both \r\n and \n) or */
-      while(is.good() &&
-            (!lineOfData.size() || lineOfData[lineOfData.size() - 1] != '\n')) {
-        char next = is.get();
-
-        // if non-ascii found then we're done... immediately
-        if (next <= 0) {
-          is.seekg(0, ios::end);
-          is.get();
-          return lineOfData;
+      while(!lineOfData.size() || lineOfData[lineOfData.size() - 1] != '\n') {
+        int next = buffer->sbumpc();
+
+        // if non-ascii found (or there is no more data) then we're done...
+        //   immediately
+        if (next == EOF || (char) next <= 0) {
+          if (next != EOF) {
+            buffer->pubseekoff(0, ios::end, ios::in);
+          }
+          is.setstate(ios::eofbit | ios::failbit);
+          return QString::fromLatin1(lineOfData);
         }
 
-        // if any errors (i.e. eof) happen in the get operation then don't
-        //   store this data
-        if (is.good()) {
-          lineOfData += next;
-        }
+        lineOfData += (char) next;
 
         if (insideComment &&
             lineOfData.size() >= 2 && lineOfData[lineOfData.size() - 2] == '*' &&
@@ -1756,17 +1821,19 @@ namespace Isis {
       lineOfData = lineOfData.trimmed();
 
       // read up to next non-whitespace in input stream
-      while(is.good() &&
-            (is.peek() == ' ' ||
-             is.peek() == '\r' ||
-             is.peek() == '\n')) {
-        is.get();
+      int next = buffer->sgetc();
+      while(next == ' ' || next == '\r' || next == '\n') {
+        next = buffer->snextc();
+      }
+
+      if (next == EOF) {
+        is.setstate(ios::eofbit);
       }
 
       // if lineOfData is empty (line was empty), we repeat
     }
 
-    return lineOfData;
+    return QString::fromLatin1(lineOfData);
   }
 
 
@@ -1838,14 +1905,12 @@ namespace Isis {
     if (this != &other) {
       m_formatter = other.m_formatter;
 
-      if (m_name) {
-        delete [] m_name;
-        m_name = NULL;
+      // The other name is already valid, so it is shared instead of set again
+      if (!m_name.isEmpty() && !other.m_name.isEmpty() && other.m_name != m_name) {
+        nameChanged();
       }
 
-      if (other.m_name) {
-        setName(other.m_name);
-      }
+      m_name = other.m_name;
 
       m_values = other.m_values;
 
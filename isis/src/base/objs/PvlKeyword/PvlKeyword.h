@@ -94,6 +94,15 @@ namespace Isis {
    *                          the QString "Yes" instead of the keyword name. Added padding on
    *                          control statements to bring the code closer to ISIS Coding Standards.
    *                          References #1659.
+   *  @history 2018-09-07 Isis Development Team - m_name is now an implicitly shared QString,
+   *                          so copying a keyword into a container no longer allocates and
+   *                          validates its name again. stringEqual compares the strings in
+   *                          place instead of building upper case copies. Added foldedString()
+   *                          and nameChanges() for the name indexes of PvlContainer and
+   *                          PvlObject.
+   *  @history 2018-09-07 Isis Development Team - readLine() takes characters from the
+   *                          stream's buffer instead of calling get() and peek() for each
+   *                          character, and builds the line in a QByteArray.
    */
   class PvlKeyword {
     public:
@@ -112,10 +121,7 @@ namespace Isis {
        * @return The name of the keyword.
        */
       QString name() const {
-        if(m_name)
-          return m_name;
-        else
-          return "";
+        return m_name;
       };
       /**
        * Determines whether two PvlKeywords have the same name or not.
@@ -185,8 +191,8 @@ namespace Isis {
        * @param key The keyword to compare names with
        */
       bool operator==(const PvlKeyword &key) const {
-        if(!m_name && !key.m_name) return true;
-        if(!m_name || !key.m_name) return false;
+        if(m_name.isEmpty() && key.m_name.isEmpty()) return true;
+        if(m_name.isEmpty() || key.m_name.isEmpty()) return false;
 
         return (stringEqual(m_name, key.m_name));
       };
@@ -237,6 +243,9 @@ namespace Isis {
 
       static bool stringEqual(const QString &string1,
                               const QString &string2);
+      static QString foldedString(const QString &string);
+      static int nameChanges();
+      static void nameChanged();
 
 
       static QString readLine(std::istream &is, bool insideComment);
@@ -270,8 +279,11 @@ namespace Isis {
       PvlFormat *m_formatter;
 
     private:
-      //! The keyword's name... This is a c-string for memory efficiency
-      char * m_name;
+      /**
+       * The keyword's name. This is implicitly shared, so copies of a keyword
+       * do not allocate a new name.
+       */
+      QString m_name;
 
       /**
        * The values in the keyword. This is a QVarLengthArray purely for
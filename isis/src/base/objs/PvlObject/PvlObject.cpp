@@ -344,6 +344,7 @@ namespace Isis {
     }
 
     m_objects.erase(key);
+    m_objectIndex.invalidate();
   }
 
 
@@ -366,6 +367,7 @@ namespace Isis {
     for(int i = 0; i < index; i++)  key++;
 
     m_objects.erase(key);
+    m_objectIndex.invalidate();
   }
 
 
@@ -386,6 +388,7 @@ namespace Isis {
     }
 
     m_groups.erase(key);
+    m_groupIndex.invalidate();
   }
 
 
@@ -408,6 +411,7 @@ namespace Isis {
     for(int i = 0; i < index; i++)  key++;
 
     m_groups.erase(key);
+    m_groupIndex.invalidate();
   }
 
 
@@ -794,6 +798,8 @@ namespace Isis {
 
     m_objects = other.m_objects;
     m_groups = other.m_groups;
+    m_objectIndex.invalidate();
+    m_groupIndex.invalidate();
 
     return *this;
   }
@@ -70,6 +70,10 @@ namespace Isis {
    *  @history 2016-08-24 Kelvin Rodriguez - Unit test properly converts indices
    *                          to strings inside loops when appending to strings. Silences
    *                          -Wstring-plus-int warnings on Clang. Part of porting to OS X 10.11
+   *  @history 2018-09-07 Isis Development Team - Group and object lookups by name use
+   *                          lazily built name indexes instead of constructing a
+   *                          temporary PvlGroup or PvlObject and comparing it against
+   *                          every element.
    */
   class PvlObject : public Isis::PvlContainer {
     public:
@@ -141,8 +145,13 @@ namespace Isis {
       PvlGroupIterator findGroup(const QString &name,
                                  PvlGroupIterator beg,
                                  PvlGroupIterator end) {
-        Isis::PvlGroup temp(name);
-        return std::find(beg, end, temp);
+        if(beg == beginGroup() && end == endGroup()) {
+          int index = m_groupIndex.indexOf(name, m_groups);
+          return (index == -1) ? end : beg + index;
+        }
+
+        while(beg != end && !beg->isNamed(name)) beg++;
+        return beg;
       }
 
 
@@ -155,8 +164,13 @@ namespace Isis {
       ConstPvlGroupIterator findGroup(const QString &name,
                                       ConstPvlGroupIterator beg,
                                       ConstPvlGroupIterator end) const {
-        Isis::PvlGroup temp(name);
-        return std::find(beg, end, temp);
+        if(beg == beginGroup() && end == endGroup()) {
+          int index = m_groupIndex.indexOf(name, m_groups);
+          return (index == -1) ? end : beg + index;
+        }
+
+        while(beg != end && !beg->isNamed(name)) beg++;
+        return beg;
       }
 
 
@@ -197,6 +211,7 @@ namespace Isis {
        */
       void addGroup(const Isis::PvlGroup &group) {
         m_groups.push_back(group);
+        m_groupIndex.appended(m_groups);
         //m_groups[m_groups.size()-1].SetFileName(FileName());
       };
 
@@ -286,8 +301,13 @@ namespace Isis {
       PvlObjectIterator findObject(const QString &name,
                                    PvlObjectIterator beg,
                                    PvlObjectIterator end) {
-        PvlObject temp(name);
-        return std::find(beg, end, temp);
+        if(beg == beginObject() && end == endObject()) {
+          int index = m_objectIndex.indexOf(name, m_objects);
+          return (index == -1) ? end : beg + index;
+        }
+
+        while(beg != end && !beg->isNamed(name)) beg++;
+        return beg;
       }
 
 
@@ -301,8 +321,13 @@ namespace Isis {
       ConstPvlObjectIterator findObject(const QString &name,
                                         ConstPvlObjectIterator beg,
                                         ConstPvlObjectIterator end) const {
-        PvlObject temp(name);
-        return std::find(beg, end, temp);
+        if(beg == beginObject() && end == endObject()) {
+          int index = m_objectIndex.indexOf(name, m_objects);
+          return (index == -1) ? end : beg + index;
+        }
+
+        while(beg != end && !beg->isNamed(name)) beg++;
+        return beg;
       }
 
 
@@ -319,6 +344,7 @@ namespace Isis {
       void addObject(const PvlObject &object) {
         m_objects.push_back(object);
         m_objects[m_objects.size()-1].setFileName(fileName());
+        m_objectIndex.appended(m_objects);
       }
 
       void deleteObject(const QString &name);
@@ -354,6 +380,8 @@ namespace Isis {
         Isis::PvlContainer::clear();
         m_objects.clear();
         m_groups.clear();
+        m_objectIndex.invalidate();
+        m_groupIndex.invalidate();
       }
 
       const PvlObject &operator=(const PvlObject &other);
@@ -366,6 +394,8 @@ namespace Isis {
                                                 in the current PvlObject. */
       QList<PvlGroup> m_groups;/**<A vector of PvlGroups contained
                                                 in the current PvlObject. */
+      NameIndex m_objectIndex; //!< The index of m_objects by name
+      NameIndex m_groupIndex;  //!< The index of m_groups by name
   };
 }
 
@@ -33,6 +33,127 @@
 using namespace std;
 namespace Isis {
 
+  //! The number of characters read from a stream at a time
+  static const int CharacterBlockSize = 65536;
+
+  //! Classes of characters the tokenizer scans for
+  enum CharacterClass {
+    ValidCharacter = 1,      //!< Printable, whitespace or NULL
+    WhiteSpaceCharacter = 2, //!< Whitespace or NULL
+    TokenEndCharacter = 4,   //!< Whitespace, NULL or an equal sign
+    CommentEndCharacter = 8  //!< A carriage return, line feed or NULL
+  };
+
+
+  //! A table of the classes of every character
+  struct CharacterClassTable {
+    //! Classifies the characters with isprint and isspace
+    CharacterClassTable() {
+      for (int c = 0; c < 256; c++) {
+        classes[c] = 0;
+        if (isprint(c) || isspace(c) || c == '\0') classes[c] |= ValidCharacter;
+        if (isspace(c) || c == '\0') classes[c] |= WhiteSpaceCharacter | TokenEndCharacter;
+        if (c == '=') classes[c] |= TokenEndCharacter;
+        if (c == '\r' || c == '\n' || c == '\0') classes[c] |= CommentEndCharacter;
+      }
+    }
+
+    unsigned char classes[256]; //!< The CharacterClass bits of each character
+  };
+
+
+  /**
+   * Returns the CharacterClass bits of a character.
+   *
+   * @param c The character, which cannot be EOF
+   *
+   * @return int The CharacterClass bits of the character
+   */
+  static inline int characterClass(int c) {
+    static const CharacterClassTable table;
+    return table.classes[c];
+  }
+
+
+  /**
+   * Constructs a buffer that reads from a stream as characters are needed.
+   *
+   * @param stream The stream to read
+   */
+  PvlTokenizer::CharacterBuffer::CharacterBuffer(std::istream &stream) {
+    m_stream = &stream;
+    m_start = stream.tellg();
+    m_streamDone = false;
+    m_position = 0;
+  }
+
+
+  /**
+   * Constructs a buffer over characters that are already in memory.
+   *
+   * @param data The characters to scan
+   */
+  PvlTokenizer::CharacterBuffer::CharacterBuffer(const QByteArray &data) {
+    m_stream = NULL;
+    m_start = std::istream::pos_type(-1);
+    m_streamDone = true;
+    m_data = data;
+    m_position = 0;
+  }
+
+
+  /**
+   * Puts a stream that was read ahead of the last character used back
+   * after that character, so the caller can keep reading where the
+   * tokenizer stopped.
+   */
+  PvlTokenizer::CharacterBuffer::~CharacterBuffer() {
+    if (m_stream && m_position < m_data.size() && m_start != std::istream::pos_type(-1)) {
+      if (!m_stream->bad()) {
+        m_stream->clear();
+        m_stream->seekg(m_start + std::streamoff(m_position), ios::beg);
+      }
+    }
+  }
+
+
+  /**
+   * Returns a copy of a range of the characters.
+   *
+   * @param start The position of the first character
+   * @param end The position after the last character
+   *
+   * @return QString The characters in the range
+   */
+  QString PvlTokenizer::CharacterBuffer::text(int start, int end) const {
+    return QString::fromLatin1(m_data.constData() + start, end - start);
+  }
+
+
+  /**
+   * Reads the next block of the stream into the buffer.
+   *
+   * @return bool True if more characters were read
+   */
+  bool PvlTokenizer::CharacterBuffer::fill() {
+    if (m_streamDone) return false;
+
+    int oldSize = m_data.size();
+    m_data.resize(oldSize + CharacterBlockSize);
+    m_stream->read(m_data.data() + oldSize, CharacterBlockSize);
+    int count = (int) m_stream->gcount();
+    m_data.resize(oldSize + count);
+
+    if (count < CharacterBlockSize) {
+      m_streamDone = true;
+      // Leave the stream at its end the way peeking past the end would
+      if (!m_stream->bad()) m_stream->clear(ios::eofbit);
+    }
+
+    return count > 0;
+  }
+
+
   //! Constructs a Tokenizer with an empty token list
   PvlTokenizer::PvlTokenizer() {
     Clear();
@@ -53,6 +174,9 @@ namespace Isis {
    * reaching either 1) end-of-stream, or
    * 2) a programmer specified terminator QString
    *
+   * The stream is read in blocks. If it is read past the terminator, it is
+   * put back after the terminator before this returns.
+   *
    * @param stream The input stream to tokenize
    *
    * @param terminator If the tokenizer see's this QString as a token in the input
@@ -62,18 +186,19 @@ namespace Isis {
    */
   void PvlTokenizer::Load(std::istream &stream, const QString &terminator) {
     QString upTerminator(terminator.toUpper());
+    CharacterBuffer buffer(stream);
     QString s;
     int c;
     bool newlineFound = false;
 
     while(true) {
-      newlineFound = SkipWhiteSpace(stream);
-      c = stream.peek();
+      newlineFound = SkipWhiteSpace(buffer);
+      c = buffer.peek();
       ValidateCharacter(c);
       if(c == EOF) return;
 
       if(c == '#') {
-        s = ReadComment(stream);
+        s = ReadComment(buffer);
         Isis::PvlToken t("_COMMENT_");
         t.addValue(s);
 
@@ -91,12 +216,12 @@ namespace Isis {
       }
 
       if(c == '/') {
-        c = stream.get();
-        c = stream.peek();
-        stream.unget();
+        buffer.get();
+        c = buffer.peek();
+        buffer.unget();
         ValidateCharacter(c);
         if(c == '*') {
-          s = ReadComment(stream);
+          s = ReadComment(buffer);
           Isis::PvlToken t("_COMMENT_");
           t.addValue(s);
 
@@ -114,7 +239,7 @@ namespace Isis {
         }
       }
 
-      s = ReadToken(stream);
+      s = ReadToken(buffer);
       Isis::PvlToken t(s);
 
       if(t.keyUpper() == upTerminator) {
@@ -122,8 +247,8 @@ namespace Isis {
         return;
       }
 
-      SkipWhiteSpace(stream);
-      c = stream.peek();
+      SkipWhiteSpace(buffer);
+      c = buffer.peek();
       ValidateCharacter(c);
       if(c == EOF) {
         tokens.push_back(t);
@@ -136,10 +261,10 @@ namespace Isis {
         continue;
       }
 
-      stream.ignore();
-      SkipWhiteSpace(stream);
+      buffer.ignore();
+      SkipWhiteSpace(buffer);
 
-      c = stream.peek();
+      c = buffer.peek();
       ValidateCharacter(c);
       if(c == EOF) {
         tokens.push_back(t);
@@ -147,9 +272,9 @@ namespace Isis {
       }
 
       if(c == '(') {
-        stream.ignore();
+        buffer.ignore();
         try {
-          s = ReadToParen(stream);
+          s = ReadToParen(buffer);
           ParseCommaList(t, s);
         }
         catch(IException &e) {
@@ -161,9 +286,9 @@ namespace Isis {
       }
 
       if(c == '{') {
-        stream.ignore();
+        buffer.ignore();
         try {
-          s = ReadToBrace(stream);
+          s = ReadToBrace(buffer);
           ParseCommaList(t, s);
         }
         catch(IException &e) {
@@ -175,9 +300,9 @@ namespace Isis {
       }
 
       if(c == '"') {
-        stream.ignore();
+        buffer.ignore();
         try {
-          s = ReadToDoubleQuote(stream);
+          s = ReadToDoubleQuote(buffer);
         }
         catch(IException &e) {
           QString message = Isis::Message::KeywordValueBad(t.key());
@@ -189,9 +314,9 @@ namespace Isis {
       }
 
       if(c == '\'') {
-        stream.ignore();
+        buffer.ignore();
         try {
-          s = ReadToSingleQuote(stream);
+          s = ReadToSingleQuote(buffer);
         }
         catch(IException &e) {
           QString message = Isis::Message::KeywordValueBad(t.key());
@@ -203,7 +328,7 @@ namespace Isis {
       }
 
 
-      s = ReadToken(stream);
+      s = ReadToken(buffer);
       t.addValue(s);
       tokens.push_back(t);
       continue;
@@ -211,77 +336,77 @@ namespace Isis {
   }
 
   /**
-   * Reads and returns a comment from the stream.
+   * Reads and returns a comment from the buffer.
    *
-   * @param stream Input stream to read from
+   * @param buffer Buffer to read from
    *
    * @return QString
    */
-  QString PvlTokenizer::ReadComment(std::istream &stream) {
-    QString s;
+  QString PvlTokenizer::ReadComment(CharacterBuffer &buffer) {
+    int start = buffer.position();
     int c;
 
-    c = stream.get();
-    while((c != '\r') && (c != '\n') && (c != '\0')) {
-      s += (char) c;
-      c = stream.peek();
+    c = buffer.get();
+    while(!(characterClass(c) & CommentEndCharacter)) {
+      c = buffer.peek();
       ValidateCharacter(c);
-      if(c == EOF) return s;
-      c = stream.get();
+      if(c == EOF) return buffer.text(start, buffer.position());
+      c = buffer.get();
     }
 
-    stream.unget();
+    buffer.unget();
 
-    return s;
+    return buffer.text(start, buffer.position());
   }
 
   /**
-   * Reads and returns a token from the stream. A token is delimited by either
+   * Reads and returns a token from the buffer. A token is delimited by either
    * whitespace or an equal sign. In the case of whitespace the token will be
    * considered valueless. That is, there will be no value in the value side of
    * the token (e.g., KEYWORD=).
    *
-   * @param stream Input stream to read from
+   * @param buffer Buffer to read from
    *
    * @return QString
    */
-  QString PvlTokenizer::ReadToken(std::istream &stream) {
-    QString s;
+  QString PvlTokenizer::ReadToken(CharacterBuffer &buffer) {
+    int start = buffer.position();
     int c;
 
-    c = stream.get();
-    while((!isspace(c)) && (c != '\0') && (c != '=')) {
-      s += (char) c;
-      c = stream.peek();
+    c = buffer.get();
+    while(!(characterClass(c) & TokenEndCharacter)) {
+      c = buffer.peek();
       ValidateCharacter(c);
-      if(c == EOF) return s;
-      c = stream.get();
+      if(c == EOF) return buffer.text(start, buffer.position());
+      c = buffer.get();
     }
 
-    stream.unget();
+    buffer.unget();
 
-    return s;
+    return buffer.text(start, buffer.position());
   }
 
   /**
    * Skips over whitespace so long as it is not inside quotes. Whitespace is
    * tabs, blanks, line feeds, carriage returns, and NULLs.
    *
-   * @param stream Input stream to read from
+   * @param buffer Buffer to read from
+   *
+   * @return bool True if a line feed was skipped
    */
-  bool PvlTokenizer::SkipWhiteSpace(std::istream &stream) {
+  bool PvlTokenizer::SkipWhiteSpace(CharacterBuffer &buffer) {
     bool foundNewline = false;
     int c;
 
-    c = stream.peek();
+    c = buffer.peek();
     ValidateCharacter(c);
-    while((isspace(c)) || (c == '\0')) {
+    while(c != EOF && (characterClass(c) & WhiteSpaceCharacter)) {
       if(c == '\n') {
         foundNewline = true;
       }
 
-      c = stream.get();
-      c = stream.peek();
+      buffer.ignore();
+      c = buffer.peek();
       ValidateCharacter(c);
     }
 
@@ -289,60 +414,56 @@ namespace Isis {
   }
 
 
-  QString PvlTokenizer::ReadToDoubleQuote(std::istream &stream) {
-    QString s;
-    int c;
-
-    do {
-      c = stream.get();
-      ValidateCharacter(c);
-      if(c == EOF) {
-        QString message = Isis::Message::MissingDelimiter('"', s);
-        throw IException(IException::Unknown, message, _FILEINFO_);
-      }
-      else if(c != '"') {
-        s += (char) c;
-      }
-    }
-    while(c != '"');
+  /**
+   * Reads up to the next double quote and consumes it.
+   *
+   * @param buffer Buffer to read from
+   *
+   * @return QString The characters before the quote
+   */
+  QString PvlTokenizer::ReadToDoubleQuote(CharacterBuffer &buffer) {
+    return ReadToQuote(buffer, '"');
+  }
 
-    int pos = s.indexOf(QRegExp("[\\n\\r]"));
-    while(pos != -1) {
-      QString first = s.mid(0, pos);
-      bool addspace = false;
-      if(first[pos-1] == ' ') addspace = true;
-      first = first.remove(QRegExp("[\\s]*$"));
-      QString second = s.mid(pos + 1);
-      if(second[0] == ' ') addspace = true;
-      if(second[0] == '\r') addspace = true;
-      if(second[0] == '\n') addspace = true;
-      second = second.remove(QRegExp("^[\\s]*"));
-      if(second[0] == ',') addspace = false;
-      s = first;
-      if(addspace) s += " ";
-      s += second;
 
-      pos = s.indexOf(QRegExp("[\\n\\r]"));
-    }
-    return s;
+  /**
+   * Reads up to the next single quote and consumes it.
+   *
+   * @param buffer Buffer to read from
+   *
+   * @return QString The characters before the quote
+   */
+  QString PvlTokenizer::ReadToSingleQuote(CharacterBuffer &buffer) {
+    return ReadToQuote(buffer, '\'');
   }
 
-  QString PvlTokenizer::ReadToSingleQuote(std::istream &stream) {
-    QString s;
+
+  /**
+   * Reads up to the next quote and consumes it. Line breaks in the quoted
+   * text are removed along with the whitespace around them, leaving a
+   * single space where there was whitespace next to the break.
+   *
+   * @param buffer Buffer to read from
+   * @param quote The quote character ending the text
+   *
+   * @return QString The characters before the quote
+   */
+  QString PvlTokenizer::ReadToQuote(CharacterBuffer &buffer, char quote) {
+    int start = buffer.position();
     int c;
 
     do {
-      c = stream.get();
+      c = buffer.get();
       ValidateCharacter(c);
       if(c == EOF) {
-        QString message = Isis::Message::MissingDelimiter('\'', s);
+        QString message = Isis::Message::MissingDelimiter(quote,
+                                                          buffer.text(start, buffer.position()));
         throw IException(IException::Unknown, message, _FILEINFO_);
       }
-      else if(c != '\'') {
-        s += (char) c;
-      }
     }
-    while(c != '\'');
+    while(c != quote);
+
+    QString s = buffer.text(start, buffer.position() - 1);
 
     int pos = s.indexOf(QRegExp("[\\n\\r]"));
     while(pos != -1) {
@@ -359,96 +480,86 @@ namespace Isis {
       s = first;
       if(addspace) s += " ";
       s += second;
+
       pos = s.indexOf(QRegExp("[\\n\\r]"));
     }
-
     return s;
   }
 
-  QString PvlTokenizer::ReadToParen(std::istream &stream) {
-    QString s;
-    int c;
-    int leftParenCount = 1;
 
-    do {
-      c = stream.get();
-      ValidateCharacter(c);
-      if(c == EOF) {
-        QString message = Isis::Message::MissingDelimiter(')', s);
-        throw IException(IException::Unknown, message, _FILEINFO_);
-      }
-      else if(c == '"') {
-        try {
-          s += "\"" + ReadToDoubleQuote(stream) + "\"";
-        }
-        catch(IException &) {
-          QString message = Isis::Message::MissingDelimiter('"', s);
-          throw IException(IException::Unknown, message, _FILEINFO_);
-        }
-      }
-      else if(c == '\'') {
-        try {
-          s += "'" + ReadToSingleQuote(stream) + "'";
-        }
-        catch(IException &) {
-          QString message = Isis::Message::MissingDelimiter('\'', s);
-          throw IException(IException::Unknown, message, _FILEINFO_);
-        }
-      }
-      else if(c == ')') {
-        leftParenCount--;
-        if(leftParenCount > 0) s += (char) c;
-      }
-      else {
-        s += (char) c;
-        if(c == '(') leftParenCount++;
-      }
-    }
-    while(leftParenCount > 0);
+  /**
+   * Reads up to the matching close parenthesis and consumes it.
+   *
+   * @param buffer Buffer to read from
+   *
+   * @return QString The characters inside the parentheses
+   */
+  QString PvlTokenizer::ReadToParen(CharacterBuffer &buffer) {
+    return ReadToClose(buffer, '(', ')');
+  }
 
-    return s;
+
+  /**
+   * Reads up to the matching close brace and consumes it.
+   *
+   * @param buffer Buffer to read from
+   *
+   * @return QString The characters inside the braces
+   */
+  QString PvlTokenizer::ReadToBrace(CharacterBuffer &buffer) {
+    return ReadToClose(buffer, '{', '}');
   }
 
-  QString PvlTokenizer::ReadToBrace(std::istream &stream) {
+
+  /**
+   * Reads up to the close character matching an open character that has
+   * already been consumed, and consumes it. Nested pairs and quoted text are
+   * kept in the result. The text between quoted strings is copied out of the
+   * buffer as whole ranges.
+   *
+   * @param buffer Buffer to read from
+   * @param open The character that opened the list
+   * @param close The character that closes the list
+   *
+   * @return QString The characters inside the list
+   */
+  QString PvlTokenizer::ReadToClose(CharacterBuffer &buffer, char open, char close) {
     QString s;
+    int start = buffer.position();
     int c;
-    int leftBraceCount = 1;
+    int openCount = 1;
 
     do {
-      c = stream.get();
+      c = buffer.get();
       ValidateCharacter(c);
       if(c == EOF) {
-        QString message = Isis::Message::MissingDelimiter('}', s);
+        s += buffer.text(start, buffer.position());
+        QString message = Isis::Message::MissingDelimiter(close, s);
         throw IException(IException::Unknown, message, _FILEINFO_);
       }
-      else if(c == '"') {
+      else if(c == '"' || c == '\'') {
+        s += buffer.text(start, buffer.position() - 1);
         try {
-          s += "\"" + ReadToDoubleQuote(stream) + "\"";
-        }
-        catch(IException &e) {
-          QString message = Isis::Message::MissingDelimiter('"', s);
-          throw IException(IException::Unknown, message, _FILEINFO_);
-        }
-      }
-      else if(c == '\'') {
-        try {
-          s += "'" + ReadToSingleQuote(stream) + "'";
+          QString quoted = ReadToQuote(buffer, (char) c);
+          s += (char) c;
+          s += quoted;
+          s += (char) c;
         }
         catch(IException &) {
-          QString message = Isis::Message::MissingDelimiter('\'', s);
+          QString message = Isis::Message::MissingDelimiter((char) c, s);
           throw IException(IException::Unknown, message, _FILEINFO_);
         }
+        start = buffer.position();
       }
-      else if(c == '}') {
-        leftBraceCount--;
-        if(leftBraceCount > 0) s += (char) c;
+      else if(c == close) {
+        openCount--;
+        if(openCount == 0) s += buffer.text(start, buffer.position() - 1);
       }
-      else {
-        s += (char) c;
-        if(c == '{') leftBraceCount++;
+      else if(c == open) {
+        openCount++;
       }
     }
-    while(leftBraceCount > 0);
+    while(openCount > 0);
 
     return s;
   }
@@ -462,27 +573,33 @@ namespace Isis {
    * @param cl QString containing comma separated list
    */
   void PvlTokenizer::ParseCommaList(Isis::PvlToken &t, const QString &cl) {
-    stringstream stream(cl.toLatin1().data());
+    // The list ends at the first NULL, as it did when it was read from a
+    // stringstream built from a C string
+    QByteArray data = cl.toLatin1();
+    int nullPosition = data.indexOf('\0');
+    if(nullPosition != -1) data.truncate(nullPosition);
+
+    CharacterBuffer buffer(data);
     int c;
     QString s;
 
     do {
-      SkipWhiteSpace(stream);
-      c = stream.get();
+      SkipWhiteSpace(buffer);
+      c = buffer.get();
       if(c == '"') {
-        s += ReadToDoubleQuote(stream);
+        s += ReadToDoubleQuote(buffer);
       }
       else if(c == '\'') {
-        s += ReadToSingleQuote(stream);
+        s += ReadToSingleQuote(buffer);
       }
       else if(c == '(') {
         s += "(";
-        s += ReadToParen(stream);
+        s += ReadToParen(buffer);
         s += ")";
       }
       else if(c == '{') {
         s += "{";
-        s += ReadToBrace(stream);
+        s += ReadToBrace(buffer);
         s += "}";
       }
       else if(c == ',') {
@@ -510,9 +627,7 @@ namespace Isis {
    */
   void PvlTokenizer::ValidateCharacter(int c) {
     if(c == EOF) return;
-    if(isprint(c)) return;
-    if(isspace(c)) return;
-    if(c == '\0') return;
+    if(characterClass(c) & ValidCharacter) return;
 
     QString message = "ASCII data expected but found unprintable (binary) data";
     throw IException(IException::Unknown, message, _FILEINFO_);
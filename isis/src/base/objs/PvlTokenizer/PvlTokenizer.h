@@ -22,9 +22,11 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+#include <cstdio>
 #include <iostream>
 #include "PvlToken.h"
 
+#include <QByteArray>
 #include <QString>
 
 namespace Isis {
@@ -88,21 +90,104 @@ namespace Isis {
    *  @history 2010-01-08 Eric Hyer - PvlTokenizer.cpp used EOF without including
    *                                  fstream, breaking this class on recent
    *                                  compilers (I added #include <fstream>).
+   *
+   *  @history 2018-09-07 Isis Development Team - Load now reads the stream in
+   *                           blocks into a CharacterBuffer and scans it with
+   *                           a table of character classes instead of calling
+   *                           get() and peek() on the stream for every
+   *                           character. Tokens are copied out of the buffer
+   *                           as whole ranges. The tokens and errors are the
+   *                           same as before.
    */
   class PvlTokenizer {
 
     protected:
+      /**
+       * A buffered source of characters for the tokenizer. Characters are
+       * read from a stream in blocks as the tokenizer needs them, or come
+       * from an array that is already in memory. Text is copied out of the
+       * buffer a whole range at a time. When the buffer is destroyed, a
+       * stream it read ahead of the tokenizer is put back after the last
+       * character that was used.
+       *
+       * @author 2018-09-07 Isis Development Team
+       *
+       * @internal
+       *   @history 2018-09-07 Isis Development Team - Original version.
+       */
+      class CharacterBuffer {
+        public:
+          CharacterBuffer(std::istream &stream);
+          CharacterBuffer(const QByteArray &data);
+          ~CharacterBuffer();
+
+          /**
+           * Returns the next character without consuming it.
+           *
+           * @return int The next character, or EOF at the end of the data
+           */
+          int peek() {
+            if (m_position < m_data.size() || fill()) {
+              return (unsigned char) m_data.constData()[m_position];
+            }
+            return EOF;
+          }
+
+          /**
+           * Consumes and returns the next character.
+           *
+           * @return int The next character, or EOF at the end of the data
+           */
+          int get() {
+            int c = peek();
+            if (c != EOF) m_position++;
+            return c;
+          }
+
+          //! Consumes the next character
+          void ignore() {
+            get();
+          }
+
+          //! Puts the last character read back
+          void unget() {
+            if (m_position > 0) m_position--;
+          }
+
+          /**
+           * Returns the position of the next character in the buffer.
+           *
+           * @return int The position of the next character
+           */
+          int position() const {
+            return m_position;
+          }
+
+          QString text(int start, int end) const;
+
+        private:
+          bool fill();
+
+          std::istream *m_stream;           //!< The stream being read, or NULL
+          std::istream::pos_type m_start;   //!< Where the stream was at first
+          bool m_streamDone;                //!< True when the stream has no more
+          QByteArray m_data;                //!< The characters read so far
+          int m_position;                   //!< The next character to scan
+      };
+
       std::vector<Isis::PvlToken> tokens; /**<The array of Tokens parse out of
                                               the stream*/
 
 
-      QString ReadComment(std::istream &stream);
-      QString ReadToken(std::istream &stream);
-      bool SkipWhiteSpace(std::istream &stream);
-      QString ReadToSingleQuote(std::istream &stream);
-      QString ReadToDoubleQuote(std::istream &stream);
-      QString ReadToParen(std::istream &stream);
-      QString ReadToBrace(std::istream &stream);
+      QString ReadComment(CharacterBuffer &buffer);
+      QString ReadToken(CharacterBuffer &buffer);
+      bool SkipWhiteSpace(CharacterBuffer &buffer);
+      QString ReadToSingleQuote(CharacterBuffer &buffer);
+      QString ReadToDoubleQuote(CharacterBuffer &buffer);
+      QString ReadToQuote(CharacterBuffer &buffer, char quote);
+      QString ReadToParen(CharacterBuffer &buffer);
+      QString ReadToBrace(CharacterBuffer &buffer);
+      QString ReadToClose(CharacterBuffer &buffer, char open, char close);
       void ParseCommaList(Isis::PvlToken &t, const QString &cl);
       void ValidateCharacter(int c);
 
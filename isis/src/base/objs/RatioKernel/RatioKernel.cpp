@@ -0,0 +1,112 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "RatioKernel.h"
+
+#include "Buffer.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the DENOMINATOR parameter.
+   *
+   * @param parameters The parameters of the run
+   */
+  RatioKernel::RatioKernel(const QMap<QString, QString> &parameters) {
+    m_denominatorName = parameters["DENOMINATOR"];
+  }
+
+
+  //! Destroys the RatioKernel
+  RatioKernel::~RatioKernel() {
+  }
+
+
+  /**
+   * Returns NUMERATOR, the parameter of the input cube.
+   *
+   * @return QString The parameter name
+   */
+  QString RatioKernel::InputParameter() const {
+    return "NUMERATOR";
+  }
+
+
+  /**
+   * Opens the denominator cube, which must be the size of the input cube and
+   * have its number of bands or one band.
+   *
+   * @param input The input cube
+   *
+   * @throws Isis::IException::User - The denominator does not match the input
+   */
+  void RatioKernel::Prepare(Cube &input) {
+    m_denominator.reset(OpenSecondaryCube(m_denominatorName, input));
+
+    if (m_denominator->bandCount() != 1 &&
+        m_denominator->bandCount() != input.bandCount()) {
+      QString message = "The number of bands in the secondary input cubes must match";
+      message += " the primary input cube or be exactly one";
+      throw IException(IException::User, message, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Divides the pixels of a line by the denominator. Special pixels and
+   * division by zero give NULL.
+   *
+   * @param in The numerator pixels
+   * @param out The output pixels
+   */
+  void RatioKernel::Apply(Buffer &in, Buffer &out) const {
+    LineManager denominator(*m_denominator);
+    denominator.SetLine(in.Line(), m_denominator->bandCount() == 1 ? 1 : in.Band());
+    m_denominator->read(denominator);
+
+    for (int i = 0; i < in.size(); i++) {
+      double numerator = in[i];
+      if (IsSpecial(numerator) || IsSpecial(denominator[i]) ||
+          denominator[i] == 0.0) {
+        out[i] = NULL8;
+      }
+      else {
+        out[i] = numerator / denominator[i];
+      }
+    }
+  }
+}
+
+
+/**
+ * Creates a ratio kernel, or NULL if there is no DENOMINATOR.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *RatioKernelPlugin(const QMap<QString, QString> &parameters) {
+  if (!parameters.contains("DENOMINATOR")) return NULL;
+  return new Isis::RatioKernel(parameters);
+}
@@ -0,0 +1,62 @@
+#ifndef RatioKernel_h
+#define RatioKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QScopedPointer>
+#include <QString>
+
+#include "Cube.h"
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the ratio program
+   *
+   * This kernel divides the pixels of the NUMERATOR cube by those of the
+   * DENOMINATOR cube.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class RatioKernel : public PixelKernel {
+    public:
+      RatioKernel(const QMap<QString, QString> &parameters);
+      ~RatioKernel();
+
+      QString InputParameter() const;
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+
+    private:
+      QString m_denominatorName;          //!< The denominator file name
+      QScopedPointer<Cube> m_denominator; //!< The denominator cube
+  };
+};
+
+#endif
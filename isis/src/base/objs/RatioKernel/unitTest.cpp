@@ -0,0 +1,44 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Cube.h"
+#include "Preference.h"
+#include "RatioKernel.h"
+
+using namespace Isis;
+using namespace std;
+
+extern "C" PixelKernel *RatioKernelPlugin(const QMap<QString, QString> &parameters);
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+
+  cout << "Testing a ratio kernel ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["DENOMINATOR"] = "$base/testData/isisTruth.cub";
+
+  RatioKernel ratio(parameters);
+  ratio.Prepare(cube);
+  cout << "Input parameter = " << ratio.InputParameter() << endl;
+  cout << "Prepare reads pixels? " << ratio.PrepareReadsPixels() << endl;
+  cout << endl;
+
+  cout << "Testing the plugin ..." << endl;
+  PixelKernel *kernel = RatioKernelPlugin(parameters);
+  cout << "Kernel with a DENOMINATOR? " << (kernel ? "Yes" : "No") << endl;
+  delete kernel;
+
+  parameters.remove("DENOMINATOR");
+  kernel = RatioKernelPlugin(parameters);
+  cout << "Kernel without a DENOMINATOR? " << (kernel ? "Yes" : "No") << endl;
+  delete kernel;
+
+  cube.close();
+  return 0;
+}
@@ -90,19 +90,9 @@ namespace Isis {
    */
   PvlGroup SerialNumber::FindSerialTranslation(Pvl &label) {
     Pvl outLabel;
-    static PvlGroup dataDir(Preference::Preferences().findGroup("DataDirectory"));
-
-    // Get the mission name
-    static QString missionTransFile = (QString) dataDir["base"] + "/translations/MissionName2DataDir.trn";
-    static PvlToPvlTranslationManager missionXlater(missionTransFile);
-    missionXlater.SetLabel(label);
-    QString mission = missionXlater.Translate("MissionName");
-
-    // Get the instrument name
-    static QString instTransFile = (QString) dataDir["base"] + "/translations/Instruments.trn";
-    static PvlToPvlTranslationManager instrumentXlater(instTransFile);
-    instrumentXlater.SetLabel(label);
-    QString instrument = instrumentXlater.Translate("InstrumentName");
+    QString mission;
+    QString instrument;
+    FindMissionInstrument(label, mission, instrument);
 
     // We want to use this instrument's translation manager. It's much faster for
     //   SerialNumberList if we keep the translation manager in memory, so re-reading
@@ -122,8 +112,7 @@ namespace Isis {
     // If we don't succeed, create one
     if(translationIterator == missionTranslators.end()) {
       // Get the file
-      FileName snFile((QString) dataDir[mission] + "/translations/" +
-                                    instrument + "SerialNumber????.trn");
+      FileName snFile(TranslationFile(mission, instrument));
       snFile = snFile.highestVersion();
 
       // use the translation file to generate keywords
@@ -143,6 +132,63 @@ namespace Isis {
     return snGroup;
   }
 
+  /**
+   * Returns the serial number translation file of a label, with "????" in
+   * place of its version. The highest version of this file is the one used to
+   * compose the serial number of the label.
+   *
+   * @param label A pvl formatted label to find the translation file of
+   *
+   * @return QString The unversioned translation file
+   */
+  QString SerialNumber::TranslationFile(Pvl &label) {
+    QString mission;
+    QString instrument;
+    FindMissionInstrument(label, mission, instrument);
+    return TranslationFile(mission, instrument);
+  }
+
+
+  /**
+   * Returns the serial number translation file of an instrument, with "????"
+   * in place of its version.
+   *
+   * @param mission The mission name, which names its data directory
+   * @param instrument The instrument name
+   *
+   * @return QString The unversioned translation file
+   */
+  QString SerialNumber::TranslationFile(const QString &mission, const QString &instrument) {
+    static PvlGroup dataDir(Preference::Preferences().findGroup("DataDirectory"));
+    return (QString) dataDir[mission] + "/translations/" + instrument + "SerialNumber????.trn";
+  }
+
+
+  /**
+   * Translates the mission and instrument names of a label, which select its
+   * serial number translation file.
+   *
+   * @param label A pvl formatted label
+   * @param mission Returns the mission name
+   * @param instrument Returns the instrument name
+   */
+  void SerialNumber::FindMissionInstrument(Pvl &label, QString &mission, QString &instrument) {
+    static PvlGroup dataDir(Preference::Preferences().findGroup("DataDirectory"));
+
+    // Get the mission name
+    static QString missionTransFile = (QString) dataDir["base"] + "/translations/MissionName2DataDir.trn";
+    static PvlToPvlTranslationManager missionXlater(missionTransFile);
+    missionXlater.SetLabel(label);
+    mission = missionXlater.Translate("MissionName");
+
+    // Get the instrument name
+    static QString instTransFile = (QString) dataDir["base"] + "/translations/Instruments.trn";
+    static PvlToPvlTranslationManager instrumentXlater(instTransFile);
+    instrumentXlater.SetLabel(label);
+    instrument = instrumentXlater.Translate("InstrumentName");
+  }
+
+
   /**
    * Create the SerialNumber string by concatenating the keywords in the label
    * with '/' in between serialNumber groups and the number of observationKeys
@@ -81,6 +81,9 @@ namespace Isis {
    *  @history 2008-05-09 Steven Lambright Optimized the FindSerialTranslation
    *           method
    *  @history 2008-05-18 Steven Lambright Fixed documentation
+   *  @history 2018-09-07 Isis Development Team - Added TranslationFile() so
+   *           SerialNumberList can tell when the translation of a cached
+   *           serial number changed.
    */
   class SerialNumber {
     public:
@@ -96,6 +99,8 @@ namespace Isis {
 
       static QString ComposeObservation(const QString &sn, SerialNumberList &list, bool def2filename = false);
 
+      static QString TranslationFile(Pvl &label);
+
     protected:
 
       static QString CreateSerialNumber(PvlGroup &snGroup, int key);
@@ -103,6 +108,8 @@ namespace Isis {
     private:
 
       static PvlGroup FindSerialTranslation(Pvl &label);
+      static QString TranslationFile(const QString &mission, const QString &instrument);
+      static void FindMissionInstrument(Pvl &label, QString &mission, QString &instrument);
 
   }; // End of Class
 }; // End of namespace
@@ -1,13 +1,25 @@
 #include "SerialNumberList.h"
 
-#include <QString>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrentMap>
 
 #include "IException.h"
 #include "FileList.h"
 #include "FileName.h"
 #include "ObservationNumber.h"
+#include "Preference.h"
 #include "Progress.h"
 #include "Pvl.h"
+#include "PvlGroup.h"
 #include "SerialNumber.h"
 
 namespace Isis {
@@ -24,12 +36,20 @@ namespace Isis {
 
 
   /**
-   * Creates a SerialNumberList from a list of filenames
+   * Creates a SerialNumberList from a list of filenames. The labels of the files are read in
+   * parallel, and the serial numbers are composed in the order of the list.
+   *
+   * If a cache file is given, the serial numbers of files whose size and modification time
+   * have not changed since they were cached are taken from it without reading their labels,
+   * and the serial numbers of the other files are added to it. A cached serial number is also
+   * read again if the translation files it was composed with have changed. The cache file is created if
+   * it does not exist, and can be shared by any number of lists.
    *
    * @param listfile The list of files to be given serial numbers
    * @param checkTarget Specifies whether or not to check to make sure the target names
    *                    match between files added to the serialnumber list
    * @param progress Monitors progress of serial number creation
+   * @param cacheFile The cache file of serial numbers, or an empty string to read every label
    *
    * @throws IException::User "Can't open or invalid file list"
    *
@@ -39,7 +59,8 @@ namespace Isis {
    */
   SerialNumberList::SerialNumberList(const QString &listfile,
                                      bool checkTarget,
-                                     Progress *progress) {
+                                     Progress *progress,
+                                     const QString &cacheFile) {
     m_checkTarget = checkTarget;
     m_target.clear();
 
@@ -50,11 +71,124 @@ namespace Isis {
         progress->SetMaximumSteps((int) flist.size() + 1);
         progress->CheckStatus();
       }
-      for (int i = 0; i < flist.size(); i++) {
-        add(flist[i].toString());
-        if (progress != NULL) {
-          progress->CheckStatus();
+
+      QHash<QString, CacheEntry> cache;
+      if (!cacheFile.isEmpty()) {
+        cache = readCache(cacheFile);
+      }
+      bool cacheChanged = false;
+
+      // The version of each translation file is found once per list
+      QHash<QString, QString> versions;
+
+      // Labels are read in groups to bound the memory they hold. The serial numbers are
+      //   composed one at a time since SerialNumber shares its translation managers.
+      int threads = QThreadPool::globalInstance()->maxThreadCount();
+      int groupSize = 64 * qMax(1, threads);
+
+      for (int groupStart = 0; groupStart < flist.size(); groupStart += groupSize) {
+        int groupEnd = qMin(flist.size(), groupStart + groupSize);
+
+        QStringList expanded;
+        QVector<CacheEntry> entries;
+        QVector<bool> cached;
+        QStringList unreadFiles;
+
+        for (int i = groupStart; i < groupEnd; i++) {
+          QString filename = flist[i].expanded();
+          QFileInfo info(filename);
+
+          CacheEntry entry;
+          entry.size = info.size();
+          entry.modified = info.lastModified().toMSecsSinceEpoch();
+
+          bool isCached = false;
+          if (cache.contains(filename)) {
+            const CacheEntry &cachedEntry = cache[filename];
+            isCached = (cachedEntry.size == entry.size &&
+                        cachedEntry.modified == entry.modified &&
+                        (!m_checkTarget || !cachedEntry.target.isEmpty()));
+
+            if (isCached) {
+              if (!versions.contains(cachedEntry.translation)) {
+                versions[cachedEntry.translation] = translationVersion(cachedEntry.translation);
+              }
+              isCached = (!cachedEntry.version.isEmpty() &&
+                          cachedEntry.version == versions[cachedEntry.translation]);
+            }
+            if (isCached) {
+              entry = cachedEntry;
+            }
+          }
+
+          if (!isCached) {
+            unreadFiles.append(filename);
+          }
+
+          expanded.append(filename);
+          entries.append(entry);
+          cached.append(isCached);
+        }
+
+        QList<Pvl> labels;
+        if (threads > 1) {
+          labels = QtConcurrent::blockingMapped(unreadFiles, &SerialNumberList::readLabel);
         }
+        else {
+          for (int i = 0; i < unreadFiles.size(); i++) {
+            labels.append(readLabel(unreadFiles[i]));
+          }
+        }
+
+        int nextLabel = 0;
+        for (int i = 0; i < expanded.size(); i++) {
+          if (cached[i]) {
+            try {
+              insertPair(entries[i].pair, entries[i].target);
+            }
+            catch (IException &e) {
+              QString msg = "FileName [" + expanded[i] +
+                            "] can not be added to serial number list.";
+              throw IException(e, IException::User, msg, _FILEINFO_);
+            }
+          }
+          else {
+            Pvl &label = labels[nextLabel++];
+
+            // Read the label again to report why it could not be read
+            if (label.objects() == 0) {
+              label = Pvl(expanded[i]);
+            }
+
+            addLabel(label, flist[groupStart + i].toString(), false, &entries[i]);
+
+            if (!cacheFile.isEmpty()) {
+              // A file whose translation file is unknown is not cached
+              try {
+                entries[i].translation = SerialNumber::TranslationFile(label);
+              }
+              catch (IException &) {
+                entries[i].translation.clear();
+              }
+
+              if (!versions.contains(entries[i].translation)) {
+                versions[entries[i].translation] = translationVersion(entries[i].translation);
+              }
+              entries[i].version = versions[entries[i].translation];
+
+              cache[expanded[i]] = entries[i];
+              cacheChanged = true;
+            }
+          }
+
+          if (progress != NULL) {
+            progress->CheckStatus();
+          }
+        }
+      }
+
+      if (cacheChanged) {
+        writeCache(cacheFile, cache);
       }
     }
     catch (IException &e) {
@@ -114,13 +248,29 @@ namespace Isis {
    */
   void SerialNumberList::add(const QString &filename, bool def2filename) {
     Pvl p(Isis::FileName(filename).expanded());
-    PvlObject cubeObj = p.findObject("IsisCube");
+    addLabel(p, filename, def2filename);
+  }
+
+
+  /**
+   * Adds the serial number composed from the label of a file to the list.
+   *
+   * @param label The label of the file
+   * @param filename The filename to be added
+   * @param def2filename If a serial number could not be found, try to return the filename
+   * @param entry If not NULL, set to the Pair and target name of the file
+   *
+   * @see add(const QString &, bool)
+   */
+  void SerialNumberList::addLabel(Pvl &label, const QString &filename, bool def2filename,
+                                  CacheEntry *entry) {
+    PvlObject cubeObj = label.findObject("IsisCube");
 
     try {
 
-      // Test the target name if desired
+      // Find the target name if desired
+      QString target;
       if (m_checkTarget) {
-        QString target;
         PvlGroup targetGroup;
         if (cubeObj.hasGroup("Instrument")) {
           targetGroup = cubeObj.findGroup("Instrument");
@@ -145,35 +295,13 @@ namespace Isis {
 
         target = targetGroup["TargetName"][0];
         target = target.toUpper();
-        if (m_target.isEmpty()) {
-          m_target = target;
-        }
-        else if (m_target != target) {
-          QString msg = "Target name of [" + target + "] from file ["
-                        + filename + "] does not match [" + m_target + "].";
-          throw IException(IException::User, msg, _FILEINFO_);
-        }
       }
 
       // Create the SN
-      QString sn = SerialNumber::Compose(p, def2filename);
-      QString on = ObservationNumber::Compose(p, def2filename);
-      if (sn == "Unknown") {
-        QString msg = "Invalid serial number [Unknown] from file ["
-                      + filename + "].";
-        throw IException(IException::User, msg, _FILEINFO_);
-      }
-      else if (hasSerialNumber(sn)) {
-        int index = serialNumberIndex(sn);
-        QString msg = "Duplicate serial number [" + sn + "] from files ["
-                      + SerialNumberList::fileName(sn) + "] and [" + fileName(index) + "].";
-        throw IException(IException::User, msg, _FILEINFO_);
-      }
-
       Pair nextpair;
       nextpair.filename = Isis::FileName(filename).expanded();
-      nextpair.serialNumber = sn;
-      nextpair.observationNumber = on;
+      nextpair.serialNumber = SerialNumber::Compose(label, def2filename);
+      nextpair.observationNumber = ObservationNumber::Compose(label, def2filename);
 
       // Need to obtain the SpacecraftName and InstrumentId from the Instrument
       // group for use in bundle adjustment
@@ -185,9 +313,12 @@ namespace Isis {
         }
       }
 
-      m_pairs.push_back(nextpair);
-      m_serialMap.insert(std::pair<QString, int>(sn, (int)(m_pairs.size() - 1)));
-      m_fileMap.insert(std::pair<QString, int>(nextpair.filename, (int)(m_pairs.size() - 1)));
+      insertPair(nextpair, target);
+
+      if (entry != NULL) {
+        entry->target = target;
+        entry->pair = nextpair;
+      }
     }
     catch (IException &e) {
       QString msg = "FileName [" + Isis::FileName(filename).expanded() +
@@ -198,6 +329,47 @@ namespace Isis {
   }
 
 
+  /**
+   * Adds a Pair to the end of the list after checking its target name and serial number.
+   *
+   * @param pair The Pair to be added
+   * @param target The upper case target name of the file, if m_checkTarget is true
+   *
+   * @throws IException::User "Target name from file does not match."
+   * @throws IException::User "Invalid serial number [Unknown] from file."
+   * @throws IException::User "Duplicate serial number from files [file1] and [file2]."
+   */
+  void SerialNumberList::insertPair(const Pair &pair, const QString &target) {
+    if (m_checkTarget) {
+      if (m_target.isEmpty()) {
+        m_target = target;
+      }
+      else if (m_target != target) {
+        QString msg = "Target name of [" + target + "] from file ["
+                      + pair.filename + "] does not match [" + m_target + "].";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+    }
+
+    if (pair.serialNumber == "Unknown") {
+      QString msg = "Invalid serial number [Unknown] from file ["
+                    + pair.filename + "].";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+    else if (hasSerialNumber(pair.serialNumber)) {
+      int index = serialNumberIndex(pair.serialNumber);
+      QString msg = "Duplicate serial number [" + pair.serialNumber + "] from files ["
+                    + SerialNumberList::fileName(pair.serialNumber) + "] and ["
+                    + fileName(index) + "].";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    m_pairs.push_back(pair);
+    m_serialMap.insert(std::pair<QString, int>(pair.serialNumber, (int)(m_pairs.size() - 1)));
+    m_fileMap.insert(std::pair<QString, int>(pair.filename, (int)(m_pairs.size() - 1)));
+  }
+
+
   /**
    * @brief Overloaded add method that takes char * parameters
    *
@@ -589,4 +761,193 @@ namespace Isis {
   }
 
 
+  /**
+   * Sorts the list by serial number, so the order of the list does not depend on the order
+   * the files were added in.
+   */
+  void SerialNumberList::sortBySerialNumber() {
+    std::sort(m_pairs.begin(), m_pairs.end(), lessSerialNumber);
+
+    m_serialMap.clear();
+    m_fileMap.clear();
+    for (int i = 0; i < (int)m_pairs.size(); i++) {
+      m_serialMap.insert(std::pair<QString, int>(m_pairs[i].serialNumber, i));
+      m_fileMap.insert(std::pair<QString, int>(m_pairs[i].filename, i));
+    }
+  }
+
+
+  /**
+   * Reads the label of a file. This is called from several threads at once, so errors are
+   * returned as an empty label instead of being thrown.
+   *
+   * @param filename The expanded filename
+   *
+   * @return Pvl The label, or an empty Pvl if it could not be read
+   */
+  Pvl SerialNumberList::readLabel(const QString &filename) {
+    try {
+      return Pvl(filename);
+    }
+    catch (IException &) {
+      return Pvl();
+    }
+  }
+
+
+  /**
+   * Returns the version of the translation files a serial number is composed with: the name and
+   * modification time of the highest version of its serial number translation file, and the
+   * modification times of the mission and instrument translation files that select it.
+   *
+   * @param translation The unversioned serial number translation file
+   *
+   * @return QString The version, or an empty string if the translation file can not be found
+   */
+  QString SerialNumberList::translationVersion(const QString &translation) {
+    if (translation.isEmpty()) {
+      return "";
+    }
+
+    QString version;
+    try {
+      static PvlGroup dataDir(Preference::Preferences().findGroup("DataDirectory"));
+
+      QStringList files;
+      files << FileName(translation).highestVersion().expanded()
+            << FileName((QString) dataDir["base"] +
+                        "/translations/MissionName2DataDir.trn").expanded()
+            << FileName((QString) dataDir["base"] + "/translations/Instruments.trn").expanded();
+
+      QStringList fields;
+      for (int i = 0; i < files.size(); i++) {
+        QFileInfo info(files[i]);
+        if (!info.exists()) {
+          return "";
+        }
+        fields << info.fileName() << QString::number(info.lastModified().toMSecsSinceEpoch());
+      }
+      version = fields.join(":");
+    }
+    catch (IException &) {
+      return "";
+    }
+
+    return version;
+  }
+
+
+  /**
+   * Reads a cache file of serial numbers. Lines that can not be read are skipped, and a cache
+   * file that does not exist is empty.
+   *
+   * @param cacheFile The cache file
+   *
+   * @return QHash<QString, CacheEntry> The cached Pairs by expanded filename
+   */
+  QHash<QString, SerialNumberList::CacheEntry> SerialNumberList::readCache(
+      const QString &cacheFile) {
+    QHash<QString, CacheEntry> cache;
+
+    QFile file(Isis::FileName(cacheFile).expanded());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      return cache;
+    }
+
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+      QString line = stream.readLine();
+      if (line.startsWith("#")) continue;
+
+      QStringList fields = line.split("\t");
+      if (fields.size() != 10) continue;
+
+      CacheEntry entry;
+      bool sizeOk = false;
+      bool modifiedOk = false;
+      entry.pair.filename = fields[0];
+      entry.size = fields[1].toLongLong(&sizeOk);
+      entry.modified = fields[2].toLongLong(&modifiedOk);
+      entry.target = fields[3];
+      entry.pair.serialNumber = fields[4];
+      entry.pair.observationNumber = fields[5];
+      entry.pair.spacecraftName = fields[6];
+      entry.pair.instrumentId = fields[7];
+      entry.translation = fields[8];
+      entry.version = fields[9];
+
+      if (sizeOk && modifiedOk) {
+        cache[entry.pair.filename] = entry;
+      }
+    }
+
+    return cache;
+  }
+
+
+  /**
+   * Writes a cache file of serial numbers. The file is written next to the cache file and
+   * renamed over it, so a list being created at the same time never reads part of it. Failing
+   * to write the cache is not an error, since the cache only saves reading labels.
+   *
+   * @param cacheFile The cache file
+   * @param cache The cached Pairs by expanded filename
+   */
+  void SerialNumberList::writeCache(const QString &cacheFile,
+                                    const QHash<QString, CacheEntry> &cache) {
+    QString cachePath = Isis::FileName(cacheFile).expanded();
+    QString tempPath = cachePath + "." + QString::number(QCoreApplication::applicationPid());
+
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+      return;
+    }
+
+    QTextStream stream(&file);
+    stream << "# Isis serial number list cache: file, size, modified, target, serial number, "
+              "observation number, spacecraft, instrument, translation, translation version\n";
+
+    QHash<QString, CacheEntry>::const_iterator it;
+    for (it = cache.constBegin(); it != cache.constEnd(); ++it) {
+      const CacheEntry &entry = it.value();
+      QStringList fields;
+      fields << entry.pair.filename << QString::number(entry.size)
+             << QString::number(entry.modified) << entry.target << entry.pair.serialNumber
+             << entry.pair.observationNumber << entry.pair.spacecraftName
+             << entry.pair.instrumentId << entry.translation << entry.version;
+
+      QString line = fields.join("\t");
+      if (line.contains("\n") || line.split("\t").size() != 10) continue;
+
+      stream << line << "\n";
+    }
+
+    stream.flush();
+    file.close();
+
+    if (file.error() != QFile::NoError) {
+      QFile::remove(tempPath);
+      return;
+    }
+
+    QFile::remove(cachePath);
+    if (!QFile::rename(tempPath, cachePath)) {
+      QFile::remove(tempPath);
+    }
+  }
+
+
+  /**
+   * Compares the serial numbers of two Pairs for sorting.
+   *
+   * @param first The first Pair
+   * @param second The second Pair
+   *
+   * @return bool True if the serial number of first is less than the serial number of second
+   */
+  bool SerialNumberList::lessSerialNumber(const Pair &first, const Pair &second) {
+    return first.serialNumber < second.serialNumber;
+  }
+
+
 }
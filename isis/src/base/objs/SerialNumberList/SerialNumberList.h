@@ -26,11 +26,13 @@
 #include <map>
 #include <vector>
 
+#include <QHash>
 #include <QString>
 
 namespace Isis {
 
   class Progress;
+  class Pvl;
 
   /**
    * @brief Serial Number list generator
@@ -75,12 +77,20 @@ namespace Isis {
    *                          Fixes #3967.
    *  @history 2017-08-09 Adam Goins - Modified code to be consistent with ISIS coding standards
    *                          Fixes #3991.
+   *  @history 2018-09-07 Isis Development Team - The list file constructor reads the labels
+   *                          in parallel and can keep the serial numbers in a cache file, so
+   *                          files that have not changed are not read again. Added
+   *                          sortBySerialNumber().
+   *  @history 2018-09-07 Isis Development Team - Cached serial numbers are read again when the
+   *                          serial number translation file they were composed with, or the
+   *                          mission and instrument translation files, change.
    */
 
   class SerialNumberList {
     public:
       SerialNumberList(bool checkTarget = true);
-      SerialNumberList(const QString &list, bool checkTarget = true, Progress *progress = NULL);
+      SerialNumberList(const QString &list, bool checkTarget = true, Progress *progress = NULL,
+                       const QString &cacheFile = "");
       virtual ~SerialNumberList();
 
       void add(const QString &filename, bool def2filename = false);
@@ -104,6 +114,8 @@ namespace Isis {
 
       std::vector<QString> possibleSerialNumbers(const QString &on);
 
+      void sortBySerialNumber();
+
     protected:
       /**
        * A serial number list entity that contains the filename serial number pair. May also 
@@ -128,6 +140,29 @@ namespace Isis {
       bool m_checkTarget;
       QString m_target; //!< Target name that the files must have if m_checkTarget is true  
 
+    private:
+      /**
+       * A Pair in the cache file of a list, with the size and modification time of the file it
+       * was composed from and the version of the translation files it was composed with.
+       */
+      struct CacheEntry {
+        qint64 size;         //!< The size of the file in bytes
+        qint64 modified;     //!< The modification time of the file, in ms since the epoch
+        QString target;      //!< The upper case target name, if it was checked
+        QString translation; //!< The unversioned serial number translation file of the file
+        QString version;     //!< The version of the translation files, see translationVersion()
+        Pair pair;           //!< The serial number Pair of the file
+      };
+
+      void addLabel(Pvl &label, const QString &filename, bool def2filename,
+                    CacheEntry *entry = NULL);
+      void insertPair(const Pair &pair, const QString &target);
+
+      static Pvl readLabel(const QString &filename);
+      static QString translationVersion(const QString &translation);
+      static QHash<QString, CacheEntry> readCache(const QString &cacheFile);
+      static void writeCache(const QString &cacheFile, const QHash<QString, CacheEntry> &cache);
+      static bool lessSerialNumber(const Pair &first, const Pair &second);
   };
 };
 
@@ -97,6 +97,48 @@ int main(int argc, char *argv[]) {
   SerialNumberList snlProgressNull(temp.expanded(), true, NULL);
   printSerialNumberList(snlProgressNull);
 
+  // Test SerialNumberList(QString, bool, Progress, QString)
+  cout << endl << "Creating SerialNumberList(QString, bool, Progress=NULL, QString)" << endl;
+  FileName cache("$temporary/serialNumberCache.txt");
+  QFile cacheFile(cache.expanded());
+  cacheFile.remove();
+  SerialNumberList snlCaching(temp.expanded(), true, NULL, cache.expanded());
+  cacheFile.open(QIODevice::ReadOnly | QIODevice::Text);
+  int cacheEntries = 0;
+  while (!cacheFile.atEnd()) {
+    if (!cacheFile.readLine().startsWith("#")) cacheEntries++;
+  }
+  cacheFile.close();
+  cout << "Cache entries = " << cacheEntries << endl;
+  SerialNumberList snlCached(temp.expanded(), true, NULL, cache.expanded());
+  printSerialNumberList(snlCached);
+
+  // Change a cached serial number; an unchanged cube must come back from the cache
+  cacheFile.open(QIODevice::ReadOnly | QIODevice::Text);
+  QString cacheText = QString(cacheFile.readAll());
+  cacheFile.close();
+  cacheText.replace("MGS/561812335:32/MOC-WA/RED", "MGS/561812335:32/MOC-WA/CACHED");
+  cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+  cacheFile.write(cacheText.toLatin1());
+  cacheFile.close();
+  SerialNumberList snlEdited(temp.expanded(), true, NULL, cache.expanded());
+  cout << "Serial number from edited cache = " << snlEdited.serialNumber(0) << endl;
+  cacheFile.remove();
+
+  // Test sortBySerialNumber()
+  cout << endl << "Testing sortBySerialNumber()" << endl;
+  SerialNumberList snlSorted(false);
+  snlSorted.add("$mgs/testData/m0402852.cub");
+  snlSorted.add("$mgs/testData/ab102401.cub");
+  snlSorted.add("$lo/testData/3133_h1.cub");
+  snlSorted.sortBySerialNumber();
+  for (int i = 0; i < snlSorted.size(); i++) {
+    QString sn = snlSorted.serialNumber(i);
+    cout << "  " << sn << " = " << FileName(snlSorted.fileName(i)).name()
+         << ", index from SerialNumber = " << snlSorted.serialNumberIndex(sn)
+         << ", index from FileName = " << snlSorted.fileNameIndex(snlSorted.fileName(i)) << endl;
+  }
+
   cout << endl << endl;
 
 
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "SpecpixKernel.h"
+
+#include <algorithm>
+
+#include <QMutexLocker>
+
+#include "Buffer.h"
+#include "IException.h"
+#include "IString.h"
+#include "PvlKeyword.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the minimum and maximum of each range, such as
+   * NULLMIN and NULLMAX. A range is used when both were given.
+   *
+   * @param parameters The parameters of the run
+   *
+   * @throws Isis::IException::User - Ranges of different special pixels
+   *                                  overlap
+   */
+  SpecpixKernel::SpecpixKernel(const QMap<QString, QString> &parameters) {
+    addRange(parameters, "NULLMIN", "NULLMAX", NULL8, NullCount);
+    addRange(parameters, "LRSMIN", "LRSMAX", LOW_REPR_SAT8, LrsCount);
+    addRange(parameters, "HRSMIN", "HRSMAX", HIGH_REPR_SAT8, HrsCount);
+    addRange(parameters, "LISMIN", "LISMAX", LOW_INSTR_SAT8, LisCount);
+    addRange(parameters, "HISMIN", "HISMAX", HIGH_INSTR_SAT8, HisCount);
+
+    //  Sorted on the minimum in descending order, each minimum must be at
+    //  least the maximum of the next range or the ranges overlap.
+    std::sort(m_ranges.begin(), m_ranges.end(), descending);
+    for (int i = 0; i < m_ranges.size() - 1; i++) {
+      if (m_ranges[i].minimum < m_ranges[i + 1].maximum) {
+        QString message = "Check the ranges entered for overlap between differing  ";
+        message += "special pixels.  ";
+        throw IException(IException::User, message, _FILEINFO_);
+      }
+    }
+
+    for (int i = 0; i < Counts; i++) {
+      m_counts[i] = 0;
+    }
+  }
+
+
+  //! Destroys the SpecpixKernel
+  SpecpixKernel::~SpecpixKernel() {
+  }
+
+
+  /**
+   * Sets the pixels of a line that are in a range to its special pixel and
+   * counts them.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void SpecpixKernel::Apply(Buffer &in, Buffer &out) const {
+    BigInt counts[Counts] = {0, 0, 0, 0, 0};
+
+    for (int i = 0; i < in.size(); i++) {
+      double value = in[i];
+      double result = value;
+      for (int range = 0; range < m_ranges.size(); range++) {
+        if (value >= m_ranges[range].minimum && value <= m_ranges[range].maximum) {
+          result = m_ranges[range].pixel;
+          counts[m_ranges[range].count]++;
+        }
+      }
+      out[i] = result;
+    }
+
+    QMutexLocker locker(&m_countsMutex);
+    for (int i = 0; i < Counts; i++) {
+      m_counts[i] += counts[i];
+    }
+  }
+
+
+  /**
+   * Returns the number and type of the special pixels created.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup SpecpixKernel::Results() const {
+    PvlGroup results("Results");
+    results.addComment("The number and type of pixels created");
+    results += PvlKeyword("Null", toString(m_counts[NullCount]));
+    results += PvlKeyword("Lrs", toString(m_counts[LrsCount]));
+    results += PvlKeyword("Lis", toString(m_counts[LisCount]));
+    results += PvlKeyword("Hrs", toString(m_counts[HrsCount]));
+    results += PvlKeyword("His", toString(m_counts[HisCount]));
+
+    BigInt total = 0;
+    for (int i = 0; i < Counts; i++) {
+      total += m_counts[i];
+    }
+    results += PvlKeyword("Total", toString(total));
+    return results;
+  }
+
+
+  /**
+   * Adds a range if both its minimum and maximum were given.
+   *
+   * @param parameters The parameters of the run
+   * @param minimumName The parameter name of the minimum
+   * @param maximumName The parameter name of the maximum
+   * @param pixel The special pixel
+   * @param count The count of the special pixel
+   */
+  void SpecpixKernel::addRange(const QMap<QString, QString> &parameters,
+                               const QString &minimumName, const QString &maximumName,
+                               double pixel, Count count) {
+    if (parameters.contains(minimumName) && parameters.contains(maximumName)) {
+      Range range;
+      range.minimum = toDouble(parameters[minimumName]);
+      range.maximum = toDouble(parameters[maximumName]);
+      range.pixel = pixel;
+      range.count = count;
+      m_ranges.append(range);
+    }
+  }
+
+
+  /**
+   * Orders ranges on descending minimum.
+   *
+   * @param first A range
+   * @param second Another range
+   *
+   * @return bool True if first has the larger minimum
+   */
+  bool SpecpixKernel::descending(const Range &first, const Range &second) {
+    return first.minimum > second.minimum;
+  }
+}
+
+
+/**
+ * Creates a specpix kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *SpecpixKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::SpecpixKernel(parameters);
+}
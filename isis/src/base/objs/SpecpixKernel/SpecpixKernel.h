@@ -0,0 +1,85 @@
+#ifndef SpecpixKernel_h
+#define SpecpixKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QMutex>
+#include <QVector>
+
+#include "Constants.h"
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the specpix program
+   *
+   * This kernel sets the pixels in ranges of values to special pixels and
+   * counts the special pixels it creates.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class SpecpixKernel : public PixelKernel {
+    public:
+      SpecpixKernel(const QMap<QString, QString> &parameters);
+      ~SpecpixKernel();
+
+      void Apply(Buffer &in, Buffer &out) const;
+      PvlGroup Results() const;
+
+    private:
+      //! The counts of the special pixels created
+      enum Count {
+        NullCount,
+        LrsCount,
+        LisCount,
+        HrsCount,
+        HisCount,
+        Counts
+      };
+
+      //! A range of values that is set to a special pixel
+      struct Range {
+        double minimum; //!< The smallest value in the range
+        double maximum; //!< The largest value in the range
+        double pixel;   //!< The special pixel
+        Count count;    //!< The count of the special pixel
+      };
+
+      void addRange(const QMap<QString, QString> &parameters,
+                    const QString &minimumName, const QString &maximumName,
+                    double pixel, Count count);
+      static bool descending(const Range &first, const Range &second);
+
+      QVector<Range> m_ranges;         //!< The ranges, on descending minimum
+      mutable BigInt m_counts[Counts]; //!< The special pixels created
+      mutable QMutex m_countsMutex;    //!< Guards the counts
+  };
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Cube.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+#include "SpecpixKernel.h"
+
+using namespace Isis;
+using namespace std;
+
+/**
+ * Applies a kernel to a line of ones and prints the null pixels and the sum of
+ * the other pixels of the output.
+ */
+void printLine(const PixelKernel &kernel, Cube &cube, int line) {
+  LineManager in(cube);
+  LineManager out(cube);
+  in.SetLine(line);
+  out.SetLine(line);
+  for (int i = 0; i < in.size(); i++) {
+    in[i] = 1.0;
+  }
+
+  kernel.Apply(in, out);
+
+  int nulls = 0;
+  double sum = 0.0;
+  for (int i = 0; i < out.size(); i++) {
+    if (IsNullPixel(out[i])) {
+      nulls++;
+    }
+    else {
+      sum += out[i];
+    }
+  }
+
+  cout << "Line " << line << ": null pixels = " << nulls
+       << ", sum of the other pixels = " << sum << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+
+  cout << "Testing a specpix kernel ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["NULLMIN"] = "0.5";
+  parameters["NULLMAX"] = "1.5";
+  parameters["HRSMIN"] = "2";
+  parameters["HRSMAX"] = "3";
+
+  SpecpixKernel specpix(parameters);
+  specpix.Prepare(cube);
+  printLine(specpix, cube, 1);
+  printLine(specpix, cube, 2);
+  PvlGroup results = specpix.Results();
+  cout << results["Null"] << endl;
+  cout << results["Hrs"] << endl;
+  cout << results["Total"] << endl;
+  cout << endl;
+
+  cout << "Testing overlapping ranges ..." << endl;
+  try {
+    parameters["LRSMIN"] = "1";
+    parameters["LRSMAX"] = "2.5";
+    SpecpixKernel overlap(parameters);
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  cube.close();
+  return 0;
+}
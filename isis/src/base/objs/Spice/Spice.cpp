@@ -25,6 +25,7 @@
 #include <iomanip>
 
 #include <QDebug>
+#include <QStringList>
 #include <QVector>
 
 #include <getSpkAbCorrState.hpp>
@@ -417,6 +418,11 @@ namespace Isis {
         throw IException(IException::Io, msg, _FILEINFO_);
       }
       QString fileName = file.expanded();
+
+      // Furnished kernels are already loaded and are not unloaded with this
+      // object
+      if (furnishedKernels().contains(fileName)) continue;
+
       furnsh_c(fileName.toLatin1().data());
       m_kernels->push_back(key[i]);
     }
@@ -424,6 +430,68 @@ namespace Isis {
     NaifStatus::CheckErrors();
   }
 
+
+  /**
+   * Furnishes NAIF kernels that stay loaded until unloadFurnishedKernels() is
+   * called. Spice objects created in the meantime use them without loading or
+   * unloading them again, so a batch of cubes that use the same kernels loads
+   * them once. The kernels should be given in the order a Spice object loads
+   * them. Like the rest of NAIF, this is not thread safe.
+   *
+   * @param kernels The kernel files
+   *
+   * @throw Isis::IException::Io - "Spice file does not exist."
+   */
+  void Spice::furnishKernels(const QStringList &kernels) {
+    NaifStatus::CheckErrors();
+
+    for (int i = 0; i < kernels.size(); i++) {
+      if (kernels[i] == "") continue;
+      if (kernels[i].toUpper() == "NULL") continue;
+      if (kernels[i].toUpper() == "NADIR") continue;
+      if (kernels[i].toUpper() == "TABLE") continue;
+      FileName file(kernels[i]);
+      if (!file.fileExists()) {
+        QString msg = "Spice file does not exist [" + file.expanded() + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+      QString fileName = file.expanded();
+      if (furnishedKernels().contains(fileName)) continue;
+
+      furnsh_c(fileName.toLatin1().data());
+      furnishedKernels().append(fileName);
+    }
+
+    NaifStatus::CheckErrors();
+  }
+
+
+  /**
+   * Unloads the kernels loaded by furnishKernels().
+   */
+  void Spice::unloadFurnishedKernels() {
+    NaifStatus::CheckErrors();
+
+    QStringList &kernels = furnishedKernels();
+    for (int i = 0; i < kernels.size(); i++) {
+      unload_c(kernels[i].toLatin1().data());
+    }
+    kernels.clear();
+
+    NaifStatus::CheckErrors();
+  }
+
+
+  /**
+   * Returns the expanded names of the kernels loaded by furnishKernels().
+   *
+   * @return QStringList& The furnished kernels
+   */
+  QStringList &Spice::furnishedKernels() {
+    static QStringList kernels;
+    return kernels;
+  }
+
   /**
    * Destroys the Spice object
    */
@@ -28,6 +28,8 @@
 #include <SpiceZfc.h>
 #include <SpiceZmc.h>
 
+#include <QStringList>
+
 #include "Pvl.h"
 #include "ShapeModel.h"
 #include "SpicePosition.h"
@@ -278,6 +280,9 @@ namespace Isis {
    *                           m_et is set. References #4476. 
    *   @history 2016-10-21 Jeannie Backer - Reorder method signatures and member variable
    *                           declarations to fit ISIS coding standards. References #4476.
+   *   @history 2018-09-07 Isis Development Team - Added furnishKernels() and
+   *                           unloadFurnishedKernels() so a batch of cubes that use the same
+   *                           kernels loads them once. load() skips furnished kernels.
    */
   class Spice {
     public:
@@ -336,6 +341,9 @@ namespace Isis {
       PvlObject getStoredNaifKeywords() const;
       virtual double resolution();
 
+      static void furnishKernels(const QStringList &kernels);
+      static void unloadFurnishedKernels();
+
     protected:
       /**
        * NAIF value primitive type
@@ -383,6 +391,7 @@ namespace Isis {
       void init(Pvl &lab, bool noTables);
 
       void load(PvlKeyword &key, bool notab);
+      static QStringList &furnishedKernels();
       void computeSolarLongitude(iTime et);
 
       Longitude *m_solarLongitude; //!< Body rotation solar longitude value
@@ -15,6 +15,7 @@
 #include "NaifStatus.h"
 #include "NumericalApproximation.h"
 #include "PolynomialUnivariate.h"
+#include "Table.h"
 #include "TableField.h"
 
 namespace Isis {
@@ -357,6 +358,8 @@ namespace Isis {
    *   @history 2011-01-05 Debbie A. Cook - Added PolyFunction type
    *   @history 2011-04-08 Debbie A. Cook - Corrected loop counter in
    *            PolyFunction section to only go up to table.Records() - 1
+   *   @history 2018-09-07 Isis Development Team - Reads the fields of the
+   *            table as columns instead of unpacking each record.
    *
    */
   void SpicePosition::LoadCache(Table &table) {
@@ -401,59 +404,69 @@ namespace Isis {
                        _FILEINFO_);
     }
 
+    if (table.Records() == 0) {
+      return;
+    }
+
+    // Read each field of every record as a column instead of unpacking the
+    //   records one at a time
+    TableRecord &layout = table[0];
+    std::vector< TableColumn<double> > columns;
+    for (int f = 0; f < layout.Fields(); f++) {
+      columns.push_back(table.DoubleColumn(layout[f].name()));
+    }
+
     // Loop through and move the table to the cache
     if (p_source != PolyFunction) {
-      for (int r = 0; r < table.Records(); r++) {
-        TableRecord &rec = table[r];
-        if (rec.Fields() == 7) {
-          p_hasVelocity = true;
-        }
-        else if (rec.Fields() == 4) {
-          p_hasVelocity = false;
-        }
-        else  {
-          QString msg = "Expecting four or seven fields in the SpicePosition table";
-          throw IException(IException::Programmer, msg, _FILEINFO_);
-        }
+      if (columns.size() == 7) {
+        p_hasVelocity = true;
+      }
+      else if (columns.size() == 4) {
+        p_hasVelocity = false;
+      }
+      else  {
+        QString msg = "Expecting four or seven fields in the SpicePosition table";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+      int inext = p_hasVelocity ? 6 : 3;
 
+      for (int r = 0; r < table.Records(); r++) {
         std::vector<double> j2000Coord;
-        j2000Coord.push_back((double)rec[0]);
-        j2000Coord.push_back((double)rec[1]);
-        j2000Coord.push_back((double)rec[2]);
-        int inext = 3;
+        j2000Coord.push_back(columns[0][r]);
+        j2000Coord.push_back(columns[1][r]);
+        j2000Coord.push_back(columns[2][r]);
 
         p_cache.push_back(j2000Coord);
         if (p_hasVelocity) {
           std::vector<double> j2000Velocity;
-          j2000Velocity.push_back((double)rec[3]);
-          j2000Velocity.push_back((double)rec[4]);
-          j2000Velocity.push_back((double)rec[5]);
-          inext = 6;
+          j2000Velocity.push_back(columns[3][r]);
+          j2000Velocity.push_back(columns[4][r]);
+          j2000Velocity.push_back(columns[5][r]);
 
           p_cacheVelocity.push_back(j2000Velocity);
         }
-        p_cacheTime.push_back((double)rec[inext]);
+        p_cacheTime.push_back(columns[inext][r]);
       }
     }
     else {
       // Coefficient table for postion coordinates x, y, and z
       std::vector<double> coeffX, coeffY, coeffZ;
 
-      for (int r = 0; r < table.Records() - 1; r++) {
-        TableRecord &rec = table[r];
+      if (columns.size() != 3) {
+        QString msg = "Expecting three fields in the SpicePosition coefficient table";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
 
-        if(rec.Fields() != 3) {
-          // throw an error
-        }
-        coeffX.push_back((double)rec[0]);
-        coeffY.push_back((double)rec[1]);
-        coeffZ.push_back((double)rec[2]);
+      for (int r = 0; r < table.Records() - 1; r++) {
+        coeffX.push_back(columns[0][r]);
+        coeffY.push_back(columns[1][r]);
+        coeffZ.push_back(columns[2][r]);
       }
       // Take care of function time parameters
-      TableRecord &rec = table[table.Records()-1];
-      double baseTime = (double)rec[0];
-      double timeScale = (double)rec[1];
-      double degree = (double)rec[2];
+      int last = table.Records() - 1;
+      double baseTime = columns[0][last];
+      double timeScale = columns[1][last];
+      double degree = columns[2][last];
       SetPolynomialDegree((int) degree);
       SetOverrideBaseTime(baseTime, timeScale);
       SetPolynomial(coeffX, coeffY, coeffZ);
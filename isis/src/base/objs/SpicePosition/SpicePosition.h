@@ -179,6 +179,8 @@ namespace Isis {
    *   @history 2017-08-18 Tyler Wilson, Summer Stapleton, Ian Humphrey -  Added opening/closing brackets
    *                           to SetEphemerisTimePolyFunction() so this class compiles without warnings
    *                           under C++14. References #4809.   
+   *   @history 2018-09-07 Isis Development Team - LoadCache(Table) reads the fields of the
+   *                           table as columns instead of unpacking each record.
    */
   class SpicePosition {
     public:
@@ -488,30 +488,28 @@ namespace Isis {
       loadPCFromTable(table.Label());
     }
 
-    int recFields = table[0].Fields();
-
-    // Loop through and move the table to the cache.  Retrieve the first record to
-    // establish the type of cache and then use the appropriate loop.
+    // Read each field of every record as a column instead of unpacking the
+    //   records one at a time. The first record establishes the type of cache.
+    TableRecord &layout = table[0];
+    int recFields = layout.Fields();
+    std::vector< TableColumn<double> > columns;
+    for (int f = 0; f < recFields; f++) {
+      columns.push_back(table.DoubleColumn(layout[f].name()));
+    }
 
     // list table of quaternion and time
     if (recFields == 5) {
       for (int r = 0; r < table.Records(); r++) {
-        TableRecord &rec = table[r];
-
-        if (rec.Fields() != recFields) {
-          // throw and error
-        }
-
         std::vector<double> j2000Quat;
-        j2000Quat.push_back((double)rec[0]);
-        j2000Quat.push_back((double)rec[1]);
-        j2000Quat.push_back((double)rec[2]);
-        j2000Quat.push_back((double)rec[3]);
+        j2000Quat.push_back(columns[0][r]);
+        j2000Quat.push_back(columns[1][r]);
+        j2000Quat.push_back(columns[2][r]);
+        j2000Quat.push_back(columns[3][r]);
 
         Quaternion q(j2000Quat);
         std::vector<double> CJ = q.ToMatrix();
         p_cache.push_back(CJ);
-        p_cacheTime.push_back((double)rec[4]);
+        p_cacheTime.push_back(columns[4][r]);
       }
       p_source = Memcache;
     }
@@ -519,17 +517,11 @@ namespace Isis {
     // list table of quaternion, angular velocity vector, and time
     else if (recFields == 8) {
       for (int r = 0; r < table.Records(); r++) {
-        TableRecord &rec = table[r];
-
-        if (rec.Fields() != recFields) {
-          // throw and error
-        }
-
         std::vector<double> j2000Quat;
-        j2000Quat.push_back((double)rec[0]);
-        j2000Quat.push_back((double)rec[1]);
-        j2000Quat.push_back((double)rec[2]);
-        j2000Quat.push_back((double)rec[3]);
+        j2000Quat.push_back(columns[0][r]);
+        j2000Quat.push_back(columns[1][r]);
+        j2000Quat.push_back(columns[2][r]);
+        j2000Quat.push_back(columns[3][r]);
 
 
         Quaternion q(j2000Quat);
@@ -537,12 +529,12 @@ namespace Isis {
         p_cache.push_back(CJ);
 
         std::vector<double> av;
-        av.push_back((double)rec[4]);
-        av.push_back((double)rec[5]);
-        av.push_back((double)rec[6]);
+        av.push_back(columns[4][r]);
+        av.push_back(columns[5][r]);
+        av.push_back(columns[6][r]);
         p_cacheAv.push_back(av);
 
-        p_cacheTime.push_back((double)rec[7]);
+        p_cacheTime.push_back(columns[7][r]);
         p_hasAngularVelocity = true;
       }
       p_source = Memcache;
@@ -553,21 +545,16 @@ namespace Isis {
       std::vector<double> coeffAng1, coeffAng2, coeffAng3;
 
       for (int r = 0; r < table.Records() - 1; r++) {
-        TableRecord &rec = table[r];
-
-        if (rec.Fields() != recFields) {
-          // throw an error
-        }
-        coeffAng1.push_back((double)rec[0]);
-        coeffAng2.push_back((double)rec[1]);
-        coeffAng3.push_back((double)rec[2]);
+        coeffAng1.push_back(columns[0][r]);
+        coeffAng2.push_back(columns[1][r]);
+        coeffAng3.push_back(columns[2][r]);
       }
 
       // Take care of time parameters
-      TableRecord &rec = table[table.Records()-1];
-      double baseTime = (double)rec[0];
-      double timeScale = (double)rec[1];
-      double degree = (double)rec[2];
+      int last = table.Records() - 1;
+      double baseTime = columns[0][last];
+      double timeScale = columns[1][last];
+      double degree = columns[2][last];
       SetPolynomialDegree((int) degree);
       SetOverrideBaseTime(baseTime, timeScale);
       SetPolynomial(coeffAng1, coeffAng2, coeffAng3);
@@ -209,6 +209,8 @@ namespace Isis {
    *   @history 2017-12-13 Ken Edmundson - Added "case DYN:" to methods ToReferencePartial and toJ2000Partial. Fixes #5251.
    *                           This problem was found when trying to bundle M3 images that had been spiceinited with nadir
    *                           pointing. The nadir frame is defined as a Dynamic Frame by Naif.
+   *   @history 2018-09-07 Isis Development Team - LoadCache(Table) reads the fields of the
+   *                           table as columns instead of unpacking each record.
    *
    *  @todo Downsize using Hermite cubic spline and allow Nadir tables to be downsized again.
    *  @todo Consider making this a base class with child classes based on frame type or 
@@ -265,6 +265,37 @@ namespace Isis {
   }
 
 
+  /**
+   * Adds the accumulators and counters of another Statistics object to this
+   * one, so data sets can be split up, gathered separately and merged. The
+   * counts, minimum and maximum are the same as if the other object's data had
+   * been added to this one. The sums are not bit-identical: each object sums
+   * its own data first, so the rounding differs and the average, variance and
+   * related values can differ in the last bits. Both objects should use the
+   * same valid range; the valid range of this object is kept.
+   *
+   * @param other The statistics to merge into this object
+   */
+  void Statistics::Merge(const Statistics &other) {
+    m_sum += other.m_sum;
+    m_sumsum += other.m_sumsum;
+    if (other.m_validPixels > 0) {
+      if (other.m_minimum < m_minimum) m_minimum = other.m_minimum;
+      if (other.m_maximum > m_maximum) m_maximum = other.m_maximum;
+    }
+    m_totalPixels += other.m_totalPixels;
+    m_validPixels += other.m_validPixels;
+    m_nullPixels += other.m_nullPixels;
+    m_lrsPixels += other.m_lrsPixels;
+    m_lisPixels += other.m_lisPixels;
+    m_hrsPixels += other.m_hrsPixels;
+    m_hisPixels += other.m_hisPixels;
+    m_underRangePixels += other.m_underRangePixels;
+    m_overRangePixels += other.m_overRangePixels;
+    m_removedData = m_removedData || other.m_removedData;
+  }
+
+
   void Statistics::SetValidRange(const double minimum, const double maximum) {
     m_validMinimum = minimum;
     m_validMaximum = maximum;
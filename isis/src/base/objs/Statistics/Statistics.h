@@ -98,6 +98,9 @@ namespace Isis {
    *                           Statistics serialization/unserialization. References #2282.
    *   @history 2017-04-20 Makayla Shepherd - Removed the hdf5 code because we are using XML for
    *                           serialization. Fixes #4795.
+   *   @history 2018-09-07 Isis Development Team - Added Merge() so statistics gathered on
+   *                           separate pieces of a data set, for example by separate threads,
+   *                           can be combined.
    *
    *   @todo 2005-02-07 Deborah Lee Soltesz - add example using cube data to the class documentation
    *   @todo 2015-08-13 Jeannie Backer - Clean up header and implementation files once
@@ -123,6 +126,8 @@ namespace Isis {
       void RemoveData(const double *data, const unsigned int count);
       void RemoveData(const double data);
 
+      void Merge(const Statistics &other);
+
       void SetValidRange(const double minimum = Isis::ValidMinimum,
                          const double maximum = Isis::ValidMaximum);
 
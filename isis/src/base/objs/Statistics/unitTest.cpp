@@ -441,6 +441,31 @@ int main(int argc, char *argv[]) {
     qDebug() << "Z-Score at 1.0       " << statsFromEmptyXml.ZScore(1.0);
     qDebug() << "";
 
+    qDebug() << "Testing Merge of AddData(1, 2, 3, Null, HRS) and AddData(LRS, HIS, LIS, 10, -1)";
+    Statistics firstHalf;
+    firstHalf.SetValidRange(1, 6);
+    firstHalf.AddData(a, 5);
+    Statistics secondHalf;
+    secondHalf.SetValidRange(1, 6);
+    secondHalf.AddData(&a[5], 5);
+    firstHalf.Merge(secondHalf);
+    qDebug() << "Average:             " << firstHalf.Average();
+    qDebug() << "Variance:            " << firstHalf.Variance();
+    qDebug() << "Minimum:             " << firstHalf.Minimum();
+    qDebug() << "Maximum:             " << firstHalf.Maximum();
+    qDebug() << "Total Pixels:        " << firstHalf.TotalPixels();
+    qDebug() << "Valid Pixels:        " << firstHalf.ValidPixels();
+    qDebug() << "Null Pixels:         " << firstHalf.NullPixels();
+    qDebug() << "Lis Pixels:          " << firstHalf.LisPixels();
+    qDebug() << "Lrs Pixels:          " << firstHalf.LrsPixels();
+    qDebug() << "His Pixels:          " << firstHalf.HisPixels();
+    qDebug() << "Hrs Pixels:          " << firstHalf.HrsPixels();
+    qDebug() << "Over Range Pixels:   " << firstHalf.OverRangePixels();
+    qDebug() << "Under Range Pixels:  " << firstHalf.UnderRangePixels();
+    qDebug() << "Sum:                 " << firstHalf.Sum();
+    qDebug() << "SumSquare:           " << firstHalf.SumSquare();
+    qDebug() << "";
+
     qDebug() << "Testing error throws...";
     try {
       // You are removing non-existant data in [Statistics::RemoveData]
@@ -0,0 +1,159 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "StretchKernel.h"
+
+#include <QScopedPointer>
+#include <QStringList>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "FileName.h"
+#include "Histogram.h"
+#include "PvlKeyword.h"
+#include "SpecialPixel.h"
+#include "TextFile.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the pairs, read from INPUTFILE if READFILE is true
+   * and from PAIRS otherwise, and from the special pixel mappings. Pairs of
+   * percentages are parsed once the input cube is known.
+   *
+   * @param parameters The parameters of the run
+   */
+  StretchKernel::StretchKernel(const QMap<QString, QString> &parameters) {
+    if (BooleanParameter(parameters, "READFILE", false)) {
+      TextFile pairsFile;
+      pairsFile.SetComment("#");
+      pairsFile.Open(FileName(parameters["INPUTFILE"]).expanded());
+
+      // concat all non-comment lines into one string
+      QString line = "";
+      while (pairsFile.GetLine(line, true)) {
+        m_pairs += " " + line;
+      }
+      m_pairs += line;
+    }
+    else if (parameters.contains("PAIRS")) {
+      m_pairs = parameters["PAIRS"];
+    }
+
+    QStringList specialPixels;
+    specialPixels << "NULL" << "LIS" << "LRS" << "HIS" << "HRS";
+    foreach (QString specialPixel, specialPixels) {
+      if (parameters.contains(specialPixel)) {
+        m_specialPixels[specialPixel] = parameters[specialPixel];
+      }
+    }
+
+    m_usePercentages = BooleanParameter(parameters, "USEPERCENTAGES", false);
+    if (!m_usePercentages) {
+      m_stretch.Parse(m_pairs);
+      setSpecialPixels();
+    }
+  }
+
+
+  //! Destroys the StretchKernel
+  StretchKernel::~StretchKernel() {
+  }
+
+
+  /**
+   * Returns true if the pairs are percentages of the input histogram.
+   *
+   * @return bool True if Prepare() reads the input pixels
+   */
+  bool StretchKernel::PrepareReadsPixels() const {
+    return m_usePercentages;
+  }
+
+
+  /**
+   * Parses pairs of percentages with the histogram of the input cube.
+   *
+   * @param input The input cube
+   */
+  void StretchKernel::Prepare(Cube &input) {
+    if (m_usePercentages) {
+      QScopedPointer<Histogram> histogram(input.histogram());
+      m_stretch.Parse(m_pairs, histogram.data());
+      setSpecialPixels();
+    }
+  }
+
+
+  /**
+   * Stretches the pixels of a line.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void StretchKernel::Apply(Buffer &in, Buffer &out) const {
+    for (int i = 0; i < in.size(); i++) {
+      out[i] = m_stretch.Map(in[i]);
+    }
+  }
+
+
+  /**
+   * Returns the stretch pairs as input and output values.
+   *
+   * @return PvlGroup The results
+   */
+  PvlGroup StretchKernel::Results() const {
+    PvlKeyword dnPairs("StretchPairs");
+    dnPairs.addValue(m_stretch.Text());
+
+    PvlGroup results("Results");
+    results.addKeyword(dnPairs);
+    return results;
+  }
+
+
+  //! Sets the given special pixel mappings, which parsing resets
+  void StretchKernel::setSpecialPixels() {
+    if (m_specialPixels.contains("NULL"))
+      m_stretch.SetNull(StringToPixel(m_specialPixels["NULL"]));
+    if (m_specialPixels.contains("LIS"))
+      m_stretch.SetLis(StringToPixel(m_specialPixels["LIS"]));
+    if (m_specialPixels.contains("LRS"))
+      m_stretch.SetLrs(StringToPixel(m_specialPixels["LRS"]));
+    if (m_specialPixels.contains("HIS"))
+      m_stretch.SetHis(StringToPixel(m_specialPixels["HIS"]));
+    if (m_specialPixels.contains("HRS"))
+      m_stretch.SetHrs(StringToPixel(m_specialPixels["HRS"]));
+  }
+}
+
+
+/**
+ * Creates a stretch kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *StretchKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::StretchKernel(parameters);
+}
@@ -0,0 +1,68 @@
+#ifndef StretchKernel_h
+#define StretchKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QMap>
+#include <QString>
+
+#include "PixelKernel.h"
+#include "Stretch.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the stretch program
+   *
+   * This kernel maps pixels through the line segments between pairs of input
+   * and output values.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin.
+   */
+  class StretchKernel : public PixelKernel {
+    public:
+      StretchKernel(const QMap<QString, QString> &parameters);
+      ~StretchKernel();
+
+      bool PrepareReadsPixels() const;
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+      PvlGroup Results() const;
+
+    private:
+      void setSpecialPixels();
+
+      Stretch m_stretch;     //!< The stretch
+      QString m_pairs;       //!< The pairs as given
+      bool m_usePercentages; //!< True if the input values are percentages
+      //! The special pixel mappings given, keyed by parameter name
+      QMap<QString, QString> m_specialPixels;
+  };
+};
+
+#endif
@@ -54,6 +54,7 @@ namespace Isis {
   Table::Table(const QString &tableName, Isis::TableRecord &rec) :
     Blob(tableName, "Table") {
     p_assoc = Table::None;
+    p_swap = false;
     p_blobPvl += Isis::PvlKeyword("Records", 0);
     p_blobPvl += Isis::PvlKeyword("ByteOrder", "NULL");
     for (int f = 0; f < rec.Fields(); f++) p_blobPvl.addGroup(rec[f].pvlGroup());
@@ -75,6 +76,7 @@ namespace Isis {
   Table::Table(const QString &tableName) :
     Isis::Blob(tableName, "Table") {
     p_assoc = Table::None;
+    p_swap = false;
   }
 
   /**
@@ -94,6 +96,7 @@ namespace Isis {
   Table::Table(const QString &tableName, const QString &file) :
     Blob(tableName, "Table") {
     p_assoc = Table::None;
+    p_swap = false;
     Read(file);
   }
 
@@ -115,6 +118,7 @@ namespace Isis {
   Table::Table(const QString &tableName, const QString &file,
       const Pvl &fileHeader) : Blob(tableName, "Table") {
     p_assoc = Table::None;
+    p_swap = false;
     Read(file, fileHeader);
   }
 
@@ -130,16 +134,7 @@ namespace Isis {
     p_records = other.p_records;
     p_assoc = other.p_assoc;
     p_swap = other.p_swap;
-
-    for (unsigned int i = 0; i < other.p_recbufs.size(); i++) {
-      char *data = new char[RecordSize()];
-
-      for (int j = 0; j < RecordSize(); j++) {
-        data[j] = other.p_recbufs[i][j];
-      }
-
-      p_recbufs.push_back(data);
-    }
+    p_data = other.p_data;
   }
 
   /**
@@ -158,16 +153,7 @@ namespace Isis {
     p_records = other.p_records;
     p_assoc = other.p_assoc;
     p_swap = other.p_swap;
-
-    for (unsigned int i = 0; i < other.p_recbufs.size(); i++) {
-      char *data = new char[RecordSize()];
-
-      for (int j = 0; j < RecordSize(); j++) {
-        data[j] = other.p_recbufs[i][j];
-      }
-
-      p_recbufs.push_back(data);
-    }
+    p_data = other.p_data;
 
     return *this;
   }
@@ -222,7 +208,8 @@ namespace Isis {
    * @return @b int Number of records
    */
   int Table::Records() const {
-    return p_recbufs.size();
+    if (RecordSize() == 0) return 0;
+    return p_data.size() / RecordSize();
   }
 
   /**
@@ -251,10 +238,65 @@ namespace Isis {
    * @return Returns the TableRecord at specific index
    */
   Isis::TableRecord &Table::operator[](const int index) {
-    p_record.Unpack(p_recbufs[index]);
+    if (p_swap) SwapData();
+    p_record.Unpack(&p_data[(size_t)index * RecordSize()]);
     return p_record;
   }
 
+
+  /**
+   * Returns the index of a field in the records of the table.
+   *
+   * @param name The name of the field
+   *
+   * @return @b int Index of the field, or -1 if there is no field with the name
+   */
+  int Table::FieldIndex(const QString &name) {
+    for (int f = 0; f < p_record.Fields(); f++) {
+      if (p_record[f].name().toUpper() == name.toUpper()) return f;
+    }
+    return -1;
+  }
+
+
+  /**
+   * Returns a view of an Integer field of every record.
+   *
+   * @param name The name of the field
+   *
+   * @return @b TableColumn<int> The values of the field
+   */
+  TableColumn<int> Table::IntegerColumn(const QString &name) {
+    int offset = FieldOffset(name, TableField::Integer);
+    return TableColumn<int>(*this, offset, p_record[name].size());
+  }
+
+
+  /**
+   * Returns a view of a Double field of every record.
+   *
+   * @param name The name of the field
+   *
+   * @return @b TableColumn<double> The values of the field
+   */
+  TableColumn<double> Table::DoubleColumn(const QString &name) {
+    int offset = FieldOffset(name, TableField::Double);
+    return TableColumn<double>(*this, offset, p_record[name].size());
+  }
+
+
+  /**
+   * Returns a view of a Real field of every record.
+   *
+   * @param name The name of the field
+   *
+   * @return @b TableColumn<float> The values of the field
+   */
+  TableColumn<float> Table::RealColumn(const QString &name) {
+    int offset = FieldOffset(name, TableField::Real);
+    return TableColumn<float>(*this, offset, p_record[name].size());
+  }
+
   /**
    * Adds a TableRecord to the Table
    *
@@ -274,9 +316,10 @@ namespace Isis {
                      + Isis::toString(RecordSize()) + " bytes]. Record sizes must match.";
        throw IException(IException::Unknown, msg, _FILEINFO_);
      }
-    char *newbuf = new char[RecordSize()];
-    rec.Pack(newbuf);
-    p_recbufs.push_back(newbuf);
+    if (p_swap) SwapData();
+    size_t sbyte = p_data.size();
+    p_data.resize(sbyte + RecordSize());
+    rec.Pack(&p_data[sbyte]);
   }
 
   /**
@@ -286,7 +329,8 @@ namespace Isis {
    * @param index Index of TableRecord to be updated
    */
   void Table::Update(const Isis::TableRecord &rec, const int index) {
-    rec.Pack(p_recbufs[index]);
+    if (p_swap) SwapData();
+    rec.Pack(&p_data[(size_t)index * RecordSize()]);
   }
 
   /**
@@ -295,18 +339,15 @@ namespace Isis {
    * @param index Index of TableRecord to be deleted
    */
   void Table::Delete(const int index) {
-    vector<char *>::iterator it = p_recbufs.begin();
-    for (int i = 0; i < index; i++, it++);
-    delete [] p_recbufs[index];
-    p_recbufs.erase(it);
+    vector<char>::iterator it = p_data.begin() + (size_t)index * RecordSize();
+    p_data.erase(it, it + RecordSize());
   }
 
   /**
    * Clear the table of all records
    */
   void Table::Clear() {
-    for (int i = 0; i < (int)p_recbufs.size(); i++) delete [] p_recbufs[i];
-    p_recbufs.clear();
+    p_data.clear();
   }
 
   //! Virtual function to validate PVL table information
@@ -349,27 +390,104 @@ namespace Isis {
    * @throws Isis::IException::Io - Error reading or preparing to read a record
    */
   void Table::ReadData(std::istream &stream) {
-    for (int rec = 0; rec < p_records; rec++) {
-      streampos sbyte = (streampos)(p_startByte - 1) +
-                        (streampos)(rec * RecordSize());
-      stream.seekg(sbyte, std::ios::beg);
-      if (!stream.good()) {
-        QString msg = "Error preparing to read record [" + Isis::toString(rec + 1) + 
-                     "] from Table [" + p_blobName + "]";
-        throw IException(IException::Io, msg, _FILEINFO_);
+    // The records are stored one after another, so read them all at once. The
+    // bytes are swapped when a record is first accessed.
+    if (p_records <= 0 || RecordSize() == 0) return;
+
+    streampos sbyte = (streampos)(p_startByte - 1);
+    stream.seekg(sbyte, std::ios::beg);
+    if (!stream.good()) {
+      QString msg = "Error preparing to read record [1] from Table [" + p_blobName + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    p_data.resize((size_t)p_records * RecordSize());
+    stream.read(&p_data[0], p_data.size());
+    if (!stream.good()) {
+      int records = stream.gcount() / RecordSize();
+      p_data.clear();
+      QString msg = "Error reading record [" + Isis::toString(records + 1) +
+                    "] from Table [" + p_blobName + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Swaps the bytes of every record read from a file with a different byte
+   * order. The byte offset and size of each value is found once for the record
+   * layout and then applied to every record.
+   *
+   * @throws Isis::IException::Programmer - Invalid field type
+   */
+  void Table::SwapData() {
+    vector<int> offsets;
+    vector<int> sizes;
+    int sbyte = 0;
+    for (int f = 0; f < p_record.Fields(); f++) {
+      TableField &field = p_record[f];
+      if (field.isText()) {
+        sbyte += field.bytes();
+        continue;
+      }
+      if (!field.isDouble() && !field.isInteger() && !field.isReal()) {
+        QString msg = "Unable to swap bytes. Invalid field type";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
       }
 
-      char *buf = new char[RecordSize()];
-      stream.read(buf, RecordSize());
-      if (!stream.good()) {
-        QString msg = "Error reading record [" + Isis::toString(rec + 1) + 
-                      "] from Table [" + p_blobName + "]";
-        throw IException(IException::Io, msg, _FILEINFO_);
+      int valueSize = field.bytes() / field.size();
+      for (int i = 0; i < field.size(); i++) {
+        offsets.push_back(sbyte);
+        sizes.push_back(valueSize);
+        sbyte += valueSize;
       }
+    }
 
-      if (p_swap) p_record.Swap(buf);
-      p_recbufs.push_back(buf);
+    for (size_t rec = 0; rec < p_data.size(); rec += RecordSize()) {
+      char *buf = &p_data[rec];
+      for (unsigned int v = 0; v < offsets.size(); v++) {
+        char *swap = buf + offsets[v];
+        for (int i = 0, j = sizes[v] - 1; i < j; i++, j--) {
+          char temp = swap[i];
+          swap[i] = swap[j];
+          swap[j] = temp;
+        }
+      }
     }
+
+    p_swap = false;
+  }
+
+
+  /**
+   * Returns the byte offset of a field in the records of the table.
+   *
+   * @param name The name of the field
+   * @param type The type the field must have
+   *
+   * @return @b int The byte offset of the field
+   *
+   * @throws Isis::IException::Programmer - The field does not exist
+   * @throws Isis::IException::Programmer - The field has a different type
+   */
+  int Table::FieldOffset(const QString &name, TableField::Type type) {
+    int index = FieldIndex(name);
+    if (index < 0) {
+      QString msg = "Field [" + name + "] does not exist in Table [" + p_blobName + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    if (p_record[index].type() != type) {
+      QString msg = "Field [" + name + "] in Table [" + p_blobName +
+                    "] does not have the requested type";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    int offset = 0;
+    for (int f = 0; f < index; f++) {
+      offset += p_record[f].bytes();
+    }
+    return offset;
   }
 
   //! Virtual Function to prepare labels for writing
@@ -404,9 +522,8 @@ namespace Isis {
    * @param os Outputstream to write the data to
    */
   void Table::WriteData(std::fstream &os) {
-    for (int rec = 0; rec < Records(); rec++) {
-      os.write(p_recbufs[rec], RecordSize());
-    }
+    if (p_swap) SwapData();
+    if (p_data.size() > 0) os.write(&p_data[0], p_data.size());
   }
 
 
@@ -23,11 +23,50 @@
  */
 
 #include "Blob.h"
+
+#include <cstring>
 #include <vector>
+
 #include "TableRecord.h"
 
 namespace Isis {
   class Pvl;
+  class Table;
+
+  /**
+   * @brief A typed view of one field of every record in a Table.
+   *
+   * A TableColumn reads the values of one Integer, Double or Real field
+   * directly out of the record data of a Table without unpacking the records
+   * into TableField objects. If the table was read from a file with a
+   * different byte order, the values are swapped as they are read.
+   *
+   * A column refers to its table, so it must not outlive it. Records added
+   * to or deleted from the table are seen by the column.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   */
+  template <typename T> class TableColumn {
+    public:
+      TableColumn(const Table &table, int offset, int size);
+
+      int Records() const;
+      int Size() const;
+
+      T operator[](const int record) const;
+      T Value(const int record, const int index = 0) const;
+      std::vector<T> Values(const int index = 0) const;
+
+    private:
+      const Table *m_table; //!< The table the column reads from
+      int m_offset;         //!< Byte offset of the field in each record
+      int m_size;           //!< Number of values in the field
+  };
+
   /**
    * @brief Class for storing Table blobs information.
    *
@@ -70,6 +109,10 @@ namespace Isis {
    *   @history 2015-10-04 Jeannie Backer Improved coding standards. Uncommented error throw for
    *                           operator+=(record) that verifies that the record sizes match.
    *                           References #1178
+   *   @history 2018-09-07 Isis Development Team - Records are now stored in one contiguous buffer
+   *                           that is read from the file in a single read. Byte swapping is
+   *                           deferred until a record is accessed, and the new TableColumn
+   *                           accessors read field values without unpacking records.
    */
   class Table : public Isis::Blob {
     public:
@@ -110,6 +153,12 @@ namespace Isis {
       // Read a record
       TableRecord &operator[](const int index);
 
+      // Read a field of every record
+      int FieldIndex(const QString &name);
+      TableColumn<int> IntegerColumn(const QString &name);
+      TableColumn<double> DoubleColumn(const QString &name);
+      TableColumn<float> RealColumn(const QString &name);
+
       // Add a record
       void operator+=(TableRecord &rec);
 
@@ -130,15 +179,114 @@ namespace Isis {
       void WriteInit();
       void WriteData(std::fstream &os);
 
-      TableRecord p_record;          //!< The current table record
-      std::vector<char *> p_recbufs; //!< Buffers containing record values
+      void SwapData();
+      int FieldOffset(const QString &name, TableField::Type type);
+
+      TableRecord p_record;      //!< The current table record
+      std::vector<char> p_data;  //!< The values of every record, one after another
 
       int p_records; /**< Holds record count read from labels, may differ from
-                         the size of p_recbufs.*/
+                         the number of records in p_data.*/
 
       Association p_assoc; //!< Association Type of the table
-      bool p_swap;         //!< Only used for reading
+      bool p_swap;         /**< True if p_data is still in the byte order of
+                                the file it was read from.*/
+
+      template <typename T> friend class TableColumn;
   };
+
+
+  /**
+   * Constructs a column that reads a field of a table.
+   *
+   * @param table The table to read from
+   * @param offset The byte offset of the field in each record
+   * @param size The number of values in the field
+   */
+  template <typename T>
+  TableColumn<T>::TableColumn(const Table &table, int offset, int size) {
+    m_table = &table;
+    m_offset = offset;
+    m_size = size;
+  }
+
+
+  /**
+   * Returns the number of records in the table.
+   *
+   * @return @b int Number of records
+   */
+  template <typename T>
+  int TableColumn<T>::Records() const {
+    return m_table->Records();
+  }
+
+
+  /**
+   * Returns the number of values in the field of each record.
+   *
+   * @return @b int Number of values per record
+   */
+  template <typename T>
+  int TableColumn<T>::Size() const {
+    return m_size;
+  }
+
+
+  /**
+   * Returns the first value of the field in a record.
+   *
+   * @param record Index of the record
+   *
+   * @return @b T The value
+   */
+  template <typename T>
+  T TableColumn<T>::operator[](const int record) const {
+    return Value(record, 0);
+  }
+
+
+  /**
+   * Returns a value of the field in a record.
+   *
+   * @param record Index of the record
+   * @param index Index of the value in the field
+   *
+   * @return @b T The value
+   */
+  template <typename T>
+  T TableColumn<T>::Value(const int record, const int index) const {
+    const char *source = &m_table->p_data[(size_t)record * m_table->RecordSize() +
+                                          m_offset + index * sizeof(T)];
+    T value;
+    if (m_table->p_swap) {
+      char *dest = (char *) &value;
+      for (unsigned int i = 0; i < sizeof(T); i++) {
+        dest[i] = source[sizeof(T) - 1 - i];
+      }
+    }
+    else {
+      memcpy(&value, source, sizeof(T));
+    }
+    return value;
+  }
+
+
+  /**
+   * Returns a value of the field in every record.
+   *
+   * @param index Index of the value in the field
+   *
+   * @return @b std::vector<T> The value of each record
+   */
+  template <typename T>
+  std::vector<T> TableColumn<T>::Values(const int index) const {
+    std::vector<T> values(Records());
+    for (int record = 0; record < (int) values.size(); record++) {
+      values[record] = Value(record, index);
+    }
+    return values;
+  }
 };
 
 #endif
@@ -144,6 +144,22 @@ int main(int argc, char *argv[]) {
     }
     cout << endl;
 
+    cout << "Testing column accessors..." << endl;
+    TableColumn<int> column1 = t2.IntegerColumn("Column1");
+    TableColumn<double> column4 = t2.DoubleColumn("column4");
+    cout << "Column1 = ";
+    for (int i = 0; i < column1.Records(); i++) {
+      cout << column1[i] << "\t";
+    }
+    cout << endl;
+    cout << "Column4 = ";
+    vector<double> column4Values = column4.Values();
+    for (unsigned int i = 0; i < column4Values.size(); i++) {
+      cout << column4Values[i] << "\t";
+    }
+    cout << endl;
+    cout << "Index of Column3 = " << t2.FieldIndex("Column3") << endl << endl;
+
     cout << "Testing Clear  method..." << endl;
     t4.Clear();
     cout << "Number of Records = " << t4.Records() << endl;
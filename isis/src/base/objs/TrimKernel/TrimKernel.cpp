@@ -0,0 +1,111 @@
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "TrimKernel.h"
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "IException.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+  /**
+   * Creates the kernel from the TOP, BOTTOM, LEFT and RIGHT parameters.
+   *
+   * @param parameters The parameters of the run
+   */
+  TrimKernel::TrimKernel(const QMap<QString, QString> &parameters) {
+    m_top = IntegerParameter(parameters, "TOP", 0);
+    m_bottom = IntegerParameter(parameters, "BOTTOM", 0);
+    m_left = IntegerParameter(parameters, "LEFT", 0);
+    m_right = IntegerParameter(parameters, "RIGHT", 0);
+    m_lastLine = 0;
+    m_lastSample = 0;
+  }
+
+
+  //! Destroys the TrimKernel
+  TrimKernel::~TrimKernel() {
+  }
+
+
+  /**
+   * Finds the last line and sample that are kept.
+   *
+   * @param input The input cube
+   */
+  void TrimKernel::Prepare(Cube &input) {
+    m_lastLine = input.lineCount() - m_bottom;
+    m_lastSample = input.sampleCount() - m_right;
+  }
+
+
+  /**
+   * Sets the trimmed pixels of a line to NULL and copies the rest.
+   *
+   * @param in The input pixels
+   * @param out The output pixels
+   */
+  void TrimKernel::Apply(Buffer &in, Buffer &out) const {
+    if (in.Line() <= m_top || in.Line() > m_lastLine) {
+      for (int i = 0; i < in.size(); i++) {
+        out[i] = NULL8;
+      }
+    }
+    else {
+      for (int i = 0; i < in.size(); i++) {
+        if (in.Sample(i) <= m_left || in.Sample(i) > m_lastSample) {
+          out[i] = NULL8;
+        }
+        else {
+          out[i] = in[i];
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Checks that something was trimmed. The output is written first, as it is
+   * by the trim program.
+   *
+   * @throws Isis::IException::User - Nothing was trimmed
+   */
+  void TrimKernel::Finish() const {
+    if (m_top == 0 && m_bottom == 0 && m_left == 0 && m_right == 0) {
+      QString message = "No trimming was done-output equals input file";
+      throw IException(IException::User, message, _FILEINFO_);
+    }
+  }
+}
+
+
+/**
+ * Creates a trim kernel.
+ *
+ * @param parameters The parameters of the run
+ *
+ * @return Isis::PixelKernel* The kernel
+ */
+extern "C" Isis::PixelKernel *TrimKernelPlugin(const QMap<QString, QString> &parameters) {
+  return new Isis::TrimKernel(parameters);
+}
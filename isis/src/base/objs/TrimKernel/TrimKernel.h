@@ -0,0 +1,63 @@
+#ifndef TrimKernel_h
+#define TrimKernel_h
+/**
+ * @file
+ * $Revision: 1.0 $
+ * $Date: 2018/09/07 00:00:00 $
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include "PixelKernel.h"
+
+namespace Isis {
+  /**
+   * @brief The pixel kernel of the trim program
+   *
+   * This kernel sets the pixels near the edges of the cube to NULL and copies
+   * the rest.
+   *
+   * @ingroup HighLevelCubeIO
+   *
+   * @author 2018-09-07 Isis Development Team
+   *
+   * @internal
+   *   @history 2018-09-07 Isis Development Team - Original version, moved out of
+   *                           PixelKernel into a plugin. Finish() now gives the
+   *                           error trim gives when nothing was trimmed.
+   */
+  class TrimKernel : public PixelKernel {
+    public:
+      TrimKernel(const QMap<QString, QString> &parameters);
+      ~TrimKernel();
+
+      void Prepare(Cube &input);
+      void Apply(Buffer &in, Buffer &out) const;
+      void Finish() const;
+
+    private:
+      int m_top;        //!< Lines trimmed from the top
+      int m_bottom;     //!< Lines trimmed from the bottom
+      int m_left;       //!< Samples trimmed from the left
+      int m_right;      //!< Samples trimmed from the right
+      int m_lastLine;   //!< Last line that is kept
+      int m_lastSample; //!< Last sample that is kept
+  };
+};
+
+#endif
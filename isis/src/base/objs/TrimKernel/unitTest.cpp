@@ -0,0 +1,83 @@
+#include <iostream>
+
+#include <QMap>
+#include <QString>
+
+#include "Cube.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+#include "TrimKernel.h"
+
+using namespace Isis;
+using namespace std;
+
+/**
+ * Applies a kernel to a line of ones and prints the null pixels and the sum of
+ * the other pixels of the output.
+ */
+void printLine(const PixelKernel &kernel, Cube &cube, int line) {
+  LineManager in(cube);
+  LineManager out(cube);
+  in.SetLine(line);
+  out.SetLine(line);
+  for (int i = 0; i < in.size(); i++) {
+    in[i] = 1.0;
+  }
+
+  kernel.Apply(in, out);
+
+  int nulls = 0;
+  double sum = 0.0;
+  for (int i = 0; i < out.size(); i++) {
+    if (IsNullPixel(out[i])) {
+      nulls++;
+    }
+    else {
+      sum += out[i];
+    }
+  }
+
+  cout << "Line " << line << ": null pixels = " << nulls
+       << ", sum of the other pixels = " << sum << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+  Preference::Preferences(true);
+
+  Cube cube;
+  cube.open("$base/testData/isisTruth.cub");
+  int lines = cube.lineCount();
+
+  cout << "Testing a trim kernel ..." << endl;
+  QMap<QString, QString> parameters;
+  parameters["TOP"] = "2";
+  parameters["BOTTOM"] = "3";
+  parameters["LEFT"] = "4";
+  parameters["RIGHT"] = "5";
+
+  TrimKernel trim(parameters);
+  trim.Prepare(cube);
+  printLine(trim, cube, 2);
+  printLine(trim, cube, 3);
+  printLine(trim, cube, lines - 3);
+  printLine(trim, cube, lines - 2);
+  trim.Finish();
+  cout << endl;
+
+  cout << "Testing a trim kernel that trims nothing ..." << endl;
+  TrimKernel none((QMap<QString, QString>()));
+  none.Prepare(cube);
+  printLine(none, cube, 1);
+  try {
+    none.Finish();
+  }
+  catch (IException &e) {
+    e.print();
+  }
+
+  cube.close();
+  return 0;
+}
@@ -59,6 +59,7 @@ namespace Isis {
     p_saveFile = "";
     p_abortOnError = true;
     p_parentId = 0;
+    p_daemonName = "";
 
     // Make sure the user has a .Isis and .Isis/history directory
     try {
@@ -113,6 +114,25 @@ namespace Isis {
   }
 
 
+  /**
+   * Clears the parameters and loads them from a new command line. This is
+   * used by a resident worker to load the command line of each run it is sent.
+   *
+   * @param argc Number of arguments on the command line
+   * @param argv[] Array of arguments
+   */
+  void UserInterface::SetCommandLine(int argc, char *argv[]) {
+    for (int k = 0; k < NumGroups(); k++) {
+      for (int j = 0; j < NumParams(k); j++) {
+        Clear( ParamName(k, j) );
+      }
+    }
+
+    p_daemonName = "";
+    loadCommandLine(argc, argv);
+  }
+
+
   /**
    * Clears the gui parameters and sets the batch list information at line i as
    * the new parameters
@@ -401,6 +421,7 @@ namespace Isis {
     options.push_back("-PREFERENCE");
     options.push_back("-LOG");
     options.push_back("-VERBOSE");
+    options.push_back("-DAEMON");
     options.push_back("-PID");
 
     bool usedDashLast = false;
@@ -475,6 +496,12 @@ namespace Isis {
       throw IException(IException::User, msg, _FILEINFO_);
     }
 
+    // A resident worker gets the parameters of each run when it is run
+    if ( p_daemonName != "" && (p_interactive || BatchListSize() != 0 || p_parentId != 0) ) {
+      QString msg = "-DAEMON cannot be used with -GUI, -BATCHLIST or -PID";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
     // Must use batchlist if using errorlist or onerror=continue
     if ( (BatchListSize() == 0) && (!p_abortOnError || p_errList != "") ) {
       QString msg = "-ERRLIST and -ONERROR=continue cannot be used without ";
@@ -797,6 +824,9 @@ namespace Isis {
     else if (name == "-PID") {
       p_parentId = toInt(value);
     }
+    else if (name == "-DAEMON") {
+      p_daemonName = value.isEmpty() ? QString("default") : value;
+    }
     else if (name == "-ERRLIST") {
       p_errList = value;
 
@@ -146,6 +146,8 @@ namespace Isis {
    *                           Added lacking [at]throws documentation to UserInterface.cpp.
    *   @history 2016-04-05 Jesse Mapel - Changed bad histroy file error message to reflect that
    *                           the history file could be for a different application. Fixes #2366
+   *   @history 2018-09-07 Isis Development Team - Added the -DAEMON reserved parameter and
+   *                           SetCommandLine() for runs sent to a resident worker.
    *                           
    */
 
@@ -191,6 +193,16 @@ namespace Isis {
       int ParentId() {
         return p_parentId;
       };  
+
+      /**
+       * Returns the name of the resident worker to run as, or an empty string
+       * if the program was not run with -DAEMON
+       *
+       * @return QString The worker name
+       */
+      QString DaemonName() {
+        return p_daemonName;
+      };
       
       /**
        * @return the Gui
@@ -203,6 +215,7 @@ namespace Isis {
       bool GetInfoFlag();
       
       void SetBatchList(int i);
+      void SetCommandLine(int argc, char *argv[]);
       void SetErrorList(int i);
       
       void SaveHistory();
@@ -224,6 +237,8 @@ namespace Isis {
 
       //! Boolean value representing whether to abort or continue on error.
       bool p_abortOnError;
+      //! Name of the resident worker to run as.
+      QString p_daemonName;
       //! Vector of batchlist data.
       std::vector<std::vector<QString> > p_batchList;
       //! This variable will contain argv.
@@ -44,7 +44,11 @@ using namespace Isis;
 void IsisMain() {
 
   UserInterface &ui = Application::GetUserInterface();
-  SerialNumberList serialNumbers(ui.GetFileName("FROMLIST"));
+  QString serialNumberCache = "";
+  if (ui.WasEntered("SNCACHE")) {
+    serialNumberCache = ui.GetFileName("SNCACHE");
+  }
+  SerialNumberList serialNumbers(ui.GetFileName("FROMLIST"), true, NULL, serialNumberCache);
 
   // Get the AutoSeed PVL internalized
   Pvl seedDef(ui.GetFileName("DEFFILE"));
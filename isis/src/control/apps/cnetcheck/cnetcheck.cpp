@@ -101,18 +101,27 @@ void IsisMain() {
   QVector<QString> listedSerialNumbers;
   SerialNumberList num2cube;
 
-  if (inlist.size() > 0) {
-    progress.SetText("Initializing");
-    progress.SetMaximumSteps(inlist.size());
-    progress.CheckStatus();
+  if (ui.WasEntered("SNCACHE")) {
+    num2cube = SerialNumberList(ui.GetFileName("FROMLIST"), true, &progress,
+                                ui.GetFileName("SNCACHE"));
   }
+  else {
+    if (inlist.size() > 0) {
+      progress.SetText("Initializing");
+      progress.SetMaximumSteps(inlist.size());
+      progress.CheckStatus();
+    }
 
-  for (int index = 0; index < inlist.size(); index++) {
-    num2cube.add(inlist[index].toString());
-    QString st = num2cube.serialNumber(inlist[index].toString());
+    for (int index = 0; index < inlist.size(); index++) {
+      num2cube.add(inlist[index].toString());
+      progress.CheckStatus();
+    }
+  }
+
+  for (int index = 0; index < num2cube.size(); index++) {
+    QString st = num2cube.serialNumber(index);
     inListNums.insert(st);
     listedSerialNumbers.push_back(st);   // Used with nonListedSerialNumbers
-    progress.CheckStatus();
   }
 
   QVector<QString> nonListedSerialNumbers;
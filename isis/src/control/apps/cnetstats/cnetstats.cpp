@@ -85,9 +85,9 @@ void IsisMain() {
       ReadDefFile(cNetFilter, pvlDefFile);
     }
 
-    // Run Image Stats
+    // Run Image Stats. The image stats were generated by the ControlNetFilter constructor
+    // and regenerated after each filter, so they are up to date.
     if (ui.WasEntered("CREATE_IMAGE_STATS") && ui.GetBoolean("CREATE_IMAGE_STATS")) {
-      cNetFilter.GenerateImageStats();
       cNetFilter.PrintImageStats(sImageFile);
     }
 
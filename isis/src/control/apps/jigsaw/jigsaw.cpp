@@ -53,6 +53,10 @@ void IsisMain() {
 
   QString cnetFile = ui.GetFileName("CNET");
   QString cubeList = ui.GetFileName("FROMLIST");
+  QString serialNumberCache = "";
+  if (ui.WasEntered("SNCACHE")) {
+    serialNumberCache = ui.GetFileName("SNCACHE");
+  }
   
   // retrieve settings from jigsaw gui
   
@@ -64,10 +68,11 @@ void IsisMain() {
       QString heldList = ui.GetFileName("HELDLIST");
       // Update the control network so that any control points intersecting a held image are fixed
       ControlNetQsp cnet = fixHeldImages(cnetFile, heldList, cubeList);
-      bundleAdjustment = new BundleAdjust(settings, cnet, cubeList);
+      bundleAdjustment = new BundleAdjust(settings, cnet, cubeList, true, serialNumberCache);
     }
     else {
-      bundleAdjustment = new BundleAdjust(settings, cnetFile, cubeList);
+      bundleAdjustment = new BundleAdjust(settings, cnetFile, cubeList, true,
+                                          serialNumberCache);
     }
   }
   catch (IException &e) {
@@ -199,6 +204,12 @@ BundleSettingsQsp bundleSettings(UserInterface &ui) {
                                   ui.GetDouble("SIGMA0"),
                                   ui.GetInteger("MAXITS"));
 
+  // solve method
+  settings->setSolveMethod(BundleSettings::stringToSolveMethod(ui.GetString("SOLVEMETHOD")),
+                           BundleSettings::stringToPreconditioner(ui.GetString("PRECONDITIONER")),
+                           ui.GetDouble("CG_TOLERANCE"),
+                           ui.GetInteger("CG_MAXITS"));
+
   // max likelihood estimation
   if (ui.GetString("MODEL1").compare("NONE") != 0) {
     // if model1 is not "NONE", add to the models list with its quantile
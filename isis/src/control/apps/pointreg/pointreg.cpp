@@ -8,6 +8,7 @@
 #include "AutoRegFactory.h"
 #include "Camera.h"
 #include "Chip.h"
+#include "ChipCache.h"
 #include "ControlMeasure.h"
 #include "ControlMeasureLogData.h"
 #include "ControlNet.h"
@@ -27,6 +28,7 @@ using namespace Isis;
 
 AutoReg *ar;
 AutoReg *validator;
+ChipCache *chipCache;
 CubeManager *cubeMgr;
 SerialNumberList *files;
 QList<QString> *falsePositives;
@@ -202,6 +204,7 @@ void IsisMain() {
   // Initialize variables
   ar = NULL;
   validator = NULL;
+  chipCache = NULL;
   cubeMgr = NULL;
   files = NULL;
   falsePositives = NULL;
@@ -249,6 +252,11 @@ void IsisMain() {
   Pvl pvl(ui.GetFileName("DEFFILE"));
   ar = AutoRegFactory::Create(pvl);
 
+  // Reference chips are loaded once per measure being registered, so share loaded chips and
+  // cube tiles between all of the registrations
+  chipCache = new ChipCache;
+  ar->SetChipCache(chipCache);
+
   Progress progress;
   progress.SetText("Registering Points");
   progress.SetMaximumSteps(outNet.GetNumPoints());
@@ -269,6 +277,7 @@ void IsisMain() {
   QString validate = ui.GetString("VALIDATE");
   if (validate != "SKIP") {
     validator = AutoRegFactory::Create(pvl);
+    validator->SetChipCache(chipCache);
 
     validator->SetTolerance(validator->MostLenientTolerance());
     validator->SetPatternZScoreMinimum(DBL_MIN);
@@ -513,6 +522,9 @@ void IsisMain() {
   delete validator;
   validator = NULL;
 
+  delete chipCache;
+  chipCache = NULL;
+
   delete cubeMgr;
   cubeMgr = NULL;
 
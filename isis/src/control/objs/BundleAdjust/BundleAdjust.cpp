@@ -10,10 +10,13 @@
 #include <QDebug>
 #include <QFile>
 #include <QMutex>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 // boost lib
 #include <boost/lexical_cast.hpp>
 #include <boost/numeric/ublas/io.hpp>
+#include <boost/numeric/ublas/lu.hpp>
 #include <boost/numeric/ublas/matrix_sparse.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
 
@@ -90,11 +93,13 @@ namespace Isis {
    * @param cnetFile The filename of the control network to be used.
    * @param cubeList The list of filenames of the cubes to be adjusted.
    * @param printSummary If summaries should be printed each iteration.
+   * @param serialNumberCache The serial number cache file for the cube list, or "" for none.
    */
   BundleAdjust::BundleAdjust(BundleSettingsQsp bundleSettings,
                              const QString &cnetFile,
                              const QString &cubeList,
-                             bool printSummary) {
+                             bool printSummary,
+                             const QString &serialNumberCache) {
     m_abort = false;
     Progress progress;
     // initialize constructor dependent settings...
@@ -110,7 +115,7 @@ namespace Isis {
       throw;
     }
     m_bundleResults.setOutputControlNet(m_controlNet);
-    m_serialNumberList = new SerialNumberList(cubeList);
+    m_serialNumberList = new SerialNumberList(cubeList, true, NULL, serialNumberCache);
     m_bundleSettings = bundleSettings;
     m_bundleTargetBody = bundleSettings->bundleTargetBody();
 
@@ -235,11 +240,13 @@ namespace Isis {
    * @param cnet QSharedPointer to the control net to adjust.
    * @param cubeList QString name of list of cubes to create serial numbers for.
    * @param printSummary Boolean indicating whether to print application output summary.
+   * @param serialNumberCache The serial number cache file for the cube list, or "" for none.
    */
   BundleAdjust::BundleAdjust(BundleSettingsQsp bundleSettings,
                              ControlNetQsp cnet,
                              const QString &cubeList,
-                             bool printSummary) {
+                             bool printSummary,
+                             const QString &serialNumberCache) {
     m_abort = false;
     m_printSummary = printSummary;
     m_cleanUp = false;
@@ -251,7 +258,7 @@ namespace Isis {
       throw;
     }
     m_bundleResults.setOutputControlNet(m_controlNet);
-    m_serialNumberList = new SerialNumberList(cubeList);
+    m_serialNumberList = new SerialNumberList(cubeList, true, NULL, serialNumberCache);
     m_bundleSettings = bundleSettings;
     m_bundleTargetBody = bundleSettings->bundleTargetBody();
 
@@ -708,10 +715,20 @@ namespace Isis {
    *   @history 2016-11-16 Ian Humphrey - Modified catch block to throw the caught exception, so
    *                           a message box will appear to the user when running jigsaw in GUI
    *                           mode. Fixes #4483.
+   *   @history 2018-09-06 Isis Development Team - Throws if error propagation is requested with
+   *                           the conjugate gradient solve method.
    */
   bool BundleAdjust::solveCholesky() {
     try {
 
+      // error propagation needs the Cholesky factor of the normal equations
+      if (m_bundleSettings->solveMethod() == BundleSettings::ConjugateGradient
+          && m_bundleSettings->errorPropagation()) {
+        QString msg = "Error propagation is not available with the conjugate gradient solve "
+                      "method";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
       // throw error if a frame camera is included AND
       // if m_bundleSettings->solveInstrumentPositionOverHermiteSpline()
       // is set to true (can only use for line scan or radar)
@@ -1013,11 +1030,15 @@ namespace Isis {
    * Each BundleControlPoint will stores its Q matrix and NIC vector once finished.
    * The covariance matrix for each point will be stored in its adjusted surface point.
    *
+   * The partials and measure normals are formed serially, because the cameras are shared by
+   * all of the points of an image. The points are collected into batches that are eliminated
+   * from the reduced normal equations on the global thread pool by eliminatePoints().
+   *
    * @return @b bool
    *
    * @see BundleAdjust::formMeasureNormals
-   * @see BundleAdjust::formPointNormals
    * @see BundleAdjust::formWeightedNormals
+   * @see BundleAdjust::eliminatePoints
    */
   bool BundleAdjust::formNormalEquations() {
     bool status = false;
@@ -1030,9 +1051,6 @@ namespace Isis {
     static LinearAlgebra::Matrix coeffImage;
     static LinearAlgebra::Matrix coeffPoint3D(2, 3);
     static LinearAlgebra::Vector coeffRHS(2);
-    static boost::numeric::ublas::symmetric_matrix<double, upper> N22(3);
-    SparseBlockColumnMatrix N12;
-    static LinearAlgebra::Vector n2(3);
     boost::numeric::ublas::compressed_vector<double> n1(m_rank);
 
     m_RHS.resize(m_rank);
@@ -1045,16 +1063,36 @@ namespace Isis {
       coeffTarget.resize(2,numTargetBodyParameters);
     }
 
-    // clear N12, n1, and nj
-    N12.clear();
+    // clear n1, and nj
     n1.clear();
     m_RHS.clear();
 
     // clear static matrices
     coeffPoint3D.clear();
     coeffRHS.clear();
-    N22.clear();
-    n2.clear();
+
+    // The elimination tasks split the columns of the reduced normal equations. There are
+    // several tasks per thread because the later columns of the upper triangle hold more
+    // blocks.
+    int numThreads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    int numColumns = m_sparseNormals.size();
+    int numTasks = 1;
+    if (numThreads > 1) {
+      numTasks = qMax(1, qMin(numColumns, 4 * numThreads));
+    }
+
+    QVector<PointEliminationTask> tasks(numTasks);
+    for (int i = 0; i < numTasks; i++) {
+      tasks[i].beginColumn = (i * numColumns) / numTasks;
+      tasks[i].endColumn = ((i + 1) * numColumns) / numTasks;
+    }
+
+    QVector<PointNormals> pending(256 * numThreads);
+    for (int i = 0; i < pending.size(); i++) {
+      pending[i].N22.resize(3);
+      pending[i].n2.resize(3);
+    }
+    int numPending = 0;
 
     // loop over 3D points
     int numGood3DPoints = 0;
@@ -1075,11 +1113,11 @@ namespace Isis {
         continue;
       }
 
-      if ( i != 0 ) {
-        N22.clear();
-        N12.wipe();
-        n2.clear();
-      }
+      PointNormals &normals = pending[numPending];
+      normals.point = point;
+      normals.N22.clear();
+      normals.N12.wipe();
+      normals.n2.clear();
 
       // loop over measures for this point
       int numMeasures = point->size();
@@ -1105,12 +1143,24 @@ namespace Isis {
         int numObs = m_bundleResults.numberObservations();
         m_bundleResults.setNumberObservations(numObs + 2);
 
-        formMeasureNormals(N22, N12, n1, n2, coeffTarget, coeffImage, coeffPoint3D, coeffRHS,
-                             measure->observationIndex());
+        formMeasureNormals(normals.N22, normals.N12, n1, normals.n2,
+                           coeffTarget, coeffImage, coeffPoint3D, coeffRHS,
+                           measure->observationIndex());
 
       } // end loop over this points measures
 
-      formPointNormals(N22, N12, n2, m_RHS, point);
+      // the weights themselves are applied by formPointQ
+      for (int j = 0; j < 3; j++) {
+        if (point->weights()(j) > 0.0) {
+          m_bundleResults.incrementNumberConstrainedPointParameters(1);
+        }
+      }
+
+      numPending++;
+      if (numPending == pending.size()) {
+        eliminatePoints(pending, numPending, tasks);
+        numPending = 0;
+      }
 
       pointIndex++;
 
@@ -1118,6 +1168,8 @@ namespace Isis {
 
   } // end loop over 3D points
 
+  eliminatePoints(pending, numPending, tasks);
+
   // finally, form the reduced normal equations
   formWeightedNormals(n1, m_RHS);
 
@@ -1267,27 +1319,25 @@ namespace Isis {
 
 
   /**
-   * Compute the Q matrix and NIC vector for a control point.  The inputs N22, N12, and n2
-   * come from calling formMeasureNormals() with the control point's measures.
-   * The Q matrix and NIC vector are stored in the BundleControlPoint.
-   * R = N12 x Q is accumulated into m_sparseNormals.
+   * Compute the Q matrix and NIC vector for a control point and store them in the
+   * BundleControlPoint. The inputs N22, N12, and n2 come from calling formMeasureNormals()
+   * with the control point's measures. The point weights are added to N22 and n2, and N22 is
+   * replaced by its inverse.
+   *
+   * This only modifies its arguments, so different points can be formed at the same time.
    *
    * @param N22 The normal equation matrix for the point on the body.
    * @param N12 The normal equation matrix for the camera and the target body.
    * @param n2 The right hand side vector for the point on the body.
-   * @param nj The output right hand side vector.
-   * @param bundleControlPoint The control point that the Q matrixs are NIC vector
+   * @param bundleControlPoint The control point that the Q matrix and NIC vector
    *                           are being formed for.
    *
-   * @return @b bool If the matrices were successfully formed.
-   *
-   * @see BundleAdjust::formNormalEquations
+   * @see BundleAdjust::eliminatePoints
    */
-  bool BundleAdjust::formPointNormals(symmetric_matrix<double, upper>&N22,
-                                      SparseBlockColumnMatrix &N12,
-                                      vector<double> &n2,
-                                      vector<double> &nj,
-                                      BundleControlPointQsp &bundleControlPoint) {
+  void BundleAdjust::formPointQ(symmetric_matrix<double, upper> &N22,
+                                SparseBlockColumnMatrix &N12,
+                                vector<double> &n2,
+                                BundleControlPointQsp &bundleControlPoint) {
 
     boost::numeric::ublas::bounded_vector<double, 3> &NIC = bundleControlPoint->nicVector();
     SparseBlockRowMatrix &Q = bundleControlPoint->cholmodQMatrix();
@@ -1304,19 +1354,16 @@ namespace Isis {
     if (weights(0) > 0.0) {
       N22(0,0) += weights(0);
       n2(0) += (-weights(0) * corrections(0));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
     }
 
     if (weights(1) > 0.0) {
       N22(1,1) += weights(1);
       n2(1) += (-weights(1) * corrections(1));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
     }
 
     if (weights(2) > 0.0) {
       N22(2,2) += weights(2);
       n2(2) += (-weights(2) * corrections(2));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
     }
 
     // invert N22
@@ -1332,14 +1379,6 @@ namespace Isis {
 
     // form product of N22(inverse) and n2; store in NIC
     NIC = prod(N22, n2);
-
-    // accumulate -R directly into reduced normal equations
-    productAB(N12, Q);
-
-    // accumulate -nj
-    accumProductAlphaAB(-1.0, Q, n2, nj);
-
-    return true;
   }
 
 
@@ -1416,6 +1455,135 @@ namespace Isis {
   }
 
 
+  /**
+   * Eliminates a batch of points from the reduced normal equations.
+   *
+   * The Q matrix of every point is formed on the global thread pool, and each task then
+   * subtracts the points from its own range of columns of m_sparseNormals and m_RHS. Every
+   * block is accumulated over the points in batch order, so the reduced normal equations are
+   * identical for any number of threads.
+   *
+   * @param pending The auxiliary normal equations of the points in the batch.
+   * @param numPending The number of points in the batch.
+   * @param tasks The elimination tasks.
+   *
+   * @see BundleAdjust::formNormalEquations
+   */
+  void BundleAdjust::eliminatePoints(QVector<PointNormals> &pending,
+                                     int numPending,
+                                     QVector<PointEliminationTask> &tasks) {
+    if (tasks.size() == 1) {
+      for (int i = 0; i < numPending; i++) {
+        PointNormals &normals = pending[i];
+        formPointQ(normals.N22, normals.N12, normals.n2, normals.point);
+      }
+      PointEliminationFunctor(this, &pending, numPending)(tasks[0]);
+      return;
+    }
+
+    QtConcurrent::blockingMap(pending.begin(), pending.begin() + numPending,
+                              PointQFunctor(this));
+    QtConcurrent::blockingMap(tasks, PointEliminationFunctor(this, &pending, numPending));
+  }
+
+
+  /**
+   * Subtracts the contribution of a point to a range of columns from m_sparseNormals and
+   * m_RHS. The Q matrix of the point must have been formed by formPointQ(). This only modifies
+   * the columns in the range, so different ranges can be eliminated at the same time.
+   *
+   * @param normals The auxiliary normal equations of the point.
+   * @param beginColumn The first column block.
+   * @param endColumn One past the last column block.
+   *
+   * @see BundleAdjust::eliminatePoints
+   */
+  void BundleAdjust::eliminatePointColumns(PointNormals &normals,
+                                           int beginColumn,
+                                           int endColumn) {
+    SparseBlockRowMatrix &Q = normals.point->cholmodQMatrix();
+
+    QMap<int, LinearAlgebra::Matrix *>::const_iterator Qit = Q.lowerBound(beginColumn);
+    for ( ; Qit != Q.constEnd() && Qit.key() < endColumn; ++Qit) {
+      int columnIndex = Qit.key();
+      LinearAlgebra::Matrix *Qblock = Qit.value();
+      SparseBlockColumnMatrix *column = m_sparseNormals.at(columnIndex);
+
+      // accumulate -R into the upper triangle of this column
+      QMapIterator<int, LinearAlgebra::Matrix *> N12it(normals.N12);
+      while ( N12it.hasNext() ) {
+        N12it.next();
+
+        int rowIndex = N12it.key();
+        if ( rowIndex > columnIndex ) {
+          break;
+        }
+
+        LinearAlgebra::Matrix *N12block = N12it.value();
+        column->insertMatrixBlock(rowIndex, N12block->size1(), Qblock->size2());
+
+        LinearAlgebra::Matrix product = prod(*N12block, *Qblock);
+        (*(*column)[rowIndex]) -= product;
+      }
+
+      // accumulate -nj
+      LinearAlgebra::Vector blockProduct = prod(trans(*Qblock), normals.n2);
+      int numParams = column->startColumn();
+      for (unsigned i = 0; i < blockProduct.size(); i++) {
+        m_RHS(numParams + i) += -1.0 * blockProduct(i);
+      }
+    }
+  }
+
+
+  /**
+   * Constructs a PointQFunctor.
+   *
+   * @param bundleAdjust The bundle whose normal equations are being formed.
+   */
+  BundleAdjust::PointQFunctor::PointQFunctor(BundleAdjust *bundleAdjust) {
+    m_bundleAdjust = bundleAdjust;
+  }
+
+
+  /**
+   * Forms the Q matrix and NIC vector of a pending point.
+   *
+   * @param normals The auxiliary normal equations of the point.
+   */
+  void BundleAdjust::PointQFunctor::operator()(PointNormals &normals) const {
+    m_bundleAdjust->formPointQ(normals.N22, normals.N12, normals.n2, normals.point);
+  }
+
+
+  /**
+   * Constructs a PointEliminationFunctor.
+   *
+   * @param bundleAdjust The bundle whose normal equations are being formed.
+   * @param pending The auxiliary normal equations of the points waiting to be eliminated.
+   * @param numPending The number of points waiting to be eliminated.
+   */
+  BundleAdjust::PointEliminationFunctor::PointEliminationFunctor(BundleAdjust *bundleAdjust,
+                                                                 QVector<PointNormals> *pending,
+                                                                 int numPending) {
+    m_bundleAdjust = bundleAdjust;
+    m_pending = pending;
+    m_numPending = numPending;
+  }
+
+
+  /**
+   * Eliminates the pending points, in order, from the columns of a task.
+   *
+   * @param task The elimination task.
+   */
+  void BundleAdjust::PointEliminationFunctor::operator()(PointEliminationTask &task) const {
+    for (int i = 0; i < m_numPending; i++) {
+      m_bundleAdjust->eliminatePointColumns((*m_pending)[i], task.beginColumn, task.endColumn);
+    }
+  }
+
+
   /**
    * Perform the matrix multiplication v2 = alpha ( Q x v1 ).
    *
@@ -1452,7 +1620,7 @@ namespace Isis {
    * @param N12 A sparse block matrix
    * @param Q The output sparse block matrix
    *
-   * @see BundleAdjust::formPointNormals
+   * @see BundleAdjust::formPointQ
    */
   bool BundleAdjust::productATransB(symmetric_matrix <double,upper> &N22,
                                     SparseBlockColumnMatrix &N12,
@@ -1476,100 +1644,22 @@ namespace Isis {
 
 
   /**
-   * Perform the matrix multiplication C = N12 x Q.
-   * The result, C, is stored in m_sparseNormals.
-   *
-   * @param N12 A sparse block matrix.
-   * @param Q A sparse block matrix
-   *
-   * @see BundleAdjust::formPointNormals
-   */
-  void BundleAdjust::productAB(SparseBlockColumnMatrix &N12,
-                               SparseBlockRowMatrix &Q) {
-    // iterators for N12 and Q
-    QMapIterator<int, LinearAlgebra::Matrix*> N12it(N12);
-    QMapIterator<int, LinearAlgebra::Matrix*> Qit(Q);
-
-    // now multiply blocks and subtract from m_sparseNormals
-    while ( N12it.hasNext() ) {
-      N12it.next();
-
-      int rowIndex = N12it.key();
-      LinearAlgebra::Matrix *N12block = N12it.value();
-
-      while ( Qit.hasNext() ) {
-        Qit.next();
-
-        int columnIndex = Qit.key();
-
-        if ( rowIndex > columnIndex ) {
-          continue;
-        }
-
-        LinearAlgebra::Matrix *Qblock = Qit.value();
-
-        // insert submatrix at column, row
-        m_sparseNormals.insertMatrixBlock(columnIndex, rowIndex,
-                                          N12block->size1(), Qblock->size2());
-
-        (*(*m_sparseNormals[columnIndex])[rowIndex]) -= prod(*N12block,*Qblock);
-      }
-      Qit.toFront();
-    }
-  }
-
-
-  /**
-   * Performs the matrix multiplication nj = nj + alpha (Q x n2).
-   *
-   * @param alpha A constant multiplier.
-   * @param Q A sparse block matrix.
-   * @param n2 A vector.
-   * @param nj The output accumulation vector.
-   *
-   * @see BundleAdjust::formPointNormals
-   */
-  void BundleAdjust::accumProductAlphaAB(double alpha,
-                                         SparseBlockRowMatrix &Q,
-                                         vector<double> &n2,
-                                         vector<double> &nj) {
-
-    if (alpha == 0.0) {
-      return;
-    }
-
-    int numParams;
-
-    QMapIterator<int, LinearAlgebra::Matrix*> Qit(Q);
-
-    while ( Qit.hasNext() ) {
-      Qit.next();
-
-      int columnIndex = Qit.key();
-      LinearAlgebra::Matrix *Qblock = Qit.value();
-
-      LinearAlgebra::Vector blockProduct = prod(trans(*Qblock),n2);
-
-      numParams = m_sparseNormals.at(columnIndex)->startColumn();
-
-      for (unsigned i = 0; i < blockProduct.size(); i++) {
-        nj(numParams+i) += alpha*blockProduct(i);
-      }
-    }
-  }
-
-
-  /**
-   * Compute the solution to the normal equations using the CHOLMOD library.
+   * Compute the solution to the normal equations using the CHOLMOD library, or with a
+   * preconditioned conjugate gradient if that solve method is selected in the bundle settings.
    *
    * @return @b bool If the solution was successfully computed.
    *
    * @throws IException::Programmer "CHOLMOD: Failed to load Triplet matrix"
    *
    * @see BundleAdjust::solveCholesky
+   * @see BundleAdjust::solveConjugateGradient
    */
   bool BundleAdjust::solveSystem() {
 
+    if (m_bundleSettings->solveMethod() == BundleSettings::ConjugateGradient) {
+      return solveConjugateGradient();
+    }
+
     // load cholmod triplet
     if ( !loadCholmodTriplet() ) {
       QString msg = "CHOLMOD: Failed to load Triplet matrix";
@@ -1628,6 +1718,268 @@ namespace Isis {
   }
 
 
+  /**
+   * @brief Compute the solution to the normal equations with a preconditioned conjugate
+   *        gradient.
+   *
+   * The reduced normal equations are used directly from the blocks of m_sparseNormals, so
+   * no CHOLMOD triplet, sparse matrix, or factor is created. The memory used is that of the
+   * blocks, which grows with the number of overlapping image pairs rather than with the
+   * fill-in of a Cholesky factor. The preconditioner is selected in the bundle settings.
+   *
+   * If the conjugate gradient has not reached the tolerance after the maximum number of
+   * iterations, the solve fails and the bundle is not converged.
+   *
+   * @return @b bool If the solution was successfully computed.
+   *
+   * @see BundleAdjust::solveSystem
+   * @see BundleSettings::setSolveMethod
+   */
+  bool BundleAdjust::solveConjugateGradient() {
+
+    // invert the diagonal blocks for the preconditioner
+    int numBlocks = m_sparseNormals.size();
+    QVector<LinearAlgebra::Matrix> inverseDiagonal(numBlocks);
+
+    for (int i = 0; i < numBlocks; i++) {
+      LinearAlgebra::Matrix *diagonalBlock = m_sparseNormals.getBlock(i, i);
+      if ( !diagonalBlock ) {
+        QString msg = "Matrix NOT positive-definite: no observations for parameter block "
+                      + toString(i);
+        error(msg);
+        emit(finished());
+        return false;
+      }
+
+      // only the upper triangle of a diagonal block is used (see loadCholmodTriplet)
+      int blockSize = diagonalBlock->size1();
+      LinearAlgebra::Matrix block(blockSize, blockSize);
+      for (int row = 0; row < blockSize; row++) {
+        for (int column = row; column < blockSize; column++) {
+          block(row, column) = block(column, row) = (*diagonalBlock)(row, column);
+        }
+      }
+
+      permutation_matrix<std::size_t> pivots(blockSize);
+      if ( lu_factorize(block, pivots) != 0 ) {
+        QString msg = "Matrix NOT positive-definite: singular parameter block " + toString(i);
+        error(msg);
+        emit(finished());
+        return false;
+      }
+
+      inverseDiagonal[i] = identity_matrix<double>(blockSize);
+      lu_substitute(block, pivots, inverseDiagonal[i]);
+    }
+
+    int maximumIterations = m_bundleSettings->conjugateGradientMaximumIterations();
+    if (maximumIterations <= 0) {
+      maximumIterations = m_rank;
+    }
+
+    LinearAlgebra::Vector residual(m_RHS);
+    LinearAlgebra::Vector preconditioned(m_rank);
+    LinearAlgebra::Vector direction(m_rank);
+    LinearAlgebra::Vector product(m_rank);
+
+    m_imageSolution.clear();
+
+    double rhsNorm = norm_2(m_RHS);
+    if (rhsNorm == 0.0) {
+      return true;
+    }
+
+    double tolerance = m_bundleSettings->conjugateGradientTolerance() * rhsNorm;
+
+    applyPreconditioner(inverseDiagonal, residual, preconditioned);
+    direction = preconditioned;
+    double rz = inner_prod(residual, preconditioned);
+
+    int iteration = 0;
+    double residualNorm = rhsNorm;
+    while (iteration < maximumIterations && residualNorm > tolerance) {
+      iteration++;
+
+      productNormalsV(direction, product);
+
+      double curvature = inner_prod(direction, product);
+      if (curvature <= 0.0) {
+        QString msg = "Matrix NOT positive-definite: conjugate gradient failed at iteration "
+                      + toString(iteration);
+        error(msg);
+        emit(finished());
+        return false;
+      }
+
+      double alpha = rz / curvature;
+      m_imageSolution += alpha * direction;
+      residual -= alpha * product;
+      residualNorm = norm_2(residual);
+
+      if (residualNorm <= tolerance) {
+        break;
+      }
+
+      applyPreconditioner(inverseDiagonal, residual, preconditioned);
+      double previousRz = rz;
+      rz = inner_prod(residual, preconditioned);
+      direction = preconditioned + (rz / previousRz) * direction;
+    }
+
+    emit statusUpdate( QString("Conjugate gradient: %1 iterations, relative residual %2")
+                       .arg(iteration)
+                       .arg(residualNorm / rhsNorm) );
+
+    if (residualNorm > tolerance) {
+      QString msg = "Conjugate gradient did not converge in " + toString(maximumIterations)
+                    + " iterations: relative residual " + toString(residualNorm / rhsNorm)
+                    + " is greater than the tolerance "
+                    + toString(m_bundleSettings->conjugateGradientTolerance());
+      error(msg);
+      emit(finished());
+      return false;
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Perform the matrix multiplication product = N x v, where N is the reduced normal
+   * equations matrix stored in m_sparseNormals. Only the upper triangle of N is stored, so
+   * each off-diagonal block is also applied transposed.
+   *
+   * @param v A vector.
+   * @param product The output vector.
+   *
+   * @see BundleAdjust::solveConjugateGradient
+   */
+  void BundleAdjust::productNormalsV(const LinearAlgebra::Vector &v,
+                                     LinearAlgebra::Vector &product) {
+    product.clear();
+
+    int numBlockColumns = m_sparseNormals.size();
+    for (int columnIndex = 0; columnIndex < numBlockColumns; columnIndex++) {
+      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[columnIndex];
+      int columnStart = normalsColumn->startColumn();
+
+      QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+      while ( it.hasNext() ) {
+        it.next();
+
+        int rowIndex = it.key();
+        int rowStart = m_sparseNormals.at(rowIndex)->startColumn();
+        LinearAlgebra::Matrix *block = it.value();
+
+        if (columnIndex == rowIndex) {
+          // diagonal block (upper-triangular)
+          for (unsigned ii = 0; ii < block->size1(); ii++) {
+            product(rowStart + ii) += (*block)(ii, ii) * v(columnStart + ii);
+            for (unsigned jj = ii + 1; jj < block->size2(); jj++) {
+              product(rowStart + ii) += (*block)(ii, jj) * v(columnStart + jj);
+              product(columnStart + jj) += (*block)(ii, jj) * v(rowStart + ii);
+            }
+          }
+        }
+        else {
+          // off-diagonal block
+          subrange(product, rowStart, rowStart + block->size1())
+              += prod(*block, subrange(v, columnStart, columnStart + block->size2()));
+          subrange(product, columnStart, columnStart + block->size2())
+              += prod(trans(*block), subrange(v, rowStart, rowStart + block->size1()));
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Apply the conjugate gradient preconditioner selected in the bundle settings to a residual
+   * vector.
+   *
+   * BlockJacobi multiplies each block of the residual by the inverse of the corresponding
+   * diagonal block of the normal equations. BlockSSOR applies a forward and then a backward
+   * block Gauss-Seidel sweep, which is block SSOR with a relaxation factor of one.
+   *
+   * @param inverseDiagonal The inverses of the diagonal blocks of the normal equations.
+   * @param residual The residual vector.
+   * @param preconditioned The output preconditioned residual.
+   *
+   * @see BundleAdjust::solveConjugateGradient
+   */
+  void BundleAdjust::applyPreconditioner(const QVector<LinearAlgebra::Matrix> &inverseDiagonal,
+                                         const LinearAlgebra::Vector &residual,
+                                         LinearAlgebra::Vector &preconditioned) {
+    int numBlocks = m_sparseNormals.size();
+
+    if (m_bundleSettings->preconditioner() == BundleSettings::BlockJacobi) {
+      for (int i = 0; i < numBlocks; i++) {
+        int start = m_sparseNormals.at(i)->startColumn();
+        int end = start + inverseDiagonal[i].size1();
+        subrange(preconditioned, start, end) =
+            prod(inverseDiagonal[i], subrange(residual, start, end));
+      }
+      return;
+    }
+
+    // forward sweep, w(i) = D(i)^-1 (r(i) - sum over j < i of U(j,i)^T w(j)). The blocks U(j,i)
+    // are the off-diagonal blocks stored in block column i.
+    for (int i = 0; i < numBlocks; i++) {
+      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[i];
+      int start = normalsColumn->startColumn();
+      int end = start + inverseDiagonal[i].size1();
+
+      LinearAlgebra::Vector sum = subrange(residual, start, end);
+
+      QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+      while ( it.hasNext() ) {
+        it.next();
+
+        int rowIndex = it.key();
+        if (rowIndex >= i) {
+          continue;
+        }
+
+        LinearAlgebra::Matrix *block = it.value();
+        int rowStart = m_sparseNormals.at(rowIndex)->startColumn();
+        sum -= prod(trans(*block),
+                    subrange(preconditioned, rowStart, rowStart + block->size1()));
+      }
+
+      subrange(preconditioned, start, end) = prod(inverseDiagonal[i], sum);
+    }
+
+    // backward sweep, z(i) = w(i) - D(i)^-1 sum over j > i of U(i,j) z(j). Block column j is
+    // finished before any block i < j, so its blocks are accumulated into the rows above it.
+    LinearAlgebra::Vector upperSum(m_rank);
+    upperSum.clear();
+
+    for (int j = numBlocks - 1; j >= 0; j--) {
+      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[j];
+      int start = normalsColumn->startColumn();
+      int end = start + inverseDiagonal[j].size1();
+
+      subrange(preconditioned, start, end) -=
+          prod(inverseDiagonal[j], subrange(upperSum, start, end));
+
+      QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+      while ( it.hasNext() ) {
+        it.next();
+
+        int rowIndex = it.key();
+        if (rowIndex >= j) {
+          continue;
+        }
+
+        LinearAlgebra::Matrix *block = it.value();
+        int rowStart = m_sparseNormals.at(rowIndex)->startColumn();
+        subrange(upperSum, rowStart, rowStart + block->size1()) +=
+            prod(*block, subrange(preconditioned, start, end));
+      }
+    }
+  }
+
+
   /**
    * @brief Load sparse normal equations matrix into CHOLMOD triplet.
    *
@@ -1791,7 +2143,7 @@ namespace Isis {
    * @return @b bool If the matrix was inverted.
    *                 False usually means the matrix is not invertible.
    *
-   * @see BundleAdjust::formPointNormals
+   * @see BundleAdjust::formPointQ
    *
    * @TODO Move to LinearAlgebra
    */
@@ -2154,94 +2506,126 @@ namespace Isis {
         
     // TODO: Below code should move into BundleControlPoint->updateParameterCorrections
     //       except, what about the productAlphaAV method?
-    
+
     // Update lat/lon for each control point
+    if (QThreadPool::globalInstance()->maxThreadCount() > 1) {
+      QtConcurrent::blockingMap(m_bundleControlPoints, PointCorrectionFunctor(this));
+    }
+    else {
+      int numControlPoints = m_bundleControlPoints.size();
+      for (int i = 0; i < numControlPoints; i++) {
+        applyPointCorrections(m_bundleControlPoints[i]);
+      }
+    }
+  }
+
+
+  /**
+   * Apply the corrections to a control point for the current image parameter solution.
+   * This only modifies the point, so the points can be corrected at the same time.
+   *
+   * @param point The control point.
+   *
+   * @see BundleAdjust::applyParameterCorrections
+   */
+  void BundleAdjust::applyPointCorrections(BundleControlPointQsp &point) {
+    if (point->isRejected()) {
+      return;
+    }
+
     double latCorrection, lonCorrection, radCorrection;
-    int pointIndex = 0;
-    int numControlPoints = m_bundleControlPoints.size();
-    for (int i = 0; i < numControlPoints; i++) {
-      BundleControlPointQsp point = m_bundleControlPoints.at(i);
 
-      if (point->isRejected()) {
-          pointIndex++;
-          continue;
-      }
+    // get NIC, Q, and correction vector for this point
+    boost::numeric::ublas::bounded_vector< double, 3 > &NIC = point->nicVector();
+    SparseBlockRowMatrix &Q = point->cholmodQMatrix();
+    boost::numeric::ublas::bounded_vector< double, 3 > &corrections = point->corrections();
 
-      // get NIC, Q, and correction vector for this point
-      boost::numeric::ublas::bounded_vector< double, 3 > &NIC = point->nicVector();
-      SparseBlockRowMatrix &Q = point->cholmodQMatrix();
-      boost::numeric::ublas::bounded_vector< double, 3 > &corrections = point->corrections();
-      
-      // subtract product of Q and nj from NIC
-      productAlphaAV(-1.0, NIC, Q, m_imageSolution);
+    // subtract product of Q and nj from NIC
+    productAlphaAV(-1.0, NIC, Q, m_imageSolution);
 
-      // get point parameter corrections
-      latCorrection = NIC(0);
-      lonCorrection = NIC(1);
-      radCorrection = NIC(2);
+    // get point parameter corrections
+    latCorrection = NIC(0);
+    lonCorrection = NIC(1);
+    radCorrection = NIC(2);
 
-      SurfacePoint surfacepoint = point->adjustedSurfacePoint();
+    SurfacePoint surfacepoint = point->adjustedSurfacePoint();
 
-      double pointLat = surfacepoint.GetLatitude().degrees();
-      double pointLon = surfacepoint.GetLongitude().degrees();
-      double pointRad = surfacepoint.GetLocalRadius().meters();
+    double pointLat = surfacepoint.GetLatitude().degrees();
+    double pointLon = surfacepoint.GetLongitude().degrees();
+    double pointRad = surfacepoint.GetLocalRadius().meters();
 
-      pointLat += RAD2DEG * latCorrection;
-      pointLon += RAD2DEG * lonCorrection;
+    pointLat += RAD2DEG * latCorrection;
+    pointLon += RAD2DEG * lonCorrection;
 
-      // Make sure updated values are still in valid range.
-      // TODO What is the valid lon range?
-      if (pointLat < -90.0) {
-        pointLat = -180.0 - pointLat;
-        pointLon = pointLon + 180.0;
-      }
-      if (pointLat > 90.0) {
-        pointLat = 180.0 - pointLat;
-        pointLon = pointLon + 180.0;
-      }
-      while (pointLon > 360.0) {
-        pointLon = pointLon - 360.0;
-      }
-      while (pointLon < 0.0) {
-        pointLon = pointLon + 360.0;
-      }
+    // Make sure updated values are still in valid range.
+    // TODO What is the valid lon range?
+    if (pointLat < -90.0) {
+      pointLat = -180.0 - pointLat;
+      pointLon = pointLon + 180.0;
+    }
+    if (pointLat > 90.0) {
+      pointLat = 180.0 - pointLat;
+      pointLon = pointLon + 180.0;
+    }
+    while (pointLon > 360.0) {
+      pointLon = pointLon - 360.0;
+    }
+    while (pointLon < 0.0) {
+      pointLon = pointLon + 360.0;
+    }
 
-      pointRad += 1000.*radCorrection;
+    pointRad += 1000.*radCorrection;
 
-      // sum and save corrections
-      corrections(0) += latCorrection;
-      corrections(1) += lonCorrection;
-      corrections(2) += radCorrection;
-           
-      // ken testing - if solving for target body mean radius, set radius to current
-      // mean radius value
-      if (m_bundleTargetBody && (m_bundleTargetBody->solveMeanRadius()
-          || m_bundleTargetBody->solveTriaxialRadii())) {
-        if (m_bundleTargetBody->solveMeanRadius()) {
-          surfacepoint.SetSphericalCoordinates(Latitude(pointLat, Angle::Degrees),
-                                               Longitude(pointLon, Angle::Degrees),
-                                               m_bundleTargetBody->meanRadius());
-        }
-        else if (m_bundleTargetBody->solveTriaxialRadii()) {
-            Distance localRadius = m_bundleTargetBody->
-                                       localRadius(Latitude(pointLat, Angle::Degrees),
-                                                   Longitude(pointLon, Angle::Degrees));
-            surfacepoint.SetSphericalCoordinates(Latitude(pointLat, Angle::Degrees),
-                                                 Longitude(pointLon, Angle::Degrees),
-                                                 localRadius);
-        }
-      }
-      else {
+    // sum and save corrections
+    corrections(0) += latCorrection;
+    corrections(1) += lonCorrection;
+    corrections(2) += radCorrection;
+
+    // ken testing - if solving for target body mean radius, set radius to current
+    // mean radius value
+    if (m_bundleTargetBody && (m_bundleTargetBody->solveMeanRadius()
+        || m_bundleTargetBody->solveTriaxialRadii())) {
+      if (m_bundleTargetBody->solveMeanRadius()) {
         surfacepoint.SetSphericalCoordinates(Latitude(pointLat, Angle::Degrees),
                                              Longitude(pointLon, Angle::Degrees),
-                                             Distance(pointRad, Distance::Meters));
+                                             m_bundleTargetBody->meanRadius());
+      }
+      else if (m_bundleTargetBody->solveTriaxialRadii()) {
+          Distance localRadius = m_bundleTargetBody->
+                                     localRadius(Latitude(pointLat, Angle::Degrees),
+                                                 Longitude(pointLon, Angle::Degrees));
+          surfacepoint.SetSphericalCoordinates(Latitude(pointLat, Angle::Degrees),
+                                               Longitude(pointLon, Angle::Degrees),
+                                               localRadius);
       }
+    }
+    else {
+      surfacepoint.SetSphericalCoordinates(Latitude(pointLat, Angle::Degrees),
+                                           Longitude(pointLon, Angle::Degrees),
+                                           Distance(pointRad, Distance::Meters));
+    }
 
-      point->setAdjustedSurfacePoint(surfacepoint);
+    point->setAdjustedSurfacePoint(surfacepoint);
+  }
 
-      pointIndex++;
 
-    } // end loop over point corrections
+  /**
+   * Constructs a PointCorrectionFunctor.
+   *
+   * @param bundleAdjust The bundle whose points are being corrected.
+   */
+  BundleAdjust::PointCorrectionFunctor::PointCorrectionFunctor(BundleAdjust *bundleAdjust) {
+    m_bundleAdjust = bundleAdjust;
+  }
+
+
+  /**
+   * Applies the corrections to a control point.
+   *
+   * @param point The control point.
+   */
+  void BundleAdjust::PointCorrectionFunctor::operator()(BundleControlPointQsp &point) const {
+    m_bundleAdjust->applyPointCorrections(point);
   }
 
 
@@ -27,6 +27,7 @@
 #include <QObject> // parent class
 
 // std lib
+#include <functional>
 #include <vector>
 #include <fstream>
 
@@ -285,6 +286,30 @@ namespace Isis {
    *   @history 2017-08-09 Summer Stapleton - Added a try/catch around the m_controlNet assignment
    *                           in each of the constructors to verify valid control net input.
    *                           Fixes #5068.
+   *   @history 2018-09-06 Isis Development Team - Added a preconditioned conjugate gradient
+   *                           solution of the reduced normal equations, selected with
+   *                           BundleSettings::setSolveMethod(). It works directly on the blocks
+   *                           of m_sparseNormals, so the CHOLMOD factor is never formed. Added
+   *                           solveConjugateGradient(), productNormalsV(), and
+   *                           applyPreconditioner(). If the conjugate gradient does not
+   *                           reach the tolerance within the maximum number of iterations, the
+   *                           solve fails and the bundle is not converged.
+   *   @history 2018-09-07 Isis Development Team - The elimination of the points from the normal
+   *                           equations and the back-substitution of the point corrections now
+   *                           run on the global thread pool. The partials are still computed
+   *                           serially, because the cameras are shared by all of the points of an
+   *                           image. The Q matrices of the points are formed in parallel, and each
+   *                           elimination task then owns a range of columns of the reduced normal
+   *                           equations, which it accumulates over the points in order. The result
+   *                           is identical for any number of threads. Added eliminatePoints(),
+   *                           eliminatePointColumns(), formPointQ(), applyPointCorrections() and
+   *                           the PointQFunctor, PointEliminationFunctor and
+   *                           PointCorrectionFunctor classes. formPointQ() and
+   *                           eliminatePointColumns() replace formPointNormals(), productAB() and
+   *                           accumProductAlphaAB(), and the constrained point parameters are
+   *                           counted by formNormalEquations().
+   *   @history 2018-09-07 Isis Development Team - The constructors that take a cube list take an
+   *                           optional serial number cache file for the SerialNumberList.
    */
   class BundleAdjust : public QObject {
       Q_OBJECT
@@ -292,7 +317,8 @@ namespace Isis {
       BundleAdjust(BundleSettingsQsp bundleSettings,
                    const QString &cnetFile,
                    const QString &cubeList,
-                   bool printSummary = true);
+                   bool printSummary = true,
+                   const QString &serialNumberCache = "");
       BundleAdjust(BundleSettingsQsp bundleSettings,
                    QString &cnet,
                    SerialNumberList &snlist,
@@ -308,7 +334,8 @@ namespace Isis {
       BundleAdjust(BundleSettingsQsp bundleSettings,
                    ControlNetQsp cnet,
                    const QString &cubeList,
-                   bool printSummary = true);
+                   bool printSummary = true,
+                   const QString &serialNumberCache = "");
       BundleAdjust(BundleSettingsQsp bundleSettings,
                    Control &control,
                    QList<ImageList *> imgList,
@@ -343,16 +370,88 @@ namespace Isis {
       void finished();
 
     private:
+      /**
+       * The auxiliary normal equations of one control point. These are formed serially by
+       * formMeasureNormals(), because the partials are computed with the cameras shared by all
+       * of the points, and are then eliminated from the reduced normal equations by a
+       * PointQFunctor and the PointEliminationFunctors.
+       */
+      struct PointNormals {
+        BundleControlPointQsp point;                        //!< The control point.
+        boost::numeric::ublas::symmetric_matrix<
+            double, boost::numeric::ublas::upper > N22;     //!< Normals for the point.
+        SparseBlockColumnMatrix N12;                        /**!< Normals between the images
+                                                                  and the point.*/
+        LinearAlgebra::Vector n2;                           //!< Right hand side for the point.
+      };
+
+      /**
+       * A contiguous range of the column blocks of the reduced normal equations. Only the task
+       * that owns a column writes its blocks of m_sparseNormals and its rows of m_RHS.
+       */
+      struct PointEliminationTask {
+        int beginColumn;                                    //!< First column block.
+        int endColumn;                                      //!< One past the last column block.
+      };
+
+      /**
+       * Forms the Q matrix and NIC vector of one pending point. This is designed to be passed
+       * into QtConcurrent::blockingMap.
+       */
+      class PointQFunctor :
+          public std::unary_function<PointNormals &, void> {
+        public:
+          PointQFunctor(BundleAdjust *bundleAdjust);
+          void operator()(PointNormals &normals) const;
+
+        private:
+          BundleAdjust *m_bundleAdjust;                     //!< The bundle being formed.
+      };
+
+      /**
+       * Eliminates the pending points from the columns of one PointEliminationTask. This is
+       * designed to be passed into QtConcurrent::blockingMap.
+       */
+      class PointEliminationFunctor :
+          public std::unary_function<PointEliminationTask &, void> {
+        public:
+          PointEliminationFunctor(BundleAdjust *bundleAdjust,
+                                  QVector<PointNormals> *pending,
+                                  int numPending);
+          void operator()(PointEliminationTask &task) const;
+
+        private:
+          BundleAdjust *m_bundleAdjust;                     //!< The bundle being formed.
+          QVector<PointNormals> *m_pending;                 //!< The points waiting elimination.
+          int m_numPending;                                 //!< The number of pending points.
+      };
+
+      /**
+       * Applies the corrections to one control point. This is designed to be passed into
+       * QtConcurrent::blockingMap.
+       */
+      class PointCorrectionFunctor :
+          public std::unary_function<BundleControlPointQsp &, void> {
+        public:
+          PointCorrectionFunctor(BundleAdjust *bundleAdjust);
+          void operator()(BundleControlPointQsp &point) const;
+
+        private:
+          BundleAdjust *m_bundleAdjust;                     //!< The bundle being corrected.
+      };
+
       //TODO Should there be a resetBundle(BundleSettings bundleSettings) method
       //     that allows for rerunning with new settings? JWB
       void init(Progress *progress = 0);
       bool initializeNormalEquationsMatrix();
       bool validateNetwork();
       bool solveSystem();
+      bool solveConjugateGradient();
       void iterationSummary();
       BundleSolutionInfo bundleSolveInformation();
       bool computeBundleStatistics();
       void applyParameterCorrections();
+      void applyPointCorrections(BundleControlPointQsp &point);
       bool errorPropagation();
       double computeResiduals();
       bool computeRejectionLimit();
@@ -377,23 +476,20 @@ namespace Isis {
                               LinearAlgebra::Matrix                              &coeffPoint3D,
                               LinearAlgebra::Vector                              &coeffRHS,
                               int                                                observationIndex);
-      bool formPointNormals(boost::numeric::ublas::symmetric_matrix<
-                                double, boost::numeric::ublas::upper >  &N22,
-                            SparseBlockColumnMatrix                     &N12,
-                            LinearAlgebra::Vector                       &n2,
-                            LinearAlgebra::Vector                       &nj,
-                            BundleControlPointQsp                       &point);
+      void formPointQ(boost::numeric::ublas::symmetric_matrix<
+                          double, boost::numeric::ublas::upper >  &N22,
+                      SparseBlockColumnMatrix                     &N12,
+                      LinearAlgebra::Vector                       &n2,
+                      BundleControlPointQsp                       &point);
       bool formWeightedNormals(boost::numeric::ublas::compressed_vector< double >  &n1,
                                LinearAlgebra::Vector                               &nj);
+      void eliminatePoints(QVector<PointNormals>         &pending,
+                           int                           numPending,
+                           QVector<PointEliminationTask> &tasks);
+      void eliminatePointColumns(PointNormals &normals, int beginColumn, int endColumn);
 
       // dedicated matrix functions
 
-      void productAB(SparseBlockColumnMatrix &A,
-                     SparseBlockRowMatrix    &B);
-      void accumProductAlphaAB(double                alpha,
-                               SparseBlockRowMatrix  &A,
-                               LinearAlgebra::Vector &B,
-                               LinearAlgebra::Vector &C);
       bool invert3x3(boost::numeric::ublas::symmetric_matrix<
                           double, boost::numeric::ublas::upper >  &m);
       bool productATransB(boost::numeric::ublas::symmetric_matrix<
@@ -404,6 +500,11 @@ namespace Isis {
                           boost::numeric::ublas::bounded_vector< double, 3 >  &v2,
                           SparseBlockRowMatrix                                &Q,
                           LinearAlgebra::Vector                               &v1);
+      void productNormalsV(const LinearAlgebra::Vector &v,
+                           LinearAlgebra::Vector       &product);
+      void applyPreconditioner(const QVector<LinearAlgebra::Matrix> &inverseDiagonal,
+                               const LinearAlgebra::Vector          &residual,
+                               LinearAlgebra::Vector                &preconditioned);
 
       // CHOLMOD library methods
 
@@ -67,6 +67,12 @@ namespace Isis {
     m_convergenceCriteriaThreshold = 1.0e-10;
     m_convergenceCriteriaMaximumIterations = 50;
 
+    // Solve Method
+    m_solveMethod = BundleSettings::Cholesky;
+    m_preconditioner = BundleSettings::BlockJacobi;
+    m_conjugateGradientTolerance = 1.0e-10;
+    m_conjugateGradientMaximumIterations = 0;
+
     // Maximum Likelihood Estimation Options no default in the constructor - must be set.
     m_maximumLikelihood.clear();
 
@@ -130,6 +136,10 @@ namespace Isis {
         m_convergenceCriteria(other.m_convergenceCriteria),
         m_convergenceCriteriaThreshold(other.m_convergenceCriteriaThreshold),
         m_convergenceCriteriaMaximumIterations(other.m_convergenceCriteriaMaximumIterations),
+        m_solveMethod(other.m_solveMethod),
+        m_preconditioner(other.m_preconditioner),
+        m_conjugateGradientTolerance(other.m_conjugateGradientTolerance),
+        m_conjugateGradientMaximumIterations(other.m_conjugateGradientMaximumIterations),
         m_maximumLikelihood(other.m_maximumLikelihood),
         m_solveTargetBody(other.m_solveTargetBody),
         m_bundleTargetBody(other.m_bundleTargetBody),
@@ -169,6 +179,10 @@ namespace Isis {
       m_convergenceCriteria = other.m_convergenceCriteria;
       m_convergenceCriteriaThreshold = other.m_convergenceCriteriaThreshold;
       m_convergenceCriteriaMaximumIterations = other.m_convergenceCriteriaMaximumIterations;
+      m_solveMethod = other.m_solveMethod;
+      m_preconditioner = other.m_preconditioner;
+      m_conjugateGradientTolerance = other.m_conjugateGradientTolerance;
+      m_conjugateGradientMaximumIterations = other.m_conjugateGradientMaximumIterations;
       m_solveTargetBody = other.m_solveTargetBody;
       m_bundleTargetBody = other.m_bundleTargetBody;
       m_maximumLikelihood = other.m_maximumLikelihood;
@@ -597,6 +611,167 @@ namespace Isis {
 
 
 
+  // =============================================================================================//
+  // ======================== Solve Method =======================================================//
+  // =============================================================================================//
+
+  /**
+   * Converts the given string value to a BundleSettings::SolveMethod enumeration.
+   * Currently accepted inputs are listed below. This method is case insensitive.
+   * <ul>
+   *   <li>Cholesky</li>
+   *   <li>ConjugateGradient</li>
+   * </ul>
+   *
+   * @param method Solve method name to be converted.
+   *
+   * @return @b SolveMethod The enumeration corresponding to the given name.
+   *
+   * @throw Isis::Exception::Programmer "Unknown bundle solve method."
+   */
+  BundleSettings::SolveMethod BundleSettings::stringToSolveMethod(QString method) {
+    if (method.compare("CHOLESKY", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::Cholesky;
+    }
+    else if (method.compare("CONJUGATEGRADIENT", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::ConjugateGradient;
+    }
+    else throw IException(IException::Programmer,
+                          "Unknown bundle solve method [" + method + "].",
+                          _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given BundleSettings::SolveMethod enumeration to a string.
+   *
+   * @param method The SolveMethod enumeration to be converted.
+   *
+   * @return @b QString The name associated with the given solve method.
+   *
+   * @throw Isis::Exception::Programmer "Unknown bundle solve method enum."
+   */
+  QString BundleSettings::solveMethodToString(BundleSettings::SolveMethod method) {
+    if (method == Cholesky)                return "Cholesky";
+    else if (method == ConjugateGradient)  return "ConjugateGradient";
+    else  throw IException(IException::Programmer,
+                           "Unknown bundle solve method enum [" + toString(method) + "].",
+                           _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given string value to a BundleSettings::Preconditioner enumeration.
+   * Currently accepted inputs are listed below. This method is case insensitive.
+   * <ul>
+   *   <li>BlockJacobi</li>
+   *   <li>BlockSSOR</li>
+   * </ul>
+   *
+   * @param preconditioner Preconditioner name to be converted.
+   *
+   * @return @b Preconditioner The enumeration corresponding to the given name.
+   *
+   * @throw Isis::Exception::Programmer "Unknown conjugate gradient preconditioner."
+   */
+  BundleSettings::Preconditioner BundleSettings::stringToPreconditioner(QString preconditioner) {
+    if (preconditioner.compare("BLOCKJACOBI", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::BlockJacobi;
+    }
+    else if (preconditioner.compare("BLOCKSSOR", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::BlockSSOR;
+    }
+    else throw IException(IException::Programmer,
+                          "Unknown conjugate gradient preconditioner [" + preconditioner + "].",
+                          _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given BundleSettings::Preconditioner enumeration to a string.
+   *
+   * @param preconditioner The Preconditioner enumeration to be converted.
+   *
+   * @return @b QString The name associated with the given preconditioner.
+   *
+   * @throw Isis::Exception::Programmer "Unknown conjugate gradient preconditioner enum."
+   */
+  QString BundleSettings::preconditionerToString(BundleSettings::Preconditioner preconditioner) {
+    if (preconditioner == BlockJacobi)     return "BlockJacobi";
+    else if (preconditioner == BlockSSOR)  return "BlockSSOR";
+    else  throw IException(IException::Programmer,
+                           "Unknown conjugate gradient preconditioner enum ["
+                           + toString(preconditioner) + "].",
+                           _FILEINFO_);
+  }
+
+
+  /**
+   * Set the method used to solve the reduced normal equations in each iteration of the
+   * bundle adjustment.
+   *
+   * @param method An enumeration for the solve method.
+   * @param preconditioner The preconditioner used by the conjugate gradient method.
+   * @param tolerance The conjugate gradient stops when the norm of the residual is less than
+   *                  this fraction of the norm of the right hand side.
+   * @param maximumIterations The maximum number of conjugate gradient iterations in each
+   *                          iteration of the bundle adjustment. Zero means the number of
+   *                          parameters in the reduced normal equations.
+   */
+  void BundleSettings::setSolveMethod(BundleSettings::SolveMethod method,
+                                      BundleSettings::Preconditioner preconditioner,
+                                      double tolerance,
+                                      int maximumIterations) {
+    m_solveMethod = method;
+    m_preconditioner = preconditioner;
+    m_conjugateGradientTolerance = tolerance;
+    m_conjugateGradientMaximumIterations = maximumIterations;
+  }
+
+
+  /**
+   * Retrieves the method used to solve the reduced normal equations.
+   *
+   * @return @b SolveMethod The enumeration of the solve method.
+   */
+  BundleSettings::SolveMethod BundleSettings::solveMethod() const {
+    return m_solveMethod;
+  }
+
+
+  /**
+   * Retrieves the preconditioner used by the conjugate gradient solve method.
+   *
+   * @return @b Preconditioner The enumeration of the preconditioner.
+   */
+  BundleSettings::Preconditioner BundleSettings::preconditioner() const {
+    return m_preconditioner;
+  }
+
+
+  /**
+   * Retrieves the relative residual at which the conjugate gradient solve method stops.
+   *
+   * @return @b double The conjugate gradient tolerance.
+   */
+  double BundleSettings::conjugateGradientTolerance() const {
+    return m_conjugateGradientTolerance;
+  }
+
+
+  /**
+   * Retrieves the maximum number of conjugate gradient iterations in each iteration of the
+   * bundle adjustment.
+   *
+   * @return @b int The maximum number of conjugate gradient iterations. Zero means the
+   *                number of parameters in the reduced normal equations.
+   */
+  int BundleSettings::conjugateGradientMaximumIterations() const {
+    return m_conjugateGradientMaximumIterations;
+  }
+
+
+
   // =============================================================================================//
   // ======================== Parameter Uncertainties (Weighting) ================================//
   // =============================================================================================//
@@ -1009,6 +1184,13 @@ namespace Isis {
                           toString(convergenceCriteriaMaximumIterations()));
     stream.writeEndElement();
 
+    stream.writeStartElement("solveMethodOptions");
+    stream.writeAttribute("solveMethod", solveMethodToString(solveMethod()));
+    stream.writeAttribute("preconditioner", preconditionerToString(preconditioner()));
+    stream.writeAttribute("tolerance", toString(conjugateGradientTolerance()));
+    stream.writeAttribute("maximumIterations", toString(conjugateGradientMaximumIterations()));
+    stream.writeEndElement();
+
     stream.writeStartElement("maximumLikelihoodEstimation");
     for (int i = 0; i < m_maximumLikelihood.size(); i++) {
       stream.writeStartElement("model");
@@ -1182,6 +1364,29 @@ namespace Isis {
               = toInt(convergenceCriteriaMaximumIterationsStr);
         }
       }
+      else if (localName == "solveMethodOptions") {
+
+        QString solveMethodStr = attributes.value("solveMethod");
+        if (!solveMethodStr.isEmpty()) {
+          m_xmlHandlerBundleSettings->m_solveMethod = stringToSolveMethod(solveMethodStr);
+        }
+
+        QString preconditionerStr = attributes.value("preconditioner");
+        if (!preconditionerStr.isEmpty()) {
+          m_xmlHandlerBundleSettings->m_preconditioner = stringToPreconditioner(preconditionerStr);
+        }
+
+        QString toleranceStr = attributes.value("tolerance");
+        if (!toleranceStr.isEmpty()) {
+          m_xmlHandlerBundleSettings->m_conjugateGradientTolerance = toDouble(toleranceStr);
+        }
+
+        QString maximumIterationsStr = attributes.value("maximumIterations");
+        if (!maximumIterationsStr.isEmpty()) {
+          m_xmlHandlerBundleSettings->m_conjugateGradientMaximumIterations
+              = toInt(maximumIterationsStr);
+        }
+      }
       else if (localName == "model") {
         QString type = attributes.value("type");
         QString quantile = attributes.value("quantile");
@@ -101,6 +101,11 @@ namespace Isis {
    *   @history 2016-10-17 Jesse Mapel - Removed m_SCPVLFilename parameter in accordance with
    *                           USEPVL being removed from jigsaw.  References #4316.
    *   @history 2017-04-24 Ian Humphrey - Removed pvlObject(). Fixes #4797.
+   *   @history 2018-09-06 Isis Development Team - Added the SolveMethod and Preconditioner
+   *                           enums and the solve method options so that the reduced normal
+   *                           equations can be solved with a preconditioned conjugate gradient
+   *                           instead of a CHOLMOD factorization. The options are serialized
+   *                           in the solveMethodOptions element. Updated unitTest.
    *
    *   @todo Determine which XmlStackedHandlerReader constructor is preferred
    *   @todo Determine which XmlStackedHandler needs a Project pointer (see constructors)
@@ -196,6 +201,46 @@ namespace Isis {
       double convergenceCriteriaThreshold() const;
       int convergenceCriteriaMaximumIterations() const;
 
+      //=====================================================================//
+      //=========================== Solve Method ============================//
+      //=====================================================================//
+
+      /**
+       * This enum defines the options for solving the reduced normal equations.
+       */
+      enum SolveMethod {
+        Cholesky,         /**< Factor the reduced normal equations with CHOLMOD. This is the
+                               fastest method, but the memory used by the factor grows with
+                               the fill-in of the network.*/
+        ConjugateGradient /**< Solve the reduced normal equations with a preconditioned
+                               conjugate gradient. Only the blocks of the normal equations are
+                               stored, so memory grows with the number of overlapping images.
+                               Error propagation is not available with this method.*/
+      };
+
+      /**
+       * This enum defines the preconditioners for the conjugate gradient solve method.
+       */
+      enum Preconditioner {
+        BlockJacobi, /**< Precondition with the inverses of the diagonal (image) blocks.*/
+        BlockSSOR    /**< Precondition with a symmetric block Gauss-Seidel sweep (block SSOR
+                          with a relaxation factor of one). This takes about twice the work
+                          of BlockJacobi per iteration, but usually needs fewer iterations.*/
+      };
+
+      static SolveMethod stringToSolveMethod(QString method);
+      static QString solveMethodToString(SolveMethod method);
+      static Preconditioner stringToPreconditioner(QString preconditioner);
+      static QString preconditionerToString(Preconditioner preconditioner);
+      void setSolveMethod(SolveMethod method,
+                          Preconditioner preconditioner = BlockJacobi,
+                          double tolerance = 1.0e-10,
+                          int maximumIterations = 0);
+      SolveMethod solveMethod() const;
+      Preconditioner preconditioner() const;
+      double conjugateGradientTolerance() const;
+      int conjugateGradientMaximumIterations() const;
+
       //=====================================================================//
       //================ Parameter Uncertainties (Weighting) ================//
       //=====================================================================//
@@ -355,6 +400,15 @@ namespace Isis {
                                                        quitting the bundle adjustment if it has
                                                        not yet converged to the given threshold.*/
 
+      // Solve Method
+      SolveMethod m_solveMethod;                  //!< How the reduced normal equations are solved.
+      Preconditioner m_preconditioner;            //!< The conjugate gradient preconditioner.
+      double m_conjugateGradientTolerance;        /**< Relative residual at which the conjugate
+                                                       gradient stops.*/
+      int m_conjugateGradientMaximumIterations;   /**< Maximum number of conjugate gradient
+                                                       iterations per bundle iteration. Zero means
+                                                       the number of parameters.*/
+
       // Maximum Likelihood Estimation Options
       /**
        * Model and C-Quantile for each of the three maximum likelihood
@@ -189,6 +189,9 @@ int main(int argc, char *argv[]) {
     // set convergence criteria values
     copySettings.setConvergenceCriteria(
                      BundleSettings::stringToConvergenceCriteria("parametercorrections"), 0.25, 26);
+    // set solve method values
+    copySettings.setSolveMethod(BundleSettings::stringToSolveMethod("conjugategradient"),
+                                BundleSettings::stringToPreconditioner("blockssor"), 0.01, 300);
     // set maximum likelihood models
     copySettings.addMaximumLikelihoodEstimatorModel(MaximumLikelihoodWFunctions::Huber, 0.27);
     copySettings.addMaximumLikelihoodEstimatorModel(MaximumLikelihoodWFunctions::Welsch, 28);
@@ -234,6 +237,14 @@ int main(int argc, char *argv[]) {
                                BundleSettings::stringToConvergenceCriteria("SIGMA0"));
     qDebug() << BundleSettings::convergenceCriteriaToString(
                                BundleSettings::stringToConvergenceCriteria("PARAMETERCORRECTIONS"));
+    qDebug() << BundleSettings::solveMethodToString(
+                               BundleSettings::stringToSolveMethod("CHOLESKY"));
+    qDebug() << BundleSettings::solveMethodToString(
+                               BundleSettings::stringToSolveMethod("CONJUGATEGRADIENT"));
+    qDebug() << BundleSettings::preconditionerToString(
+                               BundleSettings::stringToPreconditioner("BLOCKJACOBI"));
+    qDebug() << BundleSettings::preconditionerToString(
+                               BundleSettings::stringToPreconditioner("BLOCKSSOR"));
     qDebug() << "";
 
     qDebug() << "Testing XML serialization 1: write XML from BundleSettings object...";
@@ -319,6 +330,30 @@ int main(int argc, char *argv[]) {
     catch (IException &e) {
       e.print();
     }
+    try {
+      BundleSettings::stringToSolveMethod("Pickles");
+    }
+    catch (IException &e) {
+      e.print();
+    }
+    try {
+      BundleSettings::solveMethodToString(BundleSettings::SolveMethod(33));
+    }
+    catch (IException &e) {
+      e.print();
+    }
+    try {
+      BundleSettings::stringToPreconditioner("Pickles");
+    }
+    catch (IException &e) {
+      e.print();
+    }
+    try {
+      BundleSettings::preconditionerToString(BundleSettings::Preconditioner(33));
+    }
+    catch (IException &e) {
+      e.print();
+    }
     try {
       BundleSettings invalidMaxLikelihoodModel1;
       invalidMaxLikelihoodModel1.addMaximumLikelihoodEstimatorModel(
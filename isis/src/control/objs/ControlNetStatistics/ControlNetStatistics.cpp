@@ -1,6 +1,8 @@
 #include "ControlNetStatistics.h"
 
 #include <QDebug>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 #include <geos_c.h>
 #include <geos/algorithm/ConvexHull.h>
@@ -55,8 +57,7 @@ namespace Isis {
 
     mProgress = pProgress;
 
-    GetPointIntStats();
-    GetPointDoubleStats();
+    GetPointStats();
     GenerateImageStats();
   }
 
@@ -72,8 +73,7 @@ namespace Isis {
     mCNet = pCNet;
     mProgress = pProgress;
 
-    GetPointIntStats();
-    GetPointDoubleStats();
+    GetPointStats();
   }
 
   /**
@@ -211,14 +211,13 @@ namespace Isis {
    *  imgSamples, imgLines, imgTotalPoints, imgIgnoredPoints, imgFixedPoints, imgLockedPoints,
    *  imgLocked, imgConstrainedPoints, imgFreePoints, imgConvexHullArea, imgConvexHullRatio
    *
+   * The images are summarized on the global thread pool and the summaries are stored in the
+   * order of the control network's cube graph nodes. A cube is only opened the first time its
+   * dimensions are needed.
+   *
    * @author Sharmila Prasad (11/1/2011)
    */
   void ControlNetStatistics::GenerateImageStats() {
-    geos::geom::GeometryFactory geosFactory;
-
-    CubeManager cubeMgr;
-    cubeMgr.SetNumOpenCubes(50);
-
     mCubeGraphNodes = mCNet->GetCubeGraphNodes();
 
     if (mProgress != NULL) {
@@ -227,70 +226,41 @@ namespace Isis {
       mProgress->CheckStatus();
     }
 
-    foreach (ControlCubeGraphNode * node, mCubeGraphNodes) {
-      geos::geom::CoordinateSequence * ptCoordinates =
-          new geos::geom::CoordinateArraySequence();
-
-      // setup vector for number of image properties and init to 0
-      vector<double> imgStats(numImageStats, 0);
+    // Open the cubes to get the dimensions
+    CubeManager cubeMgr;
+    cubeMgr.SetNumOpenCubes(50);
 
-      // Open the cube to get the dimensions
-      QString sn = node->getSerialNumber();
-      Cube *cube = cubeMgr.OpenCube(mSerialNumList.fileName(sn));
+    QVector<ImageSummary> summaries(mCubeGraphNodes.size());
+    for (int i = 0; i < mCubeGraphNodes.size(); i++) {
+      QString sn = mCubeGraphNodes[i]->getSerialNumber();
 
-      mSerialNumMap[sn] = true;
-      numCNetImages++;
+      if (!mImageDimensions.contains(sn)) {
+        Cube *cube = cubeMgr.OpenCube(mSerialNumList.fileName(sn));
+        mImageDimensions[sn] = qMakePair(cube->sampleCount(), cube->lineCount());
+      }
 
-      imgStats[imgSamples] = cube->sampleCount();
-      imgStats[imgLines]   = cube->lineCount();
-      double cubeArea      = imgStats[imgSamples] * imgStats[imgLines];
-
-      QList< ControlMeasure * > measures = node->getMeasures();
-
-      // Populate pts with a list of control points
-      if (!measures.isEmpty()) {
-        foreach (ControlMeasure * measure, measures) {
-          ControlPoint *parentPoint = measure->Parent();
-          imgStats[imgTotalPoints]++;
-          if (parentPoint->IsIgnored()) {
-            imgStats[imgIgnoredPoints]++;
-          }
-          if (parentPoint->GetType() == ControlPoint::Fixed) {
-            imgStats[imgFixedPoints]++;
-          }
-          if (parentPoint->GetType() == ControlPoint::Constrained) {
-            imgStats[imgConstrainedPoints]++;
-          }
-          if (parentPoint->GetType() == ControlPoint::Free) {
-            imgStats[imgFreePoints]++;
-          }
-          if (parentPoint->IsEditLocked()) {
-            imgStats[imgLockedPoints]++;
-          }
-          if (measure->IsEditLocked()) {
-            imgStats[imgLocked]++;
-          }
-          ptCoordinates->add(geos::geom::Coordinate(measure->GetSample(),
-                                                    measure->GetLine()));
-        }
+      // setup vector for number of image properties and init to 0
+      summaries[i].node = mCubeGraphNodes[i];
+      summaries[i].stats = vector<double>(numImageStats, 0);
+      summaries[i].stats[imgSamples] = mImageDimensions[sn].first;
+      summaries[i].stats[imgLines]   = mImageDimensions[sn].second;
+    }
 
-        ptCoordinates->add(geos::geom::Coordinate(measures[0]->GetSample(),
-                                                  measures[0]->GetLine()));
+    if (QThreadPool::globalInstance()->maxThreadCount() > 1) {
+      QtConcurrent::blockingMap(summaries, ImageSummaryFunctor());
+    }
+    else {
+      for (int i = 0; i < summaries.size(); i++) {
+        ImageSummaryFunctor()(summaries[i]);
       }
+    }
 
-      if (ptCoordinates->size() >= 4) {
-        // Calculate the convex hull
-
-        // Even though geos doesn't create valid linear rings/polygons from this set of coordinates,
-        //   because it self-intersects many many times, it still correctly does a convex hull
-        //   calculation on the points in the polygon.
-        geos::geom::Geometry * convexHull = geosFactory.createPolygon(
-          geosFactory.createLinearRing(ptCoordinates), 0)->convexHull();
+    for (int i = 0; i < summaries.size(); i++) {
+      QString sn = summaries[i].node->getSerialNumber();
+      vector<double> &imgStats = summaries[i].stats;
 
-        // Calculate the area of the convex hull
-        imgStats[imgConvexHullArea] = convexHull->getArea();
-        imgStats[imgConvexHullRatio] = imgStats[imgConvexHullArea] / cubeArea;
-      }
+      mSerialNumMap[sn] = true;
+      numCNetImages++;
 
       // Add info to statistics to get min, max and avg convex hull
       mConvexHullStats.AddData(imgStats[imgConvexHullArea]);
@@ -298,9 +268,6 @@ namespace Isis {
 
       mImageMap[sn] = imgStats;
 
-      delete ptCoordinates;
-      ptCoordinates = NULL;
-
       // Update Progress
       if (mProgress != NULL)
         mProgress->CheckStatus();
@@ -308,6 +275,77 @@ namespace Isis {
   }
 
 
+  /**
+   * Counts the points in an image and computes the convex hull of its measures.
+   *
+   * @param summary The image to summarize. The dimensions must already be set.
+   */
+  void ControlNetStatistics::ImageSummaryFunctor::operator()(ImageSummary &summary) const {
+    geos::geom::GeometryFactory geosFactory;
+    geos::geom::CoordinateSequence * ptCoordinates =
+        new geos::geom::CoordinateArraySequence();
+
+    vector<double> &imgStats = summary.stats;
+    double cubeArea = imgStats[imgSamples] * imgStats[imgLines];
+
+    QList< ControlMeasure * > measures = summary.node->getMeasures();
+
+    // Populate pts with a list of control points
+    if (!measures.isEmpty()) {
+      foreach (ControlMeasure * measure, measures) {
+        ControlPoint *parentPoint = measure->Parent();
+        imgStats[imgTotalPoints]++;
+        if (parentPoint->IsIgnored()) {
+          imgStats[imgIgnoredPoints]++;
+        }
+        if (parentPoint->GetType() == ControlPoint::Fixed) {
+          imgStats[imgFixedPoints]++;
+        }
+        if (parentPoint->GetType() == ControlPoint::Constrained) {
+          imgStats[imgConstrainedPoints]++;
+        }
+        if (parentPoint->GetType() == ControlPoint::Free) {
+          imgStats[imgFreePoints]++;
+        }
+        if (parentPoint->IsEditLocked()) {
+          imgStats[imgLockedPoints]++;
+        }
+        if (measure->IsEditLocked()) {
+          imgStats[imgLocked]++;
+        }
+        ptCoordinates->add(geos::geom::Coordinate(measure->GetSample(),
+                                                  measure->GetLine()));
+      }
+
+      ptCoordinates->add(geos::geom::Coordinate(measures[0]->GetSample(),
+                                                measures[0]->GetLine()));
+    }
+
+    if (ptCoordinates->size() >= 4) {
+      // Calculate the convex hull
+
+      // Even though geos doesn't create valid linear rings/polygons from this set of coordinates,
+      //   because it self-intersects many many times, it still correctly does a convex hull
+      //   calculation on the points in the polygon. The polygon takes ownership of the
+      //   coordinates.
+      geos::geom::Polygon * polygon = geosFactory.createPolygon(
+        geosFactory.createLinearRing(ptCoordinates), 0);
+      geos::geom::Geometry * convexHull = polygon->convexHull();
+
+      // Calculate the area of the convex hull
+      imgStats[imgConvexHullArea] = convexHull->getArea();
+      imgStats[imgConvexHullRatio] = imgStats[imgConvexHullArea] / cubeArea;
+
+      delete convexHull;
+      delete polygon;
+    }
+    else {
+      delete ptCoordinates;
+    }
+    ptCoordinates = NULL;
+  }
+
+
   /**
    * Print the Image Stats into specified output file
    *
@@ -436,25 +474,64 @@ namespace Isis {
 
 
   /**
-   * Get network statistics for total, valid, ignored, locked points and measures
+   * Initialize Point double stats vector
+   *
+   * @author Sharmila Prasad (1/3/2012)
+   */
+  void ControlNetStatistics::InitPointDoubleStats() {
+    for (int i = 0; i < numPointDblStats; i++) {
+      mPointDoubleStats[i] = Null;
+    }
+  }
+
+
+  /**
+   * Get network statistics for total, valid, ignored, locked points and measures, and the
+   * Network Statistics for Residuals (line, sample, magnitude) and Shifts (line, sample, pixel)
+   *
+   * Each point is summarized in a single pass over its measures on the global thread pool.
+   * The summaries are then combined in point order, so the averages are accumulated in the
+   * same order as a serial pass over the network.
    *
    * @author sprasad (7/19/2011)
    */
-  void ControlNetStatistics::GetPointIntStats() {
+  void ControlNetStatistics::GetPointStats() {
     // Init all the entries
     // totalPoints, validPoints, ignoredPoints, fixedPoints, constrainedPoints, editLockedPoints,
     // totalMeasures, validMeasures, ignoredMeasures, editLockedMeasures
     for (int i=0; i<numPointIntStats; i++) {
       mPointIntStats[i] = 0;
     }
+    InitPointDoubleStats();
 
     int iNumPoints = mCNet->GetNumPoints();
 
+    QVector<PointSummary> summaries(iNumPoints);
+    for (int i = 0; i < iNumPoints; i++) {
+      summaries[i].point = mCNet->GetPoint(i);
+    }
+
+    if (QThreadPool::globalInstance()->maxThreadCount() > 1) {
+      QtConcurrent::blockingMap(summaries, PointSummaryFunctor());
+    }
+    else {
+      for (int i = 0; i < iNumPoints; i++) {
+        PointSummaryFunctor()(summaries[i]);
+      }
+    }
+
     // totalPoints
     mPointIntStats[totalPoints] = iNumPoints;
 
+    Statistics residualMagStats;
+    Statistics pixelShiftStats;
+    double dValue = 0;
+
     for (int i = 0; i < iNumPoints; i++) {
-      if (!mCNet->GetPoint(i)->IsIgnored()) {
+      const PointSummary &summary = summaries[i];
+      const ControlPoint *cp = summary.point;
+
+      if (!cp->IsIgnored()) {
         // validPoints
         mPointIntStats[validPoints]++;
       }
@@ -464,151 +541,173 @@ namespace Isis {
       }
 
       // fixedPoints
-      if (mCNet->GetPoint(i)->GetType() == ControlPoint::Fixed)
+      if (cp->GetType() == ControlPoint::Fixed)
         mPointIntStats[fixedPoints]++;
 
       // constrainedPoints
-      if (mCNet->GetPoint(i)->GetType() == ControlPoint::Constrained)
+      if (cp->GetType() == ControlPoint::Constrained)
         mPointIntStats[constrainedPoints]++;
 
       // free points
-      if (mCNet->GetPoint(i)->GetType() == ControlPoint::Free)
+      if (cp->GetType() == ControlPoint::Free)
         mPointIntStats[freePoints]++;
 
       // editLockedPoints
-      if (mCNet->GetPoint(i)->IsEditLocked()) {
+      if (cp->IsEditLocked()) {
         mPointIntStats[editLockedPoints]++;
       }
 
       // totalMeasures
-      mPointIntStats[totalMeasures] += mCNet->GetPoint(i)->GetNumMeasures();
+      mPointIntStats[totalMeasures] += summary.numMeasures;
 
       // validMeasures
-      mPointIntStats[validMeasures] += mCNet->GetPoint(i)->GetNumValidMeasures();
+      mPointIntStats[validMeasures] += summary.numValidMeasures;
 
       // editLockedMeasures
-      mPointIntStats[editLockedMeasures] +=  mCNet->GetPoint(i)->GetNumLockedMeasures();
+      mPointIntStats[editLockedMeasures] += summary.numLockedMeasures;
+
+      for (int j = 0; j < summary.residuals.size(); j++) {
+        residualMagStats.AddData(summary.residuals[j]);
+      }
+
+      for (int j = 0; j < summary.pixelShifts.size(); j++) {
+        pixelShiftStats.AddData(summary.pixelShifts[j]);
+      }
+
+      UpdateMinMaxStats(summary, minResidual, maxResidual);
+      UpdateMinMaxStats(summary, minLineResidual, maxLineResidual);
+      UpdateMinMaxStats(summary, minSampleResidual, maxSampleResidual);
+      UpdateMinMaxStats(summary, minPixelShift, maxPixelShift);
+      UpdateMinMaxStats(summary, minLineShift, maxLineShift);
+      UpdateMinMaxStats(summary, minSampleShift, maxSampleShift);
+      UpdateMinMaxStats(summary, minGFit, maxGFit);
+
+      if (summary.minimums[minPixelZScore] != Null) {
+        dValue = fabs(summary.minimums[minPixelZScore]);
+        if (mPointDoubleStats[minPixelZScore] > dValue)
+          mPointDoubleStats[minPixelZScore] = dValue;
+      }
+
+      if (summary.maximums[maxPixelZScore] != Null) {
+        dValue = fabs(summary.maximums[maxPixelZScore]);
+        if (mPointDoubleStats[maxPixelZScore] > dValue)
+          mPointDoubleStats[maxPixelZScore] = dValue;
+      }
     }
+
     // ignoredMeasures
     mPointIntStats[ignoredMeasures] = mPointIntStats[totalMeasures] -  mPointIntStats[validMeasures];
-  }
 
+    // Average Residuals
+    mPointDoubleStats[avgResidual] = residualMagStats.Average();
 
-  /**
-   * Initialize Point double stats vector
-   *
-   * @author Sharmila Prasad (1/3/2012)
-   */
-  void ControlNetStatistics::InitPointDoubleStats() {
-    for (int i = 0; i < numPointDblStats; i++) {
-      mPointDoubleStats[i] = Null;
-    }
+    // Average Shift
+    mPointDoubleStats[avgPixelShift] = pixelShiftStats.Average();
   }
 
 
   /**
-   * Get the Network Statistics for Residuals (line, sample, magnitude) and
-   * Shifts (line, sample, pixel)
+   * Summarizes a control point in a single pass over its measures. The minimum and maximum
+   * of each measure quantity are stored at the ePointDoubleStats index of the corresponding
+   * network minimum and maximum.
    *
-   * @author Sharmila Prasad (7/19/2011)
+   * @param summary The point to summarize.
    */
-  void ControlNetStatistics::GetPointDoubleStats() {
-    InitPointDoubleStats();
-
-    int iNumPoints = mCNet->GetNumPoints();
-    double dValue = 0;
-
-    Statistics residualMagStats;
-    Statistics pixelShiftStats;
-
-    for (int i = 0; i < iNumPoints; i++) {
-      ControlPoint * cp = mCNet->GetPoint(i);
-
-      if (!cp->IsIgnored()) {
-        for (int cmIndex = 0; cmIndex < cp->GetNumMeasures(); cmIndex++) {
-          ControlMeasure *cm = cp->GetMeasure(cmIndex);
-
-          if (!cm->IsIgnored()) {
-            residualMagStats.AddData(cm->GetResidualMagnitude());
-
-            if (!IsSpecial(cm->GetPixelShift()))
-              pixelShiftStats.AddData(fabs(cm->GetPixelShift()));
-          }
-        }
+  void ControlNetStatistics::PointSummaryFunctor::operator()(PointSummary &summary) const {
+    const ControlPoint *cp = summary.point;
+    QList< ControlMeasure * > measures = cp->getMeasures();
+
+    summary.numMeasures = measures.size();
+    summary.numValidMeasures = 0;
+    summary.numLockedMeasures = 0;
+    summary.minimums = QVector<double>(numPointDblStats, Null);
+    summary.maximums = QVector<double>(numPointDblStats, Null);
+
+    Statistics resMagStats;
+    Statistics resLineStats;
+    Statistics resSampStats;
+    Statistics pixShiftStats;
+    Statistics lineShiftStats;
+    Statistics sampShiftStats;
+    Statistics gFitStats;
+    Statistics minPixelZScoreStats;
+    Statistics maxPixelZScoreStats;
+
+    foreach (ControlMeasure * cm, measures) {
+      if (cm->IsEditLocked()) {
+        summary.numLockedMeasures++;
       }
 
-      Statistics resMagStats = cp->GetStatistic(
-          &ControlMeasure::GetResidualMagnitude);
-      UpdateMinMaxStats(resMagStats, minResidual, maxResidual);
-
-      Statistics resLineStats = cp->GetStatistic(
-          &ControlMeasure::GetLineResidual);
-      UpdateMinMaxStats(resLineStats, minLineResidual, maxLineResidual);
-
-      Statistics resSampStats = cp->GetStatistic(
-          &ControlMeasure::GetSampleResidual);
-      UpdateMinMaxStats(resSampStats, minSampleResidual, maxSampleResidual);
-
-      Statistics pixShiftStats = cp->GetStatistic(
-          &ControlMeasure::GetPixelShift);
-      UpdateMinMaxStats(pixShiftStats, minPixelShift, maxPixelShift);
-
-      Statistics lineShiftStats = cp->GetStatistic(
-          &ControlMeasure::GetLineShift);
-      UpdateMinMaxStats(lineShiftStats, minLineShift, maxLineShift);
-
-      Statistics sampShiftStats = cp->GetStatistic(
-          &ControlMeasure::GetSampleShift);
-      UpdateMinMaxStats(sampShiftStats, minSampleShift, maxSampleShift);
+      if (cm->IsIgnored()) {
+        continue;
+      }
 
-      Statistics gFitStats = cp->GetStatistic(
-          ControlMeasureLogData::GoodnessOfFit);
-      UpdateMinMaxStats(gFitStats, minGFit, maxGFit);
+      summary.numValidMeasures++;
 
-      Statistics minPixelZScoreStats = cp->GetStatistic(
-          ControlMeasureLogData::MinimumPixelZScore);
+      if (!cp->IsIgnored()) {
+        summary.residuals.append(cm->GetResidualMagnitude());
 
-      if (minPixelZScoreStats.ValidPixels()) {
-        dValue = fabs(minPixelZScoreStats.Minimum());
-        if (mPointDoubleStats[minPixelZScore] > dValue)
-          mPointDoubleStats[minPixelZScore] = dValue;
+        if (!IsSpecial(cm->GetPixelShift()))
+          summary.pixelShifts.append(fabs(cm->GetPixelShift()));
       }
 
-      Statistics maxPixelZScoreStats = cp->GetStatistic(
-          ControlMeasureLogData::MaximumPixelZScore);
+      resMagStats.AddData(cm->GetResidualMagnitude());
+      resLineStats.AddData(cm->GetLineResidual());
+      resSampStats.AddData(cm->GetSampleResidual());
+      pixShiftStats.AddData(cm->GetPixelShift());
+      lineShiftStats.AddData(cm->GetLineShift());
+      sampShiftStats.AddData(cm->GetSampleShift());
+      gFitStats.AddData(
+          cm->GetLogData(ControlMeasureLogData::GoodnessOfFit).GetNumericalValue());
+      minPixelZScoreStats.AddData(
+          cm->GetLogData(ControlMeasureLogData::MinimumPixelZScore).GetNumericalValue());
+      maxPixelZScoreStats.AddData(
+          cm->GetLogData(ControlMeasureLogData::MaximumPixelZScore).GetNumericalValue());
+    }
 
-      if (maxPixelZScoreStats.ValidPixels()) {
-        dValue = fabs(maxPixelZScoreStats.Maximum());
-        if (mPointDoubleStats[maxPixelZScore] > dValue)
-          mPointDoubleStats[maxPixelZScore] = dValue;
+    Statistics *stats[] = { &resMagStats, &resLineStats, &resSampStats, &pixShiftStats,
+                            &lineShiftStats, &sampShiftStats, &gFitStats,
+                            &minPixelZScoreStats, &maxPixelZScoreStats };
+    ePointDoubleStats mins[] = { minResidual, minLineResidual, minSampleResidual,
+                                 minPixelShift, minLineShift, minSampleShift, minGFit,
+                                 minPixelZScore, maxPixelZScore };
+    ePointDoubleStats maxs[] = { maxResidual, maxLineResidual, maxSampleResidual,
+                                 maxPixelShift, maxLineShift, maxSampleShift, maxGFit,
+                                 minPixelZScore, maxPixelZScore };
+
+    for (int i = 0; i < 9; i++) {
+      if (stats[i]->ValidPixels()) {
+        summary.minimums[mins[i]] = stats[i]->Minimum();
+        summary.maximums[maxs[i]] = stats[i]->Maximum();
       }
     }
-
-    // Average Residuals
-    mPointDoubleStats[avgResidual] = residualMagStats.Average();
-
-    // Average Shift
-    mPointDoubleStats[avgPixelShift] = pixelShiftStats.Average();
   }
 
 
-  void ControlNetStatistics::UpdateMinMaxStats(const Statistics & stats,
+  /**
+   * Updates the network minimum and maximum of a quantity with the values of a point.
+   *
+   * @param summary The point summary.
+   * @param min The network minimum to update.
+   * @param max The network maximum to update.
+   */
+  void ControlNetStatistics::UpdateMinMaxStats(const PointSummary & summary,
       ePointDoubleStats min, ePointDoubleStats max) {
-    if (stats.ValidPixels()) {
+    if (summary.minimums[min] != Null) {
       if (mPointDoubleStats[min] != Null) {
         mPointDoubleStats[min] = qMin(
-            mPointDoubleStats[min], fabs(stats.Minimum()));
+            mPointDoubleStats[min], fabs(summary.minimums[min]));
       }
       else {
-        mPointDoubleStats[min] = fabs(stats.Minimum());
+        mPointDoubleStats[min] = fabs(summary.minimums[min]);
       }
 
       if (mPointDoubleStats[max] != Null) {
         mPointDoubleStats[max] = qMax(
-            mPointDoubleStats[max], fabs(stats.Maximum()));
+            mPointDoubleStats[max], fabs(summary.maximums[max]));
       }
       else {
-        mPointDoubleStats[max] = fabs(stats.Maximum());
+        mPointDoubleStats[max] = fabs(summary.maximums[max]);
       }
     }
   }
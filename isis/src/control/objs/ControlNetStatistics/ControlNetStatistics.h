@@ -1,9 +1,15 @@
 #ifndef _CONTROLNETSTATISTICS_H_
 #define _CONTROLNETSTATISTICS_H_
 
+#include <functional>
 #include <map>
 #include <iostream>
 #include <vector>
+
+#include <QMap>
+#include <QPair>
+#include <QVector>
+
 #include "Progress.h"
 #include "PvlGroup.h"
 #include "SerialNumberList.h"
@@ -35,6 +41,7 @@
 namespace Isis {
   class ControlNet;
   class ControlCubeGraphNode;
+  class ControlPoint;
   class Progress;
   class PvlGroup;
 
@@ -74,6 +81,13 @@ namespace Isis {
    *                           unable to open an output file or
    *                           finish writing to an output file.
    *                           Fixes #996.
+   *  @history 2018-09-07 Isis Development Team - The point and image statistics are now
+   *                           gathered in a single pass over the points or images, with the
+   *                           points and images summarized on the global thread pool. The
+   *                           summaries are combined in network order, so the results are the same
+   *                           as before. GetPointIntStats() and GetPointDoubleStats() were replaced
+   *                           by GetPointStats(). Image dimensions are cached so the cubes are
+   *                           only opened the first time GenerateImageStats() is called.
    *  
    */
   class ControlNetStatistics {
@@ -249,18 +263,58 @@ namespace Isis {
       QList<ControlCubeGraphNode *> mCubeGraphNodes;
 
     private:
+      /**
+       * The statistics of a single control point. These are computed on the global thread
+       * pool by a PointSummaryFunctor and combined in GetPointStats().
+       */
+      struct PointSummary {
+        ControlPoint *point;                //!< The control point.
+        int numMeasures;                    //!< Number of measures.
+        int numValidMeasures;               //!< Number of measures that are not ignored.
+        int numLockedMeasures;              //!< Number of edit locked measures.
+        QVector<double> residuals;          /**!< Residual magnitudes of the valid measures of
+                                                  a valid point, in measure order.*/
+        QVector<double> pixelShifts;        /**!< Absolute pixel shifts of the valid measures of
+                                                  a valid point, in measure order.*/
+        QVector<double> minimums;           //!< Minimum of each ePointDoubleStats, or Null.
+        QVector<double> maximums;           //!< Maximum of each ePointDoubleStats, or Null.
+      };
+
+      /**
+       * Computes a PointSummary. This is designed to be passed into QtConcurrent::blockingMap.
+       */
+      class PointSummaryFunctor : public std::unary_function<PointSummary &, void> {
+        public:
+          void operator()(PointSummary &summary) const;
+      };
+
+      /**
+       * The statistics of a single image, computed by an ImageSummaryFunctor and stored in
+       * mImageMap by GenerateImageStats().
+       */
+      struct ImageSummary {
+        ControlCubeGraphNode *node;         //!< The image's node in the control network.
+        std::vector<double> stats;          //!< The ImageStats, with the dimensions filled in.
+      };
+
+      /**
+       * Computes an ImageSummary. This is designed to be passed into
+       * QtConcurrent::blockingMap.
+       */
+      class ImageSummaryFunctor : public std::unary_function<ImageSummary &, void> {
+        public:
+          void operator()(ImageSummary &summary) const;
+      };
+
       std::map<int, int> mPointIntStats;           //!< Contains std::map of different count stats
       std::map<int, double> mPointDoubleStats;     //!< Contains std::map of different computed stats
       std::map<QString, std::vector<double> > mImageMap; //!< Contains stats by Image/Serial Num
       std::map<QString, bool> mSerialNumMap;        //!< Whether serial# is part of ControlNet
 
-      //! Get point count stats
-      void GetPointIntStats();
+      //! Get point counts and stats for Residuals and Shifts
+      void GetPointStats();
 
-      //! Get Point stats for Residuals and Shifts
-      void GetPointDoubleStats();
-
-      void UpdateMinMaxStats(const Statistics & stats,
+      void UpdateMinMaxStats(const PointSummary & summary,
                              ePointDoubleStats min,
                              ePointDoubleStats max);
 
@@ -272,6 +326,9 @@ namespace Isis {
 
       int numCNetImages;
 
+      //! Samples and lines of the images, by serial number
+      QMap< QString, QPair<int, int> > mImageDimensions;
+
       Statistics mConvexHullStats, mConvexHullRatioStats; //!< min, max, average convex hull stats
   };
 }
@@ -23,6 +23,9 @@ void IsisMain() {
 
   p.KeepTemporaryFiles(!ui.GetBoolean("REMOVE"));
 
+  // Write the temporary cubes to memory if they fit in the preferred budget
+  p.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
+
   //---------------------------------------------------------------------------
   // Set up the ingestion run if requested
   if(ui.GetBoolean("INGESTION")) {
@@ -29,6 +29,9 @@ void IsisMain() {
 
   p.KeepTemporaryFiles(false);
 
+  // Write the temporary cubes to memory if they fit in the preferred budget
+  p.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
+
   if(ui.GetBoolean("Ingestion")) {
     p.AddToPipeline("moc2isis");
     p.Application("moc2isis").SetInputParameter("FROM", false);
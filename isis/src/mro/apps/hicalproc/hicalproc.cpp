@@ -60,6 +60,9 @@ void IsisMain() {
     p1.SetOutputFile(FileName("$TEMPORARY/p1_out.cub"));
     sTempFiles.push_back(FileName("$TEMPORARY/p1_out.cub").expanded());
     p1.KeepTemporaryFiles(!bRemoveTempFiles);
+    // Write the temporary cubes of each pipeline to memory if they fit in the
+    // preferred budget
+    p1.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
     // If Raw image convert to Isis format
     p1.AddToPipeline("hi2isis");
@@ -125,6 +128,7 @@ void IsisMain() {
     pStats.SetOutputFile(FileName("$TEMPORARY/statsMask"));
     sTempFiles.push_back(FileName("$TEMPORARY/statsMask").expanded());
     pStats.KeepTemporaryFiles(!bRemoveTempFiles);
+    pStats.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
     pStats.AddToPipeline("cubenorm");
     pStats.Application("cubenorm").SetInputParameter("FROM",   false);
@@ -155,6 +159,7 @@ void IsisMain() {
       p2.SetOutputFile("TO");
     }
     p2.KeepTemporaryFiles(!bRemoveTempFiles);
+    p2.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
     p2.AddToPipeline("mask");
     p2.Application("mask").SetContinue(true);
@@ -199,6 +204,7 @@ void IsisMain() {
       p3.SetOutputFile(FileName("$TEMPORARY/StatsCubeNorm1"));
       sTempFiles.push_back(FileName("$TEMPORARY/StatsCubeNorm1").expanded());
       p3.KeepTemporaryFiles(!bRemoveTempFiles);
+      p3.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
       // Crop if skip top and bottom lines are defined in the Configuration file
       /*p3.AddToPipeline("crop");
@@ -224,6 +230,7 @@ void IsisMain() {
       p4.SetOutputFile(FileName("$TEMPORARY/StatsCubeNorm2"));
       sTempFiles.push_back(FileName("$TEMPORARY/StatsCubeNorm2").expanded());
       p4.KeepTemporaryFiles(!bRemoveTempFiles);
+      p4.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
       p4.AddToPipeline("hicubenorm");
       p4.Application("hicubenorm").SetInputParameter ("FROM",         false);
@@ -254,6 +261,7 @@ void IsisMain() {
         p5.SetOutputFile("TO");
       }
       p5.KeepTemporaryFiles(!bRemoveTempFiles);
+      p5.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
       p5.SetContinue(true);
 
       p5.AddToPipeline("cubenorm");
@@ -327,6 +335,7 @@ void IsisMain() {
         sTempFiles.push_back(FileName("$TEMPORARY/p6_out.cub").expanded());
       }
       p6.KeepTemporaryFiles(!bRemoveTempFiles);
+      p6.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
       if (iSumming == 1 || iSumming == 2) {
         p6.AddToPipeline("hidestripe", "hidestripe1");
@@ -368,6 +377,7 @@ void IsisMain() {
       }
       p7.SetOutputFile("TO");
       p7.KeepTemporaryFiles(!bRemoveTempFiles);
+      p7.SetTemporaryMemory(Pipeline::PreferredTemporaryMemory());
 
       p7.AddToPipeline("cam2map");
       p7.Application("cam2map").SetInputParameter ("FROM", false);
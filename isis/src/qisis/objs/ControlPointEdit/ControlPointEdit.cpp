@@ -26,6 +26,8 @@
 #include "Application.h"
 #include "AutoReg.h"
 #include "AutoRegFactory.h"
+#include "Chip.h"
+#include "ChipCache.h"
 #include "ChipViewport.h"
 #include "ControlMeasure.h"
 #include "ControlMeasureLogData.h"
@@ -81,6 +83,8 @@ namespace Isis {
     p_leftChip = NULL;
     delete p_rightChip;
     p_rightChip = NULL;
+    delete p_chipCache;
+    p_chipCache = NULL;
   }
 
 
@@ -372,9 +376,13 @@ namespace Isis {
     connect(rightPanLeft, SIGNAL(clicked()), this, SLOT(colorizeSaveButton()));
     connect(rightPanRight, SIGNAL(clicked()), this, SLOT(colorizeSaveButton()));
 
-    // Create chips for left and right
+    // Create chips for left and right. Navigating between points reloads the same chips, so
+    // they share a cache of loaded chips and cube tiles.
+    p_chipCache = new ChipCache;
     p_leftChip = new Chip(VIEWSIZE, VIEWSIZE);
+    p_leftChip->SetCache(p_chipCache);
     p_rightChip = new Chip(VIEWSIZE, VIEWSIZE);
+    p_rightChip->SetCache(p_chipCache);
 
     QButtonGroup *bgroup = new QButtonGroup();
     p_nogeom = new QRadioButton();
@@ -937,6 +945,7 @@ namespace Isis {
       try {
         Pvl pvl(p_templateFileName);
         p_autoRegFact = AutoRegFactory::Create(pvl);
+        p_autoRegFact->SetChipCache(p_chipCache);
       }
       catch (IException &e) {
         p_autoRegFact = NULL;
@@ -1512,6 +1521,7 @@ namespace Isis {
       if (p_autoRegFact != NULL)
         delete p_autoRegFact;
       p_autoRegFact = reg;
+      p_autoRegFact->SetChipCache(p_chipCache);
 
       p_templateFileName = fn;
 
@@ -23,6 +23,7 @@ class QVBoxLayout;
 namespace Isis {
   class AutoReg;
   class Chip;
+  class ChipCache;
   class ChipViewport;
   class ControlMeasure;
   class ControlNet;
@@ -139,6 +140,9 @@ namespace Isis {
     *   @history 2017-04-25 Marjorie Hahn - Moved AutoRegFactory creation from the constructor
     *                           to ControlPointEdit::registerPoint() so that AutoRegFactory is 
     *                           not created until it is needed. Fixes #4590.
+    *   @history 2018-09-04 Isis Development Team - The left, right and registration chips
+    *                           now share a ChipCache so that revisiting a point does not
+    *                           reread its chips from the cubes.
     *  
     *   @todo  Re-think design of the change made on 2012-07-26.  The linking was put into
     *                          ::updateLeftPositionLabel because it was the fastest solution, but
@@ -246,6 +250,7 @@ namespace Isis {
       ControlMeasure *p_rightMeasure;
       Chip *p_leftChip;
       Chip *p_rightChip;
+      ChipCache *p_chipCache;
       UniversalGroundMap *p_leftGroundMap;
       UniversalGroundMap *p_rightGroundMap;
 
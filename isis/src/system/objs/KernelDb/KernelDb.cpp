@@ -21,6 +21,8 @@
  */
 #include "KernelDb.h"
 
+#include <algorithm>
+#include <functional>
 #include <iomanip>
 #include <queue>
 
@@ -414,129 +416,538 @@ namespace Isis {
     // Loop through the objects to look for all matches to the entry value
     for (int i = 0; i < m_kernelData.objects(); i++) {
       if (m_kernelData.object(i).isNamed(entry)) {
-        priority_queue<Kernel> filesFound;
-        PvlObject &obj = m_kernelData.object(i);
-
-        for (int groupIndex = obj.groups() - 1; groupIndex >= 0; groupIndex--) {
-          // Get the group and start testing the cases in the keywords
-          // to see if they all match this cube
-          PvlGroup &grp = obj.group(groupIndex);
-
-          // If the group name isn't selection, skip it.
-          if (!grp.isNamed("Selection")) continue;
-
-          QString type = "";
-
-          // Make sure the type is allowed
-          if (grp.hasKeyword("Type")) {
-            type = (QString) grp["Type"];
-            if (!(Kernel::typeEnum(type) & m_allowedKernelTypes)) {
-              // will return 1 for each bit that has 1 in both type and allowed and
-              // return 0 for all other bits
-              //
-              // so, if Type = 0010 and allowed = 1010, then this bitwise operator
-              // (type & allowed) returns 0010 and is true.
-              // That is, this type is allowed.
-              continue;
+        if (selectionIndex(i).compiled) {
+          queues.push_back(findAllInIndex(i, lab, start, end, cameraVersion));
+        }
+        else {
+          queues.push_back(findAllInObject(m_kernelData.object(i), lab,
+                                           start, end, cameraVersion));
+        }
+      }
+    }
+
+    if (queues.size() == 0) {
+      priority_queue<Kernel> emptyKernelQueue;
+      emptyKernelQueue.push(Kernel());
+      queues.push_back(emptyKernelQueue);
+    }
+
+    return queues;
+  }
+
+  /**
+   * Finds the kernels of a kernel database object by testing every Selection
+   * group in it. This is used for objects whose Selections could not be
+   * compiled, so that they fail the same way they always have.
+   *
+   * @param obj The kernel database object to search
+   * @param lab The Pvl label containing an IsisCube object with times and
+   *            instrument ID.
+   * @param start The start time of the cube
+   * @param end The stop time of the cube
+   * @param cameraVersion The camera version of the cube, or -1
+   *
+   * @return @b priority_queue\<Kernel\> The kernels that were found
+   */
+  priority_queue<Kernel> KernelDb::findAllInObject(PvlObject &obj, Pvl &lab,
+                                                   iTime start, iTime end,
+                                                   int cameraVersion) {
+    priority_queue<Kernel> filesFound;
+
+    for (int groupIndex = obj.groups() - 1; groupIndex >= 0; groupIndex--) {
+      // Get the group and start testing the cases in the keywords
+      // to see if they all match this cube
+      PvlGroup &grp = obj.group(groupIndex);
+
+      // If the group name isn't selection, skip it.
+      if (!grp.isNamed("Selection")) continue;
+
+      QString type = "";
+
+      // Make sure the type is allowed
+      if (grp.hasKeyword("Type")) {
+        type = (QString) grp["Type"];
+        if (!(Kernel::typeEnum(type) & m_allowedKernelTypes)) {
+          // will return 1 for each bit that has 1 in both type and allowed and
+          // return 0 for all other bits
+          //
+          // so, if Type = 0010 and allowed = 1010, then this bitwise operator
+          // (type & allowed) returns 0010 and is true.
+          // That is, this type is allowed.
+          continue;
+        }
+      }
+
+      bool startMatches = matches(lab, grp, start, cameraVersion);
+      bool endMatches = matches(lab, grp, end, cameraVersion);
+
+      if (startMatches && endMatches) {
+        // Simple case - the selection simply matches
+        filesFound.push(Kernel(Kernel::typeEnum(type), files(grp)));
+        QStringList kernelfiles = files(grp);
+      }
+      else if (startMatches) {
+        // Well, the selection start matched but not the end.
+        // Let's look for a second selection to handle overlap areas.
+        for (int endTimeIndex = obj.groups() - 1;
+            endTimeIndex >= 0;
+            endTimeIndex--) {
+
+          PvlGroup &endTimeGrp = obj.group(endTimeIndex);
+
+          // The second selection must:
+          //   Not be the current selection
+          //   Be a selection
+          //   Be of the same quality
+          //   Match the end time
+          //
+          // *If start time is also matched, do not merge and simply take the
+          // secondary match
+          if (endTimeIndex == groupIndex) continue;
+          if (!endTimeGrp.isNamed("Selection")) continue;
+          if (grp.hasKeyword("Type") != endTimeGrp.hasKeyword("Type")) continue;
+          if (grp.hasKeyword("Type") &&
+              grp["Type"] != endTimeGrp["Type"]) continue;
+          if (!matches(lab, endTimeGrp, end, cameraVersion)) continue;
+
+          // Better match is true if we find a full overlap
+          bool betterMatch = false;
+
+          // True if we have matching time ranges = we want to merge
+          bool endTimesMatch = true;
+
+          // Check for matching time ranges
+          for (int keyIndex = 0;
+              !betterMatch && keyIndex < grp.keywords();
+              keyIndex++) {
+            PvlKeyword &key = grp[keyIndex];
+
+            if (!key.isNamed("Time")) continue;
+
+            iTime timeRangeStart((QString)key[0]);
+            iTime timeRangeEnd((QString)key[1]);
+
+            bool thisEndMatches = matches(lab, endTimeGrp,
+                                          timeRangeEnd, cameraVersion);
+            endTimesMatch = endTimesMatch && thisEndMatches;
+
+            if (matches(lab, endTimeGrp, start, cameraVersion)
+               && matches(lab, endTimeGrp, end, cameraVersion)) {
+              // If we run into a continuous kernel, we want to take that in all
+              //   cases.
+              betterMatch = true;
             }
           }
 
-          bool startMatches = matches(lab, grp, start, cameraVersion);
-          bool endMatches = matches(lab, grp, end, cameraVersion);
+          // No exact match but time ranges overlap, merge the selections
+          if (!betterMatch && endTimesMatch) {
+            QStringList startMatchFiles = files(grp);
+            QStringList endMatchFiles = files(endTimeGrp);
 
-          if (startMatches && endMatches) {
-            // Simple case - the selection simply matches
-            filesFound.push(Kernel(Kernel::typeEnum(type), files(grp)));
-            QStringList kernelfiles = files(grp);
+            while (endMatchFiles.size()) {
+              startMatchFiles.push_back(endMatchFiles[endMatchFiles.size() - 1]);
+              endMatchFiles.pop_back();
+            }
+
+            filesFound.push(
+              Kernel(Kernel::typeEnum(type), startMatchFiles));
           }
-          else if (startMatches) {
-            // Well, the selection start matched but not the end.
-            // Let's look for a second selection to handle overlap areas.
-            for (int endTimeIndex = obj.groups() - 1;
-                endTimeIndex >= 0;
-                endTimeIndex--) {
-
-              PvlGroup &endTimeGrp = obj.group(endTimeIndex);
-
-              // The second selection must:
-              //   Not be the current selection
-              //   Be a selection
-              //   Be of the same quality
-              //   Match the end time
-              //
-              // *If start time is also matched, do not merge and simply take the
-              // secondary match
-              if (endTimeIndex == groupIndex) continue;
-              if (!endTimeGrp.isNamed("Selection")) continue;
-              if (grp.hasKeyword("Type") != endTimeGrp.hasKeyword("Type")) continue;
-              if (grp.hasKeyword("Type") &&
-                  grp["Type"] != endTimeGrp["Type"]) continue;
-              if (!matches(lab, endTimeGrp, end, cameraVersion)) continue;
-
-              // Better match is true if we find a full overlap
-              bool betterMatch = false;
-
-              // True if we have matching time ranges = we want to merge
-              bool endTimesMatch = true;
-
-              // Check for matching time ranges
-              for (int keyIndex = 0;
-                  !betterMatch && keyIndex < grp.keywords();
-                  keyIndex++) {
-                PvlKeyword &key = grp[keyIndex];
-
-                if (!key.isNamed("Time")) continue;
-
-                iTime timeRangeStart((QString)key[0]);
-                iTime timeRangeEnd((QString)key[1]);
-
-                bool thisEndMatches = matches(lab, endTimeGrp,
-                                              timeRangeEnd, cameraVersion);
-                endTimesMatch = endTimesMatch && thisEndMatches;
-
-                if (matches(lab, endTimeGrp, start, cameraVersion)
-                   && matches(lab, endTimeGrp, end, cameraVersion)) {
-                  // If we run into a continuous kernel, we want to take that in all
-                  //   cases.
-                  betterMatch = true;
-                }
-              }
+          // Found an exact match, use it
+          else if (betterMatch) {
+            filesFound.push(Kernel(Kernel::typeEnum(type), files(endTimeGrp)));
+            QStringList kernelfiles = files(endTimeGrp);
+          }
+        }
+      }
+    }
 
-              // No exact match but time ranges overlap, merge the selections
-              if (!betterMatch && endTimesMatch) {
-                QStringList startMatchFiles = files(grp);
-                QStringList endMatchFiles = files(endTimeGrp);
+    return filesFound;
+  }
 
-                while (endMatchFiles.size()) {
-                  startMatchFiles.push_back(endMatchFiles[endMatchFiles.size() - 1]);
-                  endMatchFiles.pop_back();
-                }
 
-                filesFound.push(
-                  Kernel(Kernel::typeEnum(type), startMatchFiles));
+  /**
+   * Finds the kernels of a kernel database object using its compiled
+   * SelectionIndex. Only the Selections with a Time range containing the
+   * start or stop time, or without a Time keyword, are tested. The result is
+   * the same as findAllInObject().
+   *
+   * @param objectIndex The index of the object in the kernel data
+   * @param lab The Pvl label containing an IsisCube object with times and
+   *            instrument ID.
+   * @param start The start time of the cube
+   * @param end The stop time of the cube
+   * @param cameraVersion The camera version of the cube, or -1
+   *
+   * @return @b priority_queue\<Kernel\> The kernels that were found
+   */
+  priority_queue<Kernel> KernelDb::findAllInIndex(int objectIndex, Pvl &lab,
+                                                  iTime start, iTime end,
+                                                  int cameraVersion) {
+    priority_queue<Kernel> filesFound;
+    PvlObject &obj = m_kernelData.object(objectIndex);
+    SelectionIndex &index = selectionIndex(objectIndex);
+    const PvlObject &cube = lab.findObject("IsisCube");
+
+    // The label criteria do not depend on time, so test each Selection once
+    QVector<int> labMatch(index.selections.size(), -1);
+
+    QList<int> startSelections = selectionsAt(index, start.Et());
+    QList<int> endSelections;
+    bool endSelectionsFound = false;
+
+    foreach (int startPosition, startSelections) {
+      Selection &selection = index.selections[startPosition];
+
+      // Make sure the type is allowed
+      if (selection.hasType &&
+          !(Kernel::typeEnum(selection.type) & m_allowedKernelTypes)) {
+        continue;
+      }
+
+      if (labMatch[startPosition] == -1) {
+        labMatch[startPosition] = labMatches(cube, selection, cameraVersion);
+      }
+      if (!labMatch[startPosition]) continue;
+
+      // The start time matches, because this Selection contains it
+      bool endMatches = timeMatches(selection, end.Et());
+
+      if (endMatches) {
+        // Simple case - the selection simply matches
+        filesFound.push(Kernel(Kernel::typeEnum(selection.type),
+                               selectionFiles(obj.group(selection.groupIndex), selection)));
+        continue;
+      }
+
+      // The selection start matched but not the end. Look for a second
+      // selection to handle overlap areas.
+      if (!endSelectionsFound) {
+        endSelections = selectionsAt(index, end.Et());
+        endSelectionsFound = true;
+      }
+
+      foreach (int endPosition, endSelections) {
+        Selection &endSelection = index.selections[endPosition];
+
+        // The second selection must:
+        //   Not be the current selection
+        //   Be of the same quality
+        //   Match the end time
+        if (endPosition == startPosition) continue;
+        // findAllInObject() compares the Type keywords with PvlKeyword's
+        // operator!=, which only compares their names, so only require both
+        // Selections to have a Type (or neither) here too.
+        if (selection.hasType != endSelection.hasType) continue;
+
+        if (labMatch[endPosition] == -1) {
+          labMatch[endPosition] = labMatches(cube, endSelection, cameraVersion);
+        }
+        if (!labMatch[endPosition]) continue;
+
+        // Better match is true if we find a full overlap
+        bool betterMatch = false;
+
+        // True if we have matching time ranges = we want to merge
+        bool endTimesMatch = true;
+
+        // Check for matching time ranges
+        for (int timeIndex = 0;
+            !betterMatch && timeIndex < selection.times.size();
+            timeIndex++) {
+          bool thisEndMatches = timeMatches(endSelection,
+                                            selection.times[timeIndex].second);
+          endTimesMatch = endTimesMatch && thisEndMatches;
+
+          // If we run into a continuous kernel, we want to take that in all
+          //   cases.
+          if (timeMatches(endSelection, start.Et())) {
+            betterMatch = true;
+          }
+        }
+
+        // No exact match but time ranges overlap, merge the selections
+        if (!betterMatch && endTimesMatch) {
+          QStringList startMatchFiles =
+              selectionFiles(obj.group(selection.groupIndex), selection);
+          QStringList endMatchFiles =
+              selectionFiles(obj.group(endSelection.groupIndex), endSelection);
+
+          while (endMatchFiles.size()) {
+            startMatchFiles.push_back(endMatchFiles[endMatchFiles.size() - 1]);
+            endMatchFiles.pop_back();
+          }
+
+          filesFound.push(
+            Kernel(Kernel::typeEnum(selection.type), startMatchFiles));
+        }
+        // Found an exact match, use it
+        else if (betterMatch) {
+          filesFound.push(Kernel(Kernel::typeEnum(selection.type),
+              selectionFiles(obj.group(endSelection.groupIndex), endSelection)));
+        }
+      }
+    }
+
+    return filesFound;
+  }
+
+
+  /**
+   * Returns the compiled Selections of an object of the kernel data,
+   * compiling them the first time they are needed.
+   *
+   * @param objectIndex The index of the object in the kernel data
+   *
+   * @return @b SelectionIndex& The compiled Selections of the object
+   */
+  KernelDb::SelectionIndex &KernelDb::selectionIndex(int objectIndex) {
+    QMap<int, SelectionIndex>::iterator found = m_selectionIndexes.find(objectIndex);
+    if (found != m_selectionIndexes.end()) return found.value();
+
+    SelectionIndex &index = m_selectionIndexes[objectIndex];
+    index.compiled = true;
+
+    PvlObject &obj = m_kernelData.object(objectIndex);
+    QList< QPair<double, QPair<double, int> > > ranges;
+
+    for (int groupIndex = 0; groupIndex < obj.groups(); groupIndex++) {
+      PvlGroup &grp = obj.group(groupIndex);
+      if (!grp.isNamed("Selection")) continue;
+
+      Selection selection;
+      selection.groupIndex = groupIndex;
+
+      if (!compileSelection(grp, selection)) {
+        index.compiled = false;
+        index.selections.clear();
+        return index;
+      }
+
+      int position = index.selections.size();
+      if (selection.times.isEmpty()) {
+        index.untimedSelections.append(position);
+      }
+
+      for (int i = 0; i < selection.times.size(); i++) {
+        ranges.append(qMakePair(selection.times[i].first,
+                                qMakePair(selection.times[i].second, position)));
+      }
+
+      index.selections.append(selection);
+    }
+
+    sort(ranges.begin(), ranges.end());
+
+    double maxEnd = 0.0;
+    for (int i = 0; i < ranges.size(); i++) {
+      if (i == 0 || ranges[i].second.first > maxEnd) maxEnd = ranges[i].second.first;
+
+      index.rangeStarts.append(ranges[i].first);
+      index.rangeEnds.append(ranges[i].second.first);
+      index.maxRangeEnds.append(maxEnd);
+      index.rangeSelections.append(ranges[i].second.second);
+    }
+
+    return index;
+  }
+
+
+  /**
+   * Parses the criteria of a Selection group. This fails for a group that
+   * matches() would throw an exception for, and for a Type keyword without a
+   * value.
+   *
+   * @param grp The Selection group
+   * @param selection The Selection to fill in
+   *
+   * @return @b bool True if the group was compiled
+   */
+  bool KernelDb::compileSelection(PvlGroup &grp, Selection &selection) {
+    selection.hasType = grp.hasKeyword("Type");
+    selection.type = "";
+    selection.cameraVersionError = false;
+    selection.filesFound = false;
+
+    if (selection.hasType) {
+      if (grp["Type"].size() == 0) return false;
+      selection.type = (QString) grp["Type"];
+    }
+
+    for (int keyword = 0; keyword < grp.keywords(); keyword++) {
+      PvlKeyword &key = grp[keyword];
+
+      if (key.isNamed("Time")) {
+        if (key.size() < 2) return false;
+
+        try {
+          iTime kernelStart = (QString) key[0];
+          iTime kernelEnd   = (QString) key[1];
+          selection.times.append(qMakePair(kernelStart.Et(), kernelEnd.Et()));
+        }
+        catch (IException &) {
+          return false;
+        }
+      }
+      else if (key.isNamed("Match")) {
+        QStringList match;
+
+        if (key.size() >= 3) {
+          match.append(key[0]);
+          match.append(key[1]);
+          match.append(key[2].simplified().trimmed().toUpper());
+        }
+
+        selection.keywordMatches.append(match);
+      }
+      else if (key.isNamed("CameraVersion")) {
+        try {
+          for (int camVersionKeyIndex = 0;
+              camVersionKeyIndex < key.size();
+              camVersionKeyIndex++) {
+
+            QList< QPair<int, int> > versions;
+            IString val = key[camVersionKeyIndex];
+            IString commaTok;
+
+            while ((commaTok = val.Token(",")).ToQt().length() > 0) {
+              if (commaTok.find('-') != string::npos) {
+                int start = commaTok.Token("-").ToInteger();
+                int end = commaTok.Token("-").ToInteger();
+                versions.append(qMakePair(qMin(start, end), qMax(start, end)));
               }
-              // Found an exact match, use it
-              else if (betterMatch) {
-                filesFound.push(Kernel(Kernel::typeEnum(type), files(endTimeGrp)));
-                QStringList kernelfiles = files(endTimeGrp);
+              // This token is a single band specification
+              else {
+                int version = commaTok.ToInteger();
+                versions.append(qMakePair(version, version));
               }
             }
+
+            selection.cameraVersions.append(versions);
           }
         }
+        catch (IException &) {
+          selection.cameraVersionError = true;
+        }
+      }
+    }
 
-        queues.push_back(filesFound);
+    return true;
+  }
+
+
+  /**
+   * Returns the Selections of an index whose Time ranges contain a time, and
+   * the Selections without a Time keyword, in descending group order.
+   *
+   * @param index The compiled Selections of an object
+   * @param et The time to match
+   *
+   * @return @b QList\<int\> The indexes of the Selections
+   */
+  QList<int> KernelDb::selectionsAt(const SelectionIndex &index, double et) {
+    QList<int> found = index.untimedSelections;
+
+    // The ranges before this start at or before the time
+    int last = upper_bound(index.rangeStarts.begin(), index.rangeStarts.end(), et) -
+               index.rangeStarts.begin();
+
+    for (int i = last - 1; i >= 0 && index.maxRangeEnds[i] >= et; i--) {
+      if (index.rangeEnds[i] >= et) found.append(index.rangeSelections[i]);
+    }
+
+    sort(found.begin(), found.end(), greater<int>());
+    found.erase(unique(found.begin(), found.end()), found.end());
+
+    return found;
+  }
+
+
+  /**
+   * Tests the Match and CameraVersion criteria of a Selection against a cube
+   * label, the same way as matches().
+   *
+   * @param cube The IsisCube object of the label
+   * @param selection The compiled Selection
+   * @param cameraVersion The camera version of the cube
+   *
+   * @return @b bool True if all of the label criteria match
+   */
+  bool KernelDb::labMatches(const PvlObject &cube, const Selection &selection,
+                            int cameraVersion) {
+    foreach (const QStringList &match, selection.keywordMatches) {
+      if (match.isEmpty()) return false;
+
+      try {
+        QString cubeValue = cube.findGroup(match[0])[match[1]];
+        cubeValue = cubeValue.simplified().trimmed().toUpper();
+
+        // If QStrings are not the same, match automatically fails
+        if (cubeValue.compare(match[2]) != 0) return false;
+      }
+      catch (IException &) {
+        // This error is thrown if the group or keyword do not exist in 'lab'
+        return false;
       }
     }
 
-    if (queues.size() == 0) {
-      priority_queue<Kernel> emptyKernelQueue;
-      emptyKernelQueue.push(Kernel());
-      queues.push_back(emptyKernelQueue);
+    if (selection.cameraVersionError) return false;
+
+    for (int i = 0; i < selection.cameraVersions.size(); i++) {
+      bool versionMatch = false;
+
+      for (int j = 0; j < selection.cameraVersions[i].size(); j++) {
+        if (selection.cameraVersions[i][j].first <= cameraVersion &&
+            selection.cameraVersions[i][j].second >= cameraVersion) {
+          versionMatch = true;
+        }
+      }
+
+      if (!versionMatch) return false;
     }
 
-    return queues;
+    return true;
+  }
+
+
+  /**
+   * Tests whether a compiled Selection has no Time keyword or has a Time
+   * range containing a time.
+   *
+   * @param selection The compiled Selection
+   * @param et The time to match
+   *
+   * @return @b bool True if the time matches
+   */
+  bool KernelDb::timeMatches(const Selection &selection, double et) {
+    if (selection.times.isEmpty()) return true;
+
+    for (int i = 0; i < selection.times.size(); i++) {
+      if (selection.times[i].first <= et && selection.times[i].second >= et) return true;
+    }
+
+    return false;
   }
 
+
+  /**
+   * Returns the files of a Selection group, finding their highest versions
+   * only the first time.
+   *
+   * @param grp The Selection group
+   * @param selection The compiled Selection of the group
+   *
+   * @return @b QStringList The files of the group
+   */
+  QStringList KernelDb::selectionFiles(PvlGroup &grp, Selection &selection) {
+    if (!selection.filesFound) {
+      selection.files = files(grp);
+      selection.filesFound = true;
+    }
+
+    return selection.files;
+  }
+
+
   /**
    * This static method determines whether the given cube label matches
    * the given criteria. The method can check for three criteria types:
@@ -717,6 +1128,27 @@ namespace Isis {
    * @see kernelDbFiles()
    */
   void KernelDb::loadSystemDb(const QString &mission, const Pvl &lab) {
+    findSystemDbFiles(mission, lab);
+    readKernelDbFiles();
+  }
+
+
+  /**
+   * Finds the kernel database files that loadSystemDb() reads for a mission
+   * and cube label, without reading them. The files are added to
+   * kernelDbFiles(). Callers that select kernels for many cubes can use the
+   * files to share one loaded KernelDb between the cubes that need the same
+   * databases.
+   *
+   * @param mission A QString containing the name of the mission whose kernel
+   *                database files will be found.
+   * @param lab Reference to the labels of a cube. This is used match the
+   *            appropriate InstrumentId value, if needed.
+   *
+   * @see loadSystemDb()
+   * @see kernelDbFiles()
+   */
+  void KernelDb::findSystemDbFiles(const QString &mission, const Pvl &lab) {
 
     // Get the base DataDirectory
     PvlGroup &dataDir = Preference::Preferences().findGroup("DataDirectory");
@@ -757,7 +1189,6 @@ namespace Isis {
     loadKernelDbFiles(dataDir, missionDir + "/kernels/spk", lab);
     // Load the mission specific instrument addendum DB
     loadKernelDbFiles(dataDir, missionDir + "/kernels/iak", lab);
-    readKernelDbFiles();
   }
 
   /**
@@ -850,6 +1281,8 @@ namespace Isis {
    * @see kernelDbFiles()
    */
   void KernelDb::readKernelDbFiles() {
+    m_selectionIndexes.clear();
+
     // read each of the database files appended to the list into m_kernelData
     foreach (FileName kernelDbFile, m_kernelDbFiles) {
       try {
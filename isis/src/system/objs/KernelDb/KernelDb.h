@@ -27,8 +27,11 @@
 #include <queue>
 
 #include <QList>
+#include <QMap>
+#include <QPair>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "iTime.h"//???
 #include "Kernel.h"
@@ -109,6 +112,18 @@ namespace Isis {
    *                           kernels. This was done so that the 'shadow' program could find a
    *                           PCK and SPK to load despite not having a cube with camera
    *                           information. References #1232.
+   *   @history 2018-09-07 Isis Development Team - findAll() no longer parses the
+   *                           time strings and keyword values of every Selection
+   *                           group for each call. The Selection groups of a
+   *                           database object are compiled once into a
+   *                           SelectionIndex with their times as ET ranges, and
+   *                           only the groups with a range containing the cube
+   *                           start or stop time are tested. The files of a
+   *                           Selection are found once. Objects with a Selection
+   *                           that cannot be compiled are searched as before.
+   *   @history 2018-09-07 Isis Development Team - Added findSystemDbFiles(), which
+   *                           finds the database files loadSystemDb() reads
+   *                           without reading them.
    */
   class KernelDb {
 
@@ -138,11 +153,64 @@ namespace Isis {
                                                    Pvl &lab);
 
       void loadSystemDb(const QString &mission, const Pvl &lab);
+      void findSystemDbFiles(const QString &mission, const Pvl &lab);
       QList<FileName> kernelDbFiles();
 
       static bool matches(const Pvl &lab, PvlGroup &kernelDbGrp,
                           iTime timeToMatch, int cameraVersion);
     private:
+      /**
+       * The criteria of a Selection group in a kernel database object, parsed
+       * so that selecting kernels for a cube does not parse them again.
+       */
+      struct Selection {
+        int groupIndex;                 //!< The index of the group in its object
+        bool hasType;                   //!< True if the group has a Type keyword
+        QString type;                   //!< The Type of the group, or ""
+        QList< QPair<double, double> > times; //!< The ET range of each Time keyword
+        /**
+         * The group, keyword and upper case value of each Match keyword. The
+         * list is empty for a Match keyword without three values.
+         */
+        QList<QStringList> keywordMatches;
+        //! The version ranges of each value of each CameraVersion keyword
+        QList< QList< QPair<int, int> > > cameraVersions;
+        bool cameraVersionError;        //!< True if a CameraVersion is invalid
+        bool filesFound;                //!< True if files has been found
+        QStringList files;              //!< The kernel files of the group
+      };
+
+      /**
+       * The compiled Selection groups of a kernel database object. The Time
+       * ranges are sorted by their start, with the largest end of the ranges
+       * so far, so the Selections that contain a time are found without
+       * testing every group.
+       */
+      struct SelectionIndex {
+        bool compiled;                  //!< False if a Selection could not be compiled
+        QList<Selection> selections;    //!< The Selections in group order
+        QList<int> untimedSelections;   //!< The Selections without Time keywords
+        QVector<double> rangeStarts;    //!< The starts of the sorted Time ranges
+        QVector<double> rangeEnds;      //!< The ends of the sorted Time ranges
+        QVector<double> maxRangeEnds;   //!< The largest end of the ranges so far
+        QVector<int> rangeSelections;   //!< The Selection of each sorted range
+      };
+
+      SelectionIndex &selectionIndex(int objectIndex);
+      static bool compileSelection(PvlGroup &grp, Selection &selection);
+      static QList<int> selectionsAt(const SelectionIndex &index, double et);
+      static bool labMatches(const PvlObject &cube, const Selection &selection,
+                             int cameraVersion);
+      static bool timeMatches(const Selection &selection, double et);
+      QStringList selectionFiles(PvlGroup &grp, Selection &selection);
+
+      std::priority_queue<Kernel> findAllInObject(PvlObject &obj, Pvl &lab,
+                                                  iTime start, iTime end,
+                                                  int cameraVersion);
+      std::priority_queue<Kernel> findAllInIndex(int objectIndex, Pvl &lab,
+                                                 iTime start, iTime end,
+                                                 int cameraVersion);
+
       void loadKernelDbFiles(PvlGroup &dataDir,
                              QString directory,
                              const Pvl &lab);
@@ -165,6 +233,11 @@ namespace Isis {
       Pvl m_kernelData; /**< Pvl containing the information in the kernel
                              database(s) that is read in from the constructor
                              and whenever the loadSystemDb() method is called.*/
+      QMap<int, SelectionIndex> m_selectionIndexes; /**< The compiled Selections
+                                                         of the objects in
+                                                         m_kernelData, by object
+                                                         index. They are built
+                                                         when first searched.*/
   };
 };
 